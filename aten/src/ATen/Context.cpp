@@ -9,6 +9,7 @@
 #include <sstream>
 #include <string>
 #include <stdexcept>
+#include <algorithm>
 
 #include <ATen/Tensor.h>
 #include <ATen/cpu/FlushDenormal.h>
@@ -17,8 +18,21 @@
 
 namespace at {
 
+namespace {
+
+at::QEngine default_qengine() {
+#ifdef USE_FBGEMM
+  return at::kFBGEMM;
+#else
+  return at::kQNNPACK;
+#endif
+}
+
+} // namespace
+
 Context::Context()
-: thc_state(nullptr, [](THCState* p){ /* no-op */ } )
+: quantized_engine(default_qengine())
+, thc_state(nullptr, [](THCState* p){ /* no-op */ } )
 , thh_state(nullptr, [](THHState* p){ /* no-op */ } ) {}
 
 // TODO: This could be bad juju if someone calls globalContext() in the
@@ -55,6 +69,32 @@ void Context::setBenchmarkCuDNN(bool b) {
   benchmark_cudnn = b;
 }
 
+at::QEngine Context::qEngine() const {
+  return quantized_engine;
+}
+
+void Context::setQEngine(at::QEngine e) {
+  const auto& engines = supportedQEngines();
+  TORCH_CHECK(
+      std::find(engines.begin(), engines.end(), e) != engines.end(),
+      "quantized engine ", toString(e), " is not supported by this build");
+  quantized_engine = e;
+}
+
+const std::vector<at::QEngine>& Context::supportedQEngines() const {
+  static auto supported_qengines = []() {
+    std::vector<at::QEngine> engines;
+#ifdef USE_FBGEMM
+    engines.push_back(at::kFBGEMM);
+#endif
+#ifdef USE_QNNPACK
+    engines.push_back(at::kQNNPACK);
+#endif
+    return engines;
+  }();
+  return supported_qengines;
+}
+
 bool Context::hasMKL() const {
 #if AT_MKL_ENABLED()
   return true;
@@ -0,0 +1,112 @@
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/InitialTensorOptions.h>
+
+namespace at {
+
+namespace {
+  DeviceType sparseCsrTensorIdToDeviceType(TensorTypeId type_id) {
+    if (type_id == SparseCsrCPUTensorId()) {
+      return kCPU;
+    } else {
+      AT_ERROR("Cannot construct SparseCsrTensor with non-sparse CSR tensor type ID ", type_id);
+    }
+  }
+}
+
+// An empty sparse CSR tensor is a 0 x 0 matrix, so that it has a single row
+// pointer and no entries.
+SparseCsrTensorImpl::SparseCsrTensorImpl(at::TensorTypeId type_id, const caffe2::TypeMeta& data_type)
+    : TensorImpl(type_id, data_type, Device(sparseCsrTensorIdToDeviceType(type_id)))
+    , crow_indices_(at::zeros({1}, at::initialTensorOptions().device(sparseCsrTensorIdToDeviceType(type_id)).dtype(ScalarType::Long)))
+    , col_indices_(at::empty({0}, at::initialTensorOptions().device(sparseCsrTensorIdToDeviceType(type_id)).dtype(ScalarType::Long)))
+    , values_(at::empty({0}, at::initialTensorOptions().device(sparseCsrTensorIdToDeviceType(type_id)).dtype(data_type))) {
+  sizes_ = {0, 0};
+  refresh_numel();
+}
+
+IntArrayRef SparseCsrTensorImpl::strides() const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+bool SparseCsrTensorImpl::is_contiguous(at::MemoryFormat memory_format) const {
+  AT_ERROR("sparse CSR tensors do not have is_contiguous");
+}
+int64_t SparseCsrTensorImpl::stride(int64_t d) const {
+  AT_ERROR("sparse CSR tensors do not have strides");
+}
+void SparseCsrTensorImpl::resize_dim(int64_t ndim) {
+  AT_ERROR("sparse CSR tensors do not have resize_dim");
+}
+void SparseCsrTensorImpl::set_size(int64_t dim, int64_t new_size) {
+  AT_ERROR("sparse CSR tensors do not have set_size");
+}
+void SparseCsrTensorImpl::set_stride(int64_t dim, int64_t new_stride) {
+  AT_ERROR("sparse CSR tensors do not have set_stride");
+}
+void SparseCsrTensorImpl::set_storage_offset(int64_t storage_offset) {
+  AT_ERROR("sparse CSR tensors do not have set_storage_offset");
+}
+
+TensorImpl* SparseCsrTensorImpl::maybe_zero_dim(bool condition_when_zero_dim) {
+  TORCH_CHECK(!condition_when_zero_dim,
+           "Attempted to maybe_zero_dim on a SparseCsrTensorImpl to ", condition_when_zero_dim,
+           " but SparseCsrTensors are always matrices");
+  return this;
+}
+bool SparseCsrTensorImpl::has_storage() const {
+  return false;
+}
+const Storage& SparseCsrTensorImpl::storage() const {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+int64_t SparseCsrTensorImpl::storage_offset() const {
+  AT_ERROR("sparse CSR tensors do not have storage");
+}
+
+void SparseCsrTensorImpl::resize_and_clear_(IntArrayRef size) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "resize_and_clear_ ", err_msg_tensor_metadata_change_not_allowed);
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be matrices, but got size ", size);
+  set_member_tensors_unsafe(
+      at::zeros({size[0] + 1}, crow_indices_.options()),
+      at::empty({0}, col_indices_.options()),
+      at::empty({0}, values_.options()),
+      size);
+}
+
+void SparseCsrTensorImpl::set_member_tensors_unsafe(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  TORCH_CHECK(allow_tensor_metadata_change(), "set_member_tensors_unsafe ", err_msg_tensor_metadata_change_not_allowed);
+  AT_ASSERT(!crow_indices.is_variable() && !col_indices.is_variable() && !values.is_variable());  // They should be plain tensors!  // TODO: change this to check `.requires_grad()` and `GradMode::is_enabled()` when Variable and Tensor are merged
+
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be matrices, but got size ", size);
+  TORCH_CHECK(crow_indices.layout() == kStrided && col_indices.layout() == kStrided,
+      "expected crow_indices and col_indices to be strided tensors, but got layouts ",
+      crow_indices.layout(), " and ", col_indices.layout());
+  TORCH_CHECK(values.layout() == kStrided, "expected values to be a strided tensor, but got values of layout ", values.layout());
+  TORCH_CHECK(values.device().type() == device().type(), "device type of values (", values.device().type(), ") must match device type of device().type()", device().type(), ")");
+  TORCH_CHECK(values.scalar_type() == typeMetaToScalarType(dtype()), "dtype of values (", values.scalar_type(), ") must match dtype of sparse CSR tensor (", typeMetaToScalarType(dtype()), ")");
+  TORCH_CHECK(crow_indices.scalar_type() == kLong && col_indices.scalar_type() == kLong,
+      "crow_indices and col_indices must be int64 tensors");
+  TORCH_CHECK(crow_indices.device() == values.device() && col_indices.device() == values.device(),
+      "crow_indices, col_indices and values must be on the same device");
+
+  TORCH_CHECK(crow_indices.dim() == 1 && crow_indices.size(0) == size[0] + 1,
+      "crow_indices must have rows + 1 = ", size[0] + 1, " elements, but got size ", crow_indices.sizes());
+  TORCH_CHECK(col_indices.dim() == 1 && values.dim() == 1,
+      "col_indices and values must be one dimensional, but got sizes ", col_indices.sizes(), " and ", values.sizes());
+  TORCH_CHECK(col_indices.size(0) == values.size(0),
+      "col_indices and values must have same nnz, but got nnz from col_indices: ", col_indices.size(0),
+      ", nnz from values: ", values.size(0));
+
+  // The kernels index the member tensors through raw pointers
+  crow_indices_ = crow_indices.contiguous();
+  col_indices_ = col_indices.contiguous();
+  values_ = values.contiguous();
+  sizes_ = size.vec();
+  refresh_numel();
+}
+
+} // namespace at
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <ATen/Tensor.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/util/Exception.h>
+
+namespace at {
+struct CAFFE2_API SparseCsrTensorImpl : public TensorImpl {
+  // Stored in compressed sparse row format, crow_indices + col_indices +
+  // values. Only matrices are supported.
+
+  // INVARIANTS:
+  // sizes: dimensionality: 2, shape: (rows, cols)
+  // crow_indices_.shape: dimensionality: 1, shape: (rows + 1)
+  // col_indices_.shape:  dimensionality: 1, shape: (nnz)
+  // values_.shape:       dimensionality: 1, shape: (nnz)
+  //
+  // The entries of row i are at positions [crow_indices_[i],
+  // crow_indices_[i + 1]) of col_indices_ and values_, so
+  // crow_indices_[0] == 0 and crow_indices_[rows] == nnz. Column indices are
+  // sorted within a row, and never repeated.
+  //
+  // Unlike COO tensors, there is no uncoalesced state: the row pointers give
+  // every kernel direct access to the rows, which is what makes row-parallel
+  // kernels (e.g. SpMM) cheap.
+
+  Tensor crow_indices_; // always a LongTensor
+  Tensor col_indices_; // always a LongTensor
+  Tensor values_;
+
+public:
+  explicit SparseCsrTensorImpl(at::TensorTypeId, const caffe2::TypeMeta&);
+
+  int64_t nnz() const { return values_.size(0); }
+  Tensor crow_indices() const { return crow_indices_; }
+  Tensor col_indices() const { return col_indices_; }
+  Tensor values() const { return values_; }
+
+  IntArrayRef strides() const override;
+  bool is_contiguous(at::MemoryFormat memory_format=at::MemoryFormat::Contiguous) const override;
+  int64_t stride(int64_t d) const override;
+  void resize_dim(int64_t ndim) override;
+  void set_size(int64_t dim, int64_t new_size) override;
+  void set_stride(int64_t dim, int64_t new_stride) override;
+  void set_storage_offset(int64_t storage_offset) override;
+
+  TensorImpl* maybe_zero_dim(bool condition_when_zero_dim) override;
+  bool has_storage() const override;
+  const Storage& storage() const override;
+  int64_t storage_offset() const override;
+
+  // NOTE: this function will resize the tensor and set its indices and values
+  // to the ones of an empty matrix.
+  void resize_and_clear_(IntArrayRef size);
+
+  // Takes the indices and values and directly puts them into the tensor, no
+  // copy.
+  // NOTE: this function is unsafe because it only checks the shapes, dtypes
+  // and devices of the tensors, not the values of the indices, so it should
+  // ONLY be used where the indices are known to be valid.
+  void set_member_tensors_unsafe(
+      const Tensor& crow_indices,
+      const Tensor& col_indices,
+      const Tensor& values,
+      IntArrayRef size);
+
+  /**
+   * Return a TensorImpl that is a shallow-copy of this TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  c10::intrusive_ptr<TensorImpl> shallow_copy_and_detach(
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) const override {
+    auto impl = c10::make_intrusive<SparseCsrTensorImpl>(type_id(), dtype());
+    copy_tensor_metadata(
+      /*src_impl=*/this,
+      /*dest_impl=*/impl.get(),
+      /*version_counter=*/version_counter,
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change);
+    impl->refresh_numel();
+    return impl;
+  }
+
+  /**
+   * Shallow-copies data from another TensorImpl into this TensorImpl.
+   *
+   * For why this function doesn't check this TensorImpl's `allow_tensor_metadata_change_`,
+   * see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  void shallow_copy_from(const c10::intrusive_ptr<TensorImpl>& impl) override {
+    AT_ASSERT(has_compatible_shallow_copy_type(impl->type_id()));
+    auto csr_impl = static_cast<const SparseCsrTensorImpl*>(impl.get());
+    copy_tensor_metadata(
+      /*src_impl=*/csr_impl,
+      /*dest_impl=*/this,
+      /*version_counter=*/version_counter(),
+      /*allow_tensor_metadata_change=*/allow_tensor_metadata_change());
+    refresh_numel();
+  }
+private:
+  /**
+   * Copy the tensor metadata fields (e.g. sizes / strides / storage pointer / storage_offset)
+   * from one TensorImpl to another TensorImpl.
+   *
+   * For usage of `version_counter` and `allow_tensor_metadata_change`, see NOTE [ TensorImpl Shallow-Copying ].
+   */
+  static void copy_tensor_metadata(
+      const SparseCsrTensorImpl* src_csr_impl,
+      SparseCsrTensorImpl* dest_csr_impl,
+      const c10::VariableVersion& version_counter,
+      bool allow_tensor_metadata_change) {
+    TensorImpl::copy_tensor_metadata(src_csr_impl, dest_csr_impl, version_counter, allow_tensor_metadata_change);
+
+    // Sparse CSR-specific fields
+    dest_csr_impl->crow_indices_ = src_csr_impl->crow_indices();
+    dest_csr_impl->col_indices_ = src_csr_impl->col_indices();
+    dest_csr_impl->values_ = src_csr_impl->values();
+  }
+};
+
+} // namespace at
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/SparseCsrTensorImpl.h>
+
+namespace at { namespace sparse_csr {
+
+// Just for documentary purposes
+using SparseCsrTensor = Tensor;
+
+// This is an internal utility function for getting at the SparseCsrTensorImpl,
+// see get_sparse_impl in SparseTensorUtils.h.
+inline SparseCsrTensorImpl* get_sparse_csr_impl(const SparseCsrTensor& self) {
+  AT_ASSERTM(!self.is_variable(), "_internal_get_SparseCsrTensorImpl: should not be a variable");  // TODO: remove this when Variable and Tensor are merged
+  AT_ASSERTM(self.is_sparse_csr(), "_internal_get_SparseCsrTensorImpl: not a sparse CSR tensor");
+  return static_cast<SparseCsrTensorImpl*>(self.unsafeGetTensorImpl());
+}
+
+}} // namespace at::sparse_csr
@@ -269,6 +269,9 @@ class CAFFE2_API Tensor {
   /// Returns if a `Tensor` is mkldnn tensor.
   bool is_mkldnn() const;
 
+  /// Returns if a `Tensor` has sparse CSR layout.
+  bool is_sparse_csr() const;
+
   /// Returns if a `Tensor` has quantized backend.
   bool is_quantized() const;
 
@@ -641,10 +644,13 @@ class CAFFE2_API Tensor {
   Tensor & _coalesced_(bool coalesced) const;
   Tensor indices() const;
   Tensor values() const;
+  Tensor crow_indices() const;
+  Tensor col_indices() const;
   int64_t numel() const;
   std::vector<Tensor> unbind(int64_t dim=0) const;
   Tensor to_sparse(int64_t sparse_dim) const;
   Tensor to_sparse() const;
+  Tensor to_sparse_csr() const;
   Tensor to_mkldnn() const;
   Tensor dequantize() const;
   double q_scale() const;
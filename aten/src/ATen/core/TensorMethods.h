@@ -2606,6 +2606,30 @@ inline Tensor Tensor::values() const {
     return table->getOp<Tensor (const Tensor &)>(tensorTypeIdToBackend(type_id()), is_variable())(const_cast<Tensor&>(*this));
 #endif
 }
+inline Tensor Tensor::crow_indices() const {
+#ifdef USE_STATIC_DISPATCH
+    switch(tensorTypeIdToBackend(type_id())) {
+    
+        default:
+            AT_ERROR("crow_indices not implemented for ", at::toString(tensorTypeIdToBackend(type_id())));
+    }
+#else
+    static auto table = globalATenDispatch().getOpTable("aten::crow_indices(Tensor(a) self) -> Tensor(a)");
+    return table->getOp<Tensor (const Tensor &)>(tensorTypeIdToBackend(type_id()), is_variable())(const_cast<Tensor&>(*this));
+#endif
+}
+inline Tensor Tensor::col_indices() const {
+#ifdef USE_STATIC_DISPATCH
+    switch(tensorTypeIdToBackend(type_id())) {
+    
+        default:
+            AT_ERROR("col_indices not implemented for ", at::toString(tensorTypeIdToBackend(type_id())));
+    }
+#else
+    static auto table = globalATenDispatch().getOpTable("aten::col_indices(Tensor(a) self) -> Tensor(a)");
+    return table->getOp<Tensor (const Tensor &)>(tensorTypeIdToBackend(type_id()), is_variable())(const_cast<Tensor&>(*this));
+#endif
+}
 inline int64_t Tensor::numel() const {
 #ifdef USE_STATIC_DISPATCH
     return TypeDefault::numel(const_cast<Tensor&>(*this));
@@ -2650,6 +2674,23 @@ inline Tensor Tensor::to_sparse() const {
     return table->getOp<Tensor (const Tensor &)>(tensorTypeIdToBackend(type_id()), is_variable())(const_cast<Tensor&>(*this));
 #endif
 }
+inline Tensor Tensor::to_sparse_csr() const {
+#ifdef USE_STATIC_DISPATCH
+    switch(tensorTypeIdToBackend(type_id())) {
+        case Backend::CPU:
+            return CPUType::to_sparse_csr(const_cast<Tensor&>(*this));
+            break;
+        case Backend::SparseCPU:
+            return SparseCPUType::to_sparse_csr(const_cast<Tensor&>(*this));
+            break;
+        default:
+            AT_ERROR("to_sparse_csr not implemented for ", at::toString(tensorTypeIdToBackend(type_id())));
+    }
+#else
+    static auto table = globalATenDispatch().getOpTable("aten::to_sparse_csr(Tensor self) -> Tensor");
+    return table->getOp<Tensor (const Tensor &)>(tensorTypeIdToBackend(type_id()), is_variable())(const_cast<Tensor&>(*this));
+#endif
+}
 inline Tensor Tensor::to_mkldnn() const {
 #ifdef USE_STATIC_DISPATCH
     switch(tensorTypeIdToBackend(type_id())) {
@@ -4902,6 +4943,15 @@ inline bool is_mkldnn(Tensor self) {
   return self.is_mkldnn();
 }
 
+inline bool Tensor::is_sparse_csr() const {
+  // NB: this is not a native function to avoid dispatching overhead.
+  return impl_->is_sparse_csr();
+}
+
+inline bool is_sparse_csr(Tensor self) {
+  return self.is_sparse_csr();
+}
+
 inline bool Tensor::is_quantized() const {
   // NB: this is not a native function to avoid dispatching overhead.
   return impl_->is_quantized();
@@ -6,6 +6,7 @@
 #include <ATen/cpu/vec256/vec256_float.h>
 #include <ATen/cpu/vec256/vec256_double.h>
 #include <ATen/cpu/vec256/vec256_int.h>
+#include <ATen/cpu/vec256/vec256_qint.h>
 
 #include <algorithm>
 #include <cstddef>
@@ -0,0 +1,396 @@
+#pragma once
+
+#include <ATen/cpu/vec256/intrinsics.h>
+#include <ATen/cpu/vec256/vec256_base.h>
+#include <c10/util/qint32.h>
+#include <c10/util/qint8.h>
+#include <c10/util/quint8.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+// Vectors of quantized values.
+//
+// Vec256<qint8> and Vec256<quint8> hold 32 values and Vec256<qint32> holds 8.
+// Arithmetic on quantized values is done in float, as in the scalar kernels:
+// dequantize() widens a vector to float_num_vecs() Vec256<float>, and
+// quantize() narrows them back, rounding half to even and saturating to the
+// range of the type, with the same results as quantize_val(). Since the
+// affine mapping preserves order, maximum(), minimum(), relu() and relu6()
+// work on the integers directly. widening_subtract() gives the differences
+// of two vectors as Vec256<int32_t>, for kernels that accumulate integers.
+
+namespace at {
+namespace vec256 {
+// See Note [Acceptable use of anonymous namespace in header]
+namespace {
+
+// x / scale + zero_point in float, rounded and clamped to [qmin, qmax] like
+// quantize_val() does. NaN gives qmin. Kernels use it for the elements left
+// over after the last full vector, so that every element of a tensor is
+// quantized with the same arithmetic as the vectorized ones.
+template <typename T>
+inline typename T::underlying quantize_scalar(float x, float scale, int32_t zero_point) {
+  using underlying_t = typename T::underlying;
+  constexpr int64_t qmin = std::numeric_limits<underlying_t>::min();
+  constexpr int64_t qmax = std::numeric_limits<underlying_t>::max();
+  const float v = std::nearbyint(x / scale + zero_point);
+  if (v >= static_cast<float>(qmax)) {
+    return static_cast<underlying_t>(qmax);
+  }
+  return static_cast<underlying_t>(v >= static_cast<float>(qmin) ? v : qmin);
+}
+
+// (q - zero_point) * scale in float, the scalar counterpart of dequantize().
+template <typename T>
+inline float dequantize_scalar(typename T::underlying q, float scale, int32_t zero_point) {
+  return static_cast<float>(static_cast<int32_t>(q) - zero_point) * scale;
+}
+
+#ifdef __AVX2__
+
+// Eight 8 bit values, starting at byte 8 * i of v, widened to int32.
+template <typename T, int i>
+inline __m256i widen_8bit(__m256i v) {
+  __m128i half = _mm256_extracti128_si256(v, i / 2);
+  if (i % 2) {
+    half = _mm_srli_si128(half, 8);
+  }
+  return std::is_signed<typename T::underlying>::value
+      ? _mm256_cvtepi8_epi32(half)
+      : _mm256_cvtepu8_epi32(half);
+}
+
+// The inverse of widen_8bit for four vectors, saturating.
+template <typename T>
+inline __m256i narrow_to_8bit(__m256i a, __m256i b, __m256i c, __m256i d) {
+  const __m256i ab = _mm256_packs_epi32(a, b);
+  const __m256i cd = _mm256_packs_epi32(c, d);
+  // packing works within 128 bit lanes, which leaves the groups of four
+  // values in the order a0 b0 c0 d0 a1 b1 c1 d1
+  const __m256i abcd = std::is_signed<typename T::underlying>::value
+      ? _mm256_packs_epi16(ab, cd)
+      : _mm256_packus_epi16(ab, cd);
+  return _mm256_permutevar8x32_epi32(abcd, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+template <typename T>
+inline __m256 dequantize_epi32(__m256i v, __m256 scale, __m256i zero_point) {
+  return _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_sub_epi32(v, zero_point)), scale);
+}
+
+template <typename T>
+inline __m256i quantize_epi32(__m256 x, __m256 scale, __m256 zero_point) {
+  using underlying_t = typename T::underlying;
+  const __m256 v = _mm256_add_ps(_mm256_div_ps(x, scale), zero_point);
+  // _mm256_max_ps returns its second operand for NaN
+  const __m256 lower = _mm256_max_ps(
+      v, _mm256_set1_ps(static_cast<float>(std::numeric_limits<underlying_t>::min())));
+  if (sizeof(underlying_t) < sizeof(int32_t)) {
+    const __m256 clamped = _mm256_min_ps(
+        lower, _mm256_set1_ps(static_cast<float>(std::numeric_limits<underlying_t>::max())));
+    // rounds in the current rounding mode, like std::nearbyint
+    return _mm256_cvtps_epi32(clamped);
+  }
+  // the conversion gives INT32_MIN for values from 2^31 up
+  const __m256 too_large = _mm256_cmp_ps(lower, _mm256_set1_ps(2147483648.f), _CMP_GE_OQ);
+  return _mm256_blendv_epi8(
+      _mm256_cvtps_epi32(lower),
+      _mm256_set1_epi32(std::numeric_limits<int32_t>::max()),
+      _mm256_castps_si256(too_large));
+}
+
+struct Vec256qi {
+protected:
+  __m256i vals;
+
+public:
+  Vec256qi() {}
+  Vec256qi(__m256i v) : vals(v) {}
+  operator __m256i() const {
+    return vals;
+  }
+};
+
+template <typename T>
+struct Vec256Quantized8 : public Vec256qi {
+  using value_type = typename T::underlying;
+  using float_vec_return_type = std::array<Vec256<float>, 4>;
+  using int_vec_return_type = std::array<Vec256<int32_t>, 4>;
+  static constexpr int size() {
+    return 32;
+  }
+  static constexpr int float_num_vecs() {
+    return 4;
+  }
+  Vec256Quantized8() {}
+  Vec256Quantized8(__m256i v) : Vec256qi(v) {}
+
+  void store(void* ptr, int count = size()) const {
+    if (count != size()) {
+      __at_align32__ value_type tmp_values[size()];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp_values), vals);
+      std::memcpy(ptr, tmp_values, count * sizeof(value_type));
+    } else {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), vals);
+    }
+  }
+
+  float_vec_return_type dequantize(float scale, int32_t zero_point) const {
+    const __m256 scale_vec = _mm256_set1_ps(scale);
+    const __m256i zero_point_vec = _mm256_set1_epi32(zero_point);
+    return {
+        Vec256<float>(dequantize_epi32<T>(widen_8bit<T, 0>(vals), scale_vec, zero_point_vec)),
+        Vec256<float>(dequantize_epi32<T>(widen_8bit<T, 1>(vals), scale_vec, zero_point_vec)),
+        Vec256<float>(dequantize_epi32<T>(widen_8bit<T, 2>(vals), scale_vec, zero_point_vec)),
+        Vec256<float>(dequantize_epi32<T>(widen_8bit<T, 3>(vals), scale_vec, zero_point_vec))};
+  }
+
+  int_vec_return_type widening_subtract(__m256i b) const {
+    return {
+        Vec256<int32_t>(_mm256_sub_epi32(widen_8bit<T, 0>(vals), widen_8bit<T, 0>(b))),
+        Vec256<int32_t>(_mm256_sub_epi32(widen_8bit<T, 1>(vals), widen_8bit<T, 1>(b))),
+        Vec256<int32_t>(_mm256_sub_epi32(widen_8bit<T, 2>(vals), widen_8bit<T, 2>(b))),
+        Vec256<int32_t>(_mm256_sub_epi32(widen_8bit<T, 3>(vals), widen_8bit<T, 3>(b)))};
+  }
+
+ protected:
+  static __m256i quantize_vals(const float_vec_return_type& rhs, float scale, int32_t zero_point) {
+    const __m256 scale_vec = _mm256_set1_ps(scale);
+    const __m256 zero_point_vec = _mm256_set1_ps(static_cast<float>(zero_point));
+    return narrow_to_8bit<T>(
+        quantize_epi32<T>(rhs[0], scale_vec, zero_point_vec),
+        quantize_epi32<T>(rhs[1], scale_vec, zero_point_vec),
+        quantize_epi32<T>(rhs[2], scale_vec, zero_point_vec),
+        quantize_epi32<T>(rhs[3], scale_vec, zero_point_vec));
+  }
+};
+
+template <>
+struct Vec256<c10::qint8> : public Vec256Quantized8<c10::qint8> {
+  Vec256() {}
+  Vec256(__m256i v) : Vec256Quantized8(v) {}
+  Vec256(const c10::qint8& val) {
+    vals = _mm256_set1_epi8(val.val_);
+  }
+  static Vec256<c10::qint8> loadu(const void* ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+  }
+  static Vec256<c10::qint8> quantize(const float_vec_return_type& rhs, float scale, int32_t zero_point) {
+    return quantize_vals(rhs, scale, zero_point);
+  }
+  Vec256<c10::qint8> maximum(Vec256<c10::qint8> b) const {
+    return _mm256_max_epi8(vals, b.vals);
+  }
+  Vec256<c10::qint8> minimum(Vec256<c10::qint8> b) const {
+    return _mm256_min_epi8(vals, b.vals);
+  }
+  Vec256<c10::qint8> relu(Vec256<c10::qint8> zero_point) const {
+    return maximum(zero_point);
+  }
+  Vec256<c10::qint8> relu6(Vec256<c10::qint8> zero_point, Vec256<c10::qint8> q_six) const {
+    return maximum(zero_point).minimum(q_six);
+  }
+};
+
+template <>
+struct Vec256<c10::quint8> : public Vec256Quantized8<c10::quint8> {
+  Vec256() {}
+  Vec256(__m256i v) : Vec256Quantized8(v) {}
+  Vec256(const c10::quint8& val) {
+    vals = _mm256_set1_epi8(static_cast<int8_t>(val.val_));
+  }
+  static Vec256<c10::quint8> loadu(const void* ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+  }
+  static Vec256<c10::quint8> quantize(const float_vec_return_type& rhs, float scale, int32_t zero_point) {
+    return quantize_vals(rhs, scale, zero_point);
+  }
+  Vec256<c10::quint8> maximum(Vec256<c10::quint8> b) const {
+    return _mm256_max_epu8(vals, b.vals);
+  }
+  Vec256<c10::quint8> minimum(Vec256<c10::quint8> b) const {
+    return _mm256_min_epu8(vals, b.vals);
+  }
+  Vec256<c10::quint8> relu(Vec256<c10::quint8> zero_point) const {
+    return maximum(zero_point);
+  }
+  Vec256<c10::quint8> relu6(Vec256<c10::quint8> zero_point, Vec256<c10::quint8> q_six) const {
+    return maximum(zero_point).minimum(q_six);
+  }
+};
+
+template <>
+struct Vec256<c10::qint32> : public Vec256qi {
+  using value_type = int32_t;
+  using float_vec_return_type = std::array<Vec256<float>, 1>;
+  using int_vec_return_type = std::array<Vec256<int32_t>, 1>;
+  static constexpr int size() {
+    return 8;
+  }
+  static constexpr int float_num_vecs() {
+    return 1;
+  }
+  Vec256() {}
+  Vec256(__m256i v) : Vec256qi(v) {}
+  Vec256(const c10::qint32& val) {
+    vals = _mm256_set1_epi32(val.val_);
+  }
+  static Vec256<c10::qint32> loadu(const void* ptr) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+  }
+  void store(void* ptr, int count = size()) const {
+    if (count != size()) {
+      __at_align32__ value_type tmp_values[size()];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(tmp_values), vals);
+      std::memcpy(ptr, tmp_values, count * sizeof(value_type));
+    } else {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), vals);
+    }
+  }
+  float_vec_return_type dequantize(float scale, int32_t zero_point) const {
+    return {Vec256<float>(dequantize_epi32<c10::qint32>(
+        vals, _mm256_set1_ps(scale), _mm256_set1_epi32(zero_point)))};
+  }
+  static Vec256<c10::qint32> quantize(const float_vec_return_type& rhs, float scale, int32_t zero_point) {
+    return quantize_epi32<c10::qint32>(
+        rhs[0], _mm256_set1_ps(scale), _mm256_set1_ps(static_cast<float>(zero_point)));
+  }
+  int_vec_return_type widening_subtract(Vec256<c10::qint32> b) const {
+    return {Vec256<int32_t>(_mm256_sub_epi32(vals, b.vals))};
+  }
+  Vec256<c10::qint32> maximum(Vec256<c10::qint32> b) const {
+    return _mm256_max_epi32(vals, b.vals);
+  }
+  Vec256<c10::qint32> minimum(Vec256<c10::qint32> b) const {
+    return _mm256_min_epi32(vals, b.vals);
+  }
+  Vec256<c10::qint32> relu(Vec256<c10::qint32> zero_point) const {
+    return maximum(zero_point);
+  }
+  Vec256<c10::qint32> relu6(Vec256<c10::qint32> zero_point, Vec256<c10::qint32> q_six) const {
+    return maximum(zero_point).minimum(q_six);
+  }
+};
+
+#else
+
+// Without AVX2 the values are kept in an array and converted one by one.
+template <typename T, int kSize>
+struct Vec256QuantizedBase {
+  using value_type = typename T::underlying;
+  using float_vec_return_type = std::array<Vec256<float>, kSize / 8>;
+  using int_vec_return_type = std::array<Vec256<int32_t>, kSize / 8>;
+  static constexpr int size() {
+    return kSize;
+  }
+  static constexpr int float_num_vecs() {
+    return kSize / 8;
+  }
+
+  void store(void* ptr, int count = size()) const {
+    std::memcpy(ptr, vals, count * sizeof(value_type));
+  }
+
+  float_vec_return_type dequantize(float scale, int32_t zero_point) const {
+    float_vec_return_type result;
+    __at_align32__ float tmp_values[8];
+    for (int i = 0; i < float_num_vecs(); i++) {
+      for (int j = 0; j < 8; j++) {
+        tmp_values[j] = dequantize_scalar<T>(vals[8 * i + j], scale, zero_point);
+      }
+      result[i] = Vec256<float>::loadu(tmp_values);
+    }
+    return result;
+  }
+
+ protected:
+  value_type vals[kSize];
+
+  template <typename Vec>
+  int_vec_return_type widening_subtract_vals(const Vec& b) const {
+    int_vec_return_type result;
+    __at_align32__ int32_t tmp_values[8];
+    for (int i = 0; i < float_num_vecs(); i++) {
+      for (int j = 0; j < 8; j++) {
+        tmp_values[j] = static_cast<int32_t>(vals[8 * i + j]) - static_cast<int32_t>(b.vals[8 * i + j]);
+      }
+      result[i] = Vec256<int32_t>::loadu(tmp_values);
+    }
+    return result;
+  }
+
+  template <typename Vec>
+  static Vec quantize_vals(const float_vec_return_type& rhs, float scale, int32_t zero_point) {
+    Vec result;
+    __at_align32__ float tmp_values[8];
+    for (int i = 0; i < float_num_vecs(); i++) {
+      rhs[i].store(tmp_values);
+      for (int j = 0; j < 8; j++) {
+        result.vals[8 * i + j] = quantize_scalar<T>(tmp_values[j], scale, zero_point);
+      }
+    }
+    return result;
+  }
+
+  template <typename Vec, typename Op>
+  Vec binary_op(const Vec& b, const Op& op) const {
+    Vec result;
+    for (int i = 0; i < size(); i++) {
+      result.vals[i] = op(vals[i], b.vals[i]);
+    }
+    return result;
+  }
+};
+
+#define DEFINE_QUANTIZED_VEC256(T, kSize)                                      \
+  template <>                                                                  \
+  struct Vec256<T> : public Vec256QuantizedBase<T, kSize> {                    \
+    friend struct Vec256QuantizedBase<T, kSize>;                               \
+    Vec256() {}                                                                \
+    Vec256(const T& val) {                                                     \
+      std::fill(vals, vals + size(), val.val_);                                \
+    }                                                                          \
+    static Vec256<T> loadu(const void* ptr) {                                  \
+      Vec256<T> result;                                                        \
+      std::memcpy(result.vals, ptr, sizeof(result.vals));                      \
+      return result;                                                           \
+    }                                                                          \
+    static Vec256<T> quantize(                                                 \
+        const float_vec_return_type& rhs, float scale, int32_t zero_point) {   \
+      return quantize_vals<Vec256<T>>(rhs, scale, zero_point);                 \
+    }                                                                          \
+    int_vec_return_type widening_subtract(Vec256<T> b) const {                 \
+      return widening_subtract_vals(b);                                        \
+    }                                                                          \
+    Vec256<T> maximum(Vec256<T> b) const {                                     \
+      return binary_op(b, [](value_type x, value_type y) {                     \
+        return std::max(x, y);                                                 \
+      });                                                                      \
+    }                                                                          \
+    Vec256<T> minimum(Vec256<T> b) const {                                     \
+      return binary_op(b, [](value_type x, value_type y) {                     \
+        return std::min(x, y);                                                 \
+      });                                                                      \
+    }                                                                          \
+    Vec256<T> relu(Vec256<T> zero_point) const {                               \
+      return maximum(zero_point);                                              \
+    }                                                                          \
+    Vec256<T> relu6(Vec256<T> zero_point, Vec256<T> q_six) const {             \
+      return maximum(zero_point).minimum(q_six);                               \
+    }                                                                          \
+  };
+
+DEFINE_QUANTIZED_VEC256(c10::qint8, 32)
+DEFINE_QUANTIZED_VEC256(c10::quint8, 32)
+DEFINE_QUANTIZED_VEC256(c10::qint32, 8)
+
+#undef DEFINE_QUANTIZED_VEC256
+
+#endif // __AVX2__
+
+}}} // namespace at::vec256::<anonymous>
@@ -4,6 +4,7 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/ExpandUtils.h>
 
+#include <ATen/native/BatchLinearAlgebra.h>
 #include <ATen/native/LinearAlgebraUtils.h>
 #include <ATen/Parallel.h>
 
@@ -216,6 +217,12 @@ template<> void lapackLuSolve<float>(char trans, int n, int nrhs, float *a, int
 }
 #endif
 
+DEFINE_DISPATCH(small_solve_stub);
+DEFINE_DISPATCH(small_inverse_stub);
+DEFINE_DISPATCH(small_cholesky_stub);
+DEFINE_DISPATCH(small_det_stub);
+DEFINE_DISPATCH(small_baddbmm_stub);
+
 // Below of the definitions of the functions operating on a batch that are going to be dispatched
 // in the main helper functions for the linear algebra operations
 
@@ -254,9 +261,13 @@ std::tuple<Tensor, Tensor> _solve_helper_cpu(const Tensor& self, const Tensor& A
   auto self_working_copy = cloneBatchedColumnMajor(self);
   auto A_working_copy = cloneBatchedColumnMajor(A);
   std::vector<int64_t> infos(batchCount(self), 0);
-  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "solve_cpu", [&]{
-    apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
-  });
+  if (use_small_matrix_kernels(self, A.size(-1), batchCount(self))) {
+    small_solve_stub(kCPU, self_working_copy, A_working_copy, infos);
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "solve_cpu", [&]{
+      apply_solve<scalar_t>(self_working_copy, A_working_copy, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "solve_cpu");
   } else {
@@ -332,9 +343,13 @@ static void apply_inverse(Tensor& self, std::vector<int64_t>& infos) {
 Tensor _inverse_helper_cpu(const Tensor& self) {
   std::vector<int64_t> infos(batchCount(self), 0);
   auto self_working_copy = cloneBatchedColumnMajor(self);
-  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "inverse_cpu", [&]{
-    apply_inverse<scalar_t>(self_working_copy, infos);
-  });
+  if (use_small_matrix_kernels(self, self.size(-1), batchCount(self))) {
+    small_inverse_stub(kCPU, self_working_copy, infos);
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "inverse_cpu", [&]{
+      apply_inverse<scalar_t>(self_working_copy, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "inverse_cpu");
   } else {
@@ -451,9 +466,13 @@ static void apply_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos
 Tensor _cholesky_helper_cpu(const Tensor& self, bool upper) {
   std::vector<int64_t> infos(batchCount(self), 0);
   auto self_working_copy = cloneBatchedColumnMajor(self);
-  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
-    apply_cholesky<scalar_t>(self_working_copy, upper, infos);
-  });
+  if (use_small_matrix_kernels(self, self.size(-1), batchCount(self))) {
+    small_cholesky_stub(kCPU, self_working_copy, upper, infos);
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "cholesky_cpu", [&]{
+      apply_cholesky<scalar_t>(self_working_copy, upper, infos);
+    });
+  }
   if (self.dim() > 2) {
     batchCheckErrors(infos, "cholesky_cpu");
   } else {
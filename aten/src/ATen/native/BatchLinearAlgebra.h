@@ -0,0 +1,45 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <vector>
+
+namespace at { namespace native {
+
+// Square matrices up to this order are handled by the fixed-size kernels in
+// cpu/BatchLinearAlgebraKernel.cpp, which work on Vec256::size() matrices at
+// a time with one matrix per vector lane.
+constexpr int64_t kSmallMatrixMaxSize = 8;
+
+// Whether a batch of batch_size matrices of order n goes to the small-matrix
+// kernels instead of one LAPACK (or BLAS) call per matrix. A single matrix
+// keeps going to LAPACK.
+static inline bool use_small_matrix_kernels(const Tensor& self, int64_t n, int64_t batch_size) {
+  return self.device().type() == kCPU
+      && (self.scalar_type() == kFloat || self.scalar_type() == kDouble)
+      && n >= 2 && n <= kSmallMatrixMaxSize && batch_size > 1;
+}
+
+// The solve, inverse and cholesky kernels take the batched column major
+// working copies of the LAPACK paths (see cloneBatchedColumnMajor), overwrite
+// them the way gesv, getrf + getri and potrf do and report the same infos.
+// (b, A, infos): b <- solution, A <- LU factorization
+using small_solve_fn = void(*)(Tensor&, Tensor&, std::vector<int64_t>&);
+// (self, infos): self <- inverse
+using small_inverse_fn = void(*)(Tensor&, std::vector<int64_t>&);
+// (self, upper, infos): self <- Cholesky factor, in the triangle given by upper
+using small_cholesky_fn = void(*)(Tensor&, bool, std::vector<int64_t>&);
+// (result, self): the determinants of the (batch, n, n) tensor self
+using small_det_fn = void(*)(Tensor&, const Tensor&);
+// (result, batch1, batch2, beta, alpha, is_bmm) with square batch1: as
+// baddbmm, or as bmm when is_bmm is set
+using small_baddbmm_fn = void(*)(Tensor&, const Tensor&, const Tensor&, Scalar, Scalar, bool);
+
+DECLARE_DISPATCH(small_solve_fn, small_solve_stub);
+DECLARE_DISPATCH(small_inverse_fn, small_inverse_stub);
+DECLARE_DISPATCH(small_cholesky_fn, small_cholesky_stub);
+DECLARE_DISPATCH(small_det_fn, small_det_stub);
+DECLARE_DISPATCH(small_baddbmm_fn, small_baddbmm_stub);
+
+}} // namespace at::native
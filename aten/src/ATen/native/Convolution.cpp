@@ -14,6 +14,7 @@ static const int MIOPEN_DIM_MAX = 4;
 namespace at { namespace native {
 
 std::atomic<bool> disable_mkldnn_conv{false};
+std::atomic<CpuConvAlgorithm> cpu_conv_algorithm{CpuConvAlgorithm::Auto};
 
 struct ConvParams {
   std::vector<int64_t> stride;
@@ -39,6 +40,9 @@ struct ConvParams {
   bool use_miopen(const at::Tensor& input) const;
   bool use_mkldnn(const at::Tensor& input) const;
   bool use_nnpack(const at::Tensor& input) const;
+  bool use_winograd(const at::Tensor& input, const at::Tensor& weight) const;
+  int64_t winograd_output_tile(const at::Tensor& input) const;
+  bool use_direct(const at::Tensor& input, const at::Tensor& weight) const;
   bool is_depthwise(const at::Tensor& input, const at::Tensor& weight) const;
 };
 
@@ -182,6 +186,61 @@ auto ConvParams::use_nnpack(const at::Tensor& input) const -> bool {
   return false;
 }
 
+// The native CPU kernels take contiguous 4D float or double tensors.
+static bool is_native_cpu_conv(const ConvParams& params, const at::Tensor& input, const at::Tensor& weight) {
+  return input.type().backend() == at::Backend::CPU &&
+         (input.scalar_type() == kFloat || input.scalar_type() == kDouble) &&
+         weight.scalar_type() == input.scalar_type() &&
+         weight.layout() == kStrided &&
+         !params.transposed &&
+         input.ndimension() == 4 &&
+         weight.ndimension() == 4;
+}
+
+auto ConvParams::use_winograd(const at::Tensor& input, const at::Tensor& weight) const -> bool {
+  if (!is_native_cpu_conv(*this, input, weight) ||
+      groups != 1 ||
+      weight.size(2) != 3 || weight.size(3) != 3 ||
+      is_strided() || is_dilated()) {
+    return false;
+  }
+  switch (cpu_conv_algorithm.load()) {
+    case CpuConvAlgorithm::Winograd:
+      return true;
+    case CpuConvAlgorithm::Auto:
+      // the transforms are amortized over the channels, and the tiles waste
+      // little on the borders of large enough images
+      return !use_mkldnn(input) && !use_nnpack(input) &&
+             input.size(1) >= 16 && weight.size(0) >= 16 &&
+             input.size(2) >= 8 && input.size(3) >= 8;
+    default:
+      return false;
+  }
+}
+
+// F(4x4, 3x3) does 4x fewer multiplications than the direct convolution
+// against 2.25x for F(2x2, 3x3), but its transforms are less accurate and
+// waste more on small images.
+auto ConvParams::winograd_output_tile(const at::Tensor& input) const -> int64_t {
+  return (input.scalar_type() == kFloat && input.size(2) >= 16 && input.size(3) >= 16) ? 4 : 2;
+}
+
+auto ConvParams::use_direct(const at::Tensor& input, const at::Tensor& weight) const -> bool {
+  if (!is_native_cpu_conv(*this, input, weight)) {
+    return false;
+  }
+  switch (cpu_conv_algorithm.load()) {
+    case CpuConvAlgorithm::Direct:
+      return true;
+    case CpuConvAlgorithm::Auto:
+      // depthwise and other convolutions with few channels per group spend
+      // more on the column buffer of im2col than on the GEMM
+      return !use_mkldnn(input) && weight.size(1) <= 4 && weight.size(1) * groups == input.size(1);
+    default:
+      return false;
+  }
+}
+
 // We currently only have depthwise support for the case where groups ==
 // nInputPlane and nInputPlane == nOutputPlane (the latter due to the lack of
 // a depthwise multiplier)
@@ -598,6 +657,12 @@ at::Tensor _convolution(
           input, weight, bias,
           params.padding, params.stride, params.dilation, params.groups, params.benchmark, params.deterministic);
     }
+  } else if (params.use_winograd(input, weight)) {
+    output = at::_winograd_convolution2d(
+        input, weight, bias, params.padding, params.winograd_output_tile(input));
+  } else if (params.use_direct(input, weight)) {
+    output = at::_direct_convolution2d(
+        input, weight, bias, params.stride, params.padding, params.dilation, params.groups);
   } else if (params.use_mkldnn(input)) {
 #if AT_MKLDNN_ENABLED()
     TORCH_CHECK(input.type() == weight.type(),
@@ -14,5 +14,13 @@ namespace native {
 // where there are bugs.
 extern CAFFE2_API std::atomic<bool> disable_mkldnn_conv;
 
+// The algorithm of 2D CPU convolutions. Auto picks one from the shapes, see
+// ConvParams::use_winograd and ConvParams::use_direct. Gemm keeps to MKLDNN,
+// NNPACK and im2col + GEMM, and Winograd and Direct are used for every
+// convolution they support.
+enum class CpuConvAlgorithm { Auto, Gemm, Winograd, Direct };
+
+extern CAFFE2_API std::atomic<CpuConvAlgorithm> cpu_conv_algorithm;
+
 }  // namespace at
 }  // namespace native
@@ -0,0 +1,88 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/DirectConvolution.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(direct_conv2d_stub);
+
+Tensor direct_convolution2d_cpu(
+    const Tensor& self,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  TORCH_CHECK(self.dim() == 4, "_direct_convolution2d: expected 4D input, but got ", self.dim(), "D tensor");
+  TORCH_CHECK(weight.dim() == 4, "_direct_convolution2d: expected 4D weight, but got ", weight.dim(), "D tensor");
+  TORCH_CHECK(stride.size() == 2 && padding.size() == 2 && dilation.size() == 2,
+      "_direct_convolution2d: expected stride, padding and dilation of length 2");
+  TORCH_CHECK(stride[0] > 0 && stride[1] > 0 && dilation[0] > 0 && dilation[1] > 0,
+      "_direct_convolution2d: expected positive stride and dilation, but got ", stride, " and ", dilation);
+  TORCH_CHECK(padding[0] >= 0 && padding[1] >= 0,
+      "_direct_convolution2d: expected non-negative padding, but got ", padding);
+  TORCH_CHECK(groups > 0 && weight.size(0) % groups == 0 && weight.size(1) * groups == self.size(1),
+      "_direct_convolution2d: expected input with ", weight.size(1) * groups, " channels and ",
+      "a number of output channels divisible by ", groups, " groups, but got input of size ",
+      self.sizes(), " and weight of size ", weight.sizes());
+  TORCH_CHECK(self.scalar_type() == weight.scalar_type() &&
+      (!bias.defined() || bias.scalar_type() == self.scalar_type()),
+      "_direct_convolution2d: expected input, weight and bias to have the same dtype");
+  TORCH_CHECK(!bias.defined() || (bias.dim() == 1 && bias.size(0) == weight.size(0)),
+      "_direct_convolution2d: expected bias of size ", weight.size(0), ", but got ", bias.sizes());
+
+  const int64_t output_height =
+      (self.size(2) + 2 * padding[0] - dilation[0] * (weight.size(2) - 1) - 1) / stride[0] + 1;
+  const int64_t output_width =
+      (self.size(3) + 2 * padding[1] - dilation[1] * (weight.size(3) - 1) - 1) / stride[1] + 1;
+  TORCH_CHECK(output_height > 0 && output_width > 0,
+      "_direct_convolution2d: input of size ", self.sizes(), " is smaller than the kernel");
+
+  Tensor output = at::empty({self.size(0), weight.size(0), output_height, output_width}, self.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+  direct_conv2d_stub(
+      kCPU, output, self.contiguous(), weight.contiguous(),
+      bias.defined() ? bias.contiguous() : bias, stride, padding, dilation, groups);
+  return output;
+}
+
+// The gradients of every group are computed by the dilated convolution, which
+// has no groups.
+std::tuple<Tensor, Tensor, Tensor> _direct_convolution2d_backward(
+    const Tensor& grad_output,
+    const Tensor& self,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups,
+    std::array<bool, 3> output_mask) {
+  auto kernel_size = weight.sizes().slice(2);
+  if (groups == 1) {
+    return at::slow_conv_dilated2d_backward(
+        grad_output, self, weight, kernel_size, stride, padding, dilation, output_mask);
+  }
+  const int64_t channels = self.size(1) / groups;
+  const int64_t outputs = weight.size(0) / groups;
+  std::vector<Tensor> grad_inputs, grad_weights, grad_biases;
+  for (int64_t g = 0; g < groups; g++) {
+    Tensor grad_input, grad_weight, grad_bias;
+    std::tie(grad_input, grad_weight, grad_bias) = at::slow_conv_dilated2d_backward(
+        grad_output.narrow(1, g * outputs, outputs),
+        self.narrow(1, g * channels, channels),
+        weight.narrow(0, g * outputs, outputs),
+        kernel_size, stride, padding, dilation, output_mask);
+    grad_inputs.push_back(grad_input);
+    grad_weights.push_back(grad_weight);
+    grad_biases.push_back(grad_bias);
+  }
+  return std::make_tuple(
+      output_mask[0] ? at::cat(grad_inputs, 1) : Tensor(),
+      output_mask[1] ? at::cat(grad_weights, 0) : Tensor(),
+      output_mask[2] ? at::cat(grad_biases, 0) : Tensor());
+}
+
+}} // namespace at::native
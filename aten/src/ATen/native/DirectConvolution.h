@@ -0,0 +1,23 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// output = conv2d(input, weight, bias, stride, padding, dilation, groups)
+// computed directly, without a column buffer. `output` is allocated with the
+// output size, `bias` may be undefined.
+using direct_conv2d_fn = void(*)(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups);
+
+DECLARE_DISPATCH(direct_conv2d_fn, direct_conv2d_stub);
+
+}} // at::native
@@ -3,12 +3,14 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/native/Distance.h>
+#include <ATen/core/grad_mode.h>
 
 namespace at { namespace native {
 
 DEFINE_DISPATCH(pdist_forward_stub);
 DEFINE_DISPATCH(pdist_backward_stub);
 DEFINE_DISPATCH(cdist_stub);
+DEFINE_DISPATCH(cdist_topk_stub);
 DEFINE_DISPATCH(cdist_backward_stub);
 
 Tensor pairwise_distance(const Tensor& x1, const Tensor& x2, double p, double eps, bool keepdim) {
@@ -24,22 +26,29 @@ Tensor pdist(const Tensor& self, const double p) {
   return at::_pdist_forward(self.contiguous(), p);
 }
 
-Tensor cdist(const Tensor& x1, const Tensor& x2, const double p) {
-  TORCH_CHECK(x1.dim() >= 2, "cdist only supports at least 2D tensors, X1 got: ", x1.dim(), "D");
-  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "cdist only supports floating-point dtypes, X1 got: ", x1.scalar_type());
+static void check_cdist_inputs(const Tensor& x1, const Tensor& x2, const double p, const char* name) {
+  TORCH_CHECK(x1.dim() >= 2, name, " only supports at least 2D tensors, X1 got: ", x1.dim(), "D");
+  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), name, " only supports floating-point dtypes, X1 got: ", x1.scalar_type());
   auto device1 = x1.type().device_type();
-  TORCH_CHECK(device1 == kCPU || device1 == kCUDA, "cdist only supports CPU and CUDA devices, X1 got: ", device1);
-  TORCH_CHECK(x2.dim() >= 2, "cdist only supports at least 2D tensors, X2 got: ", x2.dim(), "D");
-  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), "cdist only supports floating-point dtypes, X2 got: ", x2.scalar_type());
+  TORCH_CHECK(device1 == kCPU || device1 == kCUDA, name, " only supports CPU and CUDA devices, X1 got: ", device1);
+  TORCH_CHECK(x2.dim() >= 2, name, " only supports at least 2D tensors, X2 got: ", x2.dim(), "D");
+  TORCH_CHECK(at::isFloatingType(x1.scalar_type()), name, " only supports floating-point dtypes, X2 got: ", x2.scalar_type());
   auto device2 = x2.type().device_type();
-  TORCH_CHECK(device2 == kCPU || device2 == kCUDA, "cdist only supports CPU and CUDA devices, X2 got: ", device2);
-  TORCH_CHECK(p >= 0, "cdist only supports non-negative p values");
+  TORCH_CHECK(device2 == kCPU || device2 == kCUDA, name, " only supports CPU and CUDA devices, X2 got: ", device2);
+  TORCH_CHECK(p >= 0, name, " only supports non-negative p values");
   TORCH_CHECK(device1 == device2, "X1 and X2 must have the same device type. X1: ", device1, " X2: ", device2);
   TORCH_CHECK(!x1.is_cuda() || x1.get_device() == x2.get_device(), "device of X1 (", x1.get_device(), ") must match device of X2 (", x2.get_device(), ")");
   int64_t c1 = x1.size(-1);
   int64_t c2 = x2.size(-1);
   TORCH_CHECK(c1 == c2, "X1 and X2 must have the same number of columns. X1: ", c1, " X2: ", c2);
+}
 
+// Broadcasts the batch dimensions of x1 and x2 and returns them with the
+// batch flattened, as contiguous [batch, r1, c] and [batch, r2, c] tensors,
+// together with the broadcast batch dimensions.
+static std::tuple<Tensor, Tensor, std::vector<int64_t>> cdist_expand_batch(const Tensor& x1, const Tensor& x2) {
+  int64_t c1 = x1.size(-1);
+  int64_t c2 = x2.size(-1);
   int64_t r1 = x1.size(-2);
   int64_t r2 = x2.size(-2);
   auto dim1 = x1.dim();
@@ -61,6 +70,18 @@ Tensor cdist(const Tensor& x1, const Tensor& x2, const double p) {
 
   Tensor tensor1_expanded = x1.expand(tensor1_expand_size).contiguous().view(tensor1_view);
   Tensor tensor2_expanded = x2.expand(tensor2_expand_size).contiguous().view(tensor2_view);
+  return std::make_tuple(tensor1_expanded, tensor2_expanded, expand_batch_portion);
+}
+
+Tensor cdist(const Tensor& x1, const Tensor& x2, const double p) {
+  check_cdist_inputs(x1, x2, p, "cdist");
+  int64_t c1 = x1.size(-1);
+  int64_t r1 = x1.size(-2);
+  int64_t r2 = x2.size(-2);
+
+  Tensor tensor1_expanded, tensor2_expanded;
+  std::vector<int64_t> expand_batch_portion;
+  std::tie(tensor1_expanded, tensor2_expanded, expand_batch_portion) = cdist_expand_batch(x1, x2);
 
   std::vector<int64_t> output_shape(expand_batch_portion);
   output_shape.insert(output_shape.end(), {r1, r2});
@@ -69,12 +90,48 @@ Tensor cdist(const Tensor& x1, const Tensor& x2, const double p) {
     if (c1 == 0) {
       result.fill_(0);
     } else {
-      cdist_stub(device1, result, tensor1_expanded, tensor2_expanded, p);
+      cdist_stub(x1.type().device_type(), result, tensor1_expanded, tensor2_expanded, p);
     }
   }
   return result;
 }
 
+// The k nearest rows of x2 for every row of x1 and their distances, nearest
+// first. On the CPU the two norm never materializes the [r1, r2] matrix of
+// distances, see DistanceOpsKernel.cpp. The distances to the neighbours are
+// computed again from their rows, which keeps them exact and differentiable.
+std::tuple<Tensor, Tensor> cdist_topk(const Tensor& x1, const Tensor& x2, int64_t k, const double p) {
+  check_cdist_inputs(x1, x2, p, "cdist_topk");
+  int64_t c1 = x1.size(-1);
+  int64_t r1 = x1.size(-2);
+  int64_t r2 = x2.size(-2);
+  TORCH_CHECK(k >= 0 && k <= r2, "cdist_topk: k (", k, ") must be between 0 and the number of rows of X2 (", r2, ")");
+
+  Tensor tensor1_expanded, tensor2_expanded;
+  std::vector<int64_t> expand_batch_portion;
+  std::tie(tensor1_expanded, tensor2_expanded, expand_batch_portion) = cdist_expand_batch(x1, x2);
+  const int64_t batch = tensor1_expanded.size(0);
+
+  Tensor indices;
+  if (x1.type().device_type() == kCPU && p == 2 && c1 > 0 && r1 > 0 && k > 0) {
+    indices = at::empty({batch, r1, k}, x1.options().dtype(kLong));
+    cdist_topk_stub(kCPU, indices, tensor1_expanded, tensor2_expanded, k);
+  } else {
+    at::NoGradGuard no_grad;
+    indices = std::get<1>(at::cdist(tensor1_expanded, tensor2_expanded, p).topk(k, -1, /*largest=*/false));
+  }
+
+  Tensor offsets = at::arange(batch, indices.options()).mul_(r2).view({batch, 1, 1});
+  Tensor neighbours = tensor2_expanded.reshape({batch * r2, c1})
+      .index_select(0, (indices + offsets).view(-1))
+      .view({batch, r1, k, c1});
+  Tensor values = at::norm(tensor1_expanded.unsqueeze(2) - neighbours, p, -1);
+
+  std::vector<int64_t> output_shape(expand_batch_portion);
+  output_shape.insert(output_shape.end(), {r1, k});
+  return std::make_tuple(values.view(output_shape), indices.view(output_shape));
+}
+
 Tensor _cdist_backward(const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& cdist) {
   TORCH_CHECK(x1.is_contiguous(), "_cdist_backward requires X1 to be contiguous");
   TORCH_CHECK(x2.is_contiguous(), "_cdist_backward requires X2 to be contiguous");
@@ -8,11 +8,14 @@ namespace at { namespace native {
 using pdist_forward_fn = void(*)(Tensor&, const Tensor&, const double p);
 using pdist_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const double p, const Tensor&);
 using cdist_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const double p);
+// The indices of the k nearest rows of x2 for every row of x1, by the two norm
+using cdist_topk_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const int64_t k);
 using cdist_backward_fn = void(*)(Tensor&, const Tensor&, const Tensor&, const Tensor&, const double p, const Tensor&);
 
 DECLARE_DISPATCH(pdist_forward_fn, pdist_forward_stub);
 DECLARE_DISPATCH(pdist_backward_fn, pdist_backward_stub);
 DECLARE_DISPATCH(cdist_fn, cdist_stub);
+DECLARE_DISPATCH(cdist_topk_fn, cdist_topk_stub);
 DECLARE_DISPATCH(cdist_backward_fn, cdist_backward_stub);
 
 }} // namespace at::native
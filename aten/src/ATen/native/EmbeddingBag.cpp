@@ -33,14 +33,6 @@ static void make_offset2bag(const Tensor &offsets, const Tensor &indices, Tensor
 
 namespace {
 
-bool isFastPathIndexSelect(const Tensor& src, Tensor& output) {
-  return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1;
-}
-
-bool isFastPathIndexSelectScale(const Tensor& src, const Tensor& scale, Tensor& output) {
-  return src.scalar_type() == kFloat && src.stride(1) == 1 && output.stride(1) == 1 && scale.stride(0) == 1;
-}
-
 // This function combines index_select (using select_indices as the index) and
 // index_add (using add_indices as the index), without creating an intermediary
 // tensor to hold the selected embeddings
@@ -69,47 +61,6 @@ void index_select_add(const Tensor &select_indices,
   }
 }
 
-template<>
-void index_select_add<float>(const Tensor &select_indices,
-                             const Tensor &add_indices,
-                             const Tensor &src,
-                             Tensor &output,
-                             const Tensor& offsets) {
-  int64_t ddim = src.size(1);
-  auto src_data = src.data_ptr<float>();
-  auto select_indices_data = select_indices.data_ptr<int64_t>();
-  auto output_data = output.data_ptr<float>();
-
-  if (isFastPathIndexSelect(src, output)) {
-    caffe2::EmbeddingLookupIdx(
-      /*block_size=*/ddim,
-      /*output_size=*/offsets.numel(),
-      /*index_size=*/select_indices.numel(),
-      /*data_size=*/src.size(0),
-      /*input=*/src_data,
-      /*indices=*/select_indices_data,
-      /*offsets=*/offsets.data<int64_t>(),
-      /*weights=*/nullptr,
-      /*scale_bias=*/nullptr,
-      /*normalize_by_lengths=*/false,
-      /*out=*/output_data
-    );
-  } else {
-    AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto add_indices_data = add_indices.data_ptr<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto numel = add_indices.numel();
-    for (int64_t i = 0; i < numel; i++) {
-      THBlas_axpy<float>(ddim, 1,
-              src_data + src_stride0 * select_indices_data[i], src_stride1,
-              output_data + output_stride0 * add_indices_data[i], output_stride1);
-    }
-  }
-}
-
 // This function fuses the following three fns:
 // index_select (using select_indices as the index)
 // mul (scaling by per_sample_weights)
@@ -146,53 +97,97 @@ static void index_select_scale_add(const Tensor &select_indices,
   }
 }
 
-template<>
-void index_select_scale_add<float>(const Tensor &select_indices,
-                                          const Tensor &add_indices,
-                                          const Tensor &scale,
-                                          const Tensor &src,
-                                          Tensor &output,
-                                          const Tensor& offsets) {
-  int64_t ddim = src.size(1);
-  auto* scale_data = scale.data_ptr<float>();
-  auto select_indices_data = select_indices.data_ptr<int64_t>();
-  auto src_data = src.data_ptr<float>();
-  auto output_data = output.data_ptr<float>();
+// Fast path of the sum and mean modes for float weights with contiguous rows.
+// The bags are split into chunks reduced in parallel by the caffe2
+// perfkernels, which prefetch the rows of the next indices. The perfkernels
+// overwrite every output row and divide the mean bags by their length, so the
+// output does not need to be zeroed and neither offset2bag nor apply_bag_size
+// are needed.
+bool isFastPathEmbeddingBag(
+    const Tensor& weight,
+    const Tensor& per_sample_weights,
+    const int64_t mode) {
+  return (mode == MODE_SUM || mode == MODE_MEAN) &&
+      weight.scalar_type() == kFloat && weight.is_contiguous() &&
+      (!per_sample_weights.defined() || per_sample_weights.is_contiguous());
+}
 
-  if (isFastPathIndexSelectScale(src, scale, output)) {
-    caffe2::EmbeddingLookupIdx(
-      /*block_size=*/ddim,
-      /*output_size=*/offsets.numel(),
-      /*index_size=*/select_indices.numel(),
-      /*data_size=*/src.size(0),
-      /*input=*/src_data,
-      /*indices=*/select_indices_data,
-      /*offsets=*/offsets.data<int64_t>(),
-      /*weights=*/scale_data,
-      /*scale_bias=*/nullptr,
-      /*normalize_by_lengths=*/false,
-      /*out=*/output_data
-    );
-  } else {
-    AT_ASSERT(select_indices.numel() == add_indices.numel());
-    auto add_indices_data = add_indices.data_ptr<int64_t>();
-    auto src_stride0 = src.stride(0);
-    auto src_stride1 = src.stride(1);
-    auto output_stride0 = output.stride(0);
-    auto output_stride1 = output.stride(1);
-    auto scale_stride = scale.stride(0);
-    auto numel = add_indices.numel();
-
-
-    for (int64_t i = 0; i < numel; i++) {
-      auto* src_base = src_data + src_stride0 * select_indices_data[i];
-      auto* output_base = output_data + output_stride0 * add_indices_data[i];
-      auto scale = scale_data[i * scale_stride];
-      for (int64_t j = 0; j < ddim; j++) {
-        output_base[j * output_stride1] += src_base[j * src_stride1] * scale;
+void embedding_bag_cpu_fast_path(
+    const Tensor& weight,
+    const Tensor& indices,
+    const Tensor& offsets,
+    const Tensor& per_sample_weights,
+    const int64_t mode,
+    Tensor& output,
+    Tensor& bag_size) {
+  const int64_t num_bags = offsets.numel();
+  const int64_t num_indices = indices.numel();
+  const int64_t num_embeddings = weight.size(0);
+  const int64_t ddim = weight.size(1);
+  const auto* offsets_data = offsets.data_ptr<int64_t>();
+  const auto* indices_data = indices.data_ptr<int64_t>();
+  const auto* weight_data = weight.data_ptr<float>();
+  const auto* scale_data = per_sample_weights.defined()
+      ? per_sample_weights.data_ptr<float>()
+      : nullptr;
+  auto* output_data = output.data_ptr<float>();
+  // bag_size is only needed by the backward of the mean mode
+  auto* bag_size_data =
+      mode == MODE_MEAN ? bag_size.data_ptr<int64_t>() : nullptr;
+
+  TORCH_CHECK(
+      num_bags == 0 || offsets_data[0] == 0,
+      "embedding_bag: the first offset is expected to be 0, got ",
+      num_bags == 0 ? 0 : offsets_data[0]);
+
+  // Enough bags per task for every task to load about GRAIN_SIZE values
+  const int64_t values_per_bag =
+      std::max<int64_t>(num_indices / std::max<int64_t>(num_bags, 1), 1) *
+      ddim;
+  const int64_t grain_size =
+      std::max<int64_t>(at::internal::GRAIN_SIZE / values_per_bag, 1);
+  at::parallel_for(0, num_bags, grain_size, [&](int64_t begin, int64_t end) {
+    // The perfkernels expect the offsets of the chunk to start at 0
+    const int64_t first_index = offsets_data[begin];
+    const int64_t last_index = end < num_bags ? offsets_data[end] : num_indices;
+    std::vector<int64_t> chunk_offsets(end - begin);
+    for (int64_t bag = begin; bag < end; ++bag) {
+      const int64_t bag_end =
+          bag + 1 < num_bags ? offsets_data[bag + 1] : num_indices;
+      TORCH_CHECK(
+          0 <= offsets_data[bag] && offsets_data[bag] <= bag_end &&
+              bag_end <= num_indices,
+          "embedding_bag: offsets must be non-decreasing and within the "
+          "range of indices");
+      chunk_offsets[bag - begin] = offsets_data[bag] - first_index;
+      if (bag_size_data) {
+        bag_size_data[bag] = bag_end - offsets_data[bag];
       }
     }
-  }
+    // The perfkernel checks the indices as well, but reports a bad one as a
+    // generic enforce failure
+    for (int64_t i = first_index; i < last_index; ++i) {
+      TORCH_CHECK_INDEX(
+          0 <= indices_data[i] && indices_data[i] < num_embeddings,
+          "embedding_bag: index ",
+          indices_data[i],
+          " is out of range for ",
+          num_embeddings,
+          " embeddings");
+    }
+    caffe2::EmbeddingLookupIdx(
+        /*block_size=*/ddim,
+        /*output_size=*/end - begin,
+        /*index_size=*/last_index - first_index,
+        /*data_size=*/num_embeddings,
+        /*input=*/weight_data,
+        /*indices=*/indices_data + first_index,
+        /*offsets=*/chunk_offsets.data(),
+        /*weights=*/scale_data ? scale_data + first_index : nullptr,
+        /*scale_bias=*/nullptr,
+        /*normalize_by_lengths=*/mode == MODE_MEAN,
+        /*out=*/output_data + begin * ddim);
+  });
 }
 
 }  // namespace
@@ -330,37 +325,35 @@ _embedding_bag_cpu(const Tensor &weight, const Tensor &indices,
   }
 
   auto bag_size = at::zeros(offsets.sizes(), indices.options());
-  make_bag_size(offsets, indices, mode, bag_size);
-
-  auto output = at::zeros({offsets.size(0), weight.size(1)}, weight.options());
-
-  // To save compute, if we are going to go down the fast path case for the 'sum'
-  // mode, we skip calculating offset2bag, since it is not going to be used.
-  auto fast_path_sum = [&weight, &per_sample_weights, &output]() {
-    if (per_sample_weights.defined()) {
-      return isFastPathIndexSelectScale(weight, per_sample_weights, output);
-    } else {
-      return isFastPathIndexSelect(weight, output);
-    }
-  };
 
   // Use an empty 0-element tensor as a sentinel that we have skipped the
   // creation of offset2bag because autograd chokes when trying to use an
   // undefined tensor as an input to a backward op.
   Tensor offset2bag = at::empty({0}, offsets.options());
-  if (mode == MODE_MEAN || mode == MODE_MAX || !fast_path_sum()) {
-    // If the last entries are empty, that the last offsets are irrelevant as they
-    // won't change anything in the assignment of ID -> bag, but index_add would
-    // throw out of bounds error. So to keep it simple we just add one more
-    // entry to the end then get rid of it after make_offset2bag.
-    offset2bag = at::zeros(
-       {indices.sizes()[0] + 1}, indices.options()); // offset2bag = [0 0 0 0 0]
-
-    make_offset2bag(offsets, indices, offset2bag);
 
-    offset2bag.resize_({indices.sizes()[0]});
+  if (isFastPathEmbeddingBag(weight, per_sample_weights, mode)) {
+    auto output = at::empty({offsets.size(0), weight.size(1)}, weight.options());
+    embedding_bag_cpu_fast_path(
+        weight, indices, offsets, per_sample_weights, mode, output, bag_size);
+    return std::tuple<Tensor, Tensor, Tensor, Tensor>(
+        output, offset2bag, bag_size, bag_size);
   }
 
+  make_bag_size(offsets, indices, mode, bag_size);
+
+  auto output = at::zeros({offsets.size(0), weight.size(1)}, weight.options());
+
+  // If the last entries are empty, that the last offsets are irrelevant as they
+  // won't change anything in the assignment of ID -> bag, but index_add would
+  // throw out of bounds error. So to keep it simple we just add one more
+  // entry to the end then get rid of it after make_offset2bag.
+  offset2bag = at::zeros(
+     {indices.sizes()[0] + 1}, indices.options()); // offset2bag = [0 0 0 0 0]
+
+  make_offset2bag(offsets, indices, offset2bag);
+
+  offset2bag.resize_({indices.sizes()[0]});
+
   if (mode == MODE_MEAN || mode == MODE_SUM) {
     AT_DISPATCH_FLOATING_TYPES(weight.scalar_type(), "embedding_bag_cpu", [&]() {
       if (per_sample_weights.defined()) {
@@ -67,6 +67,7 @@ DEFINE_DISPATCH(index_stub);
 DEFINE_DISPATCH(index_put_stub);
 DEFINE_DISPATCH(index_put_accum_stub);
 REGISTER_NO_CPU_DISPATCH(index_put_accum_stub, index_put_accum_fn);
+DEFINE_DISPATCH(scatter_add_stub);
 
 static bool all_strides_match(TensorList tensors) {
   AT_ASSERT(tensors.size() >= 1);
@@ -333,6 +334,34 @@ Tensor scatter(const Tensor & self, int64_t dim, const Tensor & index, Scalar so
   return self.clone().scatter_(dim, index, source);
 }
 
+Tensor & scatter_add_cpu_(Tensor & self, int64_t dim, const Tensor & index, const Tensor & src) {
+  dim = maybe_wrap_dim(dim, self.dim());
+  TORCH_CHECK(index.scalar_type() == ScalarType::Long,
+              "scatter_add_(): Expected dtype int64 for index, but got ", index.scalar_type());
+  TORCH_CHECK(src.scalar_type() == self.scalar_type(),
+              "scatter_add_(): Expected src to have the same dtype as self, but got ",
+              src.scalar_type(), " and ", self.scalar_type());
+  // no-op if index is empty
+  if (index.numel() == 0) {
+    return self;
+  }
+  // like TH, scalars are treated as tensors with one element
+  auto as_1d = [](const Tensor& t) { return t.dim() == 0 ? t.view({1}) : t; };
+  Tensor self_ = as_1d(self);
+  Tensor index_ = as_1d(index);
+  Tensor src_ = as_1d(src);
+  TORCH_CHECK(index_.dim() == self_.dim(), "Index tensor must have same dimensions as output tensor");
+  TORCH_CHECK(src_.dim() == self_.dim(), "Input tensor must have same dimensions as output tensor");
+  for (int64_t d = 0; d < self_.dim(); d++) {
+    TORCH_CHECK(
+        index_.size(d) <= src_.size(d) && (d == dim || index_.size(d) <= self_.size(d)),
+        "Expected index ", index_.sizes(), " to be smaller size than src ", src_.sizes(),
+        " and to be smaller than self ", self_.sizes(), " apart from dimension ", dim);
+  }
+  scatter_add_stub(kCPU, self_, dim, index_, src_);
+  return self;
+}
+
 Tensor scatter_add(const Tensor & self, int64_t dim, const Tensor & index, const Tensor & source) {
   return self.clone().scatter_add_(dim, index, source);
 }
@@ -48,6 +48,10 @@ Tensor& addmm_out(Tensor& result, const Tensor& self, const Tensor& mat1, const
     Tensor b_self;
     std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
     return s_native_addmm_out(result, b_self, mat1, mat2, beta, alpha);
+  } else if (mat1.is_sparse_csr()) {
+    Tensor b_self;
+    std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm_out");
+    return at::_sparse_csr_addmm_out(result, b_self, mat1, mat2, beta, alpha);
   } else {
     return at::_addmm_out(result, self, mat1, mat2, beta, alpha);
   }
@@ -60,6 +64,10 @@ Tensor addmm(const Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar
     Tensor b_self;
     std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm");
     return s_native_addmm(b_self, mat1, mat2, beta, alpha);
+  } else if (mat1.is_sparse_csr()) {
+    Tensor b_self;
+    std::tie(b_self) = expand_size(self, {mat1.size(0), mat2.size(1)}, "addmm");
+    return at::_sparse_csr_addmm(b_self, mat1, mat2, beta, alpha);
   } else {
     return at::_addmm(self, mat1, mat2, beta, alpha);
   }
@@ -71,6 +79,9 @@ Tensor& addmm_(Tensor& self, const Tensor& mat1, const Tensor& mat2, Scalar beta
   if (mat1_sparse) {
     // inplace is not broadcasting
     return s_native_addmm_(self, mat1, mat2, beta, alpha);
+  } else if (mat1.is_sparse_csr()) {
+    // inplace is not broadcasting
+    return at::_sparse_csr_addmm_out(self, self, mat1, mat2, beta, alpha);
   } else {
     return at::_addmm_(self, mat1, mat2, beta, alpha);
   }
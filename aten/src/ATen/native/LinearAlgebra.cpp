@@ -2,6 +2,7 @@
 #include <ATen/ExpandUtils.h>
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/native/BatchLinearAlgebra.h>
 #include <ATen/native/LinearAlgebraUtils.h>
 #include <ATen/TensorUtils.h>
 #include <ATen/Parallel.h>
@@ -33,6 +34,13 @@ Tensor det(const Tensor& self) {
   squareCheckInputs(self);
   TORCH_CHECK(at::isFloatingType(self.scalar_type()), "Expected a floating point tensor as input");
 
+  auto n = self.size(-1);
+  if (use_small_matrix_kernels(self, n, batchCount(self))) {
+    auto result = at::empty(self.sizes().slice(0, self.dim() - 2), self.options());
+    small_det_stub(kCPU, result, self.reshape({-1, n, n}));
+    return result;
+  }
+
   Tensor det_P, diag_U;
   std::tie(det_P, diag_U) = _lu_det_P_diag_U(self);
   // complete_det is 0 when U is singular (U(i, i) = 0 for some i in [1, self.size(-1)]).
@@ -187,6 +195,8 @@ inline void baddbmm_cpu_kernel(const Tensor& result, const Tensor& self, const T
 }
 
 // This tries to apply some optimizations to bmm/baddbmm:
+// - When batch1 holds small square matrices, the fixed-size kernels of
+//   cpu/BatchLinearAlgebraKernel.cpp multiply Vec256::size() of them at once.
 // - When the operand size is small, computation are parallelized over the batch
 //   dimension using OMP and naive matrix multiplication is applied.
 // - When the operand size is larger than the threshold, if compiled with MKL, MKL's batch gemm is used.
@@ -233,7 +243,12 @@ static inline Tensor& bmm_out_or_baddbmm_(Tensor& self_or_result, const Tensor&
             || (t.stride(1) == 1 && t.stride(2) >= t.size(1));
   };
 
-  if (contraction_size * res_rows * res_cols < 400) {
+  if (res_rows == contraction_size && res_cols <= kSmallMatrixMaxSize
+      && use_small_matrix_kernels(self_or_result, contraction_size, bs)
+      && self_or_result.scalar_type() == batch1.scalar_type()
+      && self_or_result.scalar_type() == batch2.scalar_type()) {
+    small_baddbmm_stub(kCPU, self_or_result, batch1, batch2, beta, alpha, is_bmm_out);
+  } else if (contraction_size * res_rows * res_cols < 400) {
     if (is_bmm_out) {
       AT_DISPATCH_ALL_TYPES(batch1.scalar_type(), "bmm", [&] {
           baddbmm_cpu_kernel<scalar_t, true>(self_or_result, batch1, batch2, beta, alpha);
@@ -7,6 +7,10 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/Dispatch.h>
 #include <ATen/CPUApplyUtils.h>
+#include <ATen/native/Loss.h>
+#include <ATen/native/cpu/SoftmaxKernel.h>
+
+#include <limits>
 
 #define EPSILON 1e-12
 #define _USE_MATH_DEFINES
@@ -148,4 +152,89 @@ Tensor poisson_nll_loss(const Tensor& input, const Tensor& target, const bool lo
 
     return apply_loss_reduction(loss, reduction);
 }
+
+std::tuple<Tensor, Tensor> cross_entropy_row_weights(
+    const Tensor& self, const Tensor& target, const Tensor& weight, int64_t ignore_index) {
+  auto ignored = target.eq(ignore_index);
+  auto safe_target = target.masked_fill(ignored, 0).contiguous();
+  const int64_t n_classes = self.size(1);
+  TORCH_CHECK(safe_target.numel() == 0 ||
+      (safe_target.min().item<int64_t>() >= 0 && safe_target.max().item<int64_t>() < n_classes),
+      "cross_entropy: target out of bounds, expected values in [0, ", n_classes, ") or ignore_index");
+  auto valid = ignored.logical_not().to(self.scalar_type());
+  auto row_weights = weight.defined() ? weight.index_select(0, safe_target).mul_(valid) : valid;
+  return std::make_tuple(safe_target, row_weights.contiguous());
+}
+
+// log_softmax followed by nll_loss, without the [N, C] log probabilities:
+// the CPU kernels stream every row once for the loss and its logsumexp, and
+// once more for the gradient.
+Tensor cross_entropy_loss(const Tensor& self, const Tensor& target, const Tensor& weight, int64_t reduction, int64_t ignore_index) {
+  if (self.device().is_cpu() && self.layout() == kStrided && self.dim() == 2 &&
+      (self.scalar_type() == kFloat || self.scalar_type() == kDouble)) {
+    return std::get<0>(at::_cross_entropy_forward(self, target, weight, reduction, ignore_index));
+  }
+  return at::nll_loss(at::log_softmax(self, 1), target, weight, reduction, ignore_index);
+}
+
+std::tuple<Tensor, Tensor> cross_entropy_forward_cpu(
+    const Tensor& self, const Tensor& target, const Tensor& weight, int64_t reduction, int64_t ignore_index) {
+  TORCH_CHECK(self.dim() == 2, "cross_entropy: expected 2D input, got ", self.dim(), "D");
+  TORCH_CHECK(target.dim() == 1 && target.size(0) == self.size(0),
+      "cross_entropy: expected target of size [", self.size(0), "], got ", target.sizes());
+  TORCH_CHECK(target.scalar_type() == kLong,
+      "cross_entropy: expected target of scalar type Long, got ", target.scalar_type());
+  TORCH_CHECK(!weight.defined() || (weight.dim() == 1 && weight.size(0) == self.size(1)),
+      "cross_entropy: expected weight of size [", self.size(1), "], got ", weight.sizes());
+  TORCH_CHECK(!weight.defined() || weight.scalar_type() == self.scalar_type(),
+      "cross_entropy: expected weight of scalar type ", self.scalar_type(), ", got ", weight.scalar_type());
+
+  Tensor safe_target, row_weights;
+  std::tie(safe_target, row_weights) = cross_entropy_row_weights(self, target, weight, ignore_index);
+  auto logits = self.contiguous();
+  auto losses = at::empty({self.size(0)}, self.options());
+  auto logsumexp = at::empty({self.size(0)}, self.options());
+  if (logits.numel() > 0) {
+    cross_entropy_forward_kernel(kCPU, losses, logsumexp, logits, safe_target, row_weights);
+  } else {
+    losses.zero_();
+    logsumexp.fill_(-std::numeric_limits<double>::infinity());
+  }
+
+  // like nll_loss, the mean over no weight at all is 0
+  Tensor output;
+  if (reduction == Reduction::Mean) {
+    auto total_weight = row_weights.sum();
+    output = losses.sum();
+    if (total_weight.item<double>() != 0) {
+      output.div_(total_weight);
+    }
+  } else if (reduction == Reduction::Sum) {
+    output = losses.sum();
+  } else {
+    output = losses;
+  }
+  return std::make_tuple(output, logsumexp);
+}
+
+Tensor cross_entropy_backward_cpu(
+    const Tensor& grad_output, const Tensor& self, const Tensor& target, const Tensor& weight,
+    int64_t reduction, int64_t ignore_index, const Tensor& logsumexp) {
+  Tensor safe_target, row_weights;
+  std::tie(safe_target, row_weights) = cross_entropy_row_weights(self, target, weight, ignore_index);
+  Tensor row_scale = (row_weights * grad_output).contiguous();
+  if (reduction == Reduction::Mean) {
+    auto total_weight = row_weights.sum();
+    if (total_weight.item<double>() != 0) {
+      row_scale.div_(total_weight);
+    }
+  }
+  auto logits = self.contiguous();
+  auto grad_input = at::empty_like(logits);
+  if (logits.numel() > 0) {
+    cross_entropy_backward_kernel(kCPU, grad_input, row_scale, logits, safe_target, logsumexp.contiguous());
+  }
+  return grad_input;
+}
+
 }}  // namespace at::native
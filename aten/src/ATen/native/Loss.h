@@ -0,0 +1,15 @@
+#pragma once
+
+#include <ATen/ATen.h>
+
+namespace at {
+namespace native {
+
+// The weight of the class of every row of a cross entropy, 0 for the rows of
+// ignore_index, and the target with those rows pointing at class 0. Shared
+// with the double backward of cross entropy in autograd.
+CAFFE2_API std::tuple<Tensor, Tensor> cross_entropy_row_weights(
+    const Tensor& self, const Tensor& target, const Tensor& weight, int64_t ignore_index);
+
+}
+}
@@ -2,6 +2,7 @@
 
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
+#include <ATen/core/grad_mode.h>
 
 namespace at { namespace native {
 
@@ -16,6 +17,29 @@ bool use_miopen(const at::Tensor& input, const double dropout_state) {
     return is_miopen_acceptable;
 }
 
+// The fused CPU kernels of RNN.h run whole stacks without recording anything
+// for autograd, and without dropout between the layers.
+bool use_fused_cpu_rnn(const Tensor& input, TensorList hx, TensorList params, double dropout_p, bool train) {
+  if (!input.device().is_cpu() || input.layout() != kStrided ||
+      (input.scalar_type() != kFloat && input.scalar_type() != kDouble) ||
+      (train && dropout_p != 0)) {
+    return false;
+  }
+  const bool needs_grad = at::GradMode::is_enabled();
+  if (needs_grad && input.requires_grad()) {
+    return false;
+  }
+  for (const auto& tensors : {hx, params}) {
+    for (const auto& t : tensors) {
+      if (!t.defined() || t.scalar_type() != input.scalar_type() || t.layout() != kStrided ||
+          (needs_grad && t.requires_grad())) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
 template<typename T>
 using pair_of = std::pair<T, T>;
 
@@ -756,6 +780,7 @@ REGISTER_NO_CPU_DISPATCH(NAME##_cudnn_stub, rnn_fn);                           \
 REGISTER_NO_CPU_DISPATCH(NAME##_miopen_stub, rnn_fn);                          \
 REGISTER_NO_CPU_DISPATCH(NAME##_packed_cudnn_stub, rnn_packed_fn);             \
 REGISTER_NO_CPU_DISPATCH(NAME##_packed_miopen_stub, rnn_packed_fn);            \
+DEFINE_DISPATCH(NAME##_fused_cpu_stub);                                        \
                                                                                \
 std::tuple<Tensor, Tensor> NAME(                                               \
     const Tensor& _input, \
@@ -780,6 +805,12 @@ std::tuple<Tensor, Tensor> NAME(                                               \
     return std::make_tuple(output, hy);                                        \
   }                                                                            \
   check_device(_input, _params, hx);                                           \
+  if (use_fused_cpu_rnn(_input, hx, _params, dropout_p, train)) {              \
+    Tensor output, hy;                                                         \
+    NAME##_fused_cpu_stub(kCPU, output, hy, _input, hx, _params, has_biases,   \
+            num_layers, dropout_p, train, bidirectional, batch_first);         \
+    return std::make_tuple(output, hy);                                        \
+  }                                                                            \
   auto input = batch_first ? _input.transpose(0, 1) : _input;                  \
   auto params = gather_params(_params, has_biases);                            \
   auto results = _rnn_impl_with_concat<CELL, FullLayer, FullBidirectionalLayer>( \
@@ -887,6 +918,7 @@ REGISTER_NO_CPU_DISPATCH(lstm_cudnn_stub, lstm_fn);
 REGISTER_NO_CPU_DISPATCH(lstm_packed_cudnn_stub, lstm_packed_fn);
 REGISTER_NO_CPU_DISPATCH(lstm_miopen_stub, lstm_fn);
 REGISTER_NO_CPU_DISPATCH(lstm_packed_miopen_stub, lstm_packed_fn);
+DEFINE_DISPATCH(lstm_fused_cpu_stub);
 
 std::tuple<Tensor, Tensor, Tensor> lstm(
       const Tensor& _input, TensorList hx,
@@ -907,6 +939,12 @@ std::tuple<Tensor, Tensor, Tensor> lstm(
     return std::make_tuple(output, hy, cy);
   }
   check_device(_input, _params, hx);
+  if (use_fused_cpu_rnn(_input, hx, _params, dropout_p, train)) {
+    Tensor output, hy, cy;
+    lstm_fused_cpu_stub(kCPU, output, hy, cy, _input, hx, _params, has_biases,
+            num_layers, dropout_p, train, bidirectional, batch_first);
+    return std::make_tuple(output, hy, cy);
+  }
   auto input = batch_first ? _input.transpose(0, 1) : _input;
   auto params = gather_params(_params, has_biases);
   auto results = _lstm_impl<FullLayer, FullBidirectionalLayer>(
@@ -27,6 +27,13 @@ DECLARE_DISPATCH(rnn_packed_fn, rnn_tanh_packed_miopen_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_cudnn_stub);
 DECLARE_DISPATCH(rnn_packed_fn, rnn_relu_packed_miopen_stub);
 
+// Inference-only CPU kernels for whole stacks, see cpu/RNNKernel.cpp. They
+// ignore dropout_p and train.
+DECLARE_DISPATCH(lstm_fn, lstm_fused_cpu_stub);
+DECLARE_DISPATCH(rnn_fn, gru_fused_cpu_stub);
+DECLARE_DISPATCH(rnn_fn, rnn_tanh_fused_cpu_stub);
+DECLARE_DISPATCH(rnn_fn, rnn_relu_fused_cpu_stub);
+
 inline void check_device(const Tensor& input, const TensorList& params, const TensorList& hiddens) {
   auto input_device = input.device();
 
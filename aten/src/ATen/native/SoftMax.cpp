@@ -261,6 +261,8 @@ DEFINE_DISPATCH(softmax_lastdim_kernel);
 DEFINE_DISPATCH(log_softmax_lastdim_kernel);
 DEFINE_DISPATCH(softmax_backward_lastdim_kernel);
 DEFINE_DISPATCH(log_softmax_backward_lastdim_kernel);
+DEFINE_DISPATCH(cross_entropy_forward_kernel);
+DEFINE_DISPATCH(cross_entropy_backward_kernel);
 
 #ifdef BUILD_NAMEDTENSOR
 Tensor softmax(const Tensor& self, Dimname dim, optional<ScalarType> dtype) {
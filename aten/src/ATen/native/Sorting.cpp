@@ -202,6 +202,47 @@ std::tuple<Tensor, Tensor> topk(
   return std::make_tuple(values, indices);
 }
 
+std::tuple<Tensor&, Tensor&> sort_out_cpu(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim_,
+    bool descending) {
+  int64_t dim = maybe_wrap_dim(dim_, self.dim(), /*wrap_scalar=*/true);
+  TORCH_CHECK(
+      self.type() == values.type(),
+      "output values must be of same type as input");
+  TORCH_CHECK(
+      indices.dtype() == kLong, "output indices must be of scalar type Long");
+
+  // the kernel reads `self` while it writes the outputs
+  Tensor input = values.is_alias_of(self) || indices.is_alias_of(self) ? self.clone() : self;
+  values.resize_(self.sizes());
+  indices.resize_(self.sizes());
+  if (input.dim() == 0 && input.numel() == 1) {
+    values.copy_(input);
+    indices.zero_();
+    return std::forward_as_tuple(values, indices);
+  }
+  if (input.numel() == 0) {
+    return std::forward_as_tuple(values, indices);
+  }
+
+  sort_stub(kCPU, values, indices, input, dim, descending);
+
+  return std::forward_as_tuple(values, indices);
+}
+
+std::tuple<Tensor, Tensor> sort_cpu(
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  Tensor values = at::empty({0}, self.options());
+  Tensor indices = at::empty({0}, self.options().dtype(kLong));
+  sort_out_cpu(values, indices, self, dim, descending);
+  return std::make_tuple(values, indices);
+}
+
 std::tuple<Tensor&, Tensor&> median_out(
     Tensor& values,
     Tensor& indices,
@@ -250,6 +291,7 @@ Tensor median_cpu(const Tensor& self) {
   return result.view({});
 }
 
+DEFINE_DISPATCH(sort_stub);
 DEFINE_DISPATCH(topk_stub);
 
 } // namespace native
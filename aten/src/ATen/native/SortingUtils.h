@@ -1,8 +1,39 @@
 #pragma once
 
+#include <ATen/Parallel.h>
+
+#include <algorithm>
+
 namespace at {
 namespace native {
 
+// Sorts [first, last) by sorting `num_chunks` chunks in parallel and then
+// merging neighbouring chunks, the merges of every round run in parallel.
+template <typename RandomIt, typename Compare>
+void parallel_merge_sort(RandomIt first, RandomIt last, int64_t num_chunks, const Compare& comp) {
+  const int64_t n = last - first;
+  if (num_chunks <= 1 || n <= 1) {
+    std::sort(first, last, comp);
+    return;
+  }
+  const int64_t chunk_size = at::divup(n, num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      std::sort(first + std::min(n, c * chunk_size), first + std::min(n, (c + 1) * chunk_size), comp);
+    }
+  });
+  for (int64_t width = chunk_size; width < n; width *= 2) {
+    at::parallel_for(0, at::divup(n, 2 * width), 1, [&](int64_t begin, int64_t end) {
+      for (int64_t m = begin; m < end; m++) {
+        const int64_t lo = m * 2 * width;
+        const int64_t mid = std::min(n, lo + width);
+        const int64_t hi = std::min(n, lo + 2 * width);
+        std::inplace_merge(first + lo, first + mid, first + hi, comp);
+      }
+    });
+  }
+}
+
 template <typename Fn>
 void dim_apply(TensorList tensors, int64_t dim, Fn f) {
   AT_ASSERT(tensors.size() > 0);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at {
+namespace native {
+
+// result += alpha * csr(crow_indices, col_indices, values) @ dense
+using spmm_sparse_csr_fn = void (*)(
+    Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    Scalar alpha);
+
+// result = csr(crow_indices, col_indices, values) @ vec
+using spmv_sparse_csr_fn = void (*)(
+    Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& vec);
+
+DECLARE_DISPATCH(spmm_sparse_csr_fn, spmm_sparse_csr_stub);
+DECLARE_DISPATCH(spmv_sparse_csr_fn, spmv_sparse_csr_stub);
+
+} // namespace native
+} // namespace at
@@ -2,17 +2,65 @@
 
 #include <ATen/ATen.h>
 #include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/native/SortingUtils.h>
+#include <c10/util/flat_hash_map.h>
 
-#include <set>
+#include <algorithm>
+#include <numeric>
 #include <tuple>
-#include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 namespace at {
 namespace native{
 
 namespace {
 
+// Smallest number of elements given to a partition or a sorted chunk, below
+// this the work isn't worth a thread.
+constexpr int64_t kMinElementsPerThread = at::internal::GRAIN_SIZE;
+
+int64_t num_partitions(int64_t numel) {
+  return std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), numel / kMinElementsPerThread));
+}
+
+// The distinct values of one partition of the input with their counts.
+// While the partition is deduplicated, the inverse indices of its elements
+// are set to the positions of their values in `values`, `ranks` maps those
+// to the final positions within the partition.
+template <typename scalar_t>
+struct UniquePartition {
+  std::vector<scalar_t> values;
+  std::vector<int64_t> counts;
+  std::vector<int64_t> ranks;
+};
+
+// Picks `num_partitions - 1` splitters from an evenly spaced sample of the
+// input. Partition `p` holds the values v with
+// splitters[p - 1] <= v < splitters[p].
+template <typename scalar_t>
+std::vector<scalar_t> sample_splitters(const scalar_t* input_data, int64_t numel, int64_t num_partitions) {
+  const int64_t sample_size = std::min<int64_t>(numel, num_partitions * 64);
+  std::vector<scalar_t> sample(sample_size);
+  for (int64_t i = 0; i < sample_size; i++) {
+    sample[i] = input_data[i * (numel / sample_size)];
+  }
+  std::sort(sample.begin(), sample.end());
+  std::vector<scalar_t> splitters(num_partitions - 1);
+  for (int64_t p = 1; p < num_partitions; p++) {
+    splitters[p - 1] = sample[p * sample_size / num_partitions];
+  }
+  return splitters;
+}
+
+// Unique, inverse indices and counts are computed in one pass per partition.
+//
+// The input is split into value ranges with sampled splitters, and the
+// elements are scattered by partition in input order. Every thread then owns
+// one partition and deduplicates it with its own hash table, so no table is
+// shared between threads. Because partitions are ordered value ranges, the
+// sorted output is the concatenation of the sorted partitions.
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
     const Tensor& self,
@@ -22,50 +70,133 @@ std::tuple<Tensor, Tensor, Tensor> unique_cpu_template(
   const Tensor& input = self.contiguous();
   const scalar_t* input_data = input.data_ptr<scalar_t>();
   int64_t numel = input.numel();
-  Tensor output;
   Tensor inverse_indices = at::empty({0}, self.options().dtype(kLong));
   Tensor counts = at::empty({0}, self.options().dtype(kLong));
 
-  std::unordered_set<scalar_t> set(input_data, input_data + numel);
-  output = at::empty({static_cast<int64_t>(set.size())}, input.options());
-  scalar_t *output_data = output.data_ptr<scalar_t>();
-
-  if (sorted) {
-    std::vector<scalar_t> vec(set.begin(), set.end());
-    std::sort(vec.begin(), vec.end());
-    std::copy(vec.begin(), vec.end(), output_data);
+  const int64_t partitions = num_partitions(numel);
+  const std::vector<scalar_t> splitters =
+      partitions > 1 ? sample_splitters(input_data, numel, partitions) : std::vector<scalar_t>();
+  auto partition_of = [&](scalar_t value) -> int64_t {
+    return std::upper_bound(splitters.begin(), splitters.end(), value) - splitters.begin();
+  };
+
+  // partition_offsets[p] is the position of the first element of partition
+  // `p` in `element_indices`, which lists the input positions grouped by
+  // partition. With a single partition the input is read directly.
+  std::vector<int64_t> partition_offsets(partitions + 1, 0);
+  std::vector<int64_t> element_indices;
+  if (partitions > 1) {
+    const int64_t chunk_size = at::divup(numel, partitions);
+    // histograms[c * partitions + p] is the number of elements of input chunk
+    // `c` falling into partition `p`.
+    std::vector<int64_t> histograms(partitions * partitions, 0);
+    at::parallel_for(0, partitions, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* histogram = histograms.data() + c * partitions;
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          histogram[partition_of(input_data[i])]++;
+        }
+      }
+    });
+    // Turn the histograms into write positions, chunk by chunk within every
+    // partition, so that each partition keeps the input order.
+    int64_t offset = 0;
+    for (int64_t p = 0; p < partitions; p++) {
+      partition_offsets[p] = offset;
+      for (int64_t c = 0; c < partitions; c++) {
+        const int64_t count = histograms[c * partitions + p];
+        histograms[c * partitions + p] = offset;
+        offset += count;
+      }
+    }
+    partition_offsets[partitions] = offset;
+    element_indices.resize(numel);
+    at::parallel_for(0, partitions, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* positions = histograms.data() + c * partitions;
+        for (int64_t i = c * chunk_size; i < std::min(numel, (c + 1) * chunk_size); i++) {
+          element_indices[positions[partition_of(input_data[i])]++] = i;
+        }
+      }
+    });
   } else {
-    std::copy(set.begin(), set.end(), output_data);
+    partition_offsets[1] = numel;
   }
+  auto element_index = [&](int64_t i) -> int64_t {
+    return partitions > 1 ? element_indices[i] : i;
+  };
 
+  int64_t* inverse_indices_data = nullptr;
   if (return_inverse || return_counts) {
     inverse_indices.resize_(input.sizes());
-    int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
-    std::unordered_map<scalar_t, int64_t> inverse_map;
-    inverse_map.reserve(output.numel());
-    for (int64_t i = 0; i < output.numel(); ++i) {
-      inverse_map[output_data[i]] = i;
-    }
-    for(int64_t i = 0; i < numel; ++i) {
-      inverse_indices_data[i] = inverse_map[input_data[i]];
-    }
-    if (return_counts) {
-      std::unordered_map<scalar_t, int64_t> counts_map;
-      counts_map.reserve(output.numel());
-      for (int64_t i = 0; i < output.numel(); ++i) {
-        counts_map[output_data[i]] = 0;
-      }
-      for(int64_t i = 0; i < numel; i++) {
-        counts_map[input_data[i]] += 1;
+    inverse_indices_data = inverse_indices.data_ptr<int64_t>();
+  }
+
+  std::vector<UniquePartition<scalar_t>> uniques(partitions);
+  at::parallel_for(0, partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      UniquePartition<scalar_t>& unique = uniques[p];
+      ska::flat_hash_map<scalar_t, int64_t> ids;
+      for (int64_t i = partition_offsets[p]; i < partition_offsets[p + 1]; i++) {
+        const int64_t index = element_index(i);
+        const scalar_t value = input_data[index];
+        auto it = ids.emplace(value, unique.values.size());
+        if (it.second) {
+          unique.values.push_back(value);
+          unique.counts.push_back(0);
+        }
+        unique.counts[it.first->second]++;
+        if (inverse_indices_data) {
+          inverse_indices_data[index] = it.first->second;
+        }
       }
-      counts.resize_(output.sizes());
-      counts.fill_(0);
-      int64_t *counts_data = counts.data_ptr<int64_t>();
-      for(int64_t i = 0; i < output.numel(); i++) {
-        counts_data[i] = counts_map[output_data[i]];
+      if (sorted) {
+        std::vector<int64_t> order(unique.values.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](int64_t a, int64_t b) {
+          return unique.values[a] < unique.values[b];
+        });
+        std::vector<scalar_t> sorted_values(order.size());
+        std::vector<int64_t> sorted_counts(order.size());
+        unique.ranks.resize(order.size());
+        for (size_t j = 0; j < order.size(); j++) {
+          sorted_values[j] = unique.values[order[j]];
+          sorted_counts[j] = unique.counts[order[j]];
+          unique.ranks[order[j]] = j;
+        }
+        unique.values = std::move(sorted_values);
+        unique.counts = std::move(sorted_counts);
       }
     }
+  });
+
+  std::vector<int64_t> output_offsets(partitions + 1, 0);
+  for (int64_t p = 0; p < partitions; p++) {
+    output_offsets[p + 1] = output_offsets[p] + uniques[p].values.size();
   }
+  Tensor output = at::empty({output_offsets[partitions]}, input.options());
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+  int64_t* counts_data = nullptr;
+  if (return_counts) {
+    counts.resize_(output.sizes());
+    counts_data = counts.data_ptr<int64_t>();
+  }
+  at::parallel_for(0, partitions, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      const UniquePartition<scalar_t>& unique = uniques[p];
+      const int64_t offset = output_offsets[p];
+      std::copy(unique.values.begin(), unique.values.end(), output_data + offset);
+      if (counts_data) {
+        std::copy(unique.counts.begin(), unique.counts.end(), counts_data + offset);
+      }
+      if (inverse_indices_data) {
+        for (int64_t i = partition_offsets[p]; i < partition_offsets[p + 1]; i++) {
+          int64_t& inverse = inverse_indices_data[element_index(i)];
+          inverse = offset + (sorted ? unique.ranks[inverse] : inverse);
+        }
+      }
+    }
+  });
   return std::make_tuple(output, inverse_indices, counts);
 }
 
@@ -120,33 +251,6 @@ std::tuple<Tensor, Tensor, Tensor> unique_consecutive_cpu_template(
   return std::make_tuple(output, inverse_indices, counts);
 }
 
-template<class ForwardIt>
-ForwardIt _unique_dim_cpu_impl(ForwardIt first, ForwardIt last,
-  std::vector<int64_t>& indices, Tensor inverse_indices_vec, Tensor counts) {
-    if (first == last) {
-      return last;
-    }
-    // save to calculate distance to iterators
-    ForwardIt begin = first;
-
-    // set first inverse index and count
-    inverse_indices_vec[indices[0]] = 0;
-    counts[0] += 1;
-
-    ForwardIt result = first;
-    while (++first != last) {
-      if (!at::equal(*result, *first) && ++result != first) {
-          *result = std::move(*first);
-      }
-      int64_t idx_result = std::distance(begin, result);
-      int64_t idx_first = std::distance(begin, first);
-      inverse_indices_vec[indices[idx_first]] = idx_result;
-      counts[idx_result] += 1;
-    }
-
-    return ++result;
-  }
-
 template <typename scalar_t>
 std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
     const Tensor& self,
@@ -180,48 +284,56 @@ std::tuple<Tensor, Tensor, Tensor> _unique_dim_cpu_template(
   auto orig_sizes = input_flat.sizes().vec();
   input_flat = input_flat.contiguous().view({input_flat.size(0), -1});
 
-  std::vector<int64_t> indices(input_flat.size(0));
+  const int64_t num_rows = input_flat.size(0);
+  std::vector<int64_t> indices(num_rows);
   std::iota(indices.begin(), indices.end(), 0);
   int64_t numel = input_flat.size(1);
-  scalar_t* input_flat_ptr = ((scalar_t*)input_flat.data_ptr());
+  const scalar_t* input_flat_ptr = input_flat.data_ptr<scalar_t>();
+  auto row_less = [&](int64_t a, int64_t b) -> bool {
+    return std::lexicographical_compare(
+        input_flat_ptr + a * numel, input_flat_ptr + (a + 1) * numel,
+        input_flat_ptr + b * numel, input_flat_ptr + (b + 1) * numel);
+  };
+  auto row_equal = [&](int64_t a, int64_t b) -> bool {
+    return std::equal(
+        input_flat_ptr + a * numel, input_flat_ptr + (a + 1) * numel,
+        input_flat_ptr + b * numel);
+  };
 
   // sort indices using data
   if (!consecutive) {
-    std::sort(indices.begin(), indices.end(),
-      [&](int64_t a, int64_t b) -> bool {
-        for (int64_t i = 0; i < numel; ++i) {
-          scalar_t lhs = input_flat_ptr[i + a * numel];
-          scalar_t rhs = input_flat_ptr[i + b * numel];
-          if (lhs < rhs) {
-            return true;
-          } else if (lhs > rhs) {
-            return false;
-          }
-        }
-        return false;
-      });
+    parallel_merge_sort(
+        indices.begin(), indices.end(), num_partitions(num_rows * numel), row_less);
   }
 
-  Tensor input_sorted;
-  if (!consecutive) {
-    input_sorted = at::empty(input_flat.sizes(), input_flat.options());
-    for (size_t i = 0; i < indices.size(); ++i) {
-      input_sorted[i] = input_flat[indices[i]];
+  // group_ids[i] is the position in the output of the row indices[i]
+  std::vector<int64_t> group_ids(num_rows);
+  at::parallel_for(1, num_rows, at::internal::GRAIN_SIZE / std::max<int64_t>(numel, 1) + 1,
+      [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      group_ids[i] = row_equal(indices[i - 1], indices[i]) ? 0 : 1;
     }
-  } else {
-    input_sorted = input_flat;
+  });
+  group_ids[0] = 0;
+  std::partial_sum(group_ids.begin(), group_ids.end(), group_ids.begin());
+  const int64_t num_groups = group_ids[num_rows - 1] + 1;
+
+  Tensor inverse_indices = at::empty({num_rows}, self.options().dtype(kLong));
+  Tensor counts = at::zeros({num_groups}, self.options().dtype(kLong));
+  Tensor unique_rows = at::empty({num_groups}, self.options().dtype(kLong));
+  int64_t* inverse_indices_data = inverse_indices.data_ptr<int64_t>();
+  int64_t* counts_data = counts.data_ptr<int64_t>();
+  int64_t* unique_rows_data = unique_rows.data_ptr<int64_t>();
+  for (int64_t i = 0; i < num_rows; i++) {
+    const int64_t group = group_ids[i];
+    if (counts_data[group]++ == 0) {
+      unique_rows_data[group] = indices[i];
+    }
+    inverse_indices_data[indices[i]] = group;
   }
 
-  Tensor inverse_indices = at::empty(indices.size(), self.options().dtype(kLong));
-  Tensor counts = at::zeros(indices.size(), self.options().dtype(kLong));
-  std::vector<Tensor> input_unbind = at::unbind(input_sorted, 0);
-  auto last = _unique_dim_cpu_impl(
-    input_unbind.begin(), input_unbind.end(), indices, inverse_indices, counts);
-  input_unbind.erase(last, input_unbind.end());
-  counts = at::narrow(counts, 0, 0, input_unbind.size());
-
   // reshape back
-  auto output = at::stack(input_unbind, 0);
+  auto output = input_flat.index_select(0, unique_rows);
   auto new_sizes = std::vector<int64_t>(orig_sizes);
   new_sizes[0] = -1;
   output = output.view(new_sizes);
@@ -0,0 +1,48 @@
+#include <ATen/ATen.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/native/WinogradConvolution.h>
+
+namespace at { namespace native {
+
+DEFINE_DISPATCH(winograd_conv2d_stub);
+
+Tensor winograd_convolution2d_cpu(
+    const Tensor& self,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef padding,
+    int64_t output_tile) {
+  TORCH_CHECK(self.dim() == 4, "_winograd_convolution2d: expected 4D input, but got ", self.dim(), "D tensor");
+  TORCH_CHECK(weight.dim() == 4 && weight.size(2) == 3 && weight.size(3) == 3,
+      "_winograd_convolution2d: expected a 3x3 weight, but got weight of size ", weight.sizes());
+  TORCH_CHECK(weight.size(1) == self.size(1),
+      "_winograd_convolution2d: expected input to have ", weight.size(1), " channels, but got ", self.size(1));
+  TORCH_CHECK(output_tile == 2 || output_tile == 4,
+      "_winograd_convolution2d: output_tile must be 2 or 4, but got ", output_tile);
+  TORCH_CHECK(padding.size() == 2 && padding[0] >= 0 && padding[1] >= 0,
+      "_winograd_convolution2d: expected non-negative padding, but got ", padding);
+  TORCH_CHECK(self.scalar_type() == weight.scalar_type() &&
+      (!bias.defined() || bias.scalar_type() == self.scalar_type()),
+      "_winograd_convolution2d: expected input, weight and bias to have the same dtype");
+  TORCH_CHECK(!bias.defined() || (bias.dim() == 1 && bias.size(0) == weight.size(0)),
+      "_winograd_convolution2d: expected bias of size ", weight.size(0), ", but got ", bias.sizes());
+
+  const int64_t output_height = self.size(2) + 2 * padding[0] - 2;
+  const int64_t output_width = self.size(3) + 2 * padding[1] - 2;
+  TORCH_CHECK(output_height > 0 && output_width > 0,
+      "_winograd_convolution2d: input of size ", self.sizes(), " is smaller than the kernel");
+
+  Tensor output = at::empty({self.size(0), weight.size(0), output_height, output_width}, self.options());
+  if (output.numel() == 0) {
+    return output;
+  }
+  if (self.size(1) == 0) {
+    return bias.defined() ? output.copy_(bias.view({1, -1, 1, 1}).expand_as(output)) : output.zero_();
+  }
+  winograd_conv2d_stub(
+      kCPU, output, self.contiguous(), weight.contiguous(),
+      bias.defined() ? bias.contiguous() : bias, padding, output_tile);
+  return output;
+}
+
+}} // namespace at::native
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+namespace at { namespace native {
+
+// output = conv2d(input, weight, bias, stride=1, padding) for 3x3 weights,
+// computed with Winograd F(output_tile x output_tile, 3x3). `output` is
+// allocated with the output size, `bias` may be undefined.
+using winograd_conv2d_fn = void(*)(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef padding,
+    int64_t output_tile);
+
+DECLARE_DISPATCH(winograd_conv2d_fn, winograd_conv2d_stub);
+
+}} // at::native
@@ -0,0 +1,398 @@
+#include <ATen/native/BatchLinearAlgebra.h>
+
+#include <algorithm>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/LinearAlgebraUtils.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// The kernels below keep Vec256::size() matrices in structure of arrays form:
+// a[i + j * rows] holds element (i, j) of all of them, one matrix per lane.
+// With the order known at compile time the loops unroll and the matrices stay
+// in registers, and every lane runs the same instructions, so that pivoting
+// and error checks are done with per-lane masks rather than branches.
+
+// A batch of matrices in memory: element (i, j) of matrix b is at
+// data[b * batch_stride + i * row_stride + j * col_stride].
+template <typename scalar_t>
+struct MatrixBatch {
+  scalar_t* data;
+  int64_t batch_stride;
+  int64_t row_stride;
+  int64_t col_stride;
+
+  // the column major working copies of BatchLinearAlgebra.cpp
+  static MatrixBatch column_major(Tensor& t) {
+    return {t.data_ptr<scalar_t>(), matrixStride(t), 1, t.size(-2)};
+  }
+
+  static MatrixBatch strided(const Tensor& t) {
+    return {t.data_ptr<scalar_t>(), t.stride(0), t.stride(1), t.stride(2)};
+  }
+
+  MatrixBatch column(int64_t j) const {
+    return {data + j * col_stride, batch_stride, row_stride, col_stride};
+  }
+};
+
+// Loads the rows x cols matrices [first, first + count) into out. The lanes
+// past count get the identity, so that they cannot report an error.
+template <typename scalar_t>
+inline void load_lanes(
+    const MatrixBatch<scalar_t>& m, int64_t first, int64_t count,
+    int64_t rows, int64_t cols, Vec256<scalar_t>* out) {
+  using Vec = Vec256<scalar_t>;
+  __at_align32__ scalar_t lanes[Vec::size()];
+  for (int64_t j = 0; j < cols; j++) {
+    for (int64_t i = 0; i < rows; i++) {
+      const scalar_t* src = m.data + first * m.batch_stride + i * m.row_stride + j * m.col_stride;
+      for (int64_t l = 0; l < Vec::size(); l++) {
+        lanes[l] = l < count ? src[l * m.batch_stride] : scalar_t(i == j ? 1 : 0);
+      }
+      out[i + j * rows] = Vec::loadu(lanes);
+    }
+  }
+}
+
+template <typename scalar_t>
+inline void store_lanes(
+    const MatrixBatch<scalar_t>& m, int64_t first, int64_t count,
+    int64_t rows, int64_t cols, const Vec256<scalar_t>* in) {
+  using Vec = Vec256<scalar_t>;
+  __at_align32__ scalar_t lanes[Vec::size()];
+  for (int64_t j = 0; j < cols; j++) {
+    for (int64_t i = 0; i < rows; i++) {
+      scalar_t* dst = m.data + first * m.batch_stride + i * m.row_stride + j * m.col_stride;
+      in[i + j * rows].store(lanes);
+      for (int64_t l = 0; l < count; l++) {
+        dst[l * m.batch_stride] = lanes[l];
+      }
+    }
+  }
+}
+
+template <typename scalar_t>
+inline void store_infos(
+    const Vec256<scalar_t>& info, int64_t first, int64_t count, std::vector<int64_t>& infos) {
+  __at_align32__ scalar_t lanes[Vec256<scalar_t>::size()];
+  info.store(lanes);
+  for (int64_t l = 0; l < count; l++) {
+    infos[first + l] = static_cast<int64_t>(lanes[l]);
+  }
+}
+
+// Sets the lanes of info that are still 0 and not selected by ok to value.
+template <typename scalar_t>
+inline void record_info(Vec256<scalar_t>& info, const Vec256<scalar_t>& ok, int64_t value) {
+  using Vec = Vec256<scalar_t>;
+  const Vec first_error = Vec::blendv(Vec(static_cast<scalar_t>(value)), info, info != Vec(0));
+  info = Vec::blendv(first_error, info, ok);
+}
+
+// Runs fn(first, count) over the groups of Vec256::size() matrices of the
+// batch, in parallel.
+template <typename scalar_t, typename F>
+inline void parallel_for_lanes(int64_t batch_size, int64_t cost_per_matrix, const F& fn) {
+  constexpr int64_t lanes = Vec256<scalar_t>::size();
+  const int64_t groups = at::divup(batch_size, lanes);
+  const int64_t grain_size = std::max<int64_t>(1, internal::GRAIN_SIZE / (lanes * cost_per_matrix));
+  at::parallel_for(0, groups, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t g = begin; g < end; g++) {
+      const int64_t first = g * lanes;
+      fn(first, std::min(lanes, batch_size - first));
+    }
+  });
+}
+
+// LU factorization with partial pivoting of the N x N column major matrices
+// in a, in the format of getrf: the unit lower factor below the diagonal and
+// the upper factor on and above it. pivots[k] is the row exchanged with row k
+// at step k, chosen as the first row of largest magnitude like getrf does.
+// info gets the 1-based index of the first zero pivot; as in getrf, the
+// column of a zero pivot is not scaled, so that the factors stay finite.
+template <typename scalar_t, int64_t N>
+inline void lu_factor(Vec256<scalar_t>* a, Vec256<scalar_t>* pivots, Vec256<scalar_t>& info) {
+  using Vec = Vec256<scalar_t>;
+  const Vec zero(0);
+  const Vec one(1);
+  for (int64_t k = 0; k < N; k++) {
+    Vec largest = a[k + k * N].abs();
+    Vec pivot_row(static_cast<scalar_t>(k));
+    for (int64_t r = k + 1; r < N; r++) {
+      const Vec magnitude = a[r + k * N].abs();
+      const Vec larger = magnitude > largest;
+      largest = Vec::blendv(largest, magnitude, larger);
+      pivot_row = Vec::blendv(pivot_row, Vec(static_cast<scalar_t>(r)), larger);
+    }
+    pivots[k] = pivot_row;
+
+    for (int64_t r = k + 1; r < N; r++) {
+      const Vec swap = pivot_row == Vec(static_cast<scalar_t>(r));
+      for (int64_t j = 0; j < N; j++) {
+        const Vec row_k = a[k + j * N];
+        a[k + j * N] = Vec::blendv(row_k, a[r + j * N], swap);
+        a[r + j * N] = Vec::blendv(a[r + j * N], row_k, swap);
+      }
+    }
+
+    const Vec nonzero = a[k + k * N] != zero;
+    record_info(info, nonzero, k + 1);
+    const Vec pivot = Vec::blendv(one, a[k + k * N], nonzero);
+    for (int64_t r = k + 1; r < N; r++) {
+      a[r + k * N] = a[r + k * N] / pivot;
+    }
+    for (int64_t j = k + 1; j < N; j++) {
+      for (int64_t r = k + 1; r < N; r++) {
+        a[r + j * N] = a[r + j * N] - a[r + k * N] * a[k + j * N];
+      }
+    }
+  }
+}
+
+// Solves A x = b in place for one right hand side, given the factorization
+// of lu_factor, as getrs does.
+template <typename scalar_t, int64_t N>
+inline void lu_solve(const Vec256<scalar_t>* a, const Vec256<scalar_t>* pivots, Vec256<scalar_t>* x) {
+  using Vec = Vec256<scalar_t>;
+  // the row exchanges of later steps were applied to the whole rows of a,
+  // lower factor included, so they all go first
+  for (int64_t k = 0; k < N; k++) {
+    for (int64_t r = k + 1; r < N; r++) {
+      const Vec swap = pivots[k] == Vec(static_cast<scalar_t>(r));
+      const Vec x_k = x[k];
+      x[k] = Vec::blendv(x_k, x[r], swap);
+      x[r] = Vec::blendv(x[r], x_k, swap);
+    }
+  }
+  for (int64_t k = 0; k < N; k++) {
+    for (int64_t r = k + 1; r < N; r++) {
+      x[r] = x[r] - a[r + k * N] * x[k];
+    }
+  }
+  for (int64_t k = N - 1; k >= 0; k--) {
+    x[k] = x[k] / a[k + k * N];
+    for (int64_t r = 0; r < k; r++) {
+      x[r] = x[r] - a[r + k * N] * x[k];
+    }
+  }
+}
+
+template <typename scalar_t, int64_t N>
+void small_solve(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
+  using Vec = Vec256<scalar_t>;
+  const auto A_batch = MatrixBatch<scalar_t>::column_major(A);
+  const auto b_batch = MatrixBatch<scalar_t>::column_major(b);
+  const int64_t nrhs = b.size(-1);
+  parallel_for_lanes<scalar_t>(batchCount(A), N * N * (N + nrhs), [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    Vec pivots[N];
+    Vec info(0);
+    load_lanes(A_batch, first, count, N, N, a);
+    lu_factor<scalar_t, N>(a, pivots, info);
+    store_lanes(A_batch, first, count, N, N, a);
+    store_infos(info, first, count, infos);
+    for (int64_t j = 0; j < nrhs; j++) {
+      Vec x[N];
+      load_lanes(b_batch.column(j), first, count, N, 1, x);
+      lu_solve<scalar_t, N>(a, pivots, x);
+      store_lanes(b_batch.column(j), first, count, N, 1, x);
+    }
+  });
+}
+
+template <typename scalar_t, int64_t N>
+void small_inverse(Tensor& self, std::vector<int64_t>& infos) {
+  using Vec = Vec256<scalar_t>;
+  const auto batch = MatrixBatch<scalar_t>::column_major(self);
+  parallel_for_lanes<scalar_t>(batchCount(self), 2 * N * N * N, [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    Vec pivots[N];
+    Vec info(0);
+    load_lanes(batch, first, count, N, N, a);
+    lu_factor<scalar_t, N>(a, pivots, info);
+    store_infos(info, first, count, infos);
+    Vec inverse[N * N];
+    for (int64_t j = 0; j < N; j++) {
+      Vec* x = inverse + j * N;
+      for (int64_t i = 0; i < N; i++) {
+        x[i] = Vec(scalar_t(i == j ? 1 : 0));
+      }
+      lu_solve<scalar_t, N>(a, pivots, x);
+    }
+    store_lanes(batch, first, count, N, N, inverse);
+  });
+}
+
+// Cholesky factorization as potf2 does it, column by column. With upper set
+// the factor U = L^T is read from and written to the upper triangle, which
+// is the lower triangle of the transpose. info gets the 1-based order of the
+// first leading minor that is not positive definite.
+template <typename scalar_t, int64_t N, bool upper>
+inline void cholesky_factor(Vec256<scalar_t>* a, Vec256<scalar_t>& info) {
+  using Vec = Vec256<scalar_t>;
+  auto elem = [a](int64_t i, int64_t j) -> Vec& {
+    return upper ? a[j + i * N] : a[i + j * N];
+  };
+  for (int64_t j = 0; j < N; j++) {
+    Vec diag = elem(j, j);
+    for (int64_t k = 0; k < j; k++) {
+      diag = diag - elem(j, k) * elem(j, k);
+    }
+    // NaN fails too, like in potf2
+    record_info(info, diag > Vec(0), j + 1);
+    diag = diag.sqrt();
+    elem(j, j) = diag;
+    for (int64_t i = j + 1; i < N; i++) {
+      Vec value = elem(i, j);
+      for (int64_t k = 0; k < j; k++) {
+        value = value - elem(i, k) * elem(j, k);
+      }
+      elem(i, j) = value / diag;
+    }
+  }
+}
+
+template <typename scalar_t, int64_t N>
+void small_cholesky(Tensor& self, bool upper, std::vector<int64_t>& infos) {
+  using Vec = Vec256<scalar_t>;
+  const auto batch = MatrixBatch<scalar_t>::column_major(self);
+  parallel_for_lanes<scalar_t>(batchCount(self), N * N * N, [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    Vec info(0);
+    load_lanes(batch, first, count, N, N, a);
+    if (upper) {
+      cholesky_factor<scalar_t, N, true>(a, info);
+    } else {
+      cholesky_factor<scalar_t, N, false>(a, info);
+    }
+    store_lanes(batch, first, count, N, N, a);
+    store_infos(info, first, count, infos);
+  });
+}
+
+// Unlike the LAPACK based det, singular matrices need no special handling:
+// they give a zero pivot, which lu_factor leaves in the upper factor.
+template <typename scalar_t, int64_t N>
+void small_det(Tensor& result, const Tensor& self) {
+  using Vec = Vec256<scalar_t>;
+  const auto batch = MatrixBatch<scalar_t>::strided(self);
+  scalar_t* result_data = result.data_ptr<scalar_t>();
+  parallel_for_lanes<scalar_t>(self.size(0), N * N * N, [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    Vec pivots[N];
+    Vec info(0);
+    load_lanes(batch, first, count, N, N, a);
+    lu_factor<scalar_t, N>(a, pivots, info);
+    Vec det(1);
+    for (int64_t k = 0; k < N; k++) {
+      const Vec exchanged = pivots[k] != Vec(static_cast<scalar_t>(k));
+      det = Vec::blendv(det, Vec(0) - det, exchanged) * a[k + k * N];
+    }
+    __at_align32__ scalar_t lanes[Vec::size()];
+    det.store(lanes);
+    std::copy(lanes, lanes + count, result_data + first);
+  });
+}
+
+template <typename scalar_t, int64_t N>
+void small_baddbmm(Tensor& result, const Tensor& batch1, const Tensor& batch2, Scalar beta_, Scalar alpha_, bool is_bmm) {
+  using Vec = Vec256<scalar_t>;
+  const auto result_batch = MatrixBatch<scalar_t>::strided(result);
+  const auto batch1_batch = MatrixBatch<scalar_t>::strided(batch1);
+  const auto batch2_batch = MatrixBatch<scalar_t>::strided(batch2);
+  const int64_t cols = batch2.size(2);
+  const Vec beta(beta_.to<scalar_t>());
+  const Vec alpha(alpha_.to<scalar_t>());
+  parallel_for_lanes<scalar_t>(batch1.size(0), N * N * cols, [&](int64_t first, int64_t count) {
+    Vec a[N * N];
+    load_lanes(batch1_batch, first, count, N, N, a);
+    for (int64_t j = 0; j < cols; j++) {
+      Vec x[N];
+      Vec y[N];
+      load_lanes(batch2_batch.column(j), first, count, N, 1, x);
+      for (int64_t i = 0; i < N; i++) {
+        y[i] = a[i] * x[0];
+        for (int64_t k = 1; k < N; k++) {
+          y[i] = y[i] + a[i + k * N] * x[k];
+        }
+      }
+      if (!is_bmm) {
+        Vec r[N];
+        load_lanes(result_batch.column(j), first, count, N, 1, r);
+        for (int64_t i = 0; i < N; i++) {
+          y[i] = r[i] * beta + y[i] * alpha;
+        }
+      }
+      store_lanes(result_batch.column(j), first, count, N, 1, y);
+    }
+  });
+}
+
+// Calls fn<scalar_t, n>(...) for the matrix order n.
+#define SMALL_MATRIX_CASE(N, fn, ...) \
+  case N:                             \
+    fn<scalar_t, N>(__VA_ARGS__);     \
+    break;
+
+#define DISPATCH_SMALL_MATRIX_SIZE(n, fn, ...)                       \
+  switch (n) {                                                       \
+    SMALL_MATRIX_CASE(2, fn, __VA_ARGS__)                            \
+    SMALL_MATRIX_CASE(3, fn, __VA_ARGS__)                            \
+    SMALL_MATRIX_CASE(4, fn, __VA_ARGS__)                            \
+    SMALL_MATRIX_CASE(5, fn, __VA_ARGS__)                            \
+    SMALL_MATRIX_CASE(6, fn, __VA_ARGS__)                            \
+    SMALL_MATRIX_CASE(7, fn, __VA_ARGS__)                            \
+    SMALL_MATRIX_CASE(8, fn, __VA_ARGS__)                            \
+    default:                                                         \
+      AT_ERROR(#fn, ": expected a matrix order between 2 and ",      \
+               kSmallMatrixMaxSize, " but got ", n);                 \
+  }
+
+void small_solve_kernel(Tensor& b, Tensor& A, std::vector<int64_t>& infos) {
+  AT_DISPATCH_FLOATING_TYPES(A.scalar_type(), "small_solve_cpu", [&] {
+    DISPATCH_SMALL_MATRIX_SIZE(A.size(-1), small_solve, b, A, infos);
+  });
+}
+
+void small_inverse_kernel(Tensor& self, std::vector<int64_t>& infos) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_inverse_cpu", [&] {
+    DISPATCH_SMALL_MATRIX_SIZE(self.size(-1), small_inverse, self, infos);
+  });
+}
+
+void small_cholesky_kernel(Tensor& self, bool upper, std::vector<int64_t>& infos) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_cholesky_cpu", [&] {
+    DISPATCH_SMALL_MATRIX_SIZE(self.size(-1), small_cholesky, self, upper, infos);
+  });
+}
+
+void small_det_kernel(Tensor& result, const Tensor& self) {
+  AT_DISPATCH_FLOATING_TYPES(self.scalar_type(), "small_det_cpu", [&] {
+    DISPATCH_SMALL_MATRIX_SIZE(self.size(-1), small_det, result, self);
+  });
+}
+
+void small_baddbmm_kernel(Tensor& result, const Tensor& batch1, const Tensor& batch2, Scalar beta, Scalar alpha, bool is_bmm) {
+  AT_DISPATCH_FLOATING_TYPES(batch1.scalar_type(), "small_baddbmm_cpu", [&] {
+    DISPATCH_SMALL_MATRIX_SIZE(batch1.size(-1), small_baddbmm, result, batch1, batch2, beta, alpha, is_bmm);
+  });
+}
+
+#undef DISPATCH_SMALL_MATRIX_SIZE
+#undef SMALL_MATRIX_CASE
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(small_solve_stub, &small_solve_kernel);
+REGISTER_DISPATCH(small_inverse_stub, &small_inverse_kernel);
+REGISTER_DISPATCH(small_cholesky_stub, &small_cholesky_kernel);
+REGISTER_DISPATCH(small_det_stub, &small_det_kernel);
+REGISTER_DISPATCH(small_baddbmm_stub, &small_baddbmm_kernel);
+
+}} // namespace at::native
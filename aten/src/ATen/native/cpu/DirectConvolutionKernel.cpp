@@ -0,0 +1,135 @@
+#include <ATen/native/DirectConvolution.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// The output rows of a block stay in the L1 cache while the contributions of
+// all the input channels and kernel positions are added to them.
+constexpr int64_t kBlockElements = 4096;
+
+// y[i] += a * x[i * incx]
+template <typename scalar_t>
+inline void axpy(int64_t n, scalar_t a, const scalar_t* x, int64_t incx, scalar_t* y) {
+  using Vec = Vec256<scalar_t>;
+  int64_t i = 0;
+  if (incx == 1) {
+    const Vec a_vec(a);
+    for (; i + Vec::size() <= n; i += Vec::size()) {
+      const Vec y_vec = Vec::loadu(y + i) + a_vec * Vec::loadu(x + i);
+      y_vec.store(y + i);
+    }
+  }
+  for (; i < n; i++) {
+    y[i] += a * x[i * incx];
+  }
+}
+
+template <typename scalar_t>
+void cpu_direct_conv2d(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  const int64_t C = input.size(1);
+  const int64_t H = input.size(2);
+  const int64_t W = input.size(3);
+  const int64_t K = output.size(1);
+  const int64_t OH = output.size(2);
+  const int64_t OW = output.size(3);
+  const int64_t KH = weight.size(2);
+  const int64_t KW = weight.size(3);
+  const int64_t channels_per_group = C / groups;
+  const int64_t outputs_per_group = K / groups;
+  const int64_t stride_h = stride[0], stride_w = stride[1];
+  const int64_t pad_h = padding[0], pad_w = padding[1];
+  const int64_t dilation_h = dilation[0], dilation_w = dilation[1];
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* weight_data = weight.data_ptr<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  // the output columns whose input column is inside the image, per kernel
+  // column
+  std::vector<int64_t> ow_begin(KW), ow_end(KW);
+  for (int64_t kw = 0; kw < KW; kw++) {
+    const int64_t first = pad_w - kw * dilation_w;
+    const int64_t last = W - 1 + pad_w - kw * dilation_w;
+    ow_begin[kw] = first <= 0 ? 0 : std::min(OW, at::divup(first, stride_w));
+    ow_end[kw] = last < 0 ? 0 : std::min(OW, last / stride_w + 1);
+  }
+
+  const int64_t rows_per_block = std::max<int64_t>(1, kBlockElements / OW);
+  // at least 1, so that inputs without channels, whose planes are just the
+  // bias, do not divide by zero
+  const int64_t plane_cost = std::max<int64_t>(1, OH * OW * channels_per_group * KH * KW);
+  const int64_t num_planes = output.size(0) * K;
+  at::parallel_for(0, num_planes, std::max<int64_t>(1, at::internal::GRAIN_SIZE / plane_cost), [&](int64_t begin, int64_t end) {
+    for (int64_t plane = begin; plane < end; plane++) {
+      const int64_t n = plane / K;
+      const int64_t k = plane % K;
+      const int64_t g = k / outputs_per_group;
+      scalar_t* out = output_data + plane * OH * OW;
+      std::fill(out, out + OH * OW, bias_data ? bias_data[k] : scalar_t(0));
+      for (int64_t oh_begin = 0; oh_begin < OH; oh_begin += rows_per_block) {
+        const int64_t oh_end = std::min(OH, oh_begin + rows_per_block);
+        for (int64_t c = 0; c < channels_per_group; c++) {
+          const scalar_t* in = input_data + (n * C + g * channels_per_group + c) * H * W;
+          const scalar_t* w = weight_data + (k * channels_per_group + c) * KH * KW;
+          for (int64_t kh = 0; kh < KH; kh++) {
+            for (int64_t oh = oh_begin; oh < oh_end; oh++) {
+              const int64_t ih = oh * stride_h - pad_h + kh * dilation_h;
+              if (ih < 0 || ih >= H) {
+                continue;
+              }
+              const scalar_t* in_row = in + ih * W;
+              scalar_t* out_row = out + oh * OW;
+              for (int64_t kw = 0; kw < KW; kw++) {
+                if (ow_begin[kw] >= ow_end[kw]) {
+                  continue;
+                }
+                const int64_t iw = ow_begin[kw] * stride_w - pad_w + kw * dilation_w;
+                axpy<scalar_t>(
+                    ow_end[kw] - ow_begin[kw], w[kh * KW + kw],
+                    in_row + iw, stride_w, out_row + ow_begin[kw]);
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+}
+
+void direct_conv2d_kernel(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "direct_conv2d", [&] {
+    cpu_direct_conv2d<scalar_t>(output, input, weight, bias, stride, padding, dilation, groups);
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(direct_conv2d_stub, &direct_conv2d_kernel);
+
+}} // namespace at::native
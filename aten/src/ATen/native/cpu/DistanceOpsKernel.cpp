@@ -3,10 +3,14 @@
 #include <numeric>
 #include <iterator>
 #include <algorithm>
+#include <utility>
+#include <vector>
 
 #include <ATen/Dispatch.h>
 #include <ATen/Parallel.h>
 #include <ATen/cpu/vml.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <TH/THBlasUtils.h>
 
 namespace at { namespace native { namespace {
 
@@ -243,11 +247,180 @@ struct Dist {
     });
   }
 
+  // The two norm of larger inputs comes from |a|^2 + |b|^2 - 2 a.b, with the
+  // products of a tile of rows of x1 and a tile of rows of x2 done by one
+  // GEMM. Both tiles and their block of distances stay in the L2 cache.
+  static constexpr int64_t kMatmulMinRows = 25;
+  static constexpr int64_t kTileBytes = 256 * 1024;
+  // Where a^2 + b^2 - 2 a.b is below this fraction of a^2 + b^2 too many of
+  // its digits cancel, and the distance is summed directly instead.
+  static constexpr double kCancellation = 0.25;
+
+  static int64_t tile_rows(int64_t m) {
+    return std::max<int64_t>(16, std::min<int64_t>(256, kTileBytes / (2 * m * sizeof(scalar_t))));
+  }
+
+  static scalar_t squared_distance(const scalar_t* a, const scalar_t* b, int64_t m) {
+    return vec256::map2_reduce_all<scalar_t>(
+        [](Vec x, Vec y) { Vec diff = x - y; return diff * diff; },
+        [](Vec x, Vec y) { return x + y; },
+        a, b, m);
+  }
+
+  // The squared norms of the n rows of x.
+  static std::vector<scalar_t> squared_norms(const scalar_t* x, int64_t n, int64_t m) {
+    std::vector<scalar_t> norms(n);
+    parallel_for(0, n, internal::GRAIN_SIZE / (4 * m), [&](int64_t start, int64_t end) {
+      for (int64_t i = start; i < end; i++) {
+        norms[i] = vec256::map2_reduce_all<scalar_t>(
+            [](Vec x, Vec y) { return x * y; },
+            [](Vec x, Vec y) { return x + y; },
+            x + i * m, x + i * m, m);
+      }
+    });
+    return norms;
+  }
+
+  // out[i, j] = |x1[i] - x2[j]|^2 for the rows1 rows of x1 and rows2 rows of
+  // x2, out has a row stride of ldo.
+  static void squared_distance_tile(
+      const scalar_t* x1, const scalar_t* norms1, int64_t rows1,
+      const scalar_t* x2, const scalar_t* norms2, int64_t rows2,
+      int64_t m, scalar_t* out, int64_t ldo) {
+    // out = -2 x1 x2^T, that is out^T = -2 x2 x1^T in column-major
+    THBlas_gemm<scalar_t>(
+        't', 'n', rows2, rows1, m,
+        scalar_t(-2), const_cast<scalar_t*>(x2), m,
+        const_cast<scalar_t*>(x1), m,
+        scalar_t(0), out, ldo);
+    for (int64_t i = 0; i < rows1; i++) {
+      scalar_t* row = out + i * ldo;
+      for (int64_t j = 0; j < rows2; j++) {
+        const scalar_t scale = norms1[i] + norms2[j];
+        const scalar_t dist = scale + row[j];
+        row[j] = dist < kCancellation * scale ? squared_distance(x1 + i * m, x2 + j * m, m) : dist;
+      }
+    }
+  }
+
+  static void run_mm_cdist(Tensor& result, const Tensor& t1, const Tensor& t2) {
+    const scalar_t * const t1_start = t1.data_ptr<scalar_t>();
+    const scalar_t * const t2_start = t2.data_ptr<scalar_t>();
+    scalar_t * const res_start = result.data_ptr<scalar_t>();
+    const int64_t d = t1.size(0);
+    const int64_t r1 = t1.size(-2);
+    const int64_t r2 = t2.size(-2);
+    const int64_t m = t1.size(-1);
+    const std::vector<scalar_t> norms1 = squared_norms(t1_start, d * r1, m);
+    const std::vector<scalar_t> norms2 = squared_norms(t2_start, d * r2, m);
+
+    const int64_t tile = tile_rows(m);
+    const int64_t tiles1 = divup(r1, tile);
+    const int64_t tiles2 = divup(r2, tile);
+    parallel_for(0, d * tiles1 * tiles2, 1, [&](int64_t start, int64_t end) {
+      for (int64_t index = start; index < end; index++) {
+        const int64_t l = index / (tiles1 * tiles2);
+        const int64_t i = (index / tiles2) % tiles1 * tile;
+        const int64_t j = index % tiles2 * tile;
+        const int64_t rows1 = std::min(tile, r1 - i);
+        const int64_t rows2 = std::min(tile, r2 - j);
+        scalar_t* res = res_start + (l * r1 + i) * r2 + j;
+        squared_distance_tile(
+            t1_start + (l * r1 + i) * m, norms1.data() + l * r1 + i, rows1,
+            t2_start + (l * r2 + j) * m, norms2.data() + l * r2 + j, rows2,
+            m, res, r2);
+        for (int64_t row = 0; row < rows1; row++) {
+          vec256::map(
+              [](Vec x) { return x.sqrt(); },
+              res + row * r2, res + row * r2, rows2);
+        }
+      }
+    });
+  }
+
+  using Neighbour = std::pair<scalar_t, int64_t>;
+
+  // NaN distances are the farthest, ties go to the lower index.
+  static bool closer(const Neighbour& a, const Neighbour& b) {
+    const bool a_nan = std::isnan(a.first);
+    const bool b_nan = std::isnan(b.first);
+    if (a_nan != b_nan) {
+      return b_nan;
+    }
+    if (!a_nan && a.first != b.first) {
+      return a.first < b.first;
+    }
+    return a.second < b.second;
+  }
+
+  // The indices of the k rows of x2 nearest to every row of x1, by the two
+  // norm. A task takes a tile of rows of x1 through all the tiles of x2 and
+  // keeps the nearest k of each row in a heap, so the distances of a single
+  // tile per thread are all that is ever stored.
+  static void apply_cdist_topk(Tensor& indices, const Tensor& t1, const Tensor& t2, const int64_t k) {
+    const scalar_t * const t1_start = t1.data_ptr<scalar_t>();
+    const scalar_t * const t2_start = t2.data_ptr<scalar_t>();
+    int64_t * const indices_start = indices.data_ptr<int64_t>();
+    const int64_t d = t1.size(0);
+    const int64_t r1 = t1.size(-2);
+    const int64_t r2 = t2.size(-2);
+    const int64_t m = t1.size(-1);
+    const std::vector<scalar_t> norms1 = squared_norms(t1_start, d * r1, m);
+    const std::vector<scalar_t> norms2 = squared_norms(t2_start, d * r2, m);
+
+    const int64_t tile = tile_rows(m);
+    const int64_t tiles1 = divup(r1, tile);
+    parallel_for(0, d * tiles1, 1, [&](int64_t start, int64_t end) {
+      std::vector<scalar_t> dist(tile * tile);
+      std::vector<std::vector<Neighbour>> heaps(tile);
+      for (int64_t index = start; index < end; index++) {
+        const int64_t l = index / tiles1;
+        const int64_t i = index % tiles1 * tile;
+        const int64_t rows1 = std::min(tile, r1 - i);
+        for (auto& heap : heaps) {
+          heap.clear();
+        }
+        for (int64_t j = 0; j < r2; j += tile) {
+          const int64_t rows2 = std::min(tile, r2 - j);
+          squared_distance_tile(
+              t1_start + (l * r1 + i) * m, norms1.data() + l * r1 + i, rows1,
+              t2_start + (l * r2 + j) * m, norms2.data() + l * r2 + j, rows2,
+              m, dist.data(), rows2);
+          for (int64_t row = 0; row < rows1; row++) {
+            auto& heap = heaps[row];
+            const scalar_t* dist_row = dist.data() + row * rows2;
+            for (int64_t col = 0; col < rows2; col++) {
+              const Neighbour candidate(dist_row[col], j + col);
+              if ((int64_t)heap.size() < k) {
+                heap.push_back(candidate);
+                std::push_heap(heap.begin(), heap.end(), closer);
+              } else if (closer(candidate, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), closer);
+                heap.back() = candidate;
+                std::push_heap(heap.begin(), heap.end(), closer);
+              }
+            }
+          }
+        }
+        for (int64_t row = 0; row < rows1; row++) {
+          auto& heap = heaps[row];
+          std::sort_heap(heap.begin(), heap.end(), closer);
+          int64_t* indices_row = indices_start + (l * r1 + i + row) * k;
+          for (int64_t n = 0; n < k; n++) {
+            indices_row[n] = heap[n].second;
+          }
+        }
+      }
+    });
+  }
+
   static void apply_cdist(Tensor& result, const Tensor& x1, const Tensor& x2, const scalar_t p) {
     if (p == 0.0) {
       run_parallel_cdist<zdist_calc<scalar_t>>(result, x1, x2, p);
     } else if (p == 1.0) {
       run_parallel_cdist<odist_calc<scalar_t>>(result, x1, x2, p);
+    } else if (p == 2.0 && (x1.size(-2) > kMatmulMinRows || x2.size(-2) > kMatmulMinRows)) {
+      run_mm_cdist(result, x1, x2);
     } else if (p == 2.0) {
       run_parallel_cdist<tdist_calc<scalar_t>>(result, x1, x2, p);
     } else if (std::isinf(p)) {
@@ -423,6 +596,12 @@ static void cdist_kernel_impl(Tensor& result, const Tensor& x1, const Tensor& x2
   });
 }
 
+static void cdist_topk_kernel_impl(Tensor& indices, const Tensor& x1, const Tensor& x2, const int64_t k) {
+  AT_DISPATCH_FLOATING_TYPES(x1.scalar_type(), "cdist_topk", [&] {
+    Dist<scalar_t>::apply_cdist_topk(indices, x1, x2, k);
+  });
+}
+
 static void cdist_backward_kernel_impl(Tensor& result, const Tensor& grad, const Tensor& x1, const Tensor& x2, const double p, const Tensor& dist) {
   AT_DISPATCH_FLOATING_TYPES(result.scalar_type(), "cdist_backward", [&] {
     Dist<scalar_t>::apply_backward_cdist(result, grad, x1, x2, p, dist);
@@ -435,6 +614,7 @@ static void cdist_backward_kernel_impl(Tensor& result, const Tensor& grad, const
 REGISTER_DISPATCH(pdist_forward_stub, &pdist_forward_kernel_impl);
 REGISTER_DISPATCH(pdist_backward_stub, &pdist_backward_kernel_impl);
 REGISTER_DISPATCH(cdist_stub, &cdist_kernel_impl);
+REGISTER_DISPATCH(cdist_topk_stub, &cdist_topk_kernel_impl);
 REGISTER_DISPATCH(cdist_backward_stub, &cdist_backward_kernel_impl);
 
 }}  // namespace at::native
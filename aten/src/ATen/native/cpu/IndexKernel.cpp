@@ -2,6 +2,8 @@
 
 #include <cmath>
 #include <iostream>
+#include <memory>
+#include <vector>
 #include <ATen/Dispatch.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/Parallel.h>
@@ -92,6 +94,132 @@ void cpu_index_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
   }
 }
 
+// Performs the updates `*dst[i] += *src[i]` for i in [0, n), where several
+// updates may have the same destination, on all threads. The result doesn't
+// depend on the scheduling of the threads:
+//
+// - When the destinations span many elements, the updates are partitioned
+//   into ranges of destination addresses. Every range is handled by one
+//   thread in the original order of the updates, so the result is exactly
+//   the one of the serial loop.
+// - When the destinations span few elements compared to the number of
+//   updates, partitioning would serialize the hot destinations. Instead
+//   every thread sums a contiguous chunk of the updates into a private
+//   buffer, and the buffers are added to the destination in chunk order.
+template <typename scalar_t>
+void cpu_parallel_accumulate(int64_t n, scalar_t* const* dst, const scalar_t* const* src) {
+  const int64_t num_chunks = std::min<int64_t>(at::get_num_threads(), n / internal::GRAIN_SIZE);
+  if (num_chunks <= 1) {
+    for (int64_t i = 0; i < n; i++) {
+      *dst[i] += *src[i];
+    }
+    return;
+  }
+  const int64_t chunk_size = at::divup(n, num_chunks);
+  auto chunk_begin = [&](int64_t c) { return std::min(n, c * chunk_size); };
+
+  std::vector<scalar_t*> chunk_min(num_chunks);
+  std::vector<scalar_t*> chunk_max(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      const auto range = std::minmax_element(dst + chunk_begin(c), dst + chunk_begin(c + 1));
+      chunk_min[c] = *range.first;
+      chunk_max[c] = *range.second;
+    }
+  });
+  scalar_t* const base = *std::min_element(chunk_min.begin(), chunk_min.end());
+  const int64_t span = *std::max_element(chunk_max.begin(), chunk_max.end()) - base + 1;
+
+  if (span * num_chunks <= n) {
+    // not a std::vector, which would pack bools into shared words
+    std::unique_ptr<scalar_t[]> partial(new scalar_t[num_chunks * span]());
+    std::vector<char> touched(num_chunks * span, 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+          const int64_t slot = c * span + (dst[i] - base);
+          partial[slot] += *src[i];
+          touched[slot] = 1;
+        }
+      }
+    });
+    // only the touched slots are destinations, the others may be elements
+    // between them that don't belong to the tensor
+    at::parallel_for(0, span, internal::GRAIN_SIZE / num_chunks + 1, [&](int64_t begin, int64_t end) {
+      for (int64_t slot = begin; slot < end; slot++) {
+        for (int64_t c = 0; c < num_chunks; c++) {
+          if (touched[c * span + slot]) {
+            base[slot] += partial[c * span + slot];
+          }
+        }
+      }
+    });
+    return;
+  }
+
+  // histograms[c * num_chunks + p] counts, then places, the updates of chunk
+  // `c` to destination range `p`
+  auto range_of = [&](int64_t i) -> int64_t {
+    return (dst[i] - base) * num_chunks / span;
+  };
+  std::vector<int64_t> histograms(num_chunks * num_chunks, 0);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+        histograms[c * num_chunks + range_of(i)]++;
+      }
+    }
+  });
+  std::vector<int64_t> range_offsets(num_chunks + 1);
+  int64_t offset = 0;
+  for (int64_t p = 0; p < num_chunks; p++) {
+    range_offsets[p] = offset;
+    for (int64_t c = 0; c < num_chunks; c++) {
+      const int64_t count = histograms[c * num_chunks + p];
+      histograms[c * num_chunks + p] = offset;
+      offset += count;
+    }
+  }
+  range_offsets[num_chunks] = n;
+  std::vector<int64_t> order(n);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); i++) {
+        order[histograms[c * num_chunks + range_of(i)]++] = i;
+      }
+    }
+  });
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t p = begin; p < end; p++) {
+      for (int64_t j = range_offsets[p]; j < range_offsets[p + 1]; j++) {
+        *dst[order[j]] += *src[order[j]];
+      }
+    }
+  });
+}
+
+template <typename scalar_t>
+void cpu_index_accumulate_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride) {
+  const int64_t n = iter.numel();
+  const int ntensor = iter.ntensors();
+  std::vector<scalar_t*> dst(n);
+  std::vector<const scalar_t*> src(n);
+  // the addresses are computed before anything is written, so an invalid
+  // index leaves `self` unchanged
+  at::parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    int64_t position = begin;
+    iter.serial_for_each([&](char** data, const int64_t* strides, int64_t size) {
+      auto indexer = Indexer(ntensor - 2, &data[2], &strides[2], index_size, index_stride);
+      for (int64_t i = 0; i < size; i++) {
+        dst[position + i] = (scalar_t*)(data[0] + strides[0] * i + indexer.get(i));
+        src[position + i] = (scalar_t*)(data[1] + strides[1] * i);
+      }
+      position += size;
+    }, {begin, end});
+  });
+  cpu_parallel_accumulate(n, dst.data(), src.data());
+}
+
 void index_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride) {
   AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Half, at::ScalarType::Bool, iter.dtype(), "index_cpu", [&] {
     cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
@@ -103,9 +231,10 @@ void index_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef inde
 void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef index_stride, bool accumulate) {
   // NOTE: duplicate indices are only supported if accumulate is true.
   AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Half, at::ScalarType::Bool, iter.dtype(), "index_put", [&] {
-    if (accumulate) {
-      // TODO: investigate parallelization of the accumulate kernel. Unlike the non-accumulate case,
-      // this needs to be thread-safe.
+    if (accumulate && iter.numel() >= internal::GRAIN_SIZE && at::get_num_threads() > 1) {
+      // Duplicate indices make the updates race, see cpu_parallel_accumulate
+      cpu_index_accumulate_kernel<scalar_t>(iter, index_size, index_stride);
+    } else if (accumulate) {
       cpu_index_kernel<scalar_t>(iter, index_size, index_stride, [](char* dst, char* src, int64_t offset) {
         *(scalar_t*)(dst + offset) += *(scalar_t*)src;
       }, /*serial_execution=*/true);
@@ -117,10 +246,80 @@ void index_put_kernel(TensorIterator& iter, IntArrayRef index_size, IntArrayRef
   });
 }
 
+// Offset of the `line`-th line of `t` along `dim`, the lines are numbered in
+// row-major order of `sizes` without `dim`.
+int64_t line_offset(const Tensor& t, IntArrayRef sizes, int64_t dim, int64_t line) {
+  int64_t offset = 0;
+  for (int64_t d = t.dim() - 1; d >= 0; d--) {
+    if (d != dim) {
+      offset += (line % sizes[d]) * t.stride(d);
+      line /= sizes[d];
+    }
+  }
+  return offset;
+}
+
+// self[..., index[..., i, ...], ...] += src[..., i, ...] along `dim`. Lines
+// along `dim` at different positions of the other dimensions update
+// different lines of `self`, so they are summed in parallel. A few long lines
+// are summed in parallel with cpu_parallel_accumulate instead.
+void scatter_add_kernel(Tensor& self, int64_t dim, const Tensor& index, const Tensor& src) {
+  const int64_t elems_per_line = index.size(dim);
+  const int64_t num_lines = index.numel() / elems_per_line;
+  const int64_t self_dim_size = self.size(dim);
+  const int64_t self_stride = self.stride(dim);
+  const int64_t index_stride = index.stride(dim);
+  const int64_t src_stride = src.stride(dim);
+  const IntArrayRef sizes = index.sizes();
+  auto check_index = [&](int64_t idx) {
+    TORCH_CHECK(idx >= 0 && idx < self_dim_size,
+        "scatter_add_(): index ", idx, " is out of bounds for dimension ", dim, " with size ", self_dim_size);
+  };
+  AT_DISPATCH_ALL_TYPES_AND2(at::ScalarType::Half, at::ScalarType::Bool, self.scalar_type(), "scatter_add_cpu", [&] {
+    scalar_t* self_data = self.data_ptr<scalar_t>();
+    const int64_t* index_data = index.data_ptr<int64_t>();
+    const scalar_t* src_data = src.data_ptr<scalar_t>();
+
+    if (num_lines < at::get_num_threads() && elems_per_line >= internal::GRAIN_SIZE) {
+      std::vector<scalar_t*> dst(elems_per_line);
+      std::vector<const scalar_t*> values(elems_per_line);
+      for (int64_t line = 0; line < num_lines; line++) {
+        scalar_t* self_line = self_data + line_offset(self, sizes, dim, line);
+        const int64_t* index_line = index_data + line_offset(index, sizes, dim, line);
+        const scalar_t* src_line = src_data + line_offset(src, sizes, dim, line);
+        at::parallel_for(0, elems_per_line, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+          for (int64_t i = begin; i < end; i++) {
+            const int64_t idx = index_line[i * index_stride];
+            check_index(idx);
+            dst[i] = self_line + idx * self_stride;
+            values[i] = src_line + i * src_stride;
+          }
+        });
+        cpu_parallel_accumulate(elems_per_line, dst.data(), values.data());
+      }
+      return;
+    }
+
+    at::parallel_for(0, num_lines, internal::GRAIN_SIZE / elems_per_line + 1, [&](int64_t begin, int64_t end) {
+      for (int64_t line = begin; line < end; line++) {
+        scalar_t* self_line = self_data + line_offset(self, sizes, dim, line);
+        const int64_t* index_line = index_data + line_offset(index, sizes, dim, line);
+        const scalar_t* src_line = src_data + line_offset(src, sizes, dim, line);
+        for (int64_t i = 0; i < elems_per_line; i++) {
+          const int64_t idx = index_line[i * index_stride];
+          check_index(idx);
+          self_line[idx * self_stride] += src_line[i * src_stride];
+        }
+      }
+    });
+  });
+}
+
 } // anonymous namespace
 
 
 REGISTER_DISPATCH(index_stub, &index_kernel);
 REGISTER_DISPATCH(index_put_stub, &index_put_kernel);
+REGISTER_DISPATCH(scatter_add_stub, &scatter_add_kernel);
 
 }} // namespace at::native
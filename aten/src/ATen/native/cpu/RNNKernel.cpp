@@ -0,0 +1,414 @@
+#include <ATen/native/RNN.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <TH/THBlasUtils.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Inference kernels for whole RNN stacks. Every step does the GEMMs of all the
+// gates into one preallocated buffer and a single vectorized pass over it,
+// instead of the separate linear, chunk and pointwise ops of the cells in
+// RNN.cpp.
+//
+// The input projection of a layer is one GEMM over all the timesteps when the
+// whole input of the layer is known. Unidirectional stacks are run as a
+// wavefront: step t of layer l only needs step t of layer l - 1 and step
+// t - 1 of layer l, so the steps (l, d - l) of a diagonal d run in parallel.
+
+enum class RNNMode { LSTM, GRU, RNN_TANH, RNN_RELU };
+
+inline int64_t num_gates(RNNMode mode) {
+  switch (mode) {
+    case RNNMode::LSTM: return 4;
+    case RNNMode::GRU: return 3;
+    default: return 1;
+  }
+}
+
+// C[m, n] = beta * C + A[m, k] @ B[n, k]^T, all row-major.
+template <typename scalar_t>
+void gemm_nt(
+    int64_t m, int64_t n, int64_t k,
+    const scalar_t* a, int64_t lda,
+    const scalar_t* b, int64_t ldb,
+    scalar_t beta, scalar_t* c, int64_t ldc) {
+  // as column-major, C^T = B A^T
+  THBlas_gemm<scalar_t>(
+      't', 'n', n, m, k,
+      scalar_t(1), const_cast<scalar_t*>(b), ldb,
+      const_cast<scalar_t*>(a), lda,
+      beta, c, ldc);
+}
+
+// Fills the rows of `c` with `bias`, or zeros when there is no bias.
+template <typename scalar_t>
+void fill_rows(scalar_t* c, int64_t rows, int64_t cols, const scalar_t* bias) {
+  for (int64_t r = 0; r < rows; r++) {
+    if (bias) {
+      std::copy(bias, bias + cols, c + r * cols);
+    } else {
+      std::fill(c + r * cols, c + (r + 1) * cols, scalar_t(0));
+    }
+  }
+}
+
+template <typename scalar_t>
+inline Vec256<scalar_t> sigmoid(const Vec256<scalar_t>& x) {
+  const Vec256<scalar_t> one(1);
+  return one / (one + x.neg().exp());
+}
+
+template <typename scalar_t>
+struct DirectionParams {
+  const scalar_t* w_ih;
+  const scalar_t* w_hh;
+  // the bias of the input projection, and of the recurrent projection for
+  // the GRU, whose new gate multiplies it with the reset gate
+  const scalar_t* bias_ih;
+  const scalar_t* bias_hh;
+  int64_t input_size;
+};
+
+template <typename scalar_t>
+struct RNNStack {
+  RNNMode mode;
+  int64_t seq_length;
+  int64_t batch_size;
+  int64_t hidden_size;
+  int64_t num_layers;
+  int64_t num_directions;
+  // [layer * num_directions + direction]
+  std::vector<DirectionParams<scalar_t>> params;
+  // tensors owning contiguous copies of the parameters and the summed biases
+  std::vector<Tensor> storage;
+
+  int64_t gate_size() const {
+    return num_gates(mode) * hidden_size;
+  }
+};
+
+// The state of one direction of one layer, and its buffers for a step.
+template <typename scalar_t>
+struct DirectionState {
+  // input gates of every step [seq_length, batch, gates], or of one step
+  std::vector<scalar_t> igates;
+  // gates of the step [batch, gates]
+  std::vector<scalar_t> gates;
+  // cell state of the LSTM [batch, hidden]
+  scalar_t* c = nullptr;
+};
+
+// h = cell(gates, h_prev), on the rows of the batch.
+template <typename scalar_t>
+void pointwise(
+    RNNMode mode, int64_t batch_size, int64_t hidden_size,
+    const scalar_t* gates, const scalar_t* igates,
+    scalar_t* c, const scalar_t* h_prev, int64_t h_prev_stride,
+    scalar_t* h, int64_t h_stride) {
+  using Vec = Vec256<scalar_t>;
+  const int64_t H = hidden_size;
+  const int64_t G = num_gates(mode) * H;
+  for (int64_t b = 0; b < batch_size; b++) {
+    const scalar_t* g = gates + b * G;
+    const scalar_t* ig = igates + b * G;
+    const scalar_t* hp = h_prev + b * h_prev_stride;
+    scalar_t* cb = c ? c + b * H : nullptr;
+    scalar_t* hb = h + b * h_stride;
+    for (int64_t j = 0; j < H; j += Vec::size()) {
+      const int64_t count = std::min<int64_t>(Vec::size(), H - j);
+      switch (mode) {
+        case RNNMode::LSTM: {
+          const Vec ingate = sigmoid(Vec::loadu(g + j, count));
+          const Vec forgetgate = sigmoid(Vec::loadu(g + H + j, count));
+          const Vec cellgate = Vec::loadu(g + 2 * H + j, count).tanh();
+          const Vec outgate = sigmoid(Vec::loadu(g + 3 * H + j, count));
+          const Vec cy = forgetgate * Vec::loadu(cb + j, count) + ingate * cellgate;
+          cy.store(cb + j, count);
+          (outgate * cy.tanh()).store(hb + j, count);
+          break;
+        }
+        case RNNMode::GRU: {
+          const Vec reset_gate = sigmoid(Vec::loadu(ig + j, count) + Vec::loadu(g + j, count));
+          const Vec input_gate = sigmoid(Vec::loadu(ig + H + j, count) + Vec::loadu(g + H + j, count));
+          const Vec new_gate = (Vec::loadu(ig + 2 * H + j, count) +
+              reset_gate * Vec::loadu(g + 2 * H + j, count)).tanh();
+          (new_gate + input_gate * (Vec::loadu(hp + j, count) - new_gate)).store(hb + j, count);
+          break;
+        }
+        case RNNMode::RNN_TANH:
+          Vec::loadu(g + j, count).tanh().store(hb + j, count);
+          break;
+        case RNNMode::RNN_RELU:
+          maximum(Vec::loadu(g + j, count), Vec(0)).store(hb + j, count);
+          break;
+      }
+    }
+  }
+}
+
+// One step of one direction of one layer. The input gates of the step are
+// in `igates`, h_prev is the output of the previous step or the initial
+// hidden state.
+template <typename scalar_t>
+void step(
+    const RNNStack<scalar_t>& stack, const DirectionParams<scalar_t>& p,
+    DirectionState<scalar_t>& state, const scalar_t* igates,
+    const scalar_t* h_prev, int64_t h_prev_stride,
+    scalar_t* h, int64_t h_stride) {
+  const int64_t B = stack.batch_size;
+  const int64_t H = stack.hidden_size;
+  const int64_t G = stack.gate_size();
+  scalar_t* gates = state.gates.data();
+  if (stack.mode == RNNMode::GRU) {
+    // the recurrent part of the new gate is gated by the reset gate, so the
+    // two projections are kept apart
+    fill_rows(gates, B, G, p.bias_hh);
+  } else {
+    std::copy(igates, igates + B * G, gates);
+  }
+  gemm_nt<scalar_t>(B, G, H, h_prev, h_prev_stride, p.w_hh, H, scalar_t(1), gates, G);
+  pointwise(stack.mode, B, H, gates, igates, state.c, h_prev, h_prev_stride, h, h_stride);
+}
+
+// igates[rows, gates] = x[rows, input_size] @ w_ih^T + bias
+template <typename scalar_t>
+void input_projection(
+    const RNNStack<scalar_t>& stack, const DirectionParams<scalar_t>& p,
+    const scalar_t* x, int64_t rows, int64_t x_stride, scalar_t* igates) {
+  const int64_t G = stack.gate_size();
+  fill_rows(igates, rows, G, p.bias_ih);
+  gemm_nt<scalar_t>(rows, G, p.input_size, x, x_stride, p.w_ih, p.input_size, scalar_t(1), igates, G);
+}
+
+// Runs the stack on input [seq_length, batch, input_size]. output is
+// [seq_length, batch, num_directions * hidden_size] and hy, cy are
+// [num_layers * num_directions, batch, hidden_size], cy only for the LSTM.
+template <typename scalar_t>
+void run_stack(
+    const RNNStack<scalar_t>& stack,
+    const Tensor& input, const Tensor& hx, const Tensor& cx,
+    Tensor& output, Tensor& hy, Tensor& cy) {
+  const int64_t T = stack.seq_length;
+  const int64_t B = stack.batch_size;
+  const int64_t H = stack.hidden_size;
+  const int64_t G = stack.gate_size();
+  const int64_t L = stack.num_layers;
+  const int64_t D = stack.num_directions;
+  const bool is_lstm = stack.mode == RNNMode::LSTM;
+
+  // the outputs of every layer but the last, which writes into `output`
+  std::vector<Tensor> layer_outputs;
+  for (int64_t l = 0; l < L; l++) {
+    layer_outputs.push_back(l + 1 < L ? at::empty({T, B, D * H}, input.options()) : output);
+  }
+  auto layer_output = [&](int64_t l) { return layer_outputs[l].data_ptr<scalar_t>(); };
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* hx_data = hx.data_ptr<scalar_t>();
+  if (is_lstm) {
+    cy.copy_(cx);
+  }
+
+  std::vector<DirectionState<scalar_t>> states(L * D);
+  for (int64_t i = 0; i < L * D; i++) {
+    states[i].gates.resize(B * G);
+    states[i].c = is_lstm ? cy.data_ptr<scalar_t>() + i * B * H : nullptr;
+  }
+
+  // step t of direction `dir` of layer l, with its input gates in `igates`
+  auto run_step = [&](int64_t l, int64_t dir, int64_t t, const scalar_t* igates) {
+    const int64_t i = l * D + dir;
+    const int64_t prev = dir == 0 ? t - 1 : t + 1;
+    scalar_t* out = layer_output(l);
+    const bool first = dir == 0 ? t == 0 : t == T - 1;
+    const scalar_t* h_prev = first ? hx_data + i * B * H : out + (prev * B * D + dir) * H;
+    step<scalar_t>(
+        stack, stack.params[i], states[i], igates,
+        h_prev, first ? H : D * H,
+        out + (t * B * D + dir) * H, D * H);
+  };
+
+  if (D == 1) {
+    // the input gates of the first layer come from one GEMM, the other
+    // layers project the output of the previous layer step by step
+    states[0].igates.resize(T * B * G);
+    input_projection<scalar_t>(stack, stack.params[0], input_data, T * B, stack.params[0].input_size, states[0].igates.data());
+    for (int64_t l = 1; l < L; l++) {
+      states[l].igates.resize(B * G);
+    }
+    auto run_cell = [&](int64_t l, int64_t t) {
+      if (l == 0) {
+        run_step(0, 0, t, states[0].igates.data() + t * B * G);
+      } else {
+        scalar_t* igates = states[l].igates.data();
+        input_projection<scalar_t>(stack, stack.params[l], layer_output(l - 1) + t * B * H, B, H, igates);
+        run_step(l, 0, t, igates);
+      }
+    };
+    for (int64_t diagonal = 0; diagonal < T + L - 1; diagonal++) {
+      const int64_t l_begin = std::max<int64_t>(0, diagonal - T + 1);
+      const int64_t l_end = std::min<int64_t>(L, diagonal + 1);
+      if (l_end - l_begin == 1) {
+        // a single cell keeps all the threads for its GEMMs
+        run_cell(l_begin, diagonal - l_begin);
+        continue;
+      }
+      at::parallel_for(l_begin, l_end, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t l = begin; l < end; l++) {
+          run_cell(l, diagonal - l);
+        }
+      });
+    }
+  } else {
+    // the backward direction needs the last step of the previous layer
+    // first, so the layers run one after the other with both directions in
+    // parallel
+    for (int64_t l = 0; l < L; l++) {
+      const scalar_t* x = l == 0 ? input_data : layer_output(l - 1);
+      for (int64_t dir = 0; dir < D; dir++) {
+        auto& state = states[l * D + dir];
+        const auto& p = stack.params[l * D + dir];
+        state.igates.resize(T * B * G);
+        input_projection<scalar_t>(stack, p, x, T * B, p.input_size, state.igates.data());
+      }
+      at::parallel_for(0, D, 1, [&](int64_t begin, int64_t end) {
+        for (int64_t dir = begin; dir < end; dir++) {
+          const scalar_t* igates = states[l * D + dir].igates.data();
+          for (int64_t s = 0; s < T; s++) {
+            const int64_t t = dir == 0 ? s : T - 1 - s;
+            run_step(l, dir, t, igates + t * B * G);
+          }
+        }
+      });
+    }
+  }
+
+  for (int64_t l = 0; l < L; l++) {
+    for (int64_t dir = 0; dir < D; dir++) {
+      const int64_t last = dir == 0 ? T - 1 : 0;
+      hy[l * D + dir].copy_(layer_outputs[l][last].narrow(1, dir * H, H));
+    }
+  }
+}
+
+template <typename scalar_t>
+RNNStack<scalar_t> make_stack(
+    RNNMode mode, const Tensor& input, const Tensor& hx, TensorList params,
+    bool has_biases, int64_t num_layers, bool bidirectional) {
+  RNNStack<scalar_t> stack;
+  stack.mode = mode;
+  stack.seq_length = input.size(0);
+  stack.batch_size = input.size(1);
+  stack.hidden_size = hx.size(2);
+  stack.num_layers = num_layers;
+  stack.num_directions = bidirectional ? 2 : 1;
+  const int64_t stride = has_biases ? 4 : 2;
+  TORCH_CHECK((int64_t)params.size() == num_layers * stack.num_directions * stride,
+      "Expected ", num_layers * stack.num_directions * stride, " RNN parameters, but got ", params.size());
+  const int64_t G = stack.gate_size();
+  const int64_t H = stack.hidden_size;
+  for (size_t i = 0; i < params.size(); i += stride) {
+    const int64_t layer = i / stride / stack.num_directions;
+    DirectionParams<scalar_t> p;
+    Tensor w_ih = params[i].contiguous();
+    Tensor w_hh = params[i + 1].contiguous();
+    TORCH_CHECK(w_ih.dim() == 2 && w_ih.size(0) == G,
+        "Expected weight_ih of layer ", layer, " to have ", G, " rows, got size ", w_ih.sizes());
+    // the layers after the first one take the outputs of all the directions
+    // of the previous layer
+    TORCH_CHECK(layer == 0 || w_ih.size(1) == stack.num_directions * H,
+        "Expected weight_ih of layer ", layer, " to have ", stack.num_directions * H,
+        " columns, got size ", w_ih.sizes());
+    TORCH_CHECK(w_hh.dim() == 2 && w_hh.size(0) == G && w_hh.size(1) == H,
+        "Expected weight_hh of layer ", layer, " to have size [", G, ", ", H, "], got ", w_hh.sizes());
+    p.w_ih = w_ih.data_ptr<scalar_t>();
+    p.w_hh = w_hh.data_ptr<scalar_t>();
+    p.input_size = w_ih.size(1);
+    p.bias_ih = p.bias_hh = nullptr;
+    stack.storage.push_back(w_ih);
+    stack.storage.push_back(w_hh);
+    if (has_biases) {
+      Tensor b_ih = params[i + 2].contiguous();
+      Tensor b_hh = params[i + 3].contiguous();
+      TORCH_CHECK(b_ih.dim() == 1 && b_ih.size(0) == G && b_hh.dim() == 1 && b_hh.size(0) == G,
+          "Expected biases of layer ", layer, " to have size [", G, "], got ", b_ih.sizes(),
+          " and ", b_hh.sizes());
+      // both biases go into the input gates, but for the GRU
+      Tensor bias_ih = mode == RNNMode::GRU ? b_ih : b_ih + b_hh;
+      p.bias_ih = bias_ih.data_ptr<scalar_t>();
+      p.bias_hh = b_hh.data_ptr<scalar_t>();
+      stack.storage.push_back(bias_ih);
+      stack.storage.push_back(b_hh);
+    }
+    stack.params.push_back(p);
+  }
+  const int64_t expected_input_size = stack.params[0].input_size;
+  TORCH_CHECK(input.size(2) == expected_input_size,
+      "input.size(-1) must be equal to input_size. Expected ", expected_input_size, ", got ", input.size(2));
+  return stack;
+}
+
+void fused_rnn_cpu(
+    RNNMode mode, Tensor& output, Tensor& hy, Tensor& cy,
+    const Tensor& _input, const Tensor& hx, const Tensor& cx,
+    TensorList params, bool has_biases, int64_t num_layers,
+    bool bidirectional, bool batch_first) {
+  const Tensor input = (batch_first ? _input.transpose(0, 1) : _input).contiguous();
+  TORCH_CHECK(input.dim() == 3, "input must have 3 dimensions, got ", input.dim());
+  const int64_t num_directions = bidirectional ? 2 : 1;
+  TORCH_CHECK(hx.dim() == 3 && hx.size(0) == num_layers * num_directions && hx.size(1) == input.size(1),
+      "Expected hidden size (", num_layers * num_directions, ", ", input.size(1), ", *), got ", hx.sizes());
+  const Tensor hx_ = hx.contiguous();
+  output = at::empty({input.size(0), input.size(1), num_directions * hx.size(2)}, input.options());
+  hy = at::empty_like(hx_);
+  if (mode == RNNMode::LSTM) {
+    TORCH_CHECK(cx.sizes() == hx.sizes(), "Expected cell state of size ", hx.sizes(), ", got ", cx.sizes());
+    cy = at::empty_like(hx_);
+  }
+  if (input.size(0) == 0 || input.size(1) == 0 || hx.size(2) == 0) {
+    hy.copy_(hx_);
+    if (mode == RNNMode::LSTM) {
+      cy.copy_(cx);
+    }
+  } else {
+    AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "fused_rnn_cpu", [&] {
+      auto stack = make_stack<scalar_t>(mode, input, hx_, params, has_biases, num_layers, bidirectional);
+      run_stack<scalar_t>(stack, input, hx_, cx, output, hy, cy);
+    });
+  }
+  if (batch_first) {
+    output = output.transpose(0, 1);
+  }
+}
+
+void lstm_fused_cpu_kernel(
+    Tensor& output, Tensor& hy, Tensor& cy,
+    const Tensor& input, TensorList hx, TensorList params, bool has_biases,
+    int64_t num_layers, double dropout_p, bool train, bool bidirectional, bool batch_first) {
+  fused_rnn_cpu(RNNMode::LSTM, output, hy, cy, input, hx[0], hx[1], params, has_biases, num_layers, bidirectional, batch_first);
+}
+
+template <RNNMode mode>
+void rnn_fused_cpu_kernel(
+    Tensor& output, Tensor& hy,
+    const Tensor& input, const Tensor& hx, TensorList params, bool has_biases,
+    int64_t num_layers, double dropout_p, bool train, bool bidirectional, bool batch_first) {
+  Tensor cy;
+  fused_rnn_cpu(mode, output, hy, cy, input, hx, Tensor(), params, has_biases, num_layers, bidirectional, batch_first);
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(lstm_fused_cpu_stub, &lstm_fused_cpu_kernel);
+REGISTER_DISPATCH(gru_fused_cpu_stub, &rnn_fused_cpu_kernel<RNNMode::GRU>);
+REGISTER_DISPATCH(rnn_tanh_fused_cpu_stub, &rnn_fused_cpu_kernel<RNNMode::RNN_TANH>);
+REGISTER_DISPATCH(rnn_relu_fused_cpu_stub, &rnn_fused_cpu_kernel<RNNMode::RNN_RELU>);
+
+}} // namespace at::native
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <limits>
 #include <numeric>
 
 #include <ATen/Dispatch.h>
@@ -260,6 +261,134 @@ static void log_softmax_backward_lastdim_kernel_impl(
       });
 }
 
+// Cross entropy of the rows of logits [N, C] against target [N], which the
+// caller has checked and where ignored rows have a weight of 0. A row is read
+// once, in chunks: the running max and sum of exponentials are rescaled when a
+// chunk raises the max, so nothing of size C is ever written.
+template <typename scalar_t>
+inline void _vec_cross_entropy_forward(
+    scalar_t* losses_data,
+    scalar_t* logsumexp_data,
+    const scalar_t* logits_data,
+    const int64_t* target_data,
+    const scalar_t* row_weights_data,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  static constexpr int64_t CHUNK_SIZE = 16 * 1024 / sizeof(scalar_t);
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(0, outer_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* row = const_cast<scalar_t*>(logits_data + i * dim_size);
+      scalar_t max_input = -std::numeric_limits<scalar_t>::infinity();
+      scalar_t tmp_sum = 0;
+      for (int64_t d = 0; d < dim_size; d += CHUNK_SIZE) {
+        const int64_t size = std::min(CHUNK_SIZE, dim_size - d);
+        const scalar_t chunk_max = vec256::reduce_all<scalar_t>(
+            [](Vec& x, Vec& y) { return vec256::maximum(x, y); },
+            row + d,
+            size);
+        if (chunk_max > max_input) {
+          tmp_sum *= std::exp(max_input - chunk_max);
+          max_input = chunk_max;
+        } else if (std::isnan(chunk_max)) {
+          max_input = chunk_max;
+        }
+        if (max_input == -std::numeric_limits<scalar_t>::infinity())
+          continue;
+        tmp_sum += vec256::map_reduce_all<scalar_t>(
+            [max_input](Vec x) { return (x - Vec(max_input)).exp(); },
+            [](Vec x, Vec y) { return x + y; },
+            row + d,
+            size);
+      }
+      const scalar_t logsumexp = max_input + std::log(tmp_sum);
+      logsumexp_data[i] = logsumexp;
+      const scalar_t weight = row_weights_data[i];
+      losses_data[i] =
+          weight == 0 ? scalar_t(0) : weight * (logsumexp - row[target_data[i]]);
+    }
+  });
+}
+
+// grad_input = row_scale * (softmax(logits) - one_hot(target)), one pass over
+// every row.
+template <typename scalar_t>
+inline void _vec_cross_entropy_backward(
+    scalar_t* grad_input_data,
+    const scalar_t* row_scale_data,
+    const scalar_t* logits_data,
+    const int64_t* target_data,
+    const scalar_t* logsumexp_data,
+    int64_t outer_size,
+    int64_t dim_size) {
+  using Vec = vec256::Vec256<scalar_t>;
+  int64_t grain_size = internal::GRAIN_SIZE / (16 * dim_size);
+  if (grain_size < 1)
+    grain_size = 1;
+
+  parallel_for(0, outer_size, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_t* grad_input = grad_input_data + i * dim_size;
+      const scalar_t scale = row_scale_data[i];
+      if (scale == 0) {
+        std::fill(grad_input, grad_input + dim_size, scalar_t(0));
+        continue;
+      }
+      const scalar_t logsumexp = logsumexp_data[i];
+      vec256::map(
+          [scale, logsumexp](Vec x) {
+            return Vec(scale) * (x - Vec(logsumexp)).exp();
+          },
+          grad_input,
+          logits_data + i * dim_size,
+          dim_size);
+      grad_input[target_data[i]] -= scale;
+    }
+  });
+}
+
+static void cross_entropy_forward_kernel_impl(
+    Tensor& losses,
+    Tensor& logsumexp,
+    const Tensor& logits,
+    const Tensor& target,
+    const Tensor& row_weights) {
+  AT_DISPATCH_FLOATING_TYPES(
+      logits.scalar_type(), "cross_entropy_forward_kernel_impl", [&] {
+        _vec_cross_entropy_forward<scalar_t>(
+            losses.data_ptr<scalar_t>(),
+            logsumexp.data_ptr<scalar_t>(),
+            logits.data_ptr<scalar_t>(),
+            target.data_ptr<int64_t>(),
+            row_weights.data_ptr<scalar_t>(),
+            logits.size(0),
+            logits.size(1));
+      });
+}
+
+static void cross_entropy_backward_kernel_impl(
+    Tensor& grad_input,
+    const Tensor& row_scale,
+    const Tensor& logits,
+    const Tensor& target,
+    const Tensor& logsumexp) {
+  AT_DISPATCH_FLOATING_TYPES(
+      logits.scalar_type(), "cross_entropy_backward_kernel_impl", [&] {
+        _vec_cross_entropy_backward<scalar_t>(
+            grad_input.data_ptr<scalar_t>(),
+            row_scale.data_ptr<scalar_t>(),
+            logits.data_ptr<scalar_t>(),
+            target.data_ptr<int64_t>(),
+            logsumexp.data_ptr<scalar_t>(),
+            logits.size(0),
+            logits.size(1));
+      });
+}
+
 } // anonymous namespace
 
 REGISTER_DISPATCH(softmax_lastdim_kernel, &softmax_lastdim_kernel_impl);
@@ -270,5 +399,7 @@ REGISTER_DISPATCH(
 REGISTER_DISPATCH(
     log_softmax_backward_lastdim_kernel,
     &log_softmax_backward_lastdim_kernel_impl);
+REGISTER_DISPATCH(cross_entropy_forward_kernel, &cross_entropy_forward_kernel_impl);
+REGISTER_DISPATCH(cross_entropy_backward_kernel, &cross_entropy_backward_kernel_impl);
 
 }} // namespace at::native
@@ -8,11 +8,17 @@ namespace native {
 
 using forward_fn = void(*)(Tensor &, const Tensor &);
 using backward_fn = void(*)(Tensor &, const Tensor &, const Tensor&);
+// (losses, logsumexp, logits, target, row_weights)
+using cross_entropy_forward_fn = void(*)(Tensor &, Tensor &, const Tensor &, const Tensor &, const Tensor &);
+// (grad_input, row_scale, logits, target, logsumexp)
+using cross_entropy_backward_fn = void(*)(Tensor &, const Tensor &, const Tensor &, const Tensor &, const Tensor &);
 
 DECLARE_DISPATCH(forward_fn, softmax_lastdim_kernel);
 DECLARE_DISPATCH(forward_fn, log_softmax_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, softmax_backward_lastdim_kernel);
 DECLARE_DISPATCH(backward_fn, log_softmax_backward_lastdim_kernel);
+DECLARE_DISPATCH(cross_entropy_forward_fn, cross_entropy_forward_kernel);
+DECLARE_DISPATCH(cross_entropy_backward_fn, cross_entropy_backward_kernel);
 
 }
 }
@@ -5,10 +5,332 @@
 #include <ATen/native/Sorting.h>
 #include <ATen/native/SortingUtils.h>
 
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
 namespace at { namespace native {
 
 namespace {
 
+// A slice with at least this many elements is sorted by several threads when
+// there are fewer slices than threads. Otherwise every thread sorts whole
+// slices.
+constexpr int64_t kParallelSortMinSize = 1 << 16;
+
+// 8 byte keys take 8 radix passes, below this size the merge sort touches
+// the data fewer times.
+constexpr int64_t kRadixSortMinSize8Bytes = 1 << 22;
+
+constexpr int kRadixBits = 8;
+constexpr int64_t kRadixBuckets = 1 << kRadixBits;
+
+int64_t num_sort_chunks(int64_t n) {
+  return std::max<int64_t>(
+      1, std::min<int64_t>(at::get_num_threads(), n / at::internal::GRAIN_SIZE));
+}
+
+// Offset of the `slice`-th slice of `t` along `dim`, the slices are numbered
+// in row-major order of the other dimensions.
+int64_t slice_offset(const Tensor& t, int64_t dim, int64_t slice) {
+  int64_t offset = 0;
+  for (int64_t d = t.dim() - 1; d >= 0; d--) {
+    if (d != dim) {
+      offset += (slice % t.size(d)) * t.stride(d);
+      slice /= t.size(d);
+    }
+  }
+  return offset;
+}
+
+// we want NaN to be sorted as top for numpy compatibility
+template <typename scalar_t>
+struct KeyValueCompAsc {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  bool operator()(const elem_t& x, const elem_t& y) const {
+    return ((!_isnan<scalar_t>(x.first) && _isnan<scalar_t>(y.first)) || (x.first < y.first));
+  }
+};
+
+template <typename scalar_t>
+struct KeyValueCompDesc {
+  using elem_t = std::pair<scalar_t, int64_t>;
+  bool operator()(const elem_t& x, const elem_t& y) const {
+    return ((_isnan<scalar_t>(x.first) && !_isnan<scalar_t>(y.first)) || (x.first > y.first));
+  }
+};
+
+// Maps a value to an unsigned integer with the same order, so that values
+// can be sorted digit by digit. All NaNs map to the largest key.
+template <typename scalar_t, typename Enable = void>
+struct RadixKey;
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<std::is_integral<scalar_t>::value>::type> {
+  using type = typename std::make_unsigned<scalar_t>::type;
+  static type encode(scalar_t value) {
+    // flipping the sign bit orders negative values before positive ones
+    return std::is_signed<scalar_t>::value
+        ? static_cast<type>(value) ^ (type(1) << (sizeof(type) * 8 - 1))
+        : static_cast<type>(value);
+  }
+};
+
+template <typename scalar_t>
+struct RadixKey<scalar_t, typename std::enable_if<std::is_floating_point<scalar_t>::value>::type> {
+  using type = typename std::conditional<sizeof(scalar_t) == 4, uint32_t, uint64_t>::type;
+  static type encode(scalar_t value) {
+    constexpr type sign_bit = type(1) << (sizeof(type) * 8 - 1);
+    if (_isnan<scalar_t>(value)) {
+      return ~type(0);
+    }
+    type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // negative values are ordered by decreasing magnitude
+    return (bits & sign_bit) ? ~bits : bits ^ sign_bit;
+  }
+};
+
+// Stable LSD radix sort of `keys`, the same permutation is applied to
+// `indices`. Every chunk of the input is counted and scattered by one
+// thread, a pass is skipped when all keys share its digit.
+template <typename key_t>
+void parallel_radix_sort(std::vector<key_t>& keys, std::vector<int64_t>& indices, int64_t num_chunks) {
+  const int64_t n = keys.size();
+  const int64_t chunk_size = at::divup(n, num_chunks);
+  std::vector<key_t> keys_tmp(n);
+  std::vector<int64_t> indices_tmp(n);
+  // offsets[c * kRadixBuckets + d] counts, then places, the keys of chunk `c`
+  // with digit `d`
+  std::vector<int64_t> offsets(num_chunks * kRadixBuckets);
+  for (size_t shift = 0; shift < sizeof(key_t) * 8; shift += kRadixBits) {
+    auto digit = [shift](key_t key) -> int64_t {
+      return (key >> shift) & (kRadixBuckets - 1);
+    };
+    std::fill(offsets.begin(), offsets.end(), 0);
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* histogram = offsets.data() + c * kRadixBuckets;
+        for (int64_t i = c * chunk_size; i < std::min(n, (c + 1) * chunk_size); i++) {
+          histogram[digit(keys[i])]++;
+        }
+      }
+    });
+
+    int64_t offset = 0;
+    bool single_digit = false;
+    for (int64_t d = 0; d < kRadixBuckets && !single_digit; d++) {
+      int64_t count = 0;
+      for (int64_t c = 0; c < num_chunks; c++) {
+        count += offsets[c * kRadixBuckets + d];
+      }
+      single_digit = count == n;
+    }
+    if (single_digit) {
+      continue;
+    }
+    for (int64_t d = 0; d < kRadixBuckets; d++) {
+      for (int64_t c = 0; c < num_chunks; c++) {
+        const int64_t count = offsets[c * kRadixBuckets + d];
+        offsets[c * kRadixBuckets + d] = offset;
+        offset += count;
+      }
+    }
+
+    at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t c = begin; c < end; c++) {
+        int64_t* positions = offsets.data() + c * kRadixBuckets;
+        for (int64_t i = c * chunk_size; i < std::min(n, (c + 1) * chunk_size); i++) {
+          const int64_t position = positions[digit(keys[i])]++;
+          keys_tmp[position] = keys[i];
+          indices_tmp[position] = indices[i];
+        }
+      }
+    });
+    keys.swap(keys_tmp);
+    indices.swap(indices_tmp);
+  }
+}
+
+// Returns the positions of the `n` elements of a strided slice in sorted
+// order, using all threads. Keys of up to 4 bytes and very large slices are
+// radix sorted, other slices are merge sorted.
+template <typename scalar_t>
+std::vector<int64_t> parallel_argsort(const scalar_t* data, int64_t stride, int64_t n, bool descending) {
+  const int64_t num_chunks = num_sort_chunks(n);
+  std::vector<int64_t> order(n);
+  if (sizeof(scalar_t) < 8 || n >= kRadixSortMinSize8Bytes) {
+    using key_t = typename RadixKey<scalar_t>::type;
+    std::vector<key_t> keys(n);
+    at::parallel_for(0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        const key_t key = RadixKey<scalar_t>::encode(data[i * stride]);
+        keys[i] = descending ? ~key : key;
+        order[i] = i;
+      }
+    });
+    parallel_radix_sort(keys, order, num_chunks);
+  } else {
+    using elem_t = std::pair<scalar_t, int64_t>;
+    std::vector<elem_t> elems(n);
+    at::parallel_for(0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        elems[i] = std::make_pair(data[i * stride], i);
+      }
+    });
+    if (descending) {
+      parallel_merge_sort(elems.begin(), elems.end(), num_chunks, KeyValueCompDesc<scalar_t>());
+    } else {
+      parallel_merge_sort(elems.begin(), elems.end(), num_chunks, KeyValueCompAsc<scalar_t>());
+    }
+    at::parallel_for(0, n, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        order[i] = elems[i].second;
+      }
+    });
+  }
+  return order;
+}
+
+// Writes the first `count` elements of `order` and the values they point to.
+template <typename scalar_t>
+void write_ordered(
+    const std::vector<int64_t>& order,
+    int64_t count,
+    const scalar_t* data,
+    int64_t stride,
+    scalar_t* values_data,
+    int64_t values_stride,
+    int64_t* indices_data,
+    int64_t indices_stride) {
+  at::parallel_for(0, count, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      values_data[i * values_stride] = data[order[i] * stride];
+      indices_data[i * indices_stride] = order[i];
+    }
+  });
+}
+
+static void sort_kernel(
+    Tensor& values,
+    Tensor& indices,
+    const Tensor& self,
+    int64_t dim,
+    bool descending) {
+  const int64_t n = self.size(dim);
+  const int64_t num_slices = self.numel() / n;
+  const int64_t self_stride = self.stride(dim);
+  const int64_t values_stride = values.stride(dim);
+  const int64_t indices_stride = indices.stride(dim);
+  AT_DISPATCH_ALL_TYPES(self.scalar_type(), "sort_cpu", [&] {
+    const scalar_t* self_data = self.data_ptr<scalar_t>();
+    scalar_t* values_data = values.data_ptr<scalar_t>();
+    int64_t* indices_data = indices.data_ptr<int64_t>();
+
+    if (n >= kParallelSortMinSize && num_slices < at::get_num_threads()) {
+      for (int64_t slice = 0; slice < num_slices; slice++) {
+        const scalar_t* data = self_data + slice_offset(self, dim, slice);
+        std::vector<int64_t> order = parallel_argsort(data, self_stride, n, descending);
+        write_ordered(
+            order, n, data, self_stride,
+            values_data + slice_offset(values, dim, slice), values_stride,
+            indices_data + slice_offset(indices, dim, slice), indices_stride);
+      }
+      return;
+    }
+
+    using elem_t = std::pair<scalar_t, int64_t>;
+    at::parallel_for(0, num_slices, std::max<int64_t>(1, at::internal::GRAIN_SIZE / n), [&](int64_t begin, int64_t end) {
+      std::vector<elem_t> elems(n);
+      for (int64_t slice = begin; slice < end; slice++) {
+        const scalar_t* data = self_data + slice_offset(self, dim, slice);
+        for (int64_t i = 0; i < n; i++) {
+          elems[i] = std::make_pair(data[i * self_stride], i);
+        }
+        if (descending) {
+          std::sort(elems.begin(), elems.end(), KeyValueCompDesc<scalar_t>());
+        } else {
+          std::sort(elems.begin(), elems.end(), KeyValueCompAsc<scalar_t>());
+        }
+        scalar_t* values_slice = values_data + slice_offset(values, dim, slice);
+        int64_t* indices_slice = indices_data + slice_offset(indices, dim, slice);
+        for (int64_t i = 0; i < n; i++) {
+          values_slice[i * values_stride] = elems[i].first;
+          indices_slice[i * indices_stride] = elems[i].second;
+        }
+      }
+    });
+  });
+}
+
+// Top k of a single large slice. Every thread selects the top k of its
+// chunk, then the top k of these candidates are selected. When k is too
+// large for this to discard much, the slice is sorted instead.
+template <typename scalar_t>
+void parallel_topk_slice(
+    const scalar_t* data,
+    int64_t stride,
+    int64_t n,
+    int64_t k,
+    bool largest,
+    bool sorted,
+    scalar_t* values_data,
+    int64_t values_stride,
+    int64_t* indices_data,
+    int64_t indices_stride) {
+  const int64_t num_chunks = num_sort_chunks(n);
+  if (k * num_chunks * 2 > n) {
+    std::vector<int64_t> order = parallel_argsort(data, stride, n, largest);
+    write_ordered(order, k, data, stride, values_data, values_stride, indices_data, indices_stride);
+    return;
+  }
+
+  using elem_t = std::pair<scalar_t, int64_t>;
+  const int64_t chunk_size = at::divup(n, num_chunks);
+  std::vector<std::vector<elem_t>> chunk_candidates(num_chunks);
+  at::parallel_for(0, num_chunks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      const int64_t chunk_begin = std::min(n, c * chunk_size);
+      const int64_t chunk_end = std::min(n, chunk_begin + chunk_size);
+      std::vector<elem_t>& chunk = chunk_candidates[c];
+      chunk.resize(chunk_end - chunk_begin);
+      for (int64_t i = chunk_begin; i < chunk_end; i++) {
+        chunk[i - chunk_begin] = std::make_pair(data[i * stride], i);
+      }
+      const int64_t chunk_k = std::min<int64_t>(k, chunk.size());
+      if (chunk_k > 0 && chunk_k < static_cast<int64_t>(chunk.size())) {
+        if (largest) {
+          std::nth_element(chunk.begin(), chunk.begin() + chunk_k - 1, chunk.end(), KeyValueCompDesc<scalar_t>());
+        } else {
+          std::nth_element(chunk.begin(), chunk.begin() + chunk_k - 1, chunk.end(), KeyValueCompAsc<scalar_t>());
+        }
+      }
+      chunk.resize(chunk_k);
+    }
+  });
+  std::vector<elem_t> candidates;
+  candidates.reserve(num_chunks * k);
+  for (const auto& chunk : chunk_candidates) {
+    candidates.insert(candidates.end(), chunk.begin(), chunk.end());
+  }
+
+  if (largest) {
+    std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), KeyValueCompDesc<scalar_t>());
+    if (sorted) {
+      parallel_merge_sort(candidates.begin(), candidates.begin() + k, num_sort_chunks(k), KeyValueCompDesc<scalar_t>());
+    }
+  } else {
+    std::nth_element(candidates.begin(), candidates.begin() + k - 1, candidates.end(), KeyValueCompAsc<scalar_t>());
+    if (sorted) {
+      parallel_merge_sort(candidates.begin(), candidates.begin() + k, num_sort_chunks(k), KeyValueCompAsc<scalar_t>());
+    }
+  }
+  for (int64_t i = 0; i < k; i++) {
+    values_data[i * values_stride] = candidates[i].first;
+    indices_data[i * indices_stride] = candidates[i].second;
+  }
+}
+
 static void topk_kernel(
     Tensor& values,
     Tensor& indices,
@@ -17,6 +339,23 @@ static void topk_kernel(
     int64_t dim,
     bool largest,
     bool sorted) {
+  const int64_t n = self.dim() > 0 ? self.size(dim) : 1;
+  if (k == 0 || n == 0) {
+    return;
+  }
+  const int64_t num_slices = self.numel() / n;
+  if (n >= kParallelSortMinSize && num_slices < at::get_num_threads()) {
+    AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
+      for (int64_t slice = 0; slice < num_slices; slice++) {
+        parallel_topk_slice(
+            self.data_ptr<scalar_t>() + slice_offset(self, dim, slice), self.stride(dim), n, k, largest, sorted,
+            values.data_ptr<scalar_t>() + slice_offset(values, dim, slice), values.stride(dim),
+            indices.data_ptr<int64_t>() + slice_offset(indices, dim, slice), indices.stride(dim));
+      }
+    });
+    return;
+  }
+
   AT_DISPATCH_ALL_TYPES(self.scalar_type(), "topk_cpu", [&] {
     dim_apply(
         {self, values, indices},
@@ -85,6 +424,7 @@ static void topk_kernel(
 
 } // anonymous namespace
 
+REGISTER_DISPATCH(sort_stub, &sort_kernel);
 REGISTER_DISPATCH(topk_stub, &topk_kernel);
 
 }} //at::native
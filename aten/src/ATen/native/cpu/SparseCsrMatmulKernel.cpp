@@ -0,0 +1,114 @@
+#include <ATen/native/SparseCsrMatmul.h>
+
+#include <algorithm>
+
+#include <ATen/AccumulateType.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/functional.h>
+#include <ATen/cpu/vec256/vec256.h>
+
+namespace at { namespace native {
+namespace {
+
+// Rows are split evenly between the threads, the cost of a row is estimated
+// from the average number of entries per row.
+int64_t row_grain_size(int64_t rows, int64_t nnz, int64_t row_width) {
+  const int64_t row_cost =
+      std::max<int64_t>(1, nnz / std::max<int64_t>(rows, 1)) * std::max<int64_t>(row_width, 1);
+  return std::max<int64_t>(1, at::internal::GRAIN_SIZE / row_cost);
+}
+
+// y += a * x
+template <typename scalar_t>
+inline void axpy(int64_t n, scalar_t a, scalar_t* x, int64_t incx, scalar_t* y, int64_t incy) {
+  if (incx == 1 && incy == 1) {
+    using Vec = vec256::Vec256<scalar_t>;
+    const Vec a_vec(a);
+    vec256::map2(
+        [a_vec](Vec x_vec, Vec y_vec) { return y_vec + a_vec * x_vec; },
+        y, x, y, n);
+  } else {
+    for (int64_t i = 0; i < n; i++) {
+      y[i * incy] += a * x[i * incx];
+    }
+  }
+}
+
+void spmm_sparse_csr_kernel(
+    Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& dense,
+    Scalar alpha) {
+  const int64_t rows = result.size(0);
+  const int64_t n = result.size(1);
+  const int64_t cols = dense.size(0);
+  const int64_t* crow = crow_indices.data_ptr<int64_t>();
+  const int64_t* col = col_indices.data_ptr<int64_t>();
+  AT_DISPATCH_ALL_TYPES(values.scalar_type(), "spmm_sparse_csr", [&] {
+    const scalar_t cast_alpha = alpha.to<scalar_t>();
+    const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+    scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+    scalar_t* result_ptr = result.data_ptr<scalar_t>();
+    const int64_t dense_stride0 = dense.stride(0);
+    const int64_t dense_stride1 = dense.stride(1);
+    const int64_t result_stride0 = result.stride(0);
+    const int64_t result_stride1 = result.stride(1);
+    // Every thread owns whole rows of the result, so the rows of the dense
+    // matrix are accumulated into it without any synchronization.
+    at::parallel_for(0, rows, row_grain_size(rows, values.numel(), n), [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        scalar_t* result_row = result_ptr + row * result_stride0;
+        for (int64_t i = crow[row]; i < crow[row + 1]; i++) {
+          const int64_t c = col[i];
+          TORCH_CHECK(c >= 0 && c < cols,
+              "addmm: index out of column bound: ", c, " not between 0 and ", cols);
+          axpy<scalar_t>(n, cast_alpha * values_ptr[i],
+              dense_ptr + c * dense_stride0, dense_stride1,
+              result_row, result_stride1);
+        }
+      }
+    });
+  });
+}
+
+void spmv_sparse_csr_kernel(
+    Tensor& result,
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    const Tensor& vec) {
+  const int64_t rows = result.size(0);
+  const int64_t cols = vec.size(0);
+  const int64_t* crow = crow_indices.data_ptr<int64_t>();
+  const int64_t* col = col_indices.data_ptr<int64_t>();
+  AT_DISPATCH_ALL_TYPES(values.scalar_type(), "spmv_sparse_csr", [&] {
+    using acc_t = acc_type<scalar_t, /*is_cuda=*/false>;
+    const scalar_t* values_ptr = values.data_ptr<scalar_t>();
+    const scalar_t* vec_ptr = vec.data_ptr<scalar_t>();
+    scalar_t* result_ptr = result.data_ptr<scalar_t>();
+    const int64_t vec_stride = vec.stride(0);
+    const int64_t result_stride = result.stride(0);
+    at::parallel_for(0, rows, row_grain_size(rows, values.numel(), 1), [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        acc_t sum = 0;
+        for (int64_t i = crow[row]; i < crow[row + 1]; i++) {
+          const int64_t c = col[i];
+          TORCH_CHECK(c >= 0 && c < cols,
+              "mv: index out of column bound: ", c, " not between 0 and ", cols);
+          sum += static_cast<acc_t>(values_ptr[i]) * vec_ptr[c * vec_stride];
+        }
+        result_ptr[row * result_stride] = static_cast<scalar_t>(sum);
+      }
+    });
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(spmm_sparse_csr_stub, &spmm_sparse_csr_kernel);
+REGISTER_DISPATCH(spmv_sparse_csr_stub, &spmv_sparse_csr_kernel);
+
+}} // namespace at::native
@@ -0,0 +1,327 @@
+#include <ATen/native/WinogradConvolution.h>
+
+#include <algorithm>
+#include <vector>
+
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <TH/THBlasUtils.h>
+
+namespace at { namespace native {
+namespace {
+
+using namespace vec256;
+
+// Winograd F(m x m, 3x3) computes an m x m output tile from an
+// alpha x alpha input tile, alpha = m + 2:
+//
+//   Y = A^T [(G g G^T) * (B^T d B)] A
+//
+// where `*` is the elementwise product. Summed over the input channels, the
+// elementwise products become alpha * alpha independent GEMMs.
+template <int m>
+struct WinogradTransform;
+
+template <>
+struct WinogradTransform<2> {
+  static constexpr int alpha = 4;
+  static double BT(int i, int j) {
+    static constexpr double kBT[4][4] = {
+        {1, 0, -1, 0},
+        {0, 1, 1, 0},
+        {0, -1, 1, 0},
+        {0, 1, 0, -1}};
+    return kBT[i][j];
+  }
+  static double G(int i, int j) {
+    static constexpr double kG[4][3] = {
+        {1, 0, 0},
+        {0.5, 0.5, 0.5},
+        {0.5, -0.5, 0.5},
+        {0, 0, 1}};
+    return kG[i][j];
+  }
+  static double AT(int i, int j) {
+    static constexpr double kAT[2][4] = {
+        {1, 1, 1, 0},
+        {0, 1, -1, -1}};
+    return kAT[i][j];
+  }
+};
+
+template <>
+struct WinogradTransform<4> {
+  static constexpr int alpha = 6;
+  static double BT(int i, int j) {
+    static constexpr double kBT[6][6] = {
+        {4, 0, -5, 0, 1, 0},
+        {0, -4, -4, 1, 1, 0},
+        {0, 4, -4, -1, 1, 0},
+        {0, -2, -1, 2, 1, 0},
+        {0, 2, -1, -2, 1, 0},
+        {0, 4, 0, -5, 0, 1}};
+    return kBT[i][j];
+  }
+  static double G(int i, int j) {
+    static constexpr double kG[6][3] = {
+        {1.0 / 4, 0, 0},
+        {-1.0 / 6, -1.0 / 6, -1.0 / 6},
+        {-1.0 / 6, 1.0 / 6, -1.0 / 6},
+        {1.0 / 24, 1.0 / 12, 1.0 / 6},
+        {1.0 / 24, -1.0 / 12, 1.0 / 6},
+        {0, 0, 1}};
+    return kG[i][j];
+  }
+  static double AT(int i, int j) {
+    static constexpr double kAT[4][6] = {
+        {1, 1, 1, 1, 1, 0},
+        {0, 1, -1, 2, -2, 0},
+        {0, 1, 1, 4, 4, 0},
+        {0, 1, -1, 8, -8, 1}};
+    return kAT[i][j];
+  }
+};
+
+// The transformed inputs and outputs of a block of tiles should stay in the
+// L2 cache between the transforms and the GEMMs.
+constexpr int64_t kBlockBytes = 256 * 1024;
+
+// U[xi][k][c] = (G g[k][c] G^T)[xi]
+template <typename scalar_t, int m>
+void transform_weight(scalar_t* U, const scalar_t* weight, int64_t K, int64_t C) {
+  using T = WinogradTransform<m>;
+  constexpr int alpha = T::alpha;
+  at::parallel_for(0, K * C, at::internal::GRAIN_SIZE / (alpha * alpha * 3), [&](int64_t begin, int64_t end) {
+    for (int64_t kc = begin; kc < end; kc++) {
+      const scalar_t* g = weight + kc * 9;
+      scalar_t tmp[alpha][3];
+      for (int i = 0; i < alpha; i++) {
+        for (int j = 0; j < 3; j++) {
+          tmp[i][j] = T::G(i, 0) * g[j] + T::G(i, 1) * g[3 + j] + T::G(i, 2) * g[6 + j];
+        }
+      }
+      for (int i = 0; i < alpha; i++) {
+        for (int j = 0; j < alpha; j++) {
+          U[(i * alpha + j) * K * C + kc] =
+              tmp[i][0] * T::G(j, 0) + tmp[i][1] * T::G(j, 1) + tmp[i][2] * T::G(j, 2);
+        }
+      }
+    }
+  });
+}
+
+// V[xi][c][b] = (B^T d B)[xi] for the tiles d of the block, Vec::size()
+// tiles at a time.
+template <typename scalar_t, int m>
+void transform_input_block(
+    scalar_t* V,
+    const scalar_t* input,
+    int64_t C, int64_t H, int64_t W,
+    int64_t pad_h, int64_t pad_w,
+    int64_t tiles_w, int64_t tiles_per_image,
+    int64_t tile_begin, int64_t num_tiles, int64_t block_stride) {
+  using T = WinogradTransform<m>;
+  using Vec = Vec256<scalar_t>;
+  constexpr int alpha = T::alpha;
+  constexpr int lanes = Vec::size();
+  scalar_t buffer[alpha][alpha][lanes];
+  Vec d[alpha][alpha];
+  Vec t[alpha][alpha];
+  for (int64_t c = 0; c < C; c++) {
+    for (int64_t b0 = 0; b0 < num_tiles; b0 += lanes) {
+      const int64_t count = std::min<int64_t>(lanes, num_tiles - b0);
+      for (int lane = 0; lane < lanes; lane++) {
+        if (lane >= count) {
+          for (int i = 0; i < alpha; i++) {
+            for (int j = 0; j < alpha; j++) {
+              buffer[i][j][lane] = 0;
+            }
+          }
+          continue;
+        }
+        const int64_t tile = tile_begin + b0 + lane;
+        const int64_t n = tile / tiles_per_image;
+        const int64_t h0 = (tile % tiles_per_image) / tiles_w * m - pad_h;
+        const int64_t w0 = (tile % tiles_w) * m - pad_w;
+        const scalar_t* plane = input + (n * C + c) * H * W;
+        for (int i = 0; i < alpha; i++) {
+          const int64_t h = h0 + i;
+          for (int j = 0; j < alpha; j++) {
+            const int64_t w = w0 + j;
+            buffer[i][j][lane] = (h >= 0 && h < H && w >= 0 && w < W) ? plane[h * W + w] : scalar_t(0);
+          }
+        }
+      }
+      for (int i = 0; i < alpha; i++) {
+        for (int j = 0; j < alpha; j++) {
+          d[i][j] = Vec::loadu(buffer[i][j]);
+        }
+      }
+      // t = B^T d
+      for (int i = 0; i < alpha; i++) {
+        for (int j = 0; j < alpha; j++) {
+          Vec sum(0);
+          for (int k = 0; k < alpha; k++) {
+            if (T::BT(i, k) != 0) {
+              sum = sum + Vec(T::BT(i, k)) * d[k][j];
+            }
+          }
+          t[i][j] = sum;
+        }
+      }
+      // V = t B
+      for (int i = 0; i < alpha; i++) {
+        for (int j = 0; j < alpha; j++) {
+          Vec sum(0);
+          for (int k = 0; k < alpha; k++) {
+            if (T::BT(j, k) != 0) {
+              sum = sum + Vec(T::BT(j, k)) * t[i][k];
+            }
+          }
+          sum.store(V + ((i * alpha + j) * C + c) * block_stride + b0, count);
+        }
+      }
+    }
+  }
+}
+
+// output tiles = A^T M A (+ bias), Vec::size() tiles at a time.
+template <typename scalar_t, int m>
+void transform_output_block(
+    scalar_t* output,
+    const scalar_t* M,
+    const scalar_t* bias,
+    int64_t K, int64_t OH, int64_t OW,
+    int64_t tiles_w, int64_t tiles_per_image,
+    int64_t tile_begin, int64_t num_tiles, int64_t block_stride) {
+  using T = WinogradTransform<m>;
+  using Vec = Vec256<scalar_t>;
+  constexpr int alpha = T::alpha;
+  constexpr int lanes = Vec::size();
+  Vec s[m][alpha];
+  scalar_t buffer[m][m][lanes];
+  for (int64_t k = 0; k < K; k++) {
+    const scalar_t bias_k = bias ? bias[k] : scalar_t(0);
+    for (int64_t b0 = 0; b0 < num_tiles; b0 += lanes) {
+      const int64_t count = std::min<int64_t>(lanes, num_tiles - b0);
+      // s = A^T M
+      for (int i = 0; i < m; i++) {
+        for (int j = 0; j < alpha; j++) {
+          Vec sum(0);
+          for (int l = 0; l < alpha; l++) {
+            if (T::AT(i, l) != 0) {
+              const Vec x = Vec::loadu(M + ((l * alpha + j) * K + k) * block_stride + b0, count);
+              sum = sum + Vec(T::AT(i, l)) * x;
+            }
+          }
+          s[i][j] = sum;
+        }
+      }
+      // y = s A
+      for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+          Vec sum(bias_k);
+          for (int l = 0; l < alpha; l++) {
+            if (T::AT(j, l) != 0) {
+              sum = sum + Vec(T::AT(j, l)) * s[i][l];
+            }
+          }
+          sum.store(buffer[i][j]);
+        }
+      }
+      for (int lane = 0; lane < count; lane++) {
+        const int64_t tile = tile_begin + b0 + lane;
+        const int64_t n = tile / tiles_per_image;
+        const int64_t h0 = (tile % tiles_per_image) / tiles_w * m;
+        const int64_t w0 = (tile % tiles_w) * m;
+        scalar_t* plane = output + (n * K + k) * OH * OW;
+        for (int i = 0; i < m && h0 + i < OH; i++) {
+          for (int j = 0; j < m && w0 + j < OW; j++) {
+            plane[(h0 + i) * OW + w0 + j] = buffer[i][j][lane];
+          }
+        }
+      }
+    }
+  }
+}
+
+template <typename scalar_t, int m>
+void cpu_winograd_conv2d(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef padding) {
+  using T = WinogradTransform<m>;
+  constexpr int alpha = T::alpha;
+  const int64_t N = input.size(0);
+  const int64_t C = input.size(1);
+  const int64_t H = input.size(2);
+  const int64_t W = input.size(3);
+  const int64_t K = output.size(1);
+  const int64_t OH = output.size(2);
+  const int64_t OW = output.size(3);
+  const int64_t tiles_h = at::divup(OH, m);
+  const int64_t tiles_w = at::divup(OW, m);
+  const int64_t tiles_per_image = tiles_h * tiles_w;
+  const int64_t num_tiles = N * tiles_per_image;
+
+  const scalar_t* input_data = input.data_ptr<scalar_t>();
+  const scalar_t* bias_data = bias.defined() ? bias.data_ptr<scalar_t>() : nullptr;
+  scalar_t* output_data = output.data_ptr<scalar_t>();
+
+  std::vector<scalar_t> U(alpha * alpha * K * C);
+  transform_weight<scalar_t, m>(U.data(), weight.data_ptr<scalar_t>(), K, C);
+
+  // a multiple of the vector size, so that only the last block has a tail
+  constexpr int64_t lanes = Vec256<scalar_t>::size();
+  int64_t block_size = kBlockBytes / (alpha * alpha * (C + K) * sizeof(scalar_t));
+  block_size = std::max<int64_t>(lanes, std::min<int64_t>(256, block_size) / lanes * lanes);
+  const int64_t num_blocks = at::divup(num_tiles, block_size);
+
+  at::parallel_for(0, num_blocks, 1, [&](int64_t begin, int64_t end) {
+    std::vector<scalar_t> V(alpha * alpha * C * block_size);
+    std::vector<scalar_t> M(alpha * alpha * K * block_size);
+    for (int64_t block = begin; block < end; block++) {
+      const int64_t tile_begin = block * block_size;
+      const int64_t block_tiles = std::min(block_size, num_tiles - tile_begin);
+      transform_input_block<scalar_t, m>(
+          V.data(), input_data, C, H, W, padding[0], padding[1],
+          tiles_w, tiles_per_image, tile_begin, block_tiles, block_size);
+      // M[xi] = U[xi] V[xi], as column-major M[xi]^T = V[xi]^T U[xi]^T
+      for (int64_t xi = 0; xi < alpha * alpha; xi++) {
+        THBlas_gemm<scalar_t>(
+            'n', 'n', block_tiles, K, C,
+            scalar_t(1), V.data() + xi * C * block_size, block_size,
+            U.data() + xi * K * C, C,
+            scalar_t(0), M.data() + xi * K * block_size, block_size);
+      }
+      transform_output_block<scalar_t, m>(
+          output_data, M.data(), bias_data, K, OH, OW,
+          tiles_w, tiles_per_image, tile_begin, block_tiles, block_size);
+    }
+  });
+}
+
+void winograd_conv2d_kernel(
+    Tensor& output,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef padding,
+    int64_t output_tile) {
+  AT_DISPATCH_FLOATING_TYPES(input.scalar_type(), "winograd_conv2d", [&] {
+    if (output_tile == 4) {
+      cpu_winograd_conv2d<scalar_t, 4>(output, input, weight, bias, padding);
+    } else {
+      cpu_winograd_conv2d<scalar_t, 2>(output, input, weight, bias, padding);
+    }
+  });
+}
+
+} // anonymous namespace
+
+REGISTER_DISPATCH(winograd_conv2d_stub, &winograd_conv2d_kernel);
+
+}} // namespace at::native
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <c10/core/QEngine.h>
 #include <c10/core/QScheme.h>
 
 #ifdef USE_FBGEMM
@@ -16,6 +17,7 @@
 // (affine quantization) of input matrix.
 // Note that in JIT mode we can think of a way to fuse col_offsets with bias.
 struct FBGEMM_API PackedLinearWeight {
+  static constexpr c10::QEngine engine = c10::QEngine::FBGEMM;
   std::unique_ptr<fbgemm::PackBMatrix<int8_t>> w;
   std::vector<int32_t> col_offsets;
   double w_scale;
@@ -23,6 +25,7 @@ struct FBGEMM_API PackedLinearWeight {
 };
 
 struct FBGEMM_API PackedConvWeight {
+  static constexpr c10::QEngine engine = c10::QEngine::FBGEMM;
   std::unique_ptr<fbgemm::PackWeightsForConv<2>> w;
   std::vector<int32_t> col_offsets;
   std::vector<int64_t> kernel;
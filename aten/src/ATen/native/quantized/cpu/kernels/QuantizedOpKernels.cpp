@@ -0,0 +1,462 @@
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/Parallel.h>
+#include <ATen/cpu/vec256/vec256.h>
+#include <ATen/native/TensorIterator.h>
+#include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
+#include <ATen/quantized/Quantizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+using namespace vec256;
+
+void qrelu_kernel(const Tensor& qx, Tensor& qy) {
+  const auto zero_point = qx.q_zero_point();
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "qrelu", [&]() {
+    using Vec = Vec256<scalar_t>;
+    auto iter = TensorIterator::unary_op(qy, qx);
+    auto zero_point_vec = Vec(scalar_t(zero_point));
+    cpu_kernel_vec(
+        iter,
+        [&](scalar_t value) -> scalar_t {
+          return scalar_t(std::max<underlying_t>(value.val_, zero_point));
+        },
+        [&](Vec value) -> Vec { return value.relu(zero_point_vec); });
+  });
+}
+
+void qrelu6_kernel(const Tensor& qx, Tensor& qy) {
+  const auto zero_point = qx.q_zero_point();
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "qrelu6", [&]() {
+    using Vec = Vec256<scalar_t>;
+    auto iter = TensorIterator::unary_op(qy, qx);
+    scalar_t six =
+        at::quantize_val<scalar_t>(qx.q_scale(), qx.q_zero_point(), 6.0);
+    auto zero_point_vec = Vec(scalar_t(zero_point));
+    auto six_vec = Vec(six);
+    cpu_kernel_vec(
+        iter,
+        [&](scalar_t value) -> scalar_t {
+          underlying_t relu_val =
+              std::max<underlying_t>(value.val_, zero_point);
+          return scalar_t(std::min<underlying_t>(relu_val, six.val_));
+        },
+        [&](Vec value) -> Vec { return value.relu6(zero_point_vec, six_vec); });
+  });
+}
+
+// Dequantizes both operands, combines them in float with op and quantizes
+// the result with the parameters of out. The scalar and vector paths do the
+// same float arithmetic, so the result does not depend on where an element
+// falls relative to the vector width.
+template <bool ReLUFused, typename scalar_op_t, typename vec_op_t>
+void qbinary_kernel(
+    Tensor& out,
+    const Tensor& self,
+    const Tensor& other,
+    const scalar_op_t& scalar_op,
+    const vec_op_t& vec_op) {
+  const int32_t zero_point = out.q_zero_point();
+  const float scale = out.q_scale();
+  const int32_t self_zero_point = self.q_zero_point();
+  const float self_scale = self.q_scale();
+  const int32_t other_zero_point = other.q_zero_point();
+  const float other_scale = other.q_scale();
+
+  auto iter = TensorIterator::binary_op(out, self, other);
+  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qbinary", [&]() {
+    using Vec = Vec256<scalar_t>;
+    cpu_kernel_vec(
+        iter,
+        [&](scalar_t a, scalar_t b) -> scalar_t {
+          const float da =
+              dequantize_scalar<scalar_t>(a.val_, self_scale, self_zero_point);
+          const float db =
+              dequantize_scalar<scalar_t>(b.val_, other_scale, other_zero_point);
+          float c = scalar_op(da, db);
+          if (ReLUFused) {
+            c = std::max<float>(c, 0.0);
+          }
+          return scalar_t(quantize_scalar<scalar_t>(c, scale, zero_point));
+        },
+        [&](Vec a, Vec b) -> Vec {
+          const auto da = a.dequantize(self_scale, self_zero_point);
+          const auto db = b.dequantize(other_scale, other_zero_point);
+          Vec::float_vec_return_type c;
+          for (int i = 0; i < Vec::float_num_vecs(); ++i) {
+            c[i] = vec_op(da[i], db[i]);
+            if (ReLUFused) {
+              c[i] = vec256::maximum(c[i], Vec256<float>(0.0f));
+            }
+          }
+          return Vec::quantize(c, scale, zero_point);
+        });
+  });
+}
+
+template <bool ReLUFused>
+void qadd_kernel(Tensor& out, const Tensor& self, const Tensor& other) {
+  qbinary_kernel<ReLUFused>(
+      out,
+      self,
+      other,
+      [](float a, float b) { return a + b; },
+      [](const Vec256<float>& a, const Vec256<float>& b) { return a + b; });
+}
+
+template <bool ReLUFused>
+void qmul_kernel(Tensor& out, const Tensor& self, const Tensor& other) {
+  qbinary_kernel<ReLUFused>(
+      out,
+      self,
+      other,
+      [](float a, float b) { return a * b; },
+      [](const Vec256<float>& a, const Vec256<float>& b) { return a * b; });
+}
+
+// Max pooling of every plane of qx. For each output row the maximum over the
+// rows of the window is taken first, a vector of columns at a time; the
+// output values are then the maxima of those over the columns of the windows.
+void qmaxpool_2d_kernel(
+    const Tensor& qx,
+    int64_t nplanes,
+    int64_t iH,
+    int64_t iW,
+    int64_t oH,
+    int64_t oW,
+    int64_t kH,
+    int64_t kW,
+    int64_t sH,
+    int64_t sW,
+    int64_t pH,
+    int64_t pW,
+    int64_t dH,
+    int64_t dW,
+    Tensor& qy) {
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "max_pool2d", [&]() {
+    using Vec = Vec256<scalar_t>;
+    const auto* idata =
+        reinterpret_cast<const underlying_t*>(qx.data_ptr<scalar_t>());
+    auto* odata = reinterpret_cast<underlying_t*>(qy.data_ptr<scalar_t>());
+    const underlying_t lowest = std::numeric_limits<underlying_t>::lowest();
+    const Vec lowest_vec = Vec(scalar_t(lowest));
+
+    at::parallel_for(0, nplanes, 0, [&](int64_t start, int64_t end) {
+      std::vector<underlying_t> col_max(iW);
+      for (auto p = start; p < end; ++p) {
+        const underlying_t* i_p = idata + p * iH * iW;
+        underlying_t* o_p = odata + p * oH * oW;
+        for (int64_t row = 0; row < oH; ++row) {
+          int64_t h_start = row * sH - pH;
+          const int64_t h_end = std::min(h_start + (kH - 1) * dH + 1, iH);
+          while (h_start < 0) {
+            h_start += dH;
+          }
+
+          int64_t w = 0;
+          for (; w + Vec::size() <= iW; w += Vec::size()) {
+            Vec max_vec = lowest_vec;
+            for (int64_t y = h_start; y < h_end; y += dH) {
+              max_vec = max_vec.maximum(Vec::loadu(i_p + y * iW + w));
+            }
+            max_vec.store(col_max.data() + w);
+          }
+          for (; w < iW; ++w) {
+            underlying_t max_val = lowest;
+            for (int64_t y = h_start; y < h_end; y += dH) {
+              max_val = std::max(max_val, i_p[y * iW + w]);
+            }
+            col_max[w] = max_val;
+          }
+
+          for (int64_t col = 0; col < oW; ++col) {
+            int64_t w_start = col * sW - pW;
+            const int64_t w_end = std::min(w_start + (kW - 1) * dW + 1, iW);
+            while (w_start < 0) {
+              w_start += dW;
+            }
+            underlying_t max_val = lowest;
+            for (int64_t x = w_start; x < w_end; x += dW) {
+              max_val = std::max(max_val, col_max[x]);
+            }
+            o_p[row * oW + col] = max_val;
+          }
+        }
+      }
+    });
+  });
+}
+
+inline int start_index(int a, int b, int c) {
+  return (int)std::floor((float)(a * c) / b);
+}
+
+inline int end_index(int a, int b, int c) {
+  return (int)std::ceil((float)((a + 1) * c) / b);
+}
+
+// Adaptive average pooling, which like max pooling sums over the rows of a
+// window first. For 8 bit types with contiguous rows this is done on vectors
+// of int32 partial sums.
+void qadaptive_avg_pool2d_kernel(
+    const Tensor& qx,
+    Tensor& qy,
+    int64_t b,
+    int64_t sizeD,
+    int64_t isizeH,
+    int64_t isizeW,
+    int64_t osizeH,
+    int64_t osizeW,
+    int64_t istrideB,
+    int64_t istrideD,
+    int64_t istrideH,
+    int64_t istrideW) {
+  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "quantized_adaptive_avg_pool2d", [&]() {
+    using Vec = Vec256<scalar_t>;
+    using IntVec = Vec256<int32_t>;
+    const auto* idata =
+        reinterpret_cast<const underlying_t*>(qx.data_ptr<scalar_t>());
+    auto* odata = reinterpret_cast<underlying_t*>(qy.data_ptr<scalar_t>());
+    const bool vectorize = sizeof(underlying_t) == 1 && istrideW == 1;
+    const Vec zero_vec = Vec(scalar_t(0));
+
+    at::parallel_for(0, b * sizeD, 0, [&](int64_t start, int64_t end) {
+      std::vector<int64_t> col_sum(isizeW);
+      for (auto i = start; i < end; ++i) {
+        const underlying_t* i_p =
+            idata + (i / sizeD) * istrideB + (i % sizeD) * istrideD;
+        underlying_t* o_p = odata + i * osizeH * osizeW;
+        for (int64_t oh = 0; oh < osizeH; ++oh) {
+          int istartH = start_index(oh, osizeH, isizeH);
+          int iendH = end_index(oh, osizeH, isizeH);
+          int kH = iendH - istartH;
+          float kHr = 1.0 / kH;
+
+          int64_t iw = 0;
+          if (vectorize) {
+            for (; iw + Vec::size() <= isizeW; iw += Vec::size()) {
+              Vec::int_vec_return_type acc;
+              std::fill(acc.begin(), acc.end(), IntVec(0));
+              for (int ih = istartH; ih < iendH; ++ih) {
+                const auto vals =
+                    Vec::loadu(i_p + ih * istrideH + iw).widening_subtract(zero_vec);
+                for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+                  acc[j] = acc[j] + vals[j];
+                }
+              }
+              __at_align32__ int32_t sums[Vec::size()];
+              for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+                acc[j].store(sums + j * IntVec::size());
+              }
+              std::copy(sums, sums + Vec::size(), col_sum.begin() + iw);
+            }
+          }
+          for (; iw < isizeW; ++iw) {
+            int64_t sum = 0;
+            for (int ih = istartH; ih < iendH; ++ih) {
+              sum += i_p[ih * istrideH + iw * istrideW];
+            }
+            col_sum[iw] = sum;
+          }
+
+          for (int64_t ow = 0; ow < osizeW; ++ow) {
+            int istartW = start_index(ow, osizeW, isizeW);
+            int iendW = end_index(ow, osizeW, isizeW);
+            int kW = iendW - istartW;
+            float kHWr = kHr / kW;
+            int64_t sum = 0;
+            for (int w = istartW; w < iendW; ++w) {
+              sum += col_sum[w];
+            }
+            o_p[oh * osizeW + ow] =
+                static_cast<underlying_t>(std::nearbyint(sum * kHWr));
+          }
+        }
+      }
+    });
+  });
+}
+
+// Each slice of the result before dim is made of one slice of every input.
+// Inputs with the quantization parameters of the result are copied, the
+// others are requantized.
+template <bool ReLUFused>
+void qcat_kernel(const std::vector<Tensor>& qxs, int64_t dim, Tensor& qy) {
+  if (qy.numel() == 0) {
+    return;
+  }
+  const int32_t zero_point = qy.q_zero_point();
+  const float scale = qy.q_scale();
+  const int64_t outer_size = c10::size_to_dim_(dim, qy.sizes());
+  const int64_t out_slice_size = qy.numel() / outer_size;
+
+  std::vector<int64_t> slice_sizes, offsets;
+  int64_t offset = 0;
+  for (const auto& qx : qxs) {
+    slice_sizes.push_back(qx.numel() / outer_size);
+    offsets.push_back(offset);
+    offset += slice_sizes.back();
+  }
+
+  AT_DISPATCH_QINT_TYPES(qy.scalar_type(), "qcat", [&]() {
+    using Vec = Vec256<scalar_t>;
+    auto* odata = reinterpret_cast<underlying_t*>(qy.data_ptr<scalar_t>());
+    const Vec zero_point_vec = Vec(scalar_t(zero_point));
+    const int64_t grain_size =
+        std::max<int64_t>(1, at::internal::GRAIN_SIZE / out_slice_size);
+
+    at::parallel_for(0, outer_size, grain_size, [&](int64_t start, int64_t end) {
+      for (size_t i = 0; i < qxs.size(); ++i) {
+        const Tensor& qx = qxs[i];
+        const auto* idata =
+            reinterpret_cast<const underlying_t*>(qx.data_ptr<scalar_t>());
+        const int64_t n = slice_sizes[i];
+        const float x_scale = qx.q_scale();
+        const int32_t x_zero_point = qx.q_zero_point();
+        const bool copy = !ReLUFused && x_scale == scale && x_zero_point == zero_point;
+
+        for (auto o = start; o < end; ++o) {
+          const underlying_t* src = idata + o * n;
+          underlying_t* dst = odata + o * out_slice_size + offsets[i];
+          if (copy) {
+            std::memcpy(dst, src, n * sizeof(underlying_t));
+            continue;
+          }
+          int64_t j = 0;
+          for (; j + Vec::size() <= n; j += Vec::size()) {
+            auto qval = Vec::quantize(
+                Vec::loadu(src + j).dequantize(x_scale, x_zero_point),
+                scale,
+                zero_point);
+            if (ReLUFused) {
+              qval = qval.relu(zero_point_vec);
+            }
+            qval.store(dst + j);
+          }
+          for (; j < n; ++j) {
+            const underlying_t qval = quantize_scalar<scalar_t>(
+                dequantize_scalar<scalar_t>(src[j], x_scale, x_zero_point),
+                scale,
+                zero_point);
+            dst[j] = ReLUFused
+                ? std::max<underlying_t>(qval, zero_point)
+                : qval;
+          }
+        }
+      }
+    });
+  });
+}
+
+void quantize_tensor_per_channel_affine_kernel(
+    const Tensor& rtensor,
+    Tensor& qtensor,
+    const std::vector<double>& scales,
+    const std::vector<int64_t>& zero_points,
+    int64_t axis) {
+  const int64_t batches = c10::size_to_dim_(axis, rtensor.sizes());
+  const int64_t elements_per_channel =
+      c10::size_from_dim_(axis + 1, rtensor.sizes());
+  const int64_t channel = rtensor.size(axis);
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "quantize_tensor_per_channel_affine", [&]() {
+        using Vec = Vec256<scalar_t>;
+        const float* rdata = rtensor.data_ptr<float>();
+        auto* qdata = reinterpret_cast<underlying_t*>(qtensor.data_ptr<scalar_t>());
+        const int64_t grain_size =
+            std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, elements_per_channel));
+
+        at::parallel_for(0, batches * channel, grain_size, [&](int64_t start, int64_t end) {
+          for (auto bc = start; bc < end; ++bc) {
+            const int64_t c = bc % channel;
+            const float scale = scales[c];
+            const int32_t zero_point = zero_points[c];
+            const float* src = rdata + bc * elements_per_channel;
+            underlying_t* dst = qdata + bc * elements_per_channel;
+            int64_t e = 0;
+            for (; e + Vec::size() <= elements_per_channel; e += Vec::size()) {
+              Vec::float_vec_return_type vals;
+              for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+                vals[j] = Vec256<float>::loadu(src + e + j * Vec256<float>::size());
+              }
+              Vec::quantize(vals, scale, zero_point).store(dst + e);
+            }
+            for (; e < elements_per_channel; ++e) {
+              dst[e] = quantize_scalar<scalar_t>(src[e], scale, zero_point);
+            }
+          }
+        });
+      });
+}
+
+void dequantize_tensor_per_channel_affine_kernel(
+    const Tensor& qtensor,
+    Tensor& rtensor,
+    const std::vector<double>& scales,
+    const std::vector<int64_t>& zero_points,
+    int64_t axis) {
+  const int64_t batches = c10::size_to_dim_(axis, rtensor.sizes());
+  const int64_t elements_per_channel =
+      c10::size_from_dim_(axis + 1, rtensor.sizes());
+  const int64_t channel = rtensor.size(axis);
+  AT_DISPATCH_QINT_TYPES(
+      qtensor.scalar_type(), "dequantize_tensor_per_channel_affine", [&]() {
+        using Vec = Vec256<scalar_t>;
+        const auto* qdata =
+            reinterpret_cast<const underlying_t*>(qtensor.data_ptr<scalar_t>());
+        float* rdata = rtensor.data_ptr<float>();
+        const int64_t grain_size =
+            std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(1, elements_per_channel));
+
+        at::parallel_for(0, batches * channel, grain_size, [&](int64_t start, int64_t end) {
+          for (auto bc = start; bc < end; ++bc) {
+            const int64_t c = bc % channel;
+            const float scale = scales[c];
+            const int32_t zero_point = zero_points[c];
+            const underlying_t* src = qdata + bc * elements_per_channel;
+            float* dst = rdata + bc * elements_per_channel;
+            int64_t e = 0;
+            for (; e + Vec::size() <= elements_per_channel; e += Vec::size()) {
+              const auto vals = Vec::loadu(src + e).dequantize(scale, zero_point);
+              for (int j = 0; j < Vec::float_num_vecs(); ++j) {
+                vals[j].store(dst + e + j * Vec256<float>::size());
+              }
+            }
+            for (; e < elements_per_channel; ++e) {
+              dst[e] = dequantize_scalar<scalar_t>(src[e], scale, zero_point);
+            }
+          }
+        });
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(qrelu_stub, &qrelu_kernel);
+REGISTER_DISPATCH(qrelu6_stub, &qrelu6_kernel);
+REGISTER_DISPATCH(qadd_stub, &qadd_kernel<false>);
+REGISTER_DISPATCH(qadd_relu_stub, &qadd_kernel<true>);
+REGISTER_DISPATCH(qmul_stub, &qmul_kernel<false>);
+REGISTER_DISPATCH(qmul_relu_stub, &qmul_kernel<true>);
+REGISTER_DISPATCH(qmaxpool_2d_stub, &qmaxpool_2d_kernel);
+REGISTER_DISPATCH(qadaptive_avg_pool2d_stub, &qadaptive_avg_pool2d_kernel);
+REGISTER_DISPATCH(qcat_stub, &qcat_kernel<false>);
+REGISTER_DISPATCH(qcat_relu_stub, &qcat_kernel<true>);
+REGISTER_DISPATCH(
+    quantize_tensor_per_channel_affine_stub,
+    &quantize_tensor_per_channel_affine_kernel);
+REGISTER_DISPATCH(
+    dequantize_tensor_per_channel_affine_stub,
+    &dequantize_tensor_per_channel_affine_kernel);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/cpp_custom_type_hack.h>
+
+namespace at {
+namespace native {
+
+// The prepack ops create the weights for the quantized engine selected at
+// the time, recorded as Packed::engine, and they can only be used with that
+// engine. Weights packed for another engine, e.g. by a model loaded before
+// the engine was changed, are reported here rather than by the cast.
+template <typename Packed>
+Packed& cast_packed_weights(const Tensor& packed, const char* op_name) {
+  TORCH_CHECK(
+      cpp_custom_type_hack::isa<Packed>(packed),
+      op_name,
+      ": the weights were not packed for the ",
+      toString(Packed::engine),
+      " quantized engine. Weights are packed for the engine that is selected "
+      "when the prepack op runs; re-pack them, or reload the model, after "
+      "selecting the engine.");
+  return cpp_custom_type_hack::cast<Packed>(packed);
+}
+
+} // namespace native
+} // namespace at
@@ -2,6 +2,8 @@
 #include <ATen/NativeFunctions.h>
 #include <ATen/Parallel.h>
 #include <ATen/core/op_registration/op_registration.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 
 #include <algorithm>
 #include <cmath>
@@ -10,97 +12,10 @@
 
 namespace at {
 namespace native {
-namespace {
-
-inline int start_index(int a, int b, int c) {
-  return (int)std::floor((float)(a * c) / b);
-}
 
-inline int end_index(int a, int b, int c) {
-  return (int)std::ceil((float)((a + 1) * c) / b);
-}
+DEFINE_DISPATCH(qadaptive_avg_pool2d_stub);
 
-template <typename scalar_t, typename underlying_t>
-static void adaptive_avg_pool2d_single_out_frame(
-    scalar_t* input_p,
-    scalar_t* output_p,
-    int64_t sizeD,
-    int64_t isizeH,
-    int64_t isizeW,
-    int64_t osizeH,
-    int64_t osizeW,
-    int64_t istrideD,
-    int64_t istrideH,
-    int64_t istrideW) {
-  at::parallel_for(0, sizeD, 0, [&](int64_t start, int64_t end) {
-    for (auto d = start; d < end; d++) {
-      /* loop over output */
-      int64_t oh, ow;
-      for (oh = 0; oh < osizeH; oh++) {
-        int istartH = start_index(oh, osizeH, isizeH);
-        int iendH = end_index(oh, osizeH, isizeH);
-        int kH = iendH - istartH;
-        float kHr = 1.0 / kH;
-
-        for (ow = 0; ow < osizeW; ow++) {
-          int istartW = start_index(ow, osizeW, isizeW);
-          int iendW = end_index(ow, osizeW, isizeW);
-          int kW = iendW - istartW;
-          float kHWr = kHr / kW;
-
-          /* local pointers */
-          scalar_t* ip =
-              input_p + d * istrideD + istartH * istrideH + istartW * istrideW;
-          scalar_t* op = output_p + d * osizeH * osizeW + oh * osizeW + ow;
-
-          /* compute local average: */
-          int64_t sum = 0;
-          int ih, iw;
-          for (ih = 0; ih < kH; ih++) {
-            for (iw = 0; iw < kW; iw++) {
-              int64_t val = (ip + ih * istrideH + iw * istrideW)->val_;
-              sum += val;
-            }
-          }
-
-          /* set output to local average */
-          op->val_ = static_cast<underlying_t>(std::nearbyint(sum * kHWr));
-        }
-      }
-    }
-  });
-}
-
-template <typename scalar_t, typename underlying_t>
-void adaptive_avg_pool2d_out_frame(
-    scalar_t* input_p,
-    scalar_t* output_p,
-    int64_t sizeB,
-    int64_t sizeD,
-    int64_t isizeH,
-    int64_t isizeW,
-    int64_t osizeH,
-    int64_t osizeW,
-    int64_t istrideB,
-    int64_t istrideD,
-    int64_t istrideH,
-    int64_t istrideW) {
-  at::parallel_for(0, sizeB, 0, [&](int64_t start, int64_t end) {
-    for (auto b = start; b < end; b++) {
-      adaptive_avg_pool2d_single_out_frame<scalar_t, underlying_t>(
-          input_p + b * istrideB,
-          output_p + b * sizeD * osizeH * osizeW,
-          sizeD,
-          isizeH,
-          isizeW,
-          osizeH,
-          osizeW,
-          istrideD,
-          istrideH,
-          istrideW);
-    }
-  });
-}
+namespace {
 
 void adaptive_avg_pool2d_out_template(
     Tensor& output,
@@ -117,47 +32,23 @@ void adaptive_avg_pool2d_out_template(
 
   auto osizeH = output_shape[output_shape.size() - 2];
   auto osizeW = output_shape[output_shape.size() - 1];
-  int64_t sizeB = output_shape.size() == 3 ? 0 : output_shape[0];
-
-  if (input.dim() == 3 || input.size(0) == 1) {
-    AT_DISPATCH_QINT_TYPES(
-        input.scalar_type(), "quantized_adaptive_avg_pool2d", [&] {
-          auto input_data = input.data_ptr<scalar_t>();
-          auto output_data = output.data_ptr<scalar_t>();
-          adaptive_avg_pool2d_single_out_frame<scalar_t, underlying_t>(
-              input_data,
-              output_data,
-              sizeD,
-              isizeH,
-              isizeW,
-              osizeH,
-              osizeW,
-              istrideD,
-              istrideH,
-              istrideW);
-        });
-  } else {
-    int64_t istrideB = input.stride(-4);
-
-    AT_DISPATCH_QINT_TYPES(
-        input.scalar_type(), "quantized_adaptive_avg_pool2d", [&] {
-          auto input_data = input.data_ptr<scalar_t>();
-          auto output_data = output.data_ptr<scalar_t>();
-          adaptive_avg_pool2d_out_frame<scalar_t, underlying_t>(
-              input_data,
-              output_data,
-              sizeB,
-              sizeD,
-              isizeH,
-              isizeW,
-              osizeH,
-              osizeW,
-              istrideB,
-              istrideD,
-              istrideH,
-              istrideW);
-        });
-  }
+  int64_t sizeB = output_shape.size() == 3 ? 1 : output_shape[0];
+  int64_t istrideB = input.dim() == 3 ? 0 : input.stride(-4);
+
+  qadaptive_avg_pool2d_stub(
+      kCPU,
+      input,
+      output,
+      sizeB,
+      sizeD,
+      isizeH,
+      isizeW,
+      osizeH,
+      osizeW,
+      istrideB,
+      istrideD,
+      istrideH,
+      istrideW);
 }
 
 std::vector<int64_t> get_output_shape(Tensor input, IntArrayRef output_size) {
@@ -193,6 +84,128 @@ std::vector<int64_t> get_output_shape(Tensor input, IntArrayRef output_size) {
 
   return output_shape;
 }
+
+#ifdef USE_QNNPACK
+// Adaptive average pooling is a global average pooling when the output is
+// 1x1, and an average pooling with kernel == stride when the output size
+// divides the input size (QNNPACK has no 1x1 average pooling).
+bool qnnpack_adaptive_avg_pool2d_supported(
+    const Tensor& input,
+    const std::vector<int64_t>& output_shape) {
+  auto osizeH = output_shape[output_shape.size() - 2];
+  auto osizeW = output_shape[output_shape.size() - 1];
+  if (input.scalar_type() != kQUInt8 || input.dim() != 4) {
+    return false;
+  }
+  if (osizeH == 1 && osizeW == 1) {
+    return true;
+  }
+  return input.size(-2) % osizeH == 0 && input.size(-1) % osizeW == 0 &&
+      (input.size(-2) / osizeH) * (input.size(-1) / osizeW) > 1;
+}
+
+// The pooling runs on a channels-last copy of the input.
+
+Tensor qnnpack_adaptive_avg_pool2d(
+    const Tensor& input,
+    const std::vector<int64_t>& output_shape) {
+  int64_t nbatch = input.size(0);
+  int64_t channels = input.size(1);
+  int64_t isizeH = input.size(2);
+  int64_t isizeW = input.size(3);
+  int64_t osizeH = output_shape[2];
+  int64_t osizeW = output_shape[3];
+  int64_t kH = isizeH / osizeH;
+  int64_t kW = isizeW / osizeW;
+
+  Tensor input_nhwc = input.permute({0, 2, 3, 1}).contiguous();
+  Tensor output_nhwc = at::_empty_affine_quantized(
+      {nbatch, osizeH, osizeW, channels},
+      input.options(),
+      input.q_scale(),
+      input.q_zero_point());
+  const auto* input_ptr =
+      reinterpret_cast<uint8_t*>(input_nhwc.data_ptr<c10::quint8>());
+  auto* output_ptr =
+      reinterpret_cast<uint8_t*>(output_nhwc.data_ptr<c10::quint8>());
+
+  initQNNPACK();
+
+  qnnp_operator_t qnnpack_operator{nullptr};
+  const bool global_pooling = osizeH == 1 && osizeW == 1;
+  qnnp_status createStatus;
+  if (global_pooling) {
+    createStatus = qnnp_create_global_average_pooling_nwc_q8(
+        channels,
+        input.q_zero_point() /* input zero_point */,
+        input.q_scale() /* input scale */,
+        input.q_zero_point() /* output zero_point */,
+        input.q_scale() /* output scale */,
+        std::numeric_limits<uint8_t>::min() /* output_min */,
+        std::numeric_limits<uint8_t>::max() /* output_max */,
+        0 /* flags */,
+        &qnnpack_operator);
+  } else {
+    createStatus = qnnp_create_average_pooling2d_nhwc_q8(
+        0 /* input_padding_top */,
+        0 /* input_padding_right */,
+        0 /* input_padding_bottom */,
+        0 /* input_padding_left */,
+        kH /* pooling_height */,
+        kW /* pooling_width */,
+        kH /* stride_height */,
+        kW /* stride_width */,
+        channels,
+        input.q_zero_point() /* input zero_point */,
+        input.q_scale() /* input scale */,
+        input.q_zero_point() /* output zero_point */,
+        input.q_scale() /* output scale */,
+        std::numeric_limits<uint8_t>::min() /* output_min */,
+        std::numeric_limits<uint8_t>::max() /* output_max */,
+        0 /* flags */,
+        &qnnpack_operator);
+  }
+  std::unique_ptr<qnnp_operator, QnnpackOperatorDeleter> qnnpack_uniq_ptr(
+      qnnpack_operator);
+  TORCH_INTERNAL_ASSERT(
+      createStatus == qnnp_status_success,
+      "failed to create QNNPACK Average Pooling operator");
+  TORCH_INTERNAL_ASSERT(qnnpack_operator != nullptr);
+
+  qnnp_status setupStatus;
+  if (global_pooling) {
+    setupStatus = qnnp_setup_global_average_pooling_nwc_q8(
+        qnnpack_operator,
+        nbatch /* batch_size */,
+        isizeH * isizeW /* width */,
+        input_ptr,
+        channels /* input_stride */,
+        output_ptr,
+        channels /* output_stride */);
+  } else {
+    setupStatus = qnnp_setup_average_pooling2d_nhwc_q8(
+        qnnpack_operator,
+        nbatch /* batch_size */,
+        isizeH /* input_height */,
+        isizeW /* input_width */,
+        input_ptr,
+        channels /* input_pixel_stride */,
+        output_ptr,
+        channels /* output_pixel_stride */,
+        nullptr /* threadpool */);
+  }
+  TORCH_INTERNAL_ASSERT(
+      setupStatus == qnnp_status_success,
+      "failed to setup QNNPACK Average Pooling operator");
+
+  const qnnp_status runStatus =
+      qnnp_run_operator(qnnpack_operator, caffe2::mobile_threadpool());
+  TORCH_INTERNAL_ASSERT(
+      runStatus == qnnp_status_success, "failed to run QNNPACK operator");
+
+  return output_nhwc.permute({0, 3, 1, 2}).contiguous();
+}
+#endif // USE_QNNPACK
 } // namespace
 
 Tensor& quantized_adaptive_avg_pool2d_out(
@@ -214,6 +227,12 @@ Tensor quantized_adaptive_avg_pool2d(
     const at::Tensor& input,
     IntArrayRef output_size) {
   const auto output_shape = get_output_shape(input, output_size);
+#ifdef USE_QNNPACK
+  if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
+      qnnpack_adaptive_avg_pool2d_supported(input, output_shape)) {
+    return qnnpack_adaptive_avg_pool2d(input, output_shape);
+  }
+#endif
   Tensor output = at::_empty_affine_quantized(
       output_shape, input.options(), input.q_scale(), input.q_zero_point());
   ;
@@ -2,12 +2,19 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/quantized/Quantizer.h>
 
 #include <algorithm>
+#include <limits>
 
 namespace at {
 namespace native {
+
+DEFINE_DISPATCH(qadd_stub);
+DEFINE_DISPATCH(qadd_relu_stub);
+
 namespace {
 
 inline void check_inputs(const Tensor& qa, const Tensor& qb) {
@@ -23,29 +30,72 @@ inline void check_inputs(const Tensor& qa, const Tensor& qb) {
       "Add operands should have same data type.");
 }
 
+#ifdef USE_QNNPACK
+// Returns false, leaving out untouched, if QNNPACK does not support the
+// quantization parameters (it bounds the ratio of the input and output scales).
+template <bool ReLUFused = false>
+bool qnnpack_add(Tensor& out, const Tensor& self, const Tensor& other) {
+  initQNNPACK();
+
+  qnnp_operator_t qnnpack_operator{nullptr};
+  const qnnp_status createStatus = qnnp_create_add_nc_q8(
+      1 /* channels */,
+      self.q_zero_point() /* a zero_point */,
+      self.q_scale() /* a scale */,
+      other.q_zero_point() /* b zero_point */,
+      other.q_scale() /* b scale */,
+      out.q_zero_point() /* sum zero_point */,
+      out.q_scale() /* sum scale */,
+      ReLUFused ? static_cast<uint8_t>(out.q_zero_point())
+                : std::numeric_limits<uint8_t>::min() /* sum min */,
+      std::numeric_limits<uint8_t>::max() /* sum max */,
+      0 /* flags */,
+      &qnnpack_operator);
+  std::unique_ptr<qnnp_operator, QnnpackOperatorDeleter> qnnpack_uniq_ptr(
+      qnnpack_operator);
+  if (createStatus != qnnp_status_success) {
+    return false;
+  }
+
+  Tensor self_contig = self.contiguous();
+  Tensor other_contig = other.contiguous();
+  const qnnp_status setupStatus = qnnp_setup_add_nc_q8(
+      qnnpack_operator,
+      self_contig.numel() /* batch size */,
+      (uint8_t*)self_contig.data_ptr<c10::quint8>() /* a */,
+      1 /* a stride */,
+      (uint8_t*)other_contig.data_ptr<c10::quint8>() /* b */,
+      1 /* b stride */,
+      (uint8_t*)out.data_ptr<c10::quint8>() /* sum */,
+      1 /* sum stride */);
+  TORCH_INTERNAL_ASSERT(
+      setupStatus == qnnp_status_success,
+      "failed to setup QNNPACK Add operator");
+
+  const qnnp_status runStatus =
+      qnnp_run_operator(qnnpack_operator, caffe2::mobile_threadpool());
+  TORCH_INTERNAL_ASSERT(
+      runStatus == qnnp_status_success, "failed to run QNNPACK operator");
+  return true;
+}
+#endif // USE_QNNPACK
+
 // Note: out is assumed to be the same size as self and other.
 // Note: Addition is only supported when self, other, out are of the same dtype.
 template <bool ReLUFused = false>
 Tensor _add_out(Tensor& out, const Tensor& self, const Tensor& other) {
-  int64_t zero_point = out.q_zero_point();
-  double scale = out.q_scale();
-  int64_t self_zero_point = self.q_zero_point();
-  double self_scale = self.q_scale();
-  int64_t other_zero_point = other.q_zero_point();
-  double other_scale = other.q_scale();
-
-  auto iter = TensorIterator::binary_op(out, self, other);
-  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qadd", [&]() {
-    cpu_kernel(iter, [&](scalar_t a, scalar_t b) -> scalar_t {
-      const auto da = at::dequantize_val(self_scale, self_zero_point, a);
-      const auto db = at::dequantize_val(other_scale, other_zero_point, b);
-      float c = da + db;
-      if (ReLUFused) {
-        c = std::max<float>(c, 0.0);
-      }
-      return at::quantize_val<scalar_t>(scale, zero_point, c);
-    });
-  });
+#ifdef USE_QNNPACK
+  if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
+      out.scalar_type() == kQUInt8 && out.is_contiguous() &&
+      qnnpack_add<ReLUFused>(out, self, other)) {
+    return out;
+  }
+#endif
+  if (ReLUFused) {
+    qadd_relu_stub(kCPU, out, self, other);
+  } else {
+    qadd_stub(kCPU, out, self, other);
+  }
   return out;
 }
 
@@ -1,13 +1,17 @@
 #include <ATen/ATen.h>
+#include <ATen/WrapDimUtils.h>
 #include <ATen/core/op_registration/op_registration.h>
-#include <ATen/native/TensorIterator.h>
-#include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 
 #include <algorithm>
 #include <vector>
 
 namespace at {
 namespace native {
+
+DEFINE_DISPATCH(qcat_stub);
+DEFINE_DISPATCH(qcat_relu_stub);
+
 namespace {
 
 bool is_valid_quantization_scheme(const Tensor& t) {
@@ -17,7 +21,8 @@ bool is_valid_quantization_scheme(const Tensor& t) {
 
 /* Quantized concatenation.
  *
- * Note: This function uses a dequantization.
+ * Note: Inputs whose quantization parameters differ from the output are
+ * requantized.
  */
 template <bool ReLUFused>
 Tensor quantized_cat(
@@ -36,19 +41,42 @@ Tensor quantized_cat(
     TORCH_CHECK(x_dtype == qx.scalar_type(), "All dtypes must be the same.");
     TORCH_CHECK(
         x_qscheme == qx.qscheme(), "Quantization schemes must be the same.");
-    xs.push_back(qx.dequantize());
+    xs.push_back(qx.contiguous());
   }
-  const Tensor y = at::cat(xs, dim);
-  Tensor qy;
-  AT_DISPATCH_QINT_TYPES(x_dtype, "qcat", [&]() {
-    qy = at::quantize_linear(y, scale, zero_point, SCALAR_TYPE);
-    if (ReLUFused) {
-      auto iter = TensorIterator::unary_op(qy, qy);
-      cpu_kernel(iter, [&](scalar_t value) -> scalar_t {
-        return scalar_t(std::max<underlying_t>(value.val_, zero_point));
-      });
+
+  const Tensor& x0 = xs[0];
+  dim = maybe_wrap_dim(dim, x0.dim());
+  std::vector<int64_t> sizes = x0.sizes().vec();
+  sizes[dim] = 0;
+  for (const Tensor& x : xs) {
+    TORCH_CHECK(
+        x.dim() == x0.dim(),
+        "Tensors must have same number of dimensions: got ",
+        x0.dim(),
+        " and ",
+        x.dim());
+    for (int64_t d = 0; d < x0.dim(); ++d) {
+      TORCH_CHECK(
+          d == dim || x.size(d) == x0.size(d),
+          "Sizes of tensors must match except in dimension ",
+          dim,
+          ". Got ",
+          x0.size(d),
+          " and ",
+          x.size(d),
+          " in dimension ",
+          d);
     }
-  });
+    sizes[dim] += x.size(dim);
+  }
+
+  Tensor qy = at::_empty_affine_quantized(
+      sizes, at::device(kCPU).dtype(x_dtype), scale, zero_point);
+  if (ReLUFused) {
+    qcat_relu_stub(kCPU, xs, dim, qy);
+  } else {
+    qcat_stub(kCPU, xs, dim, qy);
+  }
   return qy;
 }
 
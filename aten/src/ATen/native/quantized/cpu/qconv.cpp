@@ -1,9 +1,12 @@
 #include <ATen/ATen.h>
 #include <ATen/SmallVector.h>
 #include <ATen/core/op_registration/op_registration.h>
-#include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/packed_weights.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <cmath>
+#include <cstring>
+#include <limits>
 
 namespace at {
 namespace native {
@@ -64,7 +67,6 @@ SmallVector<int64_t, 4> convOutputShape(
 template <bool ReluFused>
 class QConv2dInt8 final : public c10::OperatorKernel {
  public:
-#ifdef USE_FBGEMM
   Tensor operator()(
       Tensor act,
       Tensor packed_weight,
@@ -75,6 +77,54 @@ class QConv2dInt8 final : public c10::OperatorKernel {
       int64_t groups,
       double output_scale,
       int64_t output_zero_point) {
+    auto& ctx = at::globalContext();
+
+#ifdef USE_FBGEMM
+    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+      return fbgemm_conv(
+          act,
+          packed_weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          groups,
+          output_scale,
+          output_zero_point);
+    }
+#endif
+#ifdef USE_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return qnnpack_conv(
+          act,
+          packed_weight,
+          bias,
+          stride,
+          padding,
+          dilation,
+          groups,
+          output_scale,
+          output_zero_point);
+    }
+#endif
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::conv2d ",
+        toString(ctx.qEngine()));
+  }
+
+ private:
+#ifdef USE_FBGEMM
+  Tensor fbgemm_conv(
+      Tensor act,
+      Tensor packed_weight,
+      c10::optional<Tensor> bias,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups,
+      double output_scale,
+      int64_t output_zero_point) {
     TORCH_CHECK(
         fbgemm::fbgemmSupportedCPU(), "Your CPU does not support FBGEMM.");
     TORCH_CHECK(
@@ -97,8 +147,8 @@ class QConv2dInt8 final : public c10::OperatorKernel {
     const uint8_t* act_ptr =
         reinterpret_cast<uint8_t*>(act_contig.data_ptr<c10::quint8>());
 
-    PackedConvWeight& pack_ptr =
-        cpp_custom_type_hack::cast<PackedConvWeight>(packed_weight);
+    auto& pack_ptr = cast_packed_weights<PackedConvWeight>(
+        packed_weight, "quantized::conv2d");
     auto packB = pack_ptr.w.get();
     auto& col_offsets = pack_ptr.col_offsets;
     auto& kernel = pack_ptr.kernel;
@@ -219,28 +269,146 @@ class QConv2dInt8 final : public c10::OperatorKernel {
 
     return output;
   }
-#else // USE_FBGEMM
-  Tensor operator()(
-      Tensor /* activation */,
-      Tensor /* packed_weight */,
-      c10::optional<Tensor> /* bias */,
-      torch::List<int64_t> /* stride */,
-      torch::List<int64_t> /* padding */,
-      torch::List<int64_t> /* dilation */,
-      torch::List<int64_t> /* output padding */,
-      int64_t /* groups */,
-      double /* output scale */,
-      int64_t /* output_zero_point */) {
+#endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+  Tensor qnnpack_conv(
+      Tensor act,
+      Tensor packed_weight,
+      c10::optional<Tensor> bias,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups,
+      double output_scale,
+      int64_t output_zero_point) {
     TORCH_CHECK(
-        false,
-        "This PyTorch installation was not built "
-        "with FBGEMM operators");
+        act.ndimension() == 4,
+        "Activations are supposed to have 4 dimensions.");
+    TORCH_CHECK(
+        act.scalar_type() == kQUInt8,
+        "QNNPACK only supports quint8 activations");
+    TORCH_CHECK(stride.size() == 2, "2D convolution only");
+    TORCH_CHECK(padding.size() == 2, "2D convolution only");
+    TORCH_CHECK(dilation.size() == 2, "2D convolution only");
+
+    auto& pack_ptr = cast_packed_weights<PackedConvWeightsQnnp>(
+        packed_weight, "quantized::conv2d");
+    const Tensor& weight = pack_ptr.orig_weight;
+    auto& kernel = pack_ptr.kernel;
+
+    // inputs are in NHWC format
+    int N = act.size(0);
+    int H = act.size(1);
+    int W = act.size(2);
+    int C = act.size(3);
+    int K = weight.size(0);
+    TORCH_CHECK(
+        C == weight.size(3) * groups,
+        "[QConv2D] the number of input channels should be ",
+        weight.size(3) * groups);
+
+    auto bias_contig = qnnpack_bias(bias, K);
+
+    auto outShape =
+        convOutputShape(N, H, W, K, kernel, stride, padding, dilation);
+    TORCH_CHECK(
+        std::all_of(
+            outShape.begin(), outShape.end(), [](int64_t i) { return i > 0; }),
+        "[QConv2D] each dimension of output tensor should be greater than 0");
+    TORCH_CHECK(
+        act.q_scale() * pack_ptr.w_scale / output_scale < 1.0,
+        "QNNPACK requires the output scale to be larger than the product of "
+        "the input and weight scales");
+
+    Tensor output = _empty_affine_quantized(
+        outShape, device(kCPU).dtype(kQUInt8), output_scale, output_zero_point);
+
+    initQNNPACK();
+
+    qnnp_operator_t qnnpack_operator{nullptr};
+    const qnnp_status createStatus = qnnp_create_convolution2d_nhwc_q8(
+        padding[0] /* input_padding_top */,
+        padding[1] /* input_padding_right */,
+        padding[0] /* input_padding_bottom */,
+        padding[1] /* input_padding_left */,
+        kernel[0] /* kernel_height */,
+        kernel[1] /* kernel_width */,
+        stride[0] /* subsampling_height */,
+        stride[1] /* subsampling_width */,
+        dilation[0] /* dilation_height */,
+        dilation[1] /* dilation_width */,
+        groups,
+        C / groups /* group_input_channels */,
+        K / groups /* group_output_channels */,
+        act.q_zero_point() /* input zero_point */,
+        act.q_scale() /* input scale */,
+        pack_ptr.w_zp /* kernel zero_point */,
+        pack_ptr.w_scale /* kernel scale */,
+        (uint8_t*)weight.data_ptr<c10::quint8>() /* kernel data */,
+        bias_contig.data_ptr<int32_t>() /* bias data */,
+        output_zero_point /* output zero_point */,
+        output_scale /* output scale */,
+        ReluFused ? static_cast<uint8_t>(output_zero_point)
+                  : std::numeric_limits<uint8_t>::min() /* output_min */,
+        std::numeric_limits<uint8_t>::max() /* output_max */,
+        0 /* flags */,
+        &qnnpack_operator);
+    std::unique_ptr<qnnp_operator, QnnpackOperatorDeleter> qnnpack_uniq_ptr(
+        qnnpack_operator);
+    TORCH_INTERNAL_ASSERT(
+        createStatus == qnnp_status_success,
+        "failed to create QNNPACK Convolution operator");
+    TORCH_INTERNAL_ASSERT(qnnpack_operator != nullptr);
+
+    // As Int8Conv in caffe2/operators/quantized does, inputs with fewer than
+    // 8 channels per group are moved into a buffer with 8 bytes of padding in
+    // front for the QNNPACK micro-kernels.
+    Tensor act_contig = act.contiguous();
+    const uint8_t* act_ptr =
+        reinterpret_cast<uint8_t*>(act_contig.data_ptr<c10::quint8>());
+    const bool is_depthwise = groups > 1 && groups == K && groups == C &&
+        kernel[0] * kernel[1] == 9 && dilation[1] == 1;
+    Tensor act_buffer;
+    if ((is_depthwise && groups < 8) || (!is_depthwise && C / groups < 8)) {
+      act_buffer =
+          at::empty({act_contig.numel() + 8}, device(kCPU).dtype(kByte));
+      uint8_t* act_buffer_ptr = act_buffer.data_ptr<uint8_t>() + 8;
+      std::memcpy(act_buffer_ptr, act_ptr, act_contig.numel());
+      act_ptr = act_buffer_ptr;
+    }
+
+    const qnnp_status setupStatus = qnnp_setup_convolution2d_nhwc_q8(
+        qnnpack_operator,
+        N /* batch_size */,
+        H /* input_height */,
+        W /* input_width */,
+        act_ptr /* input */,
+        C /* input_pixel_stride */,
+        (uint8_t*)output.data_ptr<c10::quint8>() /* output */,
+        K /* output_pixel_stride */,
+        nullptr /* threadpool */);
+    TORCH_INTERNAL_ASSERT(
+        setupStatus == qnnp_status_success,
+        "failed to setup QNNPACK Convolution operator");
+
+    const qnnp_status runStatus =
+        qnnp_run_operator(qnnpack_operator, caffe2::mobile_threadpool());
+    TORCH_INTERNAL_ASSERT(
+        runStatus == qnnp_status_success, "failed to run QNNPACK operator");
+
+    return output;
   }
-#endif // USE_FBGEMM
+#endif // USE_QNNPACK
 };
 
 static auto registry =
     c10::RegisterOperators()
+        .op("quantized::conv2d",
+            c10::RegisterOperators::options().kernel<QConv2dInt8<false>>(
+                QuantizedCPUTensorId()))
+        .op("quantized::conv2d_relu",
+            c10::RegisterOperators::options().kernel<QConv2dInt8<true>>(
+                QuantizedCPUTensorId()))
         .op("quantized::fbgemm_conv2d",
             c10::RegisterOperators::options().kernel<QConv2dInt8<false>>(
                 QuantizedCPUTensorId()))
@@ -2,13 +2,17 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/quantized/Quantizer.h>
 
 namespace caffe2 {
 #ifdef USE_FBGEMM
 // Required for cpp_custom_type_hack to work
 CAFFE_KNOWN_TYPE(PackedConvWeight);
-#endif
+#endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+CAFFE_KNOWN_TYPE(PackedConvWeightsQnnp);
+#endif // USE_QNNPACK
 } // namespace caffe2
 
 namespace at {
@@ -16,13 +20,38 @@ namespace native {
 namespace {
 class QConvPackWeightInt8 final : public c10::OperatorKernel {
  public:
-#ifdef USE_FBGEMM
   Tensor operator()(
       Tensor weight,
       torch::List<int64_t> stride,
       torch::List<int64_t> padding,
       torch::List<int64_t> dilation,
       int64_t groups) {
+    auto& ctx = at::globalContext();
+
+#ifdef USE_FBGEMM
+    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+      return fbgemm_conv_prepack(weight, stride, padding, dilation, groups);
+    }
+#endif
+#ifdef USE_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return qnnpack_conv_prepack(weight, stride, padding, dilation, groups);
+    }
+#endif
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::conv_prepack ",
+        toString(ctx.qEngine()));
+  }
+
+ private:
+#ifdef USE_FBGEMM
+  Tensor fbgemm_conv_prepack(
+      Tensor weight,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups) {
     TORCH_CHECK(
         weight.ndimension() == 4, "Weights are expected to have 4 dimensions");
 
@@ -117,24 +146,51 @@ class QConvPackWeightInt8 final : public c10::OperatorKernel {
     // point.
     return cpp_custom_type_hack::create(std::move(ret_ptr), weight.options());
   }
-#else // USE_FBGEMM
-  Tensor operator()(
-      Tensor, /* weight */
-      torch::List<int64_t>, /* stride */
-      torch::List<int64_t>, /* padding */
-      torch::List<int64_t>, /* dilation */
-      int64_t /* groups */
-  ) {
+#endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+  Tensor qnnpack_conv_prepack(
+      Tensor weight,
+      torch::List<int64_t> stride,
+      torch::List<int64_t> padding,
+      torch::List<int64_t> dilation,
+      int64_t groups) {
+    TORCH_CHECK(
+        weight.ndimension() == 4, "Weights are expected to have 4 dimensions");
+    TORCH_CHECK(stride.size() == 2, "2D convolution only");
     TORCH_CHECK(
-        false, "This PyTorch installation was not built with FBGEMM operators");
+        padding.size() == 2,
+        "Specify top/left padding only. \
+        bottom/right padding assumed to be equal to top/left");
+    TORCH_CHECK(dilation.size() == 2, "2D convolution only");
+    TORCH_CHECK(
+        weight.size(0) % groups == 0,
+        "The number of output channels should be divisible by groups");
+
+    // weights in KRS(C/G) format, which is also the layout of QNNPACK kernels
+    auto weight_uint8 = qnnpack_uint8_weight(weight);
+    int64_t kernel_h = weight.size(1);
+    int64_t kernel_w = weight.size(2);
+
+    auto ret_ptr =
+        guts::make_unique<PackedConvWeightsQnnp>(PackedConvWeightsQnnp{
+            weight_uint8,
+            {kernel_h, kernel_w},
+            weight_uint8.q_scale(),
+            weight_uint8.q_zero_point(),
+            weight.scalar_type()});
+    return cpp_custom_type_hack::create(std::move(ret_ptr), weight.options());
   }
-#endif // USE_FBGEMM
+#endif // USE_QNNPACK
 };
 
-static auto registry = c10::RegisterOperators().op(
-    "quantized::fbgemm_conv_prepack",
-    c10::RegisterOperators::options().kernel<QConvPackWeightInt8>(
-        QuantizedCPUTensorId()));
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::conv_prepack",
+            c10::RegisterOperators::options().kernel<QConvPackWeightInt8>(
+                QuantizedCPUTensorId()))
+        .op("quantized::fbgemm_conv_prepack",
+            c10::RegisterOperators::options().kernel<QConvPackWeightInt8>(
+                QuantizedCPUTensorId()));
 
 } // namespace
 } // namespace native
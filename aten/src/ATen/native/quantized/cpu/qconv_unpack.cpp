@@ -1,7 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/core/op_registration/op_registration.h>
-#include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/packed_weights.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
 
 namespace at {
 namespace native {
@@ -15,11 +16,31 @@ namespace {
  */
 class QConvUnpackWeightsInt8 final : public c10::OperatorKernel {
  public:
-#ifdef USE_FBGEMM
   Tensor operator()(Tensor packed_weights) {
+    auto& ctx = at::globalContext();
+
+#ifdef USE_FBGEMM
+    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+      return fbgemm_conv_unpack(packed_weights);
+    }
+#endif
+#ifdef USE_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return qnnpack_conv_unpack(packed_weights);
+    }
+#endif
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::conv_unpack ",
+        toString(ctx.qEngine()));
+  }
+
+ private:
+#ifdef USE_FBGEMM
+  Tensor fbgemm_conv_unpack(Tensor packed_weights) {
     // Pull out the packed weight instance from the owning tensor.
-    auto& pack_ptr =
-        cpp_custom_type_hack::cast<PackedConvWeight>(packed_weights);
+    auto& pack_ptr = cast_packed_weights<PackedConvWeight>(
+        packed_weights, "quantized::conv_unpack");
     auto packed_weights_p = pack_ptr.w.get();
 
     // output channels
@@ -67,23 +88,26 @@ class QConvUnpackWeightsInt8 final : public c10::OperatorKernel {
 
     return unpacked_weights;
   }
-#else // USE_FBGEMM
-  Tensor operator()(Tensor /* weight */
-  ) {
-    // We make a strong guarantee that models using these operators will have
-    // the same numerics across different machines. Therefore, we do not provide
-    // a fallback path and rather fail loudly if we cannot run FBGEMM.
-    TORCH_CHECK(
-        false, "This PyTorch installation was not built with FBGEMM operators");
-  }
 #endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+  Tensor qnnpack_conv_unpack(Tensor packed_weights) {
+    auto& pack_ptr = cast_packed_weights<PackedConvWeightsQnnp>(
+        packed_weights, "quantized::conv_unpack");
+    return qnnpack_orig_weight(pack_ptr.orig_weight, pack_ptr.w_dtype);
+  }
+#endif // USE_QNNPACK
 };
 
-static auto registry = c10::RegisterOperators().op(
-    "quantized::fbgemm_conv_unpack(Tensor packed_weights)"
-    " -> Tensor unpacked_weights",
-    c10::RegisterOperators::options().kernel<QConvUnpackWeightsInt8>(
-        CPUTensorId()));
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::conv_unpack(Tensor packed_weights)"
+            " -> Tensor unpacked_weights",
+            c10::RegisterOperators::options().kernel<QConvUnpackWeightsInt8>(
+                CPUTensorId()))
+        .op("quantized::fbgemm_conv_unpack(Tensor packed_weights)"
+            " -> Tensor unpacked_weights",
+            c10::RegisterOperators::options().kernel<QConvUnpackWeightsInt8>(
+                CPUTensorId()));
 
 } // namespace
 } // namespace native
@@ -0,0 +1,405 @@
+#include <ATen/ATen.h>
+#include <ATen/Parallel.h>
+#include <ATen/core/op_registration/op_registration.h>
+#include <caffe2/perfkernels/fused_8bit_rowwise_conversion.h>
+#include <caffe2/perfkernels/fused_8bit_rowwise_embedding_lookup.h>
+#include <caffe2/perfkernels/fused_nbit_rowwise_conversion.h>
+#include <caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace at {
+namespace native {
+namespace {
+
+// The packed weight of an N-bit embedding bag is a uint8 matrix with one row
+// per embedding, holding the packed values of the row followed by its scale
+// and bias as 16-bit floats. It has the same layout as the tensors produced by
+// the FloatToFused{4,2}BitRowwiseQuantized operators of Caffe2.
+//
+// The last byte of the packed values may be padded, so the operators reading
+// a packed weight take the embedding dim that it was packed from.
+template <int BIT_RATE>
+void checkPackedWeightNBit(
+    const at::Tensor& packed_weight,
+    int64_t embedding_dim) {
+  TORCH_CHECK(
+      packed_weight.dim() == 2 && packed_weight.scalar_type() == kByte,
+      "Expected a packed weight obtained with embedding_bag_",
+      BIT_RATE,
+      "bit_prepack");
+  TORCH_CHECK(embedding_dim > 0, "embedding_dim must be positive");
+  TORCH_CHECK(
+      packed_weight.size(1) ==
+          caffe2::FusedNBitRowwiseRowBytes(BIT_RATE, embedding_dim),
+      "A packed weight with ",
+      packed_weight.size(1),
+      " columns can't hold embeddings of dim ",
+      embedding_dim);
+}
+
+template <int BIT_RATE>
+class QEmbeddingBagPrepackNBit final : public torch::OperatorKernel {
+ public:
+  at::Tensor operator()(at::Tensor weight) {
+    TORCH_CHECK(
+        weight.dim() == 2,
+        "The weight of an embedding bag is expected to be a matrix");
+    TORCH_CHECK(
+        weight.scalar_type() == kFloat,
+        "Only float weights can be quantized, got ",
+        weight.scalar_type());
+    const auto weight_contig = weight.contiguous();
+    const int64_t rows = weight.size(0);
+    const int64_t columns = weight.size(1);
+    auto packed = at::empty(
+        {rows, caffe2::FusedNBitRowwiseRowBytes(BIT_RATE, columns)},
+        weight.options().dtype(kByte));
+    caffe2::FloatToFusedNBitRowwiseQuantizedSBHalf(
+        BIT_RATE,
+        weight_contig.data_ptr<float>(),
+        rows,
+        columns,
+        packed.data_ptr<uint8_t>());
+    return packed;
+  }
+};
+
+template <int BIT_RATE>
+class QEmbeddingBagUnpackNBit final : public torch::OperatorKernel {
+ public:
+  at::Tensor operator()(at::Tensor packed_weight, int64_t embedding_dim) {
+    checkPackedWeightNBit<BIT_RATE>(packed_weight, embedding_dim);
+    const auto packed_contig = packed_weight.contiguous();
+    const int64_t rows = packed_weight.size(0);
+    auto weight = at::empty(
+        {rows, embedding_dim}, packed_weight.options().dtype(kFloat));
+    caffe2::FusedNBitRowwiseQuantizedSBHalfToFloat(
+        BIT_RATE,
+        packed_contig.data_ptr<uint8_t>(),
+        rows,
+        embedding_dim,
+        weight.data_ptr<float>());
+    return weight;
+  }
+};
+
+// Checks the arguments of the forward of a quantized EmbeddingBag in sum
+// (mode 0) or mean (mode 1) mode, and computes the length of every bag. Like
+// for nn.EmbeddingBag, the bag i covers the indices from offsets[i] up to
+// offsets[i + 1], or the end of indices for the last bag.
+std::vector<int> checkEmbeddingBagArguments(
+    const at::Tensor& indices,
+    const at::Tensor& offsets,
+    int64_t mode,
+    const c10::optional<Tensor>& per_sample_weights) {
+  TORCH_CHECK(indices.dim() == 1, "indices must be a vector");
+  TORCH_CHECK(offsets.dim() == 1, "offsets must be a vector");
+  TORCH_CHECK(
+      mode == 0 || mode == 1,
+      "Only the sum (0) and mean (1) modes are supported, got ",
+      mode);
+  TORCH_CHECK(
+      indices.scalar_type() == kLong || indices.scalar_type() == kInt,
+      "indices must be int32 or int64, got ",
+      indices.scalar_type());
+  if (per_sample_weights.has_value() && per_sample_weights->defined()) {
+    TORCH_CHECK(
+        mode == 0, "per_sample_weights are only supported in sum mode");
+    TORCH_CHECK(
+        per_sample_weights->scalar_type() == kFloat &&
+            per_sample_weights->sizes() == indices.sizes(),
+        "per_sample_weights must be a float vector of the size of indices");
+  }
+
+  const int64_t num_indices = indices.numel();
+  const int64_t num_bags = offsets.numel();
+  const auto offsets_contig = offsets.to(kLong).contiguous();
+  const auto* offsets_data = offsets_contig.data_ptr<int64_t>();
+  std::vector<int> lengths(num_bags);
+  for (int64_t i = 0; i < num_bags; ++i) {
+    const int64_t end = i + 1 < num_bags ? offsets_data[i + 1] : num_indices;
+    TORCH_CHECK(
+        offsets_data[i] >= 0 && offsets_data[i] <= end && end <= num_indices,
+        "offsets must be non-decreasing and within the range of indices");
+    lengths[i] = end - offsets_data[i];
+  }
+  TORCH_CHECK(
+      num_bags == 0 || offsets_data[0] == 0,
+      "The first offset is expected to be 0");
+  return lengths;
+}
+
+// Runs `lookup(indices, lengths, weights, num_bags, num_indices, out)` of a
+// lengths based embedding lookup perfkernel on chunks of bags in parallel.
+template <typename IndexType, typename Lookup>
+at::Tensor parallelEmbeddingBag(
+    const at::Tensor& indices,
+    const std::vector<int>& lengths,
+    const c10::optional<Tensor>& per_sample_weights,
+    int64_t block_size,
+    const at::TensorOptions& options,
+    const Lookup& lookup) {
+  const int64_t num_bags = lengths.size();
+  const int64_t num_indices = indices.numel();
+  // The perfkernel overwrites every row
+  auto output = at::empty({num_bags, block_size}, options.dtype(kFloat));
+  const auto indices_contig = indices.contiguous();
+  const auto* indices_data = indices_contig.data_ptr<IndexType>();
+  Tensor weights_contig;
+  const float* weights_data = nullptr;
+  if (per_sample_weights.has_value() && per_sample_weights->defined()) {
+    weights_contig = per_sample_weights->contiguous();
+    weights_data = weights_contig.data_ptr<float>();
+  }
+  auto* output_data = output.data_ptr<float>();
+
+  std::vector<int64_t> bag_offsets(num_bags + 1, 0);
+  for (int64_t i = 0; i < num_bags; ++i) {
+    bag_offsets[i + 1] = bag_offsets[i] + lengths[i];
+  }
+  // Enough bags per task for every task to load about GRAIN_SIZE values
+  const int64_t values_per_bag =
+      std::max<int64_t>(num_indices / std::max<int64_t>(num_bags, 1), 1) *
+      block_size;
+  const int64_t grain_size =
+      std::max<int64_t>(at::internal::GRAIN_SIZE / values_per_bag, 1);
+  at::parallel_for(0, num_bags, grain_size, [&](int64_t begin, int64_t end) {
+    const int64_t first_index = bag_offsets[begin];
+    lookup(
+        indices_data + first_index,
+        lengths.data() + begin,
+        weights_data ? weights_data + first_index : nullptr,
+        end - begin,
+        bag_offsets[end] - first_index,
+        output_data + begin * block_size);
+  });
+  return output;
+}
+
+// Forward of EmbeddingBag over a packed N-bit weight
+template <int BIT_RATE>
+class QEmbeddingBagNBit final : public torch::OperatorKernel {
+ public:
+  at::Tensor operator()(
+      at::Tensor packed_weight,
+      at::Tensor indices,
+      at::Tensor offsets,
+      int64_t mode,
+      c10::optional<Tensor> per_sample_weights,
+      int64_t embedding_dim) {
+    checkPackedWeightNBit<BIT_RATE>(packed_weight, embedding_dim);
+    const auto lengths =
+        checkEmbeddingBagArguments(indices, offsets, mode, per_sample_weights);
+
+    const int64_t block_size = embedding_dim;
+    const auto packed_contig = packed_weight.contiguous();
+    if (indices.scalar_type() == kLong) {
+      return lookup<int64_t>(
+          packed_contig,
+          indices,
+          lengths,
+          mode,
+          per_sample_weights,
+          block_size);
+    }
+    return lookup<int32_t>(
+        packed_contig, indices, lengths, mode, per_sample_weights, block_size);
+  }
+
+ private:
+  template <typename IndexType>
+  at::Tensor lookup(
+      const at::Tensor& packed_weight,
+      const at::Tensor& indices,
+      const std::vector<int>& lengths,
+      int64_t mode,
+      const c10::optional<Tensor>& per_sample_weights,
+      int64_t block_size) {
+    const int64_t data_size = packed_weight.size(0);
+    const auto* packed_data = packed_weight.data_ptr<uint8_t>();
+    return parallelEmbeddingBag<IndexType>(
+        indices,
+        lengths,
+        per_sample_weights,
+        block_size,
+        packed_weight.options(),
+        [&](const IndexType* indices_data,
+            const int* lengths_data,
+            const float* weights,
+            int64_t num_bags,
+            int64_t num_indices,
+            float* out) {
+          caffe2::FusedNBitRowwiseEmbeddingLookup<IndexType, float>(
+              BIT_RATE,
+              block_size,
+              num_bags,
+              num_indices,
+              data_size,
+              packed_data,
+              indices_data,
+              lengths_data,
+              weights,
+              /*normalize_by_lengths=*/mode == 1,
+              out);
+        });
+  }
+};
+
+// The packed weight of an 8-bit embedding bag is a uint8 matrix with one row
+// per embedding, holding the quantized values of the row followed by its
+// scale and bias as 32-bit floats. It has the same layout as the tensors
+// produced by the FloatToFused8BitRowwiseQuantized operator of Caffe2.
+
+class QEmbeddingBagPrepackByte final : public torch::OperatorKernel {
+ public:
+  at::Tensor operator()(at::Tensor weight) {
+    TORCH_CHECK(
+        weight.dim() == 2,
+        "The weight of an embedding bag is expected to be a matrix");
+    TORCH_CHECK(
+        weight.scalar_type() == kFloat,
+        "Only float weights can be quantized, got ",
+        weight.scalar_type());
+    const auto weight_contig = weight.contiguous();
+    const int64_t rows = weight.size(0);
+    const int64_t columns = weight.size(1);
+    auto packed = at::empty(
+        {rows, columns + 2 * static_cast<int64_t>(sizeof(float))},
+        weight.options().dtype(kByte));
+    caffe2::FloatToFused8BitRowwiseQuantized(
+        weight_contig.data_ptr<float>(),
+        rows,
+        columns,
+        packed.data_ptr<uint8_t>());
+    return packed;
+  }
+};
+
+class QEmbeddingBagUnpackByte final : public torch::OperatorKernel {
+ public:
+  at::Tensor operator()(at::Tensor packed_weight) {
+    TORCH_CHECK(
+        packed_weight.dim() == 2 && packed_weight.scalar_type() == kByte,
+        "Expected a packed weight obtained with embedding_bag_byte_prepack");
+    const auto packed_contig = packed_weight.contiguous();
+    const int64_t rows = packed_weight.size(0);
+    const int64_t columns = packed_weight.size(1);
+    auto weight = at::empty(
+        {rows, columns - 2 * static_cast<int64_t>(sizeof(float))},
+        packed_weight.options().dtype(kFloat));
+    caffe2::Fused8BitRowwiseQuantizedToFloat(
+        packed_contig.data_ptr<uint8_t>(),
+        rows,
+        columns,
+        weight.data_ptr<float>());
+    return weight;
+  }
+};
+
+// Forward of EmbeddingBag over a packed 8-bit weight
+class QEmbeddingBagByte final : public torch::OperatorKernel {
+ public:
+  at::Tensor operator()(
+      at::Tensor packed_weight,
+      at::Tensor indices,
+      at::Tensor offsets,
+      int64_t mode,
+      c10::optional<Tensor> per_sample_weights) {
+    TORCH_CHECK(
+        packed_weight.dim() == 2 && packed_weight.scalar_type() == kByte,
+        "Expected a packed weight obtained with embedding_bag_byte_prepack");
+    TORCH_CHECK(
+        packed_weight.size(1) > 2 * static_cast<int64_t>(sizeof(float)),
+        "The packed weight must have more than 8 columns");
+    const auto lengths =
+        checkEmbeddingBagArguments(indices, offsets, mode, per_sample_weights);
+
+    const int64_t block_size =
+        packed_weight.size(1) - 2 * static_cast<int64_t>(sizeof(float));
+    const auto packed_contig = packed_weight.contiguous();
+    if (indices.scalar_type() == kLong) {
+      return lookup<int64_t>(
+          packed_contig,
+          indices,
+          lengths,
+          mode,
+          per_sample_weights,
+          block_size);
+    }
+    return lookup<int32_t>(
+        packed_contig, indices, lengths, mode, per_sample_weights, block_size);
+  }
+
+ private:
+  template <typename IndexType>
+  at::Tensor lookup(
+      const at::Tensor& packed_weight,
+      const at::Tensor& indices,
+      const std::vector<int>& lengths,
+      int64_t mode,
+      const c10::optional<Tensor>& per_sample_weights,
+      int64_t block_size) {
+    const int64_t data_size = packed_weight.size(0);
+    const auto* packed_data = packed_weight.data_ptr<uint8_t>();
+    return parallelEmbeddingBag<IndexType>(
+        indices,
+        lengths,
+        per_sample_weights,
+        block_size,
+        packed_weight.options(),
+        [&](const IndexType* indices_data,
+            const int* lengths_data,
+            const float* weights,
+            int64_t num_bags,
+            int64_t num_indices,
+            float* out) {
+          caffe2::Fused8BitRowwiseEmbeddingLookup<IndexType, uint8_t, float>(
+              block_size,
+              num_bags,
+              num_indices,
+              data_size,
+              packed_data,
+              indices_data,
+              lengths_data,
+              weights,
+              /*normalize_by_lengths=*/mode == 1,
+              out);
+        });
+  }
+};
+
+static auto registry =
+    torch::RegisterOperators()
+        .op("quantized::embedding_bag_4bit_prepack(Tensor weight) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagPrepackNBit<4>>(CPUTensorId()))
+        .op("quantized::embedding_bag_2bit_prepack(Tensor weight) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagPrepackNBit<2>>(CPUTensorId()))
+        .op("quantized::embedding_bag_4bit_unpack(Tensor packed_weight, int embedding_dim) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagUnpackNBit<4>>(CPUTensorId()))
+        .op("quantized::embedding_bag_2bit_unpack(Tensor packed_weight, int embedding_dim) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagUnpackNBit<2>>(CPUTensorId()))
+        .op("quantized::embedding_bag_4bit(Tensor packed_weight, Tensor indices, Tensor offsets, int mode, Tensor? per_sample_weights, int embedding_dim) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagNBit<4>>(CPUTensorId()))
+        .op("quantized::embedding_bag_2bit(Tensor packed_weight, Tensor indices, Tensor offsets, int mode, Tensor? per_sample_weights, int embedding_dim) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagNBit<2>>(CPUTensorId()))
+        .op("quantized::embedding_bag_byte_prepack(Tensor weight) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagPrepackByte>(CPUTensorId()))
+        .op("quantized::embedding_bag_byte_unpack(Tensor packed_weight) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagUnpackByte>(CPUTensorId()))
+        .op("quantized::embedding_bag_byte(Tensor packed_weight, Tensor indices, Tensor offsets, int mode, Tensor? per_sample_weights) -> Tensor",
+            torch::RegisterOperators::options()
+                .kernel<QEmbeddingBagByte>(CPUTensorId()));
+
+} // namespace
+} // namespace native
+} // namespace at
@@ -1,9 +1,11 @@
 #include <ATen/ATen.h>
 #include <ATen/core/op_registration/op_registration.h>
-#include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/packed_weights.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
 
 #include <algorithm>
+#include <limits>
 #include <string>
 
 namespace at {
@@ -13,13 +15,40 @@ namespace {
 template <bool ReluFused>
 class QLinearInt8 final : public torch::OperatorKernel {
  public:
-#ifdef USE_FBGEMM
   at::Tensor operator()(
       at::Tensor input,
       at::Tensor packed_weight,
       c10::optional<Tensor> bias,
       double output_scale,
       int64_t output_zero_point) {
+    auto& ctx = at::globalContext();
+
+#ifdef USE_FBGEMM
+    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+      return fbgemm_linear(
+          input, packed_weight, bias, output_scale, output_zero_point);
+    }
+#endif
+#ifdef USE_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return qnnpack_linear(
+          input, packed_weight, bias, output_scale, output_zero_point);
+    }
+#endif
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::linear ",
+        toString(ctx.qEngine()));
+  }
+
+ private:
+#ifdef USE_FBGEMM
+  at::Tensor fbgemm_linear(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      c10::optional<Tensor> bias,
+      double output_scale,
+      int64_t output_zero_point) {
     // uint8 * int8 -> uint8 (no quantization/dequantization)
 
     // We make a strong guarantee that models using these operators will have
@@ -41,8 +70,8 @@ class QLinearInt8 final : public torch::OperatorKernel {
     int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
 
     // Pull out the PackBMatrix and col_offsets instance from the owning tensor.
-    auto& pack_ptr =
-        cpp_custom_type_hack::cast<PackedLinearWeight>(packed_weight);
+    auto& pack_ptr = cast_packed_weights<PackedLinearWeight>(
+        packed_weight, "quantized::linear");
     auto packB = pack_ptr.w.get();
     // packB->printPackedMatrix("packedB inside fbgemm_linear (QLinearInt8): ");
     auto& col_offsets = pack_ptr.col_offsets;
@@ -148,24 +177,69 @@ class QLinearInt8 final : public torch::OperatorKernel {
 
     return output;
   }
-#else // USE_FBGEMM
-  at::Tensor operator()(
-      at::Tensor /* input */,
-      at::Tensor /* packed_weight */,
-      c10::optional<Tensor> /* bias */,
-      double /* output_scale */,
-      int64_t /* output_zero_point */) {
-    // We make a strong guarantee that models using these operators will have
-    // the same numerics across different machines. Therefore, we do not provide
-    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+#endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+  at::Tensor qnnpack_linear(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      c10::optional<Tensor> bias,
+      double output_scale,
+      int64_t output_zero_point) {
+    // uint8 * uint8 -> uint8 (no quantization/dequantization)
+    TORCH_CHECK(
+        input.dim() >= 2,
+        "The dimension of input tensor should be larger than or equal to 2");
     TORCH_CHECK(
-        false, "This PyTorch installation was not built with FBGEMM operators");
+        input.scalar_type() == kQUInt8,
+        "QNNPACK only supports quint8 activations");
+    auto input_contig = input.contiguous();
+
+    auto& pack_ptr = cast_packed_weights<PackedLinearWeightsQnnp>(
+        packed_weight, "quantized::linear");
+    const Tensor& weight = pack_ptr.orig_weight;
+
+    int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
+    int64_t N = weight.size(0);
+    int64_t K = input.size(input.dim() - 1);
+    TORCH_CHECK(
+        K == weight.size(1),
+        "The number of columns in the weight should be equal to K: " +
+            std::to_string(K));
+
+    auto bias_contig = qnnpack_bias(bias, N);
+
+    std::vector<int64_t> out_sizes = input.sizes().vec();
+    out_sizes.back() = N;
+    auto output = _empty_affine_quantized(
+        out_sizes,
+        at::device(kCPU).dtype(kQUInt8),
+        output_scale,
+        output_zero_point);
+
+    // The fused ReLU clamps the output at the quantized zero.
+    qnnpack_fully_connected(
+        input_contig,
+        weight,
+        bias_contig,
+        output,
+        M,
+        K,
+        N,
+        ReluFused ? static_cast<uint8_t>(output_zero_point) : 0,
+        std::numeric_limits<uint8_t>::max());
+    return output;
   }
-#endif // USE_FBGEMM
+#endif // USE_QNNPACK
 };
 
 static auto registry =
     torch::RegisterOperators()
+        .op("quantized::linear(Tensor X, Tensor W_prepack, Tensor? b, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
+            torch::RegisterOperators::options().kernel<QLinearInt8<false>>(
+                QuantizedCPUTensorId()))
+        .op("quantized::linear_relu(Tensor X, Tensor W_prepack, Tensor? b, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
+            torch::RegisterOperators::options().kernel<QLinearInt8<true>>(
+                QuantizedCPUTensorId()))
         .op("quantized::fbgemm_linear(Tensor X, Tensor W_prepack, Tensor? b, float Y_scale_i, int Y_zero_point_i) -> Tensor Y",
             torch::RegisterOperators::options().kernel<QLinearInt8<false>>(
                 QuantizedCPUTensorId()))
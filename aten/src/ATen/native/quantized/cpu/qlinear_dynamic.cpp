@@ -1,23 +1,69 @@
 #include <ATen/ATen.h>
 #include <ATen/core/op_registration/op_registration.h>
-#include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/packed_weights.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
 
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <string>
+#include <utility>
 
 namespace at {
 namespace native {
 namespace {
 
+#ifdef USE_QNNPACK
+// uint8 quantization parameters covering [min, max] and 0, with a scale of at
+// least min_scale.
+std::pair<double, int64_t> choose_quint8_qparams(
+    float min,
+    float max,
+    double min_scale) {
+  min = std::min(min, 0.f);
+  max = std::max(max, 0.f);
+  double scale = std::max((static_cast<double>(max) - min) / 255, min_scale);
+  if (scale == 0) {
+    scale = 0.1;
+  }
+  int64_t zero_point = static_cast<int64_t>(std::nearbyint(-min / scale));
+  zero_point = std::min<int64_t>(std::max<int64_t>(zero_point, 0), 255);
+  return std::make_pair(scale, zero_point);
+}
+#endif // USE_QNNPACK
+
 template <bool ReluFused>
 class QLinearDynamicInt8 final : public torch::OperatorKernel {
  public:
-#ifdef USE_FBGEMM
   at::Tensor operator()(
       at::Tensor input,
       at::Tensor packed_weight,
       c10::optional<Tensor> bias) {
+    auto& ctx = at::globalContext();
+
+#ifdef USE_FBGEMM
+    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+      return fbgemm_linear_dynamic(input, packed_weight, bias);
+    }
+#endif
+#ifdef USE_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return qnnpack_linear_dynamic(input, packed_weight, bias);
+    }
+#endif
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::linear_dynamic ",
+        toString(ctx.qEngine()));
+  }
+
+ private:
+#ifdef USE_FBGEMM
+  at::Tensor fbgemm_linear_dynamic(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      c10::optional<Tensor> bias) {
     // fp32 * int8 -> fp32 (with quantization on activation, and dequantization
     // on the result).
 
@@ -39,8 +85,8 @@ class QLinearDynamicInt8 final : public torch::OperatorKernel {
     int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
 
     // Pull out the PackBMatrix and col_offsets instance from the owning tensor.
-    auto& pack_ptr =
-        cpp_custom_type_hack::cast<PackedLinearWeight>(packed_weight);
+    auto& pack_ptr = cast_packed_weights<PackedLinearWeight>(
+        packed_weight, "quantized::linear_dynamic");
     auto packB = pack_ptr.w.get();
     // packB->printPackedMatrix("packedB inside fbgemm_linear_dynamic
     // (QLinearDynamicInt8): ");
@@ -163,22 +209,120 @@ class QLinearDynamicInt8 final : public torch::OperatorKernel {
 
     return output;
   }
-#else // USE_FBGEMM
-  at::Tensor operator()(
-      at::Tensor /* input */,
-      at::Tensor /* packed_weight */,
-      c10::optional<Tensor> /* bias */) {
-    // We make a strong guarantee that models using these operators will have
-    // the same numerics across different machines. Therefore, we do not provide
-    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+#endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+  // Unlike the FBGEMM path, which dequantizes the int32 accumulator directly,
+  // QNNPACK can only return uint8, so the result is requantized over the
+  // observed output range before it is dequantized. Every output has an
+  // extra error of up to half of (output range / 255), and the GEMM runs
+  // twice, after full passes over the input and the weight to bound the
+  // range. Timings of the two engines are not like-for-like.
+  at::Tensor qnnpack_linear_dynamic(
+      at::Tensor input,
+      at::Tensor packed_weight,
+      c10::optional<Tensor> bias) {
+    // fp32 * uint8 -> fp32 (with quantization on activation, and
+    // dequantization on the result).
     TORCH_CHECK(
-        false, "This PyTorch installation was not built with FBGEMM operators");
+        input.dim() >= 2,
+        "The dimension of input tensor should be larger than or equal to 2");
+    auto input_contig = input.contiguous();
+
+    auto& pack_ptr = cast_packed_weights<PackedLinearWeightsQnnp>(
+        packed_weight, "quantized::linear_dynamic");
+    const Tensor& weight = pack_ptr.orig_weight;
+
+    int64_t M = size_to_dim_(input.dim() - 1, input.sizes());
+    int64_t N = weight.size(0);
+    int64_t K = input.size(input.dim() - 1);
+    TORCH_CHECK(
+        K == weight.size(1),
+        "The number of columns in the weight should be equal to K: " +
+            std::to_string(K));
+
+    // The accumulator of QNNPACK is requantized to uint8, never returned as
+    // float, and QNNPACK requires the output scale to exceed the accumulator
+    // scale.
+    auto x_qparams = choose_quint8_qparams(
+        input_contig.min().item<float>(),
+        input_contig.max().item<float>(),
+        /*min_scale=*/0);
+    auto q_input = at::quantize_linear(
+        input_contig, x_qparams.first, x_qparams.second, kQUInt8);
+    const double acc_scale = x_qparams.first * pack_ptr.w_scale;
+    const double min_output_scale = 2 * acc_scale;
+
+    auto bias_int32 =
+        at::round(qnnpack_bias(bias, N).to(kFloat) / acc_scale).to(kInt);
+
+    // The range of the output is not known ahead of time, so the product is
+    // computed twice: first over a range bounded by the largest row of
+    // |input| times the largest |weight|, which cannot saturate, and then
+    // over the range the first pass observed.
+    const int64_t x_abs_sum =
+        (q_input.int_repr().to(kInt).view({M, K}) - x_qparams.second)
+            .abs()
+            .sum(1)
+            .max()
+            .item<int64_t>();
+    const int64_t w_abs_max = (weight.int_repr().to(kInt) - pack_ptr.w_zp)
+                                  .abs()
+                                  .max()
+                                  .item<int64_t>();
+    const int64_t acc_bound =
+        x_abs_sum * w_abs_max + bias_int32.abs().max().item<int64_t>();
+    const double bound_scale = std::max(
+        static_cast<double>(acc_bound) * acc_scale / 127, min_output_scale);
+    auto bound_output = _empty_affine_quantized(
+        {M, N}, at::device(kCPU).dtype(kQUInt8), bound_scale, 127);
+    qnnpack_fully_connected(
+        q_input,
+        weight,
+        bias_int32,
+        bound_output,
+        M,
+        K,
+        N,
+        std::numeric_limits<uint8_t>::min(),
+        std::numeric_limits<uint8_t>::max());
+
+    auto bound_int = bound_output.int_repr();
+    const float y_min =
+        (bound_int.min().item<int64_t>() - 127 - 0.5) * bound_scale;
+    const float y_max =
+        (bound_int.max().item<int64_t>() - 127 + 0.5) * bound_scale;
+    auto y_qparams = choose_quint8_qparams(y_min, y_max, min_output_scale);
+
+    std::vector<int64_t> out_sizes = input.sizes().vec();
+    out_sizes.back() = N;
+    auto output = _empty_affine_quantized(
+        out_sizes,
+        at::device(kCPU).dtype(kQUInt8),
+        y_qparams.first,
+        y_qparams.second);
+    qnnpack_fully_connected(
+        q_input,
+        weight,
+        bias_int32,
+        output,
+        M,
+        K,
+        N,
+        ReluFused ? static_cast<uint8_t>(y_qparams.second) : 0,
+        std::numeric_limits<uint8_t>::max());
+    return output.dequantize();
   }
-#endif // USE_FBGEMM
+#endif // USE_QNNPACK
 };
 
 static auto registry =
     torch::RegisterOperators()
+        .op("quantized::linear_dynamic(Tensor X, Tensor W_prepack, Tensor? b) -> Tensor Y",
+            torch::RegisterOperators::options()
+                .kernel<QLinearDynamicInt8<false>>(CPUTensorId()))
+        .op("quantized::linear_relu_dynamic(Tensor X, Tensor W_prepack, Tensor? b) -> Tensor Y",
+            torch::RegisterOperators::options()
+                .kernel<QLinearDynamicInt8<true>>(CPUTensorId()))
         .op("quantized::fbgemm_linear_dynamic(Tensor X, Tensor W_prepack, Tensor? b) -> Tensor Y",
             torch::RegisterOperators::options()
                 .kernel<QLinearDynamicInt8<false>>(CPUTensorId()))
@@ -2,6 +2,7 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
 #include <ATen/quantized/Quantizer.h>
 
 #include <algorithm>
@@ -12,6 +13,9 @@ namespace caffe2 {
 // Required for cpp_custom_type_hack to work
 CAFFE_KNOWN_TYPE(PackedLinearWeight);
 #endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+CAFFE_KNOWN_TYPE(PackedLinearWeightsQnnp);
+#endif // USE_QNNPACK
 } // namespace caffe2
 
 namespace at {
@@ -20,6 +24,29 @@ namespace {
 
 class QLinearPackWeightInt8 final : public c10::OperatorKernel {
  public:
+  at::Tensor operator()(at::Tensor weight) {
+    auto& ctx = at::globalContext();
+
+#ifdef USE_FBGEMM
+    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+      return fbgemm_linear_prepack(weight);
+    }
+#endif
+#ifdef USE_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return qnnpack_linear_prepack(weight);
+    }
+#endif
+    // We make a strong guarantee that models using these operators will have
+    // the same numerics across different machines. Therefore, we do not provide
+    // a fallback path and rather fail loudly if the engine is not built.
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::linear_prepack ",
+        toString(ctx.qEngine()));
+  }
+
+ private:
 #ifdef USE_FBGEMM
   // Calculate the column offsets.
   // Note this includes the sum of the columns as well as the scalar term
@@ -40,10 +67,10 @@ class QLinearPackWeightInt8 final : public c10::OperatorKernel {
     }
   }
 
-  at::Tensor operator()(at::Tensor weight) {
+  at::Tensor fbgemm_linear_prepack(at::Tensor weight) {
     TORCH_CHECK(
         weight.dim() == 2,
-        "The weight tensor for quantized::fbgemm_linear_prepack should be 2-dimensional.");
+        "The weight tensor for quantized::linear_prepack (fbgemm) should be 2-dimensional.");
 
     auto N = weight.size(0);
     auto K = weight.size(1);
@@ -81,22 +108,33 @@ class QLinearPackWeightInt8 final : public c10::OperatorKernel {
     // point.
     return cpp_custom_type_hack::create(std::move(ret_ptr), weight.options());
   }
-#else // USE_FBGEMM
-  at::Tensor operator()(at::Tensor /* weight */
-  ) {
-    // We make a strong guarantee that models using these operators will have
-    // the same numerics across different machines. Therefore, we do not provide
-    // a fallback path and rather fail loudly if we cannot run FBGEMM.
+#endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+  at::Tensor qnnpack_linear_prepack(at::Tensor weight) {
     TORCH_CHECK(
-        false, "This PyTorch installation was not built with FBGEMM operators");
+        weight.dim() == 2,
+        "The weight tensor for quantized::linear_prepack (qnnpack) should be 2-dimensional.");
+    auto weight_uint8 = qnnpack_uint8_weight(weight);
+
+    auto ret_ptr =
+        guts::make_unique<PackedLinearWeightsQnnp>(PackedLinearWeightsQnnp{
+            weight_uint8,
+            weight_uint8.q_scale(),
+            weight_uint8.q_zero_point(),
+            weight.scalar_type()});
+    return cpp_custom_type_hack::create(std::move(ret_ptr), weight.options());
   }
-#endif // USE_FBGEMM
+#endif // USE_QNNPACK
 };
 
-static auto registry = c10::RegisterOperators().op(
-    "quantized::fbgemm_linear_prepack(Tensor W) -> Tensor W_prepack",
-    c10::RegisterOperators::options().kernel<QLinearPackWeightInt8>(
-        QuantizedCPUTensorId()));
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::linear_prepack(Tensor W) -> Tensor W_prepack",
+            c10::RegisterOperators::options().kernel<QLinearPackWeightInt8>(
+                QuantizedCPUTensorId()))
+        .op("quantized::fbgemm_linear_prepack(Tensor W) -> Tensor W_prepack",
+            c10::RegisterOperators::options().kernel<QLinearPackWeightInt8>(
+                QuantizedCPUTensorId()));
 } // namespace
 } // namespace native
 } // namespace at
@@ -1,7 +1,8 @@
 #include <ATen/ATen.h>
 #include <ATen/core/op_registration/op_registration.h>
-#include <ATen/cpp_custom_type_hack.h>
 #include <ATen/native/quantized/cpu/fbgemm_utils.h>
+#include <ATen/native/quantized/cpu/packed_weights.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
 
 namespace at {
 namespace native {
@@ -9,11 +10,31 @@ namespace {
 
 class QLinearUnpackWeightInt8 final : public c10::OperatorKernel {
  public:
-#ifdef USE_FBGEMM
   at::Tensor operator()(at::Tensor packed_weight) {
+    auto& ctx = at::globalContext();
+
+#ifdef USE_FBGEMM
+    if (ctx.qEngine() == at::QEngine::FBGEMM) {
+      return fbgemm_linear_unpack(packed_weight);
+    }
+#endif
+#ifdef USE_QNNPACK
+    if (ctx.qEngine() == at::QEngine::QNNPACK) {
+      return qnnpack_linear_unpack(packed_weight);
+    }
+#endif
+    TORCH_CHECK(
+        false,
+        "Didn't find engine for operation quantized::linear_unpack ",
+        toString(ctx.qEngine()));
+  }
+
+ private:
+#ifdef USE_FBGEMM
+  at::Tensor fbgemm_linear_unpack(at::Tensor packed_weight) {
     // Pull out the PackBMatrix instance from the owning tensor.
-    auto& pack_ptr =
-        cpp_custom_type_hack::cast<PackedLinearWeight>(packed_weight);
+    auto& pack_ptr = cast_packed_weights<PackedLinearWeight>(
+        packed_weight, "quantized::linear_unpack");
     auto packB = pack_ptr.w.get();
 
     int64_t N = static_cast<int64_t>(packB->numCols());
@@ -35,22 +56,24 @@ class QLinearUnpackWeightInt8 final : public c10::OperatorKernel {
 
     return weight_origin;
   }
-#else // USE_FBGEMM
-  at::Tensor operator()(at::Tensor /* weight */
-  ) {
-    // We make a strong guarantee that models using these operators will have
-    // the same numerics across different machines. Therefore, we do not provide
-    // a fallback path and rather fail loudly if we cannot run FBGEMM.
-    TORCH_CHECK(
-        false, "This PyTorch installation was not built with FBGEMM operators");
-  }
 #endif // USE_FBGEMM
+#ifdef USE_QNNPACK
+  at::Tensor qnnpack_linear_unpack(at::Tensor packed_weight) {
+    auto& pack_ptr = cast_packed_weights<PackedLinearWeightsQnnp>(
+        packed_weight, "quantized::linear_unpack");
+    return qnnpack_orig_weight(pack_ptr.orig_weight, pack_ptr.w_dtype);
+  }
+#endif // USE_QNNPACK
 };
 
-static auto registry = c10::RegisterOperators().op(
-    "quantized::fbgemm_linear_unpack(Tensor W_prepack) -> Tensor W_origin",
-    c10::RegisterOperators::options().kernel<QLinearUnpackWeightInt8>(
-        CPUTensorId()));
+static auto registry =
+    c10::RegisterOperators()
+        .op("quantized::linear_unpack(Tensor W_prepack) -> Tensor W_origin",
+            c10::RegisterOperators::options().kernel<QLinearUnpackWeightInt8>(
+                CPUTensorId()))
+        .op("quantized::fbgemm_linear_unpack(Tensor W_prepack) -> Tensor W_origin",
+            c10::RegisterOperators::options().kernel<QLinearUnpackWeightInt8>(
+                CPUTensorId()));
 
 } // namespace
 } // namespace native
@@ -2,12 +2,17 @@
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/quantized/Quantizer.h>
 
 #include <algorithm>
 
 namespace at {
 namespace native {
+
+DEFINE_DISPATCH(qmul_stub);
+DEFINE_DISPATCH(qmul_relu_stub);
+
 namespace {
 
 inline void check_inputs(const Tensor& qa, const Tensor& qb) {
@@ -26,25 +31,11 @@ inline void check_inputs(const Tensor& qa, const Tensor& qb) {
 //       dtype.
 template <bool ReLUFused = false>
 Tensor _mul_out(Tensor& out, const Tensor& self, const Tensor& other) {
-  int64_t zero_point = out.q_zero_point();
-  double scale = out.q_scale();
-  int64_t self_zero_point = self.q_zero_point();
-  double self_scale = self.q_scale();
-  int64_t other_zero_point = other.q_zero_point();
-  double other_scale = other.q_scale();
-
-  auto iter = TensorIterator::binary_op(out, self, other);
-  AT_DISPATCH_QINT_TYPES(out.scalar_type(), "qmul", [&]() {
-    cpu_kernel(iter, [&](scalar_t a, scalar_t b) -> scalar_t {
-      const auto da = at::dequantize_val(self_scale, self_zero_point, a);
-      const auto db = at::dequantize_val(other_scale, other_zero_point, b);
-      float c = da * db;
-      if (ReLUFused) {
-        c = std::max<float>(c, 0.0);
-      }
-      return at::quantize_val<scalar_t>(scale, zero_point, c);
-    });
-  });
+  if (ReLUFused) {
+    qmul_relu_stub(kCPU, out, self, other);
+  } else {
+    qmul_stub(kCPU, out, self, other);
+  }
   return out;
 }
 
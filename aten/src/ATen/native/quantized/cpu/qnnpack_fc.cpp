@@ -2,9 +2,9 @@
 #include <ATen/Config.h>
 #include <ATen/core/op_registration/op_registration.h>
 #include <ATen/quantized/Quantizer.h>
-#include <caffe2/utils/threadpool/ThreadPoolMobile.h>
 
-#include "init_qnnpack.h"
+#include <limits>
+
 #include "qnnpack_utils.h"
 
 namespace at {
@@ -52,57 +52,23 @@ class QNNPACKLinear final : public torch::OperatorKernel {
         bias.sizes(),
         " instead");
 
-    initQNNPACK();
-
-    // Allocate output Tensor and a buffer for QNNPACK to use
+    // Allocate output Tensor
     Tensor output = at::_empty_affine_quantized(
         {rows_x, rows_y}, input.options(), output_scale, output_zero_point);
 
-    qnnp_operator_t qnnpack_operator{nullptr};
-
     // QNNPACK expects both weights and inputs to be uint8
-    const qnnp_status createStatus = qnnp_create_fully_connected_nc_q8(
-        cols_x /* input channels */,
-        rows_y /* output channels */,
-        input_contig.q_zero_point() /* input zero_point */,
-        input_contig.q_scale() /* input scale */,
-        weight.q_zero_point() /* kernel zero_point */,
-        weight.q_scale() /* kernel scale */,
-        (uint8_t*)weight.data_ptr<c10::quint8>() /* kernel data */,
-        (int32_t*)bias.data_ptr<c10::qint32>() /* bias data */,
-        output.q_zero_point() /* output zero_point */,
-        output.q_scale() /* output scale */,
+    qnnpack_fully_connected(
+        input_contig,
+        qnnpack_uint8_weight(weight),
+        qnnpack_bias(
+            bias.defined() ? c10::optional<Tensor>(bias) : c10::nullopt,
+            rows_y),
+        output,
+        rows_x,
+        cols_x,
+        rows_y,
         std::numeric_limits<uint8_t>::min() /* output_min */,
-        std::numeric_limits<uint8_t>::max() /* output_max */,
-        0 /* flags */,
-        &qnnpack_operator);
-
-    std::unique_ptr<qnnp_operator, QnnpackOperatorDeleter> qnnpack_uniq_ptr(
-        qnnpack_operator);
-
-    TORCH_INTERNAL_ASSERT(
-        createStatus == qnnp_status_success,
-        "failed to create QNNPACK Linear operator");
-    TORCH_INTERNAL_ASSERT(qnnpack_operator != nullptr);
-
-    const qnnp_status setupStatus = qnnp_setup_fully_connected_nc_q8(
-        qnnpack_operator /* fully_connected */,
-        rows_x /* batch_size */,
-        (uint8_t*)input_contig.data_ptr<c10::quint8>() /* input */,
-        cols_x /* input stride */,
-        (uint8_t*)output.data_ptr<c10::quint8>() /* output */,
-        rows_y /* output stride */);
-
-    TORCH_INTERNAL_ASSERT(
-        setupStatus == qnnp_status_success,
-        "failed to setup QNNPACK Linear operator");
-    pthreadpool_t threadpool = caffe2::mobile_threadpool();
-
-    const qnnp_status runStatus =
-        qnnp_run_operator(qnnpack_operator, threadpool);
-
-    TORCH_INTERNAL_ASSERT(
-        runStatus == qnnp_status_success, "failed to run QNNPACK operator");
+        std::numeric_limits<uint8_t>::max() /* output_max */);
 
     return output;
   }
@@ -1,11 +1,165 @@
 #pragma once
 
 #ifdef USE_QNNPACK
+#include <ATen/ATen.h>
+#include <caffe2/utils/threadpool/ThreadPoolMobile.h>
 #include <qnnpack.h>
 
+#include "init_qnnpack.h"
+
 struct QnnpackOperatorDeleter {
   void operator()(qnnp_operator_t op) {
     qnnp_delete_operator(op);
   }
 };
+
+// QNNPACK packs the weights when the operator is created, together with the
+// quantization parameters of the input and the output, which are only known
+// when the operator runs. The prepacking step therefore only converts the
+// weights to the uint8 representation QNNPACK expects; the operator is created
+// from them on every call. w_dtype is the type of the weights given to the
+// prepack op, which the unpack op returns.
+struct PackedLinearWeightsQnnp {
+  static constexpr c10::QEngine engine = c10::QEngine::QNNPACK;
+  at::Tensor orig_weight; // uint8, [N, K]
+  double w_scale;
+  int64_t w_zp;
+  c10::ScalarType w_dtype;
+};
+
+struct PackedConvWeightsQnnp {
+  static constexpr c10::QEngine engine = c10::QEngine::QNNPACK;
+  at::Tensor orig_weight; // uint8, [O, kH, kW, I/G]
+  std::vector<int64_t> kernel;
+  double w_scale;
+  int64_t w_zp;
+  c10::ScalarType w_dtype;
+};
+
+// The quantized weights are created as qint8 (which is what FBGEMM consumes)
+// and converted to quint8 for QNNPACK by shifting both the values and the zero
+// point by 128, which leaves the represented real values unchanged.
+inline at::Tensor qnnpack_uint8_weight(const at::Tensor& weight) {
+  TORCH_CHECK(
+      weight.qscheme() == at::kPerTensorAffine,
+      "QNNPACK only supports per tensor affine quantized weights");
+  if (weight.scalar_type() == at::kQUInt8) {
+    return weight.contiguous();
+  }
+  TORCH_CHECK(
+      weight.scalar_type() == at::kQInt8,
+      "QNNPACK expects qint8 or quint8 weights");
+  auto weight_contig = weight.contiguous();
+  auto weight_uint8 = at::_empty_affine_quantized(
+      weight_contig.sizes(),
+      at::device(at::kCPU).dtype(at::kQUInt8),
+      weight_contig.q_scale(),
+      weight_contig.q_zero_point() + 128);
+  const auto* src =
+      reinterpret_cast<const int8_t*>(weight_contig.data_ptr<c10::qint8>());
+  auto* dst = reinterpret_cast<uint8_t*>(weight_uint8.data_ptr<c10::quint8>());
+  for (int64_t i = 0; i < weight_contig.numel(); ++i) {
+    dst[i] = static_cast<uint8_t>(static_cast<int32_t>(src[i]) + 128);
+  }
+  return weight_uint8;
+}
+
+// Inverse of qnnpack_uint8_weight: the weights as they were given to the
+// prepack op, of type dtype.
+inline at::Tensor qnnpack_orig_weight(
+    const at::Tensor& weight,
+    c10::ScalarType dtype) {
+  if (dtype == at::kQUInt8) {
+    return weight;
+  }
+  auto weight_int8 = at::_empty_affine_quantized(
+      weight.sizes(),
+      at::device(at::kCPU).dtype(at::kQInt8),
+      weight.q_scale(),
+      weight.q_zero_point() - 128);
+  const auto* src =
+      reinterpret_cast<const uint8_t*>(weight.data_ptr<c10::quint8>());
+  auto* dst = reinterpret_cast<int8_t*>(weight_int8.data_ptr<c10::qint8>());
+  for (int64_t i = 0; i < weight.numel(); ++i) {
+    dst[i] = static_cast<int8_t>(static_cast<int32_t>(src[i]) - 128);
+  }
+  return weight_int8;
+}
+
+// QNNPACK reads the bias unconditionally; a missing bias is passed as zeros.
+inline at::Tensor qnnpack_bias(
+    const c10::optional<at::Tensor>& bias,
+    int64_t output_channels) {
+  if (!bias.has_value()) {
+    return at::zeros({output_channels}, at::device(at::kCPU).dtype(at::kInt));
+  }
+  const at::Tensor& bias_vec = bias.value();
+  TORCH_CHECK(bias_vec.dim() == 1, "bias should be a vector (1D Tensor)");
+  TORCH_CHECK(
+      bias_vec.size(0) == output_channels,
+      "bias should have ",
+      output_channels,
+      " elements");
+  return bias_vec.is_quantized() ? bias_vec.int_repr().contiguous()
+                                 : bias_vec.contiguous();
+}
+
+// output[M, N] = input[M, K] x weight[N, K]^T + bias[N], requantized to the
+// parameters of output and clamped to [output_min, output_max]. All the
+// tensors are contiguous; input, weight and output are quint8, bias is int32.
+inline void qnnpack_fully_connected(
+    const at::Tensor& input,
+    const at::Tensor& weight,
+    const at::Tensor& bias,
+    at::Tensor& output,
+    int64_t M,
+    int64_t K,
+    int64_t N,
+    uint8_t output_min,
+    uint8_t output_max) {
+  TORCH_CHECK(
+      input.q_scale() * weight.q_scale() / output.q_scale() < 1.0,
+      "QNNPACK requires the output scale to be larger than the product of "
+      "the input and weight scales");
+  at::native::initQNNPACK();
+
+  qnnp_operator_t qnnpack_operator{nullptr};
+  const qnnp_status createStatus = qnnp_create_fully_connected_nc_q8(
+      K /* input channels */,
+      N /* output channels */,
+      input.q_zero_point() /* input zero_point */,
+      input.q_scale() /* input scale */,
+      weight.q_zero_point() /* kernel zero_point */,
+      weight.q_scale() /* kernel scale */,
+      (uint8_t*)weight.data_ptr<c10::quint8>() /* kernel data */,
+      bias.data_ptr<int32_t>() /* bias data */,
+      output.q_zero_point() /* output zero_point */,
+      output.q_scale() /* output scale */,
+      output_min,
+      output_max,
+      0 /* flags */,
+      &qnnpack_operator);
+  std::unique_ptr<qnnp_operator, QnnpackOperatorDeleter> qnnpack_uniq_ptr(
+      qnnpack_operator);
+  TORCH_INTERNAL_ASSERT(
+      createStatus == qnnp_status_success,
+      "failed to create QNNPACK Linear operator");
+  TORCH_INTERNAL_ASSERT(qnnpack_operator != nullptr);
+
+  const qnnp_status setupStatus = qnnp_setup_fully_connected_nc_q8(
+      qnnpack_operator /* fully_connected */,
+      M /* batch_size */,
+      (uint8_t*)input.data_ptr<c10::quint8>() /* input */,
+      K /* input stride */,
+      (uint8_t*)output.data_ptr<c10::quint8>() /* output */,
+      N /* output stride */);
+  TORCH_INTERNAL_ASSERT(
+      setupStatus == qnnp_status_success,
+      "failed to setup QNNPACK Linear operator");
+
+  const qnnp_status runStatus =
+      qnnp_run_operator(qnnpack_operator, caffe2::mobile_threadpool());
+  TORCH_INTERNAL_ASSERT(
+      runStatus == qnnp_status_success, "failed to run QNNPACK operator");
+}
 #endif
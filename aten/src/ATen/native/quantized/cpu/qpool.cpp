@@ -5,80 +5,93 @@
 #include <ATen/native/Pool.h>
 #include <ATen/native/TensorIterator.h>
 #include <ATen/native/cpu/Loops.h>
+#include <ATen/native/quantized/cpu/qnnpack_utils.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/quantized/Quantizer.h>
 
 #include <algorithm>
+#include <limits>
 #include <vector>
 
 namespace at {
 namespace native {
-namespace {
 
-/* Computes the spatial 2D max pooling with dilation.
+DEFINE_DISPATCH(qmaxpool_2d_stub);
+
+namespace {
 
-Argument description in the argument list.
-*/
-template <typename T>
-void spatial_dilated_max_pooling(
-    const T* iData,
-    int64_t iC, // input/output channels
-    int64_t iH,
-    int64_t iW, // input sizes
+#ifdef USE_QNNPACK
+// QNNPACK pools NHWC tensors: the input is permuted to channels-last, and the
+// result is permuted back to NCHW.
+Tensor qnnpack_maxpool_2d(
+    const Tensor& qx, // 4-dimensional, NCHW
     int64_t oH,
-    int64_t oW, // output sizes
+    int64_t oW,
     int64_t kH,
-    int64_t kW, // kernel size
+    int64_t kW,
     int64_t sH,
-    int64_t sW, // strides
+    int64_t sW,
     int64_t pH,
-    int64_t pW, // padding
+    int64_t pW,
     int64_t dH,
-    int64_t dW, // dilation
-    T* oData,
-    int64_t* index) { // output arrays (data and max-index)
-  at::parallel_for(0, iC, 0, [&](int64_t start, int64_t end) {
-    for (auto p = start; p < end; ++p) {
-      int64_t row, col;
-      const T* i_p = iData + p * iW * iH;
-      for (row = 0; row < oH; ++row) {
-        for (col = 0; col < oW; ++col) {
-          int64_t h_start = row * sH - pH;
-          int64_t w_start = col * sW - pW;
-          int64_t h_end = std::min(h_start + (kH - 1) * dH + 1, iH);
-          int64_t w_end = std::min(w_start + (kW - 1) * dW + 1, iW);
-          while (h_start < 0)
-            h_start += dH;
-          while (w_start < 0)
-            w_start += dW;
-
-          // local pointers
-          T* o_p = oData + p * oW * oH + row * oW + col;
-          int64_t* ind_p = index + p * oW * oH + row * oW + col;
-
-          // local max
-          int64_t max_index = -1;
-          auto max_val = std::numeric_limits<typename T::underlying>::lowest();
-          int64_t tcntr = 0; // center point
-          int64_t x, y;
-          for (y = h_start; y < h_end; y += dH) {
-            for (x = w_start; x < w_end; x += dW) {
-              tcntr = y * iW + x;
-              auto val = (i_p + tcntr)->val_;
-              if (val > max_val) {
-                max_val = val;
-                max_index = tcntr;
-              }
-            }
-          }
-          *o_p = T(max_val); // Output.
-          *ind_p = max_index; // Max index for backprop.
-        }
-      }
-    }
-  });
+    int64_t dW) {
+  int64_t nbatch = qx.size(0);
+  int64_t iC = qx.size(1);
+  int64_t iH = qx.size(2);
+  int64_t iW = qx.size(3);
+  Tensor qx_nhwc = qx.permute({0, 2, 3, 1}).contiguous();
+  Tensor qy_nhwc = at::_empty_affine_quantized(
+      {nbatch, oH, oW, iC}, qx.options(), qx.q_scale(), qx.q_zero_point());
+
+  initQNNPACK();
+
+  qnnp_operator_t qnnpack_operator{nullptr};
+  const qnnp_status createStatus = qnnp_create_max_pooling2d_nhwc_u8(
+      pH /* input_padding_top */,
+      pW /* input_padding_right */,
+      pH /* input_padding_bottom */,
+      pW /* input_padding_left */,
+      kH /* pooling_height */,
+      kW /* pooling_width */,
+      sH /* stride_height */,
+      sW /* stride_width */,
+      dH /* dilation_height */,
+      dW /* dilation_width */,
+      iC /* channels */,
+      std::numeric_limits<uint8_t>::min() /* output_min */,
+      std::numeric_limits<uint8_t>::max() /* output_max */,
+      0 /* flags */,
+      &qnnpack_operator);
+  std::unique_ptr<qnnp_operator, QnnpackOperatorDeleter> qnnpack_uniq_ptr(
+      qnnpack_operator);
+  TORCH_INTERNAL_ASSERT(
+      createStatus == qnnp_status_success,
+      "failed to create QNNPACK Max Pooling operator");
+  TORCH_INTERNAL_ASSERT(qnnpack_operator != nullptr);
+
+  const qnnp_status setupStatus = qnnp_setup_max_pooling2d_nhwc_u8(
+      qnnpack_operator,
+      nbatch /* batch_size */,
+      iH /* input_height */,
+      iW /* input_width */,
+      (uint8_t*)qx_nhwc.data_ptr<c10::quint8>() /* input */,
+      iC /* input_pixel_stride */,
+      (uint8_t*)qy_nhwc.data_ptr<c10::quint8>() /* output */,
+      iC /* output_pixel_stride */,
+      nullptr /* threadpool */);
+  TORCH_INTERNAL_ASSERT(
+      setupStatus == qnnp_status_success,
+      "failed to setup QNNPACK Max Pooling operator");
+
+  const qnnp_status runStatus =
+      qnnp_run_operator(qnnpack_operator, caffe2::mobile_threadpool());
+  TORCH_INTERNAL_ASSERT(
+      runStatus == qnnp_status_success, "failed to run QNNPACK operator");
+
+  return qy_nhwc.permute({0, 3, 1, 2}).contiguous();
 }
+#endif // USE_QNNPACK
 
-template <typename Q>
 Tensor q_maxpool_2d(
     Tensor qx, // Input Tensor (Quantized)
     int64_t kH,
@@ -133,6 +146,19 @@ Tensor q_maxpool_2d(
   int64_t oW = pooling_output_shape(iW, kW, pW, sW, dW, false);
   TORCH_CHECK(oH > 0 && oW > 0, "the resulting Tensor is too small.");
 
+#ifdef USE_QNNPACK
+  // QNNPACK rejects 1x1 pooling, which the native kernel handles.
+  if (at::globalContext().qEngine() == at::QEngine::QNNPACK &&
+      qx.scalar_type() == kQUInt8 && kH * kW > 1) {
+    if (ndim == 3) {
+      return qnnpack_maxpool_2d(
+                 qx.unsqueeze(0), oH, oW, kH, kW, sH, sW, pH, pW, dH, dW)
+          .squeeze(0);
+    }
+    return qnnpack_maxpool_2d(qx, oH, oW, kH, kW, sH, sW, pH, pW, dH, dW);
+  }
+#endif
+
   std::vector<int64_t> oSizes;
   if (ndim == 3) {
     oSizes = {oC, oH, oW};
@@ -146,58 +172,23 @@ Tensor q_maxpool_2d(
       qx.q_scale(),
       qx.q_zero_point());
   auto qx_contig = qx.contiguous();
-  auto qxd = qx_contig.data_ptr<Q>();
-  auto qyd = qy.data_ptr<Q>();
-  std::vector<int64_t> index;
-  index.resize(qy.numel());
-
-  if (ndim == 3 || nbatch == 1) {
-    auto* iData = qxd;
-    auto* oData = qyd;
-    int64_t* indData = index.data();
-    spatial_dilated_max_pooling<Q>(
-        iData,
-        iC,
-        iH,
-        iW,
-        oH,
-        oW,
-        kH,
-        kW,
-        sH,
-        sW,
-        pH,
-        pW,
-        dH,
-        dW,
-        oData,
-        indData);
-  } else {
-    at::parallel_for(0, nbatch, 0, [&](int64_t start, int64_t end) {
-      for (auto p = start; p < end; ++p) {
-        auto* iData = qxd + p * iC * iW * iH;
-        auto* oData = qyd + p * oC * oW * oH;
-        int64_t* indData = index.data() + p * oC * oW * oH;
-        spatial_dilated_max_pooling<Q>(
-            iData,
-            iC,
-            iH,
-            iW,
-            oH,
-            oW,
-            kH,
-            kW,
-            sH,
-            sW,
-            pH,
-            pW,
-            dH,
-            dW,
-            oData,
-            indData);
-      }
-    });
-  }
+  qmaxpool_2d_stub(
+      kCPU,
+      qx_contig,
+      nbatch * iC,
+      iH,
+      iW,
+      oH,
+      oW,
+      kH,
+      kW,
+      sH,
+      sW,
+      pH,
+      pW,
+      dH,
+      dW,
+      qy);
   return qy;
 }
 } // namespace
@@ -218,20 +209,16 @@ Tensor quantized_max_pool2d(
   if (stride.empty()) {
     stride = kernel_size;
   }
-  Tensor qy;
-  AT_DISPATCH_QINT_TYPES(qx.scalar_type(), "max_pool2d", [&]() {
-    qy = q_maxpool_2d<scalar_t>(
-        qx,
-        kernel_size[0],
-        kernel_size[1],
-        stride[0],
-        stride[1],
-        padding[0],
-        padding[1],
-        dilation[0],
-        dilation[1]);
-  });
-  return qy;
+  return q_maxpool_2d(
+      qx,
+      kernel_size[0],
+      kernel_size[1],
+      stride[0],
+      stride[1],
+      padding[0],
+      padding[1],
+      dilation[0],
+      dilation[1]);
 }
 
 // Keep the registry in the anonymous namespace.
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <ATen/ATen.h>
+#include <ATen/native/DispatchStub.h>
+
+#include <vector>
+
+namespace at {
+namespace native {
+
+// Kernels of the per-tensor quantized CPU operators, implemented on
+// Vec256<qint8/quint8/qint32> in kernels/QuantizedOpKernels.cpp. The
+// operators check their arguments and allocate the outputs.
+
+// (qx, qy): qy <- relu(qx), relu6(qx); qy may be qx
+using qrelu_fn = void (*)(const Tensor& /*qx*/, Tensor& /*qy*/);
+// (out, self, other): out <- self op other, all three of the same shape
+using qbinary_fn =
+    void (*)(Tensor& /*out*/, const Tensor& /*self*/, const Tensor& /*other*/);
+using qmaxpool_2d_fn = void (*)(
+    const Tensor& /*qx (contiguous)*/,
+    int64_t /*nbatch * iC*/,
+    int64_t /*iH*/,
+    int64_t /*iW*/,
+    int64_t /*oH*/,
+    int64_t /*oW*/,
+    int64_t /*kH*/,
+    int64_t /*kW*/,
+    int64_t /*sH*/,
+    int64_t /*sW*/,
+    int64_t /*pH*/,
+    int64_t /*pW*/,
+    int64_t /*dH*/,
+    int64_t /*dW*/,
+    Tensor& /*qy*/);
+using qadaptive_avg_pool2d_fn = void (*)(
+    const Tensor& /*qx*/,
+    Tensor& /*qy*/,
+    int64_t /*b*/,
+    int64_t /*sizeD*/,
+    int64_t /*isizeH*/,
+    int64_t /*isizeW*/,
+    int64_t /*osizeH*/,
+    int64_t /*osizeW*/,
+    int64_t /*istrideB*/,
+    int64_t /*istrideD*/,
+    int64_t /*istrideH*/,
+    int64_t /*istrideW*/);
+// (qxs, dim, qy): qy <- cat(qxs, dim), requantized to the parameters of qy;
+// the inputs are contiguous and qy has the shape of the result
+using qcat_fn = void (*)(
+    const std::vector<Tensor>& /*qxs*/,
+    int64_t /*dim*/,
+    Tensor& /*qy*/);
+// (rtensor, qtensor, scales, zero_points, axis) for quantization and
+// (qtensor, rtensor, scales, zero_points, axis) for dequantization, with
+// contiguous tensors
+using quantize_tensor_per_channel_affine_fn = void (*)(
+    const Tensor& /*src*/,
+    Tensor& /*dst*/,
+    const std::vector<double>& /*scales*/,
+    const std::vector<int64_t>& /*zero_points*/,
+    int64_t /*axis*/);
+
+DECLARE_DISPATCH(qrelu_fn, qrelu_stub);
+DECLARE_DISPATCH(qrelu_fn, qrelu6_stub);
+DECLARE_DISPATCH(qbinary_fn, qadd_stub);
+DECLARE_DISPATCH(qbinary_fn, qadd_relu_stub);
+DECLARE_DISPATCH(qbinary_fn, qmul_stub);
+DECLARE_DISPATCH(qbinary_fn, qmul_relu_stub);
+DECLARE_DISPATCH(qmaxpool_2d_fn, qmaxpool_2d_stub);
+DECLARE_DISPATCH(qadaptive_avg_pool2d_fn, qadaptive_avg_pool2d_stub);
+DECLARE_DISPATCH(qcat_fn, qcat_stub);
+DECLARE_DISPATCH(qcat_fn, qcat_relu_stub);
+DECLARE_DISPATCH(
+    quantize_tensor_per_channel_affine_fn,
+    quantize_tensor_per_channel_affine_stub);
+DECLARE_DISPATCH(
+    quantize_tensor_per_channel_affine_fn,
+    dequantize_tensor_per_channel_affine_stub);
+
+} // namespace native
+} // namespace at
@@ -0,0 +1,292 @@
+// Basic functions on sparse CSR tensors
+
+#include <algorithm>
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <ATen/Dispatch.h>
+#include <ATen/InitialTensorOptions.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/Parallel.h>
+#include <ATen/SparseCsrTensorImpl.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse;
+using namespace at::sparse_csr;
+
+/******************************************************************************
+ * access methods
+ * See NOTE [ Sparse CSR: API ] in native_functions.yaml
+ ******************************************************************************/
+
+int64_t _nnz_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->nnz();
+}
+
+Tensor crow_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->crow_indices().alias();
+}
+
+Tensor col_indices_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->col_indices().alias();
+}
+
+Tensor values_sparse_csr(const SparseCsrTensor& self) {
+  return get_sparse_csr_impl(self)->values().alias();
+}
+
+/******************************************************************************
+ * creation methods
+ ******************************************************************************/
+
+namespace {
+
+SparseCsrTensor new_sparse_csr(const TensorOptions& options) {
+  AT_ASSERT(!options.is_variable());  // TODO: remove this when Variable and Tensor are merged
+  AT_ASSERT(options.layout() == kSparseCsr);
+  TORCH_CHECK(options.device().is_cpu(), "sparse CSR tensors are only supported on CPU, but got device ", options.device());
+  return detail::make_tensor<SparseCsrTensorImpl>(SparseCsrCPUTensorId(), options.dtype());
+}
+
+Tensor shallow_copy(const Tensor& tensor) {
+  // The member tensors of a sparse CSR tensor don't contain AutogradMeta,
+  // see new_with_dims_and_tensor_sparse
+  return Tensor(tensor.unsafeGetTensorImpl()->shallow_copy_and_detach(
+      /*version_counter=*/tensor.unsafeGetTensorImpl()->version_counter(),
+      /*allow_tensor_metadata_change=*/true));
+}
+
+SparseCsrTensor make_sparse_csr(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size) {
+  SparseCsrTensor self = new_sparse_csr(values.options().layout(kSparseCsr));
+  get_sparse_csr_impl(self)->set_member_tensors_unsafe(crow_indices, col_indices, values, size);
+  return self;
+}
+
+} // namespace
+
+Tensor empty_sparse_csr(IntArrayRef size, const TensorOptions& options, c10::optional<MemoryFormat> optional_memory_format) {
+  TORCH_CHECK(!options.pinned_memory(), "Only dense CPU tensors can be pinned");
+  SparseCsrTensor self = new_sparse_csr(options);
+  get_sparse_csr_impl(self)->resize_and_clear_(size);
+  return self;
+}
+
+SparseCsrTensor new_with_tensors_sparse_csr(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size,
+    const TensorOptions& options) {
+  SparseCsrTensor self = new_sparse_csr(options);
+  get_sparse_csr_impl(self)->set_member_tensors_unsafe(
+      shallow_copy(crow_indices), shallow_copy(col_indices), shallow_copy(values), size);
+  return self;
+}
+
+Tensor sparse_csr_tensor(
+    const Tensor& crow_indices,
+    const Tensor& col_indices,
+    const Tensor& values,
+    IntArrayRef size,
+    const TensorOptions& options) {
+  TORCH_CHECK(!options.has_layout() || options.layout() == kSparseCsr, "expected sparse CSR layout, but got layout ", options.layout());
+  TORCH_CHECK(size.size() == 2, "sparse CSR tensors must be matrices, but got size ", size);
+  TORCH_CHECK(size[0] >= 0 && size[1] >= 0, "sparse CSR tensors must have non-negative sizes, but got ", size);
+  // the following checks are redundant because they are also checked in
+  // SparseCsrTensorImpl::set_member_tensors_unsafe, but we need them to read
+  // the indices.
+  TORCH_CHECK(crow_indices.dim() == 1 && crow_indices.size(0) == size[0] + 1,
+      "crow_indices must have rows + 1 = ", size[0] + 1, " elements, but got size ", crow_indices.sizes());
+  TORCH_CHECK(col_indices.dim() == 1, "col_indices must be one dimensional, but got size ", col_indices.sizes());
+  TORCH_CHECK(crow_indices.scalar_type() == kLong && col_indices.scalar_type() == kLong,
+      "crow_indices and col_indices must be int64 tensors");
+
+  auto cpu_crow_indices = crow_indices.to(kCPU).contiguous();
+  auto cpu_col_indices = col_indices.to(kCPU).contiguous();
+  const int64_t* crow = cpu_crow_indices.data_ptr<int64_t>();
+  const int64_t* col = cpu_col_indices.data_ptr<int64_t>();
+  const int64_t nnz = col_indices.size(0);
+  TORCH_CHECK(crow[0] == 0, "crow_indices must start with 0, but got ", crow[0]);
+  TORCH_CHECK(crow[size[0]] == nnz,
+      "crow_indices must end with the number of entries ", nnz, ", but got ", crow[size[0]]);
+  for (int64_t row = 0; row < size[0]; row++) {
+    TORCH_CHECK(crow[row] <= crow[row + 1],
+        "crow_indices must be non-decreasing, but got ", crow[row], " before ", crow[row + 1]);
+    for (int64_t i = crow[row]; i < crow[row + 1]; i++) {
+      TORCH_CHECK(col[i] >= 0 && col[i] < size[1],
+          "size is inconsistent with col_indices: size is ", size[1], " but found index ", col[i]);
+      TORCH_CHECK(i == crow[row] || col[i - 1] < col[i],
+          "col_indices must be sorted and unique within every row, but found ", col[i - 1],
+          " before ", col[i], " in row ", row);
+    }
+  }
+
+  Tensor cast_values = options.has_dtype() ? values.to(typeMetaToScalarType(options.dtype())) : values;
+  return at::_sparse_csr_tensor_unsafe(
+      crow_indices, col_indices, cast_values, size, cast_values.options().layout(kSparseCsr));
+}
+
+/******************************************************************************
+ * conversions
+ ******************************************************************************/
+
+SparseCsrTensor dense_to_sparse_csr(const Tensor& self) {
+  TORCH_CHECK(self.dim() == 2, "to_sparse_csr: only matrices can be converted, but got a ", self.dim(), "D tensor");
+  const int64_t rows = self.size(0);
+  const int64_t cols = self.size(1);
+  Tensor input = self.contiguous();
+
+  // Count the entries of every row, then fill the rows in parallel at the
+  // offsets given by the prefix sum of the counts
+  Tensor crow_indices = at::empty({rows + 1}, self.options().dtype(kLong));
+  int64_t* crow = crow_indices.data_ptr<int64_t>();
+  crow[0] = 0;
+  Tensor col_indices;
+  Tensor values;
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, self.scalar_type(), "dense_to_sparse_csr", [&] {
+    const scalar_t* input_ptr = input.data_ptr<scalar_t>();
+    at::parallel_for(0, rows, std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(cols, 1)), [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        int64_t count = 0;
+        for (int64_t c = 0; c < cols; c++) {
+          count += input_ptr[row * cols + c] != scalar_t(0);
+        }
+        crow[row + 1] = count;
+      }
+    });
+    for (int64_t row = 0; row < rows; row++) {
+      crow[row + 1] += crow[row];
+    }
+
+    col_indices = at::empty({crow[rows]}, crow_indices.options());
+    values = at::empty({crow[rows]}, input.options());
+    int64_t* col = col_indices.data_ptr<int64_t>();
+    scalar_t* values_ptr = values.data_ptr<scalar_t>();
+    at::parallel_for(0, rows, std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(cols, 1)), [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        int64_t i = crow[row];
+        for (int64_t c = 0; c < cols; c++) {
+          const scalar_t value = input_ptr[row * cols + c];
+          if (value != scalar_t(0)) {
+            col[i] = c;
+            values_ptr[i] = value;
+            i++;
+          }
+        }
+      }
+    });
+  });
+  return make_sparse_csr(crow_indices, col_indices, values, self.sizes());
+}
+
+SparseCsrTensor sparse_to_sparse_csr(const SparseTensor& self) {
+  TORCH_CHECK(self.sparse_dim() == 2 && self.dense_dim() == 0,
+      "to_sparse_csr: only sparse matrices with scalar values can be converted, but got sparse_dim ",
+      self.sparse_dim(), " and dense_dim ", self.dense_dim());
+  // A coalesced COO matrix is sorted by row, then by column, which is the
+  // order of the entries of a CSR matrix
+  SparseTensor coalesced = self.coalesce();
+  const int64_t rows = self.size(0);
+  const int64_t nnz = coalesced._nnz();
+  Tensor row_indices = coalesced._indices().select(0, 0).contiguous();
+  const int64_t* row_ptr = row_indices.data_ptr<int64_t>();
+
+  Tensor crow_indices = at::zeros({rows + 1}, row_indices.options());
+  int64_t* crow = crow_indices.data_ptr<int64_t>();
+  for (int64_t i = 0; i < nnz; i++) {
+    crow[row_ptr[i] + 1]++;
+  }
+  for (int64_t row = 0; row < rows; row++) {
+    crow[row + 1] += crow[row];
+  }
+  return make_sparse_csr(
+      crow_indices,
+      coalesced._indices().select(0, 1).clone(),
+      coalesced._values().clone(),
+      self.sizes());
+}
+
+SparseTensor sparse_csr_to_sparse(const SparseCsrTensor& self) {
+  auto impl = get_sparse_csr_impl(self);
+  const int64_t rows = self.size(0);
+  const int64_t* crow = impl->crow_indices().data_ptr<int64_t>();
+  Tensor indices = at::empty({2, impl->nnz()}, impl->col_indices().options());
+  int64_t* row_ptr = indices.data_ptr<int64_t>();
+  at::parallel_for(0, rows, at::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end; row++) {
+      std::fill(row_ptr + crow[row], row_ptr + crow[row + 1], row);
+    }
+  });
+  indices.select(0, 1).copy_(impl->col_indices());
+  SparseTensor sparse = at::_sparse_coo_tensor_unsafe(
+      indices, impl->values().clone(), self.sizes(), impl->values().options().layout(kSparse));
+  return sparse._coalesced_(true);
+}
+
+Tensor sparse_csr_to_dense(const SparseCsrTensor& self) {
+  auto impl = get_sparse_csr_impl(self);
+  const int64_t rows = self.size(0);
+  const int64_t cols = self.size(1);
+  Tensor dense = at::zeros(self.sizes(), impl->values().options());
+  const int64_t* crow = impl->crow_indices().data_ptr<int64_t>();
+  const int64_t* col = impl->col_indices().data_ptr<int64_t>();
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, dense.scalar_type(), "sparse_csr_to_dense", [&] {
+    const scalar_t* values_ptr = impl->values().data_ptr<scalar_t>();
+    scalar_t* dense_ptr = dense.data_ptr<scalar_t>();
+    at::parallel_for(0, rows, std::max<int64_t>(1, at::internal::GRAIN_SIZE / std::max<int64_t>(cols, 1)), [&](int64_t begin, int64_t end) {
+      for (int64_t row = begin; row < end; row++) {
+        for (int64_t i = crow[row]; i < crow[row + 1]; i++) {
+          dense_ptr[row * cols + col[i]] = values_ptr[i];
+        }
+      }
+    });
+  });
+  return dense;
+}
+
+// The transpose of a CSR matrix is its CSC representation read as CSR: the
+// entries are bucketed by column with a counting sort. Rows are visited in
+// order, so the entries of every column come out sorted by row.
+SparseCsrTensor transpose_sparse_csr(const SparseCsrTensor& self) {
+  auto impl = get_sparse_csr_impl(self);
+  const int64_t rows = self.size(0);
+  const int64_t cols = self.size(1);
+  const int64_t nnz = impl->nnz();
+  const int64_t* crow = impl->crow_indices().data_ptr<int64_t>();
+  const int64_t* col = impl->col_indices().data_ptr<int64_t>();
+
+  Tensor t_crow_indices = at::zeros({cols + 1}, impl->crow_indices().options());
+  Tensor t_col_indices = at::empty({nnz}, impl->col_indices().options());
+  Tensor t_values = at::empty({nnz}, impl->values().options());
+  int64_t* t_crow = t_crow_indices.data_ptr<int64_t>();
+  int64_t* t_col = t_col_indices.data_ptr<int64_t>();
+  for (int64_t i = 0; i < nnz; i++) {
+    t_crow[col[i] + 1]++;
+  }
+  for (int64_t c = 0; c < cols; c++) {
+    t_crow[c + 1] += t_crow[c];
+  }
+  AT_DISPATCH_ALL_TYPES_AND(at::ScalarType::Bool, t_values.scalar_type(), "transpose_sparse_csr", [&] {
+    const scalar_t* values_ptr = impl->values().data_ptr<scalar_t>();
+    scalar_t* t_values_ptr = t_values.data_ptr<scalar_t>();
+    // next free position of every column
+    std::vector<int64_t> next(t_crow, t_crow + cols);
+    for (int64_t row = 0; row < rows; row++) {
+      for (int64_t i = crow[row]; i < crow[row + 1]; i++) {
+        const int64_t j = next[col[i]]++;
+        t_col[j] = row;
+        t_values_ptr[j] = values_ptr[i];
+      }
+    }
+  });
+  return make_sparse_csr(t_crow_indices, t_col_indices, t_values, {cols, rows});
+}
+
+}} // namespace at::native
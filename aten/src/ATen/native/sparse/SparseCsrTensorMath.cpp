@@ -0,0 +1,129 @@
+#include <ATen/ATen.h>
+#include <ATen/ExpandUtils.h>
+#include <ATen/NativeFunctions.h>
+#include <ATen/ScalarOps.h>
+#include <ATen/SparseCsrTensorUtils.h>
+#include <ATen/SparseTensorUtils.h>
+#include <ATen/native/SparseCsrMatmul.h>
+
+namespace at { namespace native {
+
+using namespace at::sparse_csr;
+
+DEFINE_DISPATCH(spmm_sparse_csr_stub);
+DEFINE_DISPATCH(spmv_sparse_csr_stub);
+
+// --------------------------------------------------------------------
+// addmm(D1, S, D2, beta, alpha) -> D  [S is a CSR matrix, no broadcast]
+//
+// D = beta * D1 + alpha * mm(S, D2)
+//
+// The rows of D are computed in parallel, see SparseCsrMatmulKernel.cpp
+// --------------------------------------------------------------------
+
+Tensor& addmm_out_sparse_csr_dense_cpu(
+    Tensor& r,
+    const Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  AT_ASSERT(!t.is_cuda());
+  TORCH_CHECK(!r.is_cuda(), "addmm: expected 'out' to be CPU tensor, but got CUDA tensor");
+  TORCH_CHECK(sparse.is_sparse_csr(), "addmm: expected 'mat1' to be a sparse CSR tensor, but got layout ", sparse.layout());
+  TORCH_CHECK(dense.layout() == kStrided, "addmm: expected 'mat2' to be a strided tensor, but got layout ", dense.layout());
+  TORCH_CHECK(!dense.is_cuda(), "addmm: expected 'mat2' to be a CPU tensor, but got a CUDA tensor");
+  TORCH_CHECK(dense.dim() == 2, "addmm: matrices expected, got ", dense.dim(), "D tensor");
+  TORCH_CHECK(sparse.scalar_type() == dense.scalar_type() && t.scalar_type() == dense.scalar_type(),
+      "addmm: expected all arguments to have the same dtype, but got ",
+      t.scalar_type(), ", ", sparse.scalar_type(), " and ", dense.scalar_type());
+
+  // ixj * jxk = ixk
+  int64_t dim_i = sparse.size(0);
+  int64_t dim_j = sparse.size(1);
+  int64_t dim_k = dense.size(1);
+
+  TORCH_CHECK(dense.size(0) == dim_j,
+      "addmm: Argument #3 (dense): Expected dim 0 size ", dim_j, ", got ", dense.size(0));
+  TORCH_CHECK(t.size(0) == dim_i,
+      "addmm: Argument #1 (t): Expected dim 0 size ", dim_i, ", got ", t.size(0));
+  TORCH_CHECK(t.size(1) == dim_k,
+      "addmm: Argument #1 (t): Expected dim 1 size ", dim_k, ", got ", t.size(1));
+
+  r.resize_({dim_i, dim_k});
+
+  // r = beta * t
+  AT_DISPATCH_ALL_TYPES(r.scalar_type(), "addmm_sparse_csr_dense", [&] {
+    scalar_t cast_beta = beta.to<scalar_t>();
+    if (cast_beta == 0) {
+      r.zero_();
+    } else if (cast_beta == 1) {
+      if (!at::sparse::is_same_tensor(r, t)) {
+        r.copy_(t);
+      }
+    } else {
+      at::mul_out(r, t, scalar_to_tensor(beta));
+    }
+  });
+
+  auto impl = get_sparse_csr_impl(sparse);
+  if (impl->nnz() == 0 || dim_k == 0) {
+    return r;
+  }
+  // The rows of `dense` are read with unit stride by the vectorized kernel
+  Tensor dense_rows = dense.stride(1) == 1 ? dense : dense.contiguous();
+  spmm_sparse_csr_stub(
+      kCPU, r, impl->crow_indices(), impl->col_indices(), impl->values(), dense_rows, alpha);
+  return r;
+}
+
+Tensor addmm_sparse_csr_dense_cpu(
+    const Tensor& t,
+    const SparseCsrTensor& sparse,
+    const Tensor& dense,
+    Scalar beta,
+    Scalar alpha
+) {
+  Tensor r = at::empty({0}, t.options());
+  addmm_out_sparse_csr_dense_cpu(r, t, sparse, dense, beta, alpha);
+  return r;
+}
+
+Tensor sparse_csr_mm(const SparseCsrTensor& self, const Tensor& dense) {
+  Tensor r = at::empty({0}, dense.options());
+  return sparse_csr_mm_out(r, self, dense);
+}
+
+Tensor& sparse_csr_mm_out(Tensor& result, const SparseCsrTensor& self, const Tensor& dense) {
+  TORCH_CHECK(dense.dim() == 2, "mm: matrices expected, got ", dense.dim(), "D tensor");
+  Tensor t = at::zeros({}, dense.options()).expand({self.size(0), dense.size(1)});
+  return at::_sparse_csr_addmm_out(result, t, self, dense, 0, 1);
+}
+
+// --------------------------------------------------------------------
+// mv(S, v) -> D  [S is a CSR matrix]
+// --------------------------------------------------------------------
+
+Tensor& sparse_csr_mv_out(Tensor& result, const SparseCsrTensor& self, const Tensor& vec) {
+  TORCH_CHECK(!result.is_cuda(), "mv: expected 'out' to be CPU tensor, but got CUDA tensor");
+  TORCH_CHECK(vec.layout() == kStrided && !vec.is_cuda(), "mv: expected 'vec' to be a strided CPU tensor");
+  TORCH_CHECK(vec.dim() == 1, "mv: vector expected, got ", vec.dim(), "D tensor");
+  TORCH_CHECK(vec.size(0) == self.size(1),
+      "mv: Argument #2 (vec): Expected size ", self.size(1), ", got ", vec.size(0));
+  TORCH_CHECK(self.scalar_type() == vec.scalar_type(),
+      "mv: expected both arguments to have the same dtype, but got ", self.scalar_type(), " and ", vec.scalar_type());
+
+  result.resize_({self.size(0)});
+  auto impl = get_sparse_csr_impl(self);
+  spmv_sparse_csr_stub(
+      kCPU, result, impl->crow_indices(), impl->col_indices(), impl->values(), vec);
+  return result;
+}
+
+Tensor sparse_csr_mv(const SparseCsrTensor& self, const Tensor& vec) {
+  Tensor result = at::empty({0}, vec.options());
+  return sparse_csr_mv_out(result, self, vec);
+}
+
+}} // namespace at::native
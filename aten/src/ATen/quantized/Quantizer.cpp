@@ -4,6 +4,7 @@
 #include <ATen/Dispatch.h>
 #include <ATen/NativeFunctions.h>
 #include <ATen/native/TensorFactories.h>
+#include <ATen/native/quantized/cpu/quantized_ops.h>
 #include <ATen/quantized/QTensorImpl.h>
 #include <ATen/core/Tensor.h>
 
@@ -156,7 +157,10 @@ T quantize_val(double scale, int64_t zero_point, float value) {
   constexpr int64_t qmin = std::numeric_limits<typename T::underlying>::min();
   constexpr int64_t qmax = std::numeric_limits<typename T::underlying>::max();
   checkZeroPoint<typename T::underlying>("quantize_val", zero_point);
-  qvalue = static_cast<int64_t>(std::nearbyint(value / scale + zero_point));
+  // Computed in float like fbgemm::Quantize and Vec256::quantize, which the
+  // vectorized kernels use, so that all of them round the same values.
+  qvalue = static_cast<int64_t>(
+      std::nearbyint(value / static_cast<float>(scale) + zero_point));
   qvalue = std::max<int64_t>(qvalue, qmin);
   qvalue = std::min<int64_t>(qvalue, qmax);
   return static_cast<T>(qvalue);
@@ -180,7 +184,7 @@ template <typename T>
 CAFFE2_API float dequantize_val(double scale, int64_t zero_point, T value) {
   // We need to convert the qint8 value to float to ensure the subtraction
   // subexpression returns a float
-  return (static_cast<float>(value.val_) - zero_point) * scale;
+  return (static_cast<float>(value.val_) - zero_point) * static_cast<float>(scale);
 }
 
 template <typename T>
@@ -230,7 +234,11 @@ template CAFFE2_API qint8 requantize_val<qint32, qint8>(double, int64_t, double,
 template CAFFE2_API quint8 requantize_val<qint32, quint8>(double, int64_t, double, int64_t, qint32);
 template CAFFE2_API qint32 requantize_val<qint32, qint32>(double, int64_t, double, int64_t, qint32);
 
-// TODO: add fbgemm for per channel
+namespace native {
+DEFINE_DISPATCH(quantize_tensor_per_channel_affine_stub);
+DEFINE_DISPATCH(dequantize_tensor_per_channel_affine_stub);
+} // namespace native
+
 template <typename T>
 Tensor quantize_tensor_per_channel_affine(Tensor rtensor,
                                           Tensor qtensor,
@@ -243,23 +251,13 @@ Tensor quantize_tensor_per_channel_affine(Tensor rtensor,
   checkZeroPoints<typename T::underlying>(fn_name, zero_points);
   int64_t channel_axis = axis[0];
   TORCH_CHECK(channel_axis < rtensor.dim(), "Channel axis out of range in per channel affine quantization.");
-  int64_t batches = size_to_dim_(channel_axis, rtensor.sizes());
-  int64_t elements_per_channel = size_from_dim_(channel_axis + 1, rtensor.sizes());
   int64_t channel = rtensor.size(channel_axis);
   TORCH_CHECK(channel == int64_t(scales.size()),
               "length of scales must equal to channel");
   TORCH_CHECK(channel == int64_t(zero_points.size()),
               "length of zero_points must equal to channel");
-  const float* rdata = rtensor.data_ptr<float>();
-  auto qdata = qtensor.data_ptr<T>();
-  for (auto b = 0; b < batches; ++b) {
-    for (auto c = 0; c < channel; ++c) {
-      for (auto e = 0; e < elements_per_channel; ++e) {
-        auto i = b * channel * elements_per_channel + c * elements_per_channel + e;
-        qdata[i] = quantize_val<T>(scales[c], zero_points[c], rdata[i]);
-      }
-    }
-  }
+  native::quantize_tensor_per_channel_affine_stub(
+      kCPU, rtensor, qtensor, scales, zero_points, channel_axis);
   return qtensor;
 }
 
@@ -276,25 +274,13 @@ Tensor dequantize_tensor_per_channel_affine(Tensor qtensor,
   int64_t channel_axis = axis[0];
   TORCH_CHECK(channel_axis < qtensor.dim(),
               "Channel axis out of range in per channel affine dequantization.");
-  int64_t batches = size_to_dim_(channel_axis, rtensor.sizes());
-  int64_t elements_per_channel = size_from_dim_(channel_axis + 1, rtensor.sizes());
   int64_t channel = rtensor.size(channel_axis);
   TORCH_CHECK(channel == int64_t(scales.size()),
               "length of scales must equal to channel");
   TORCH_CHECK(channel == int64_t(zero_points.size()),
               "length of zero_points must equal to channel");
-  const auto* qd = qtensor.data_ptr<T>();
-  float* rd = rtensor.data_ptr<float>();
-  for (auto b = 0; b < batches; ++b) {
-    for (auto c = 0; c < channel; ++c) {
-      for (auto e = 0; e < elements_per_channel; ++e) {
-        auto i = b * channel * elements_per_channel + c * elements_per_channel + e;
-        // We need to convert the qint8 value to float to ensure the subtraction
-        // subexpression returns a float
-        rd[i] = (static_cast<float>(qd[i].val_) - zero_points[c]) * scales[c];
-      }
-    }
-  }
+  native::dequantize_tensor_per_channel_affine_stub(
+      kCPU, qtensor, rtensor, scales, zero_points, channel_axis);
   return rtensor;
 }
 
@@ -6,6 +6,7 @@ import gc
 import sys
 import json
 import copy
+import time
 
 from .runner import get_nn_runners
 
@@ -45,12 +46,24 @@ def pretty_print(benchresult, colwidth=16, sep=' '):
 def trainbench(name, rnn_creator, nloops=100, warmup=10,
                seqLength=100, numLayers=1, inputSize=512, hiddenSize=512,
                miniBatch=64, device='cuda', seed=None):
+    class CPUEvent(object):
+        def record(self):
+            self.time = time.time()
+
+        def elapsed_time(self, end_event):
+            return (end_event.time - self.time) * 1000
+
+    def make_event():
+        # CUDA events for timing on the GPU, the wall clock on the CPU
+        if device == 'cpu':
+            return CPUEvent()
+        return torch.cuda.Event(enable_timing=True)
+
     def train_batch(modeldef):
-        # CUDA events for timing
-        fwd_start_event = torch.cuda.Event(enable_timing=True)
-        fwd_end_event = torch.cuda.Event(enable_timing=True)
-        bwd_start_event = torch.cuda.Event(enable_timing=True)
-        bwd_end_event = torch.cuda.Event(enable_timing=True)
+        fwd_start_event = make_event()
+        fwd_end_event = make_event()
+        bwd_start_event = make_event()
+        bwd_end_event = make_event()
 
         gc.collect()
 
@@ -78,13 +91,14 @@ def trainbench(name, rnn_creator, nloops=100, warmup=10,
                 assert param.grad is not None
                 param.grad.data.zero_()
 
-        torch.cuda.synchronize()
+        if device == 'cuda':
+            torch.cuda.synchronize()
 
         fwd_time = fwd_start_event.elapsed_time(fwd_end_event)
         bwd_time = bwd_start_event.elapsed_time(bwd_end_event)
         return fwd_time, bwd_time
 
-    assert device == 'cuda'
+    assert device in ('cuda', 'cpu')
     creator_args = dict(seqLength=seqLength, numLayers=numLayers,
                         inputSize=inputSize, hiddenSize=hiddenSize,
                         miniBatch=miniBatch, device=device, seed=seed)
@@ -105,6 +105,71 @@ op_bench.generate_pt_test(conv_2d_configs_short + conv_2d_configs_long,
                           ConvTranspose2dBenchmark)
 
 
+"""
+Microbenchmarks for the algorithms of CPU Conv2d, see
+torch._C._set_cpu_conv_algorithm.
+"""
+
+
+# 3x3 convs for Winograd, and depthwise and few-channel convs for the direct
+# convolution, with every algorithm
+conv_2d_algorithms = ['auto', 'gemm', 'winograd', 'direct']
+
+conv_2d_algorithm_configs_short = op_bench.config_list(
+    attrs=[
+        shape + [algorithm]
+        for shape in [
+            [32, 32, 3, 1, 1, 1, 1, 28, 28],
+            [32, 32, 3, 1, 1, 32, 1, 56, 56],
+        ]
+        for algorithm in conv_2d_algorithms
+    ],
+    attr_names=[
+        'in_c', 'out_c', 'kernel', 'stride', 'padding', 'groups', 'N', 'H', 'W', 'algorithm'
+    ],
+    tags=['short']
+)
+
+conv_2d_algorithm_configs_long = op_bench.config_list(
+    attrs=[
+        shape + [algorithm]
+        for shape in [
+            [64, 64, 3, 1, 1, 1, 8, 56, 56],
+            [128, 128, 3, 1, 1, 1, 8, 28, 28],
+            [3, 32, 3, 2, 1, 1, 8, 224, 224],
+            [144, 144, 3, 1, 1, 144, 8, 56, 56],
+            [144, 144, 3, 2, 1, 144, 8, 56, 56],
+            [96, 96, 5, 1, 2, 96, 8, 28, 28],
+        ]
+        for algorithm in conv_2d_algorithms
+    ],
+    attr_names=[
+        'in_c', 'out_c', 'kernel', 'stride', 'padding', 'groups', 'N', 'H', 'W', 'algorithm'
+    ],
+    tags=['long']
+)
+
+
+class Conv2dAlgorithmBenchmark(op_bench.TorchBenchmarkBase):
+    def init(self, in_c, out_c, kernel, stride, padding, groups, N, H, W, algorithm):
+        self.input = torch.rand(N, in_c, H, W)
+        self.conv2d = nn.Conv2d(in_c, out_c, kernel, stride=stride, padding=padding, groups=groups)
+        self.algorithm = algorithm
+        self.set_module_name('Conv2dAlgorithm')
+
+    def forward(self):
+        # the override is global, restore it for the other benchmarks
+        previous = torch._C._get_cpu_conv_algorithm()
+        torch._C._set_cpu_conv_algorithm(self.algorithm)
+        output = self.conv2d(self.input)
+        torch._C._set_cpu_conv_algorithm(previous)
+        return output
+
+
+op_bench.generate_pt_test(conv_2d_algorithm_configs_short + conv_2d_algorithm_configs_long,
+                          Conv2dAlgorithmBenchmark)
+
+
 """
 Microbenchmarks for Conv3d and ConvTranspose3d operators.
 """
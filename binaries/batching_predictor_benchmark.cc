@@ -0,0 +1,259 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Load generator for BatchingPredictor. FLAGS_threads clients issue
+// single-row requests against an MLP, either through a BatchingPredictor or
+// through one Predictor per client, and the throughput, latency percentiles
+// and batching statistics are reported for every run.
+//
+// Example:
+//   batching_predictor_benchmark --threads 64 --warmup 1000 --iter 100000 \
+//     --runs 3 --max_batch_size 32 --max_queue_latency_us 500
+
+#include <algorithm>
+#include <thread>
+
+#include "caffe2/core/init.h"
+#include "caffe2/core/timer.h"
+#include "caffe2/predictor/batching_predictor.h"
+#include "caffe2/predictor/emulator/benchmark.h"
+#include "caffe2/predictor/emulator/data_filler.h"
+#include "caffe2/predictor/emulator/std_output_formatter.h"
+#include "caffe2/predictor/emulator/time_profiler.h"
+#include "caffe2/utils/proto_utils.h"
+
+C10_DEFINE_bool(batching, true, "If false, every client runs its own predictor.");
+C10_DEFINE_int(max_batch_size, 32, "The maximum number of rows per batch.");
+C10_DEFINE_int(
+    max_queue_latency_us,
+    1000,
+    "The maximum time a request waits for a batch to fill up.");
+C10_DEFINE_int(
+    num_predictors,
+    1,
+    "The number of predictors (and threads) running batches.");
+C10_DEFINE_int(input_dim, 256, "The number of input features.");
+C10_DEFINE_int(hidden_dim, 512, "The width of every hidden layer.");
+C10_DEFINE_int(layers, 3, "The number of fully connected layers.");
+
+namespace caffe2 {
+namespace emulator {
+namespace {
+
+// Fills the parameters of the MLP and generates single-row inputs.
+class MLPFiller : public Filler {
+ public:
+  MLPFiller() {
+    input_names_.push_back("X");
+    for (int i = 0; i < FLAGS_layers; ++i) {
+      const auto in = i == 0 ? FLAGS_input_dim : FLAGS_hidden_dim;
+      init_net_.add_op()->CopyFrom(CreateOperatorDef(
+          "XavierFill",
+          "",
+          std::vector<string>{},
+          std::vector<string>{weight(i)},
+          std::vector<Argument>{MakeArgument<std::vector<int64_t>>(
+              "shape", {FLAGS_hidden_dim, in})}));
+      init_net_.add_op()->CopyFrom(CreateOperatorDef(
+          "ConstantFill",
+          "",
+          std::vector<string>{},
+          std::vector<string>{bias(i)},
+          std::vector<Argument>{
+              MakeArgument<std::vector<int64_t>>("shape", {FLAGS_hidden_dim}),
+              MakeArgument<float>("value", 0.1)}));
+    }
+  }
+
+  static string weight(int layer) {
+    return "W" + c10::to_string(layer);
+  }
+
+  static string bias(int layer) {
+    return "b" + c10::to_string(layer);
+  }
+
+  void fill_parameter(Workspace* ws) const override {
+    CAFFE_ENFORCE(ws->RunNetOnce(init_net_));
+  }
+
+ protected:
+  void fill_input_internal(TensorList_t* input_data) const override {
+    input_data->emplace_back(CPU);
+    TensorFiller filler({1, FLAGS_input_dim});
+    CPUContext context;
+    filler.Min(-1.0f).Max(1.0f).Fill<float>(&input_data->back(), &context);
+  }
+
+ private:
+  NetDef init_net_;
+};
+
+NetDef makeRunNet() {
+  NetDef net;
+  net.set_name("mlp");
+  net.set_type("simple");
+  net.add_external_input("X");
+  string input = "X";
+  for (int i = 0; i < FLAGS_layers; ++i) {
+    const auto fc = "fc" + c10::to_string(i);
+    net.add_external_input(MLPFiller::weight(i));
+    net.add_external_input(MLPFiller::bias(i));
+    net.add_op()->CopyFrom(CreateOperatorDef(
+        "FC",
+        "",
+        std::vector<string>{input, MLPFiller::weight(i), MLPFiller::bias(i)},
+        std::vector<string>{fc}));
+    net.add_op()->CopyFrom(CreateOperatorDef(
+        "Relu", "", std::vector<string>{fc}, std::vector<string>{fc}));
+    input = fc;
+  }
+  net.add_external_output(input);
+  return net;
+}
+
+class BatchingEmulator : public Emulator {
+ public:
+  void init() override {
+    filler_.fill_parameter(&parameters_);
+    const auto run_net = makeRunNet();
+
+    // All predictors share the parameters, and run in their own workspace.
+    auto make_predictor = [&] {
+      return caffe2::make_unique<Predictor>(makePredictorConfig(
+          NetDef(), run_net, &parameters_, /* run_init */ false));
+    };
+    if (FLAGS_batching) {
+      std::vector<std::unique_ptr<Predictor>> predictors;
+      for (int i = 0; i < FLAGS_num_predictors; ++i) {
+        predictors.push_back(make_predictor());
+      }
+      BatchingPredictorOptions options;
+      options.max_batch_size = FLAGS_max_batch_size;
+      options.max_queue_latency =
+          std::chrono::microseconds(FLAGS_max_queue_latency_us);
+      batching_predictor_ = caffe2::make_unique<BatchingPredictor>(
+          std::move(predictors), options);
+    } else {
+      for (int i = 0; i < FLAGS_threads; ++i) {
+        predictors_.push_back(make_predictor());
+      }
+    }
+
+    inputs_.resize(FLAGS_threads);
+    for (auto& input : inputs_) {
+      filler_.fill_input(&input);
+    }
+  }
+
+  void run(const uint64_t iterations) override {
+    latencies_us_.assign(FLAGS_threads, {});
+    std::vector<std::thread> threads;
+    for (int t = 0; t < FLAGS_threads; ++t) {
+      threads.emplace_back([&, t] {
+        auto& latencies = latencies_us_[t];
+        latencies.reserve(iterations / FLAGS_threads + 1);
+        Predictor::TensorList outputs;
+        for (uint64_t i = t; i < iterations; i += FLAGS_threads) {
+          Timer timer;
+          if (batching_predictor_) {
+            CAFFE_ENFORCE((*batching_predictor_)(inputs_[t], &outputs));
+          } else {
+            CAFFE_ENFORCE((*predictors_[t])(inputs_[t], &outputs));
+          }
+          latencies.push_back(timer.MicroSeconds());
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+
+  void report() {
+    std::vector<float> all;
+    for (const auto& latencies : latencies_us_) {
+      all.insert(all.end(), latencies.begin(), latencies.end());
+    }
+    if (all.empty()) {
+      return;
+    }
+    std::sort(all.begin(), all.end());
+    auto percentile = [&](double p) {
+      return all[std::min(all.size() - 1, size_t(p * all.size()))];
+    };
+    LOG(INFO) << "Request latency (us):\tp50 " << percentile(0.5) << "\tp90 "
+              << percentile(0.9) << "\tp99 " << percentile(0.99) << "\tmax "
+              << all.back();
+
+    if (batching_predictor_) {
+      const auto stats = batching_predictor_->stats();
+      LOG(INFO) << "Batches:\t\t" << stats.batches << " ("
+                << stats.full_batches << " full)\n"
+                << "Mean batch size:\t" << stats.mean_batch_size() << "\n"
+                << "Mean queue latency:\t"
+                << (stats.requests
+                        ? stats.total_queue_latency_us / stats.requests
+                        : 0)
+                << " us (max " << stats.max_queue_latency_us << " us)\n"
+                << "Mean batch latency:\t"
+                << (stats.batches ? stats.total_run_latency_us / stats.batches
+                                  : 0)
+                << " us";
+    }
+  }
+
+ private:
+  MLPFiller filler_;
+  Workspace parameters_;
+  std::unique_ptr<BatchingPredictor> batching_predictor_;
+  std::vector<std::unique_ptr<Predictor>> predictors_;
+  std::vector<TensorList_t> inputs_;
+  std::vector<std::vector<float>> latencies_us_;
+};
+
+class BatchingBenchmarkRunner : public BenchmarkRunner {
+ public:
+  explicit BatchingBenchmarkRunner(BatchingEmulator* emulator)
+      : emulator_(emulator) {}
+
+ protected:
+  void post_benchmark_cleanup() override {
+    emulator_->report();
+  }
+
+ private:
+  BatchingEmulator* emulator_;
+};
+
+} // namespace
+} // namespace emulator
+} // namespace caffe2
+
+int main(int argc, char** argv) {
+  caffe2::GlobalInit(&argc, &argv);
+
+  using namespace caffe2::emulator;
+  auto emulator = caffe2::make_unique<BatchingEmulator>();
+  BatchingBenchmarkRunner runner(emulator.get());
+
+  BenchmarkParam param;
+  param.profiler = caffe2::make_unique<TimeProfiler>();
+  param.emulator = std::move(emulator);
+  param.formatter = caffe2::make_unique<StdOutputFormatter>();
+  runner.benchmark(param);
+  return 0;
+}
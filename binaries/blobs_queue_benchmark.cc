@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Contention benchmark for BlobsQueue. FLAGS_num_writers threads write
+// records of FLAGS_num_blobs blobs into one queue while FLAGS_num_readers
+// threads read them back, and the throughput is reported for every run.
+//
+// Example:
+//   blobs_queue_benchmark --num_writers 16 --num_readers 32 --capacity 64
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/init.h"
+#include "caffe2/core/timer.h"
+#include "caffe2/queue/blobs_queue.h"
+
+C10_DEFINE_int(num_writers, 8, "The number of writing threads.");
+C10_DEFINE_int(num_readers, 32, "The number of reading threads.");
+C10_DEFINE_int(capacity, 64, "The capacity of the queue.");
+C10_DEFINE_int(num_blobs, 2, "The number of blobs in every record.");
+C10_DEFINE_int(records, 100000, "The number of records every writer writes.");
+C10_DEFINE_int(repeat, 5, "The number of runs.");
+
+namespace caffe2 {
+
+void WriteRecords(BlobsQueue* queue) {
+  std::vector<Blob> blobs(FLAGS_num_blobs);
+  std::vector<Blob*> record;
+  for (auto& blob : blobs) {
+    record.push_back(&blob);
+  }
+  for (int i = 0; i < FLAGS_records; ++i) {
+    for (auto& blob : blobs) {
+      *blob.GetMutable<int>() = i;
+    }
+    CAFFE_ENFORCE(queue->blockingWrite(record));
+  }
+}
+
+void ReadRecords(BlobsQueue* queue, int64_t* numRead) {
+  std::vector<Blob> blobs(FLAGS_num_blobs);
+  std::vector<Blob*> record;
+  for (auto& blob : blobs) {
+    record.push_back(&blob);
+  }
+  while (queue->blockingRead(record)) {
+    ++*numRead;
+  }
+}
+
+void RunBenchmark(int iter) {
+  Workspace ws;
+  auto queue = std::make_shared<BlobsQueue>(
+      &ws, "queue", FLAGS_capacity, FLAGS_num_blobs, true);
+
+  Timer timer;
+  std::vector<int64_t> numRead(FLAGS_num_readers);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < FLAGS_num_readers; ++i) {
+    readers.emplace_back(ReadRecords, queue.get(), &numRead[i]);
+  }
+  std::vector<std::thread> writers;
+  for (int i = 0; i < FLAGS_num_writers; ++i) {
+    writers.emplace_back(WriteRecords, queue.get());
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  // Readers drain the queue before they observe that it is closed.
+  queue->close();
+  int64_t total = 0;
+  for (int i = 0; i < FLAGS_num_readers; ++i) {
+    readers[i].join();
+    total += numRead[i];
+  }
+  const double elapsed_seconds = timer.Seconds();
+  CAFFE_ENFORCE_EQ(total, int64_t(FLAGS_num_writers) * FLAGS_records);
+  printf(
+      "Run %03d, %d writers, %d readers, took %4.5f seconds, "
+      "throughput %f records/sec.\n",
+      iter,
+      FLAGS_num_writers,
+      FLAGS_num_readers,
+      elapsed_seconds,
+      total / elapsed_seconds);
+}
+
+} // namespace caffe2
+
+int main(int argc, char** argv) {
+  caffe2::GlobalInit(&argc, &argv);
+  for (int i = 0; i < FLAGS_repeat; ++i) {
+    caffe2::RunBenchmark(i);
+  }
+  return 0;
+}
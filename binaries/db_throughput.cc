@@ -14,6 +14,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <cstdio>
 #include <thread>
 #include <vector>
@@ -32,6 +33,19 @@ C10_DEFINE_int(
     num_read_threads,
     1,
     "The number of concurrent reading threads.");
+C10_DEFINE_int(
+    prefetch_threads,
+    0,
+    "If positive, the reader prefetches the records with this number of "
+    "background threads.");
+C10_DEFINE_int(
+    readahead,
+    64,
+    "The number of records the prefetching reader keeps ahead.");
+C10_DEFINE_bool(
+    compare_prefetching,
+    false,
+    "If true, run the reader test without and then with prefetching.");
 
 using caffe2::db::Cursor;
 using caffe2::db::DB;
@@ -80,8 +94,12 @@ void TestThroughputWithReaderWorker(const DBReader* reader, int thread_id) {
   }
 }
 
-void TestThroughputWithReader() {
+void TestThroughputWithReader(int prefetch_threads) {
   caffe2::db::DBReader reader(FLAGS_input_db_type, FLAGS_input_db);
+  if (prefetch_threads > 0) {
+    reader.StartPrefetching(prefetch_threads, FLAGS_readahead);
+  }
+  caffe2::Timer timer;
   std::vector<std::unique_ptr<std::thread>> reading_threads(
       FLAGS_num_read_threads);
   for (int i = 0; i < reading_threads.size(); ++i) {
@@ -91,12 +109,34 @@ void TestThroughputWithReader() {
   for (int i = 0; i < reading_threads.size(); ++i) {
     reading_threads[i]->join();
   }
+  double elapsed_seconds = timer.Seconds();
+  printf(
+      "%d prefetching threads, %d reading threads, overall throughput %f "
+      "items/sec.\n",
+      prefetch_threads,
+      FLAGS_num_read_threads,
+      FLAGS_num_read_threads * FLAGS_repeat * FLAGS_report_interval /
+          elapsed_seconds);
+  if (prefetch_threads > 0) {
+    const auto stats = reader.PrefetchStats();
+    printf(
+        "Prefetched %lld records, %f MB/sec, reading the db took %4.5f "
+        "seconds per prefetching thread, waited %4.5f seconds for records "
+        "per reading thread.\n",
+        static_cast<long long>(stats.records),
+        stats.bytes / elapsed_seconds / 1e6,
+        stats.read_seconds / prefetch_threads,
+        stats.wait_seconds / FLAGS_num_read_threads);
+  }
 }
 
 int main(int argc, char** argv) {
   caffe2::GlobalInit(&argc, &argv);
-  if (FLAGS_use_reader) {
-    TestThroughputWithReader();
+  if (FLAGS_compare_prefetching) {
+    TestThroughputWithReader(0);
+    TestThroughputWithReader(std::max(FLAGS_prefetch_threads, 1));
+  } else if (FLAGS_use_reader) {
+    TestThroughputWithReader(FLAGS_prefetch_threads);
   } else {
     TestThroughputWithDB();
   }
@@ -0,0 +1,127 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Throughput benchmark for RebatchingQueue on dense features. FLAGS_num_writers
+// threads enqueue batches of FLAGS_input_batch_size rows of FLAGS_num_blobs
+// float features of dimension FLAGS_feature_dim, while FLAGS_num_readers
+// threads dequeue batches of FLAGS_output_batch_size rows. Every run is done
+// with the splitting queue and with the zero copy queue.
+//
+// Example:
+//   rebatching_queue_benchmark --feature_dim 4096 --output_batch_size 256
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "caffe2/core/init.h"
+#include "caffe2/core/timer.h"
+#include "caffe2/queue/rebatching_queue.h"
+
+C10_DEFINE_int(num_writers, 4, "The number of enqueuing threads.");
+C10_DEFINE_int(num_readers, 4, "The number of dequeuing threads.");
+C10_DEFINE_int(capacity, 4096, "The capacity of the queue, in rows.");
+C10_DEFINE_int(num_blobs, 2, "The number of features of every row.");
+C10_DEFINE_int(feature_dim, 1024, "The number of floats of a feature.");
+C10_DEFINE_int(input_batch_size, 128, "The number of rows enqueued at once.");
+C10_DEFINE_int(output_batch_size, 128, "The number of rows dequeued at once.");
+C10_DEFINE_int(batches, 200, "The number of batches every writer enqueues.");
+C10_DEFINE_int(repeat, 3, "The number of runs of every mode.");
+
+namespace caffe2 {
+
+void EnqueueBatches(RebatchingQueue* queue) {
+  CPUContext context;
+  std::vector<Tensor> tensors;
+  std::vector<const Tensor*> inputs;
+  for (int i = 0; i < FLAGS_num_blobs; ++i) {
+    tensors.emplace_back(
+        std::vector<int64_t>{FLAGS_input_batch_size, FLAGS_feature_dim}, CPU);
+  }
+  for (auto& tensor : tensors) {
+    std::fill_n(tensor.mutable_data<float>(), tensor.numel(), 1.0f);
+    inputs.push_back(&tensor);
+  }
+  for (int i = 0; i < FLAGS_batches; ++i) {
+    CAFFE_ENFORCE(queue->enqueueMany(context, inputs));
+  }
+}
+
+void DequeueBatches(RebatchingQueue* queue, int64_t* numRows) {
+  CPUContext context;
+  std::vector<Tensor> tensors;
+  std::vector<Tensor*> outputs;
+  for (int i = 0; i < FLAGS_num_blobs; ++i) {
+    tensors.emplace_back(CPU);
+  }
+  for (auto& tensor : tensors) {
+    outputs.push_back(&tensor);
+  }
+  while (queue->dequeue(context, FLAGS_output_batch_size, outputs)) {
+    *numRows += outputs[0]->size(0);
+  }
+}
+
+void RunBenchmark(int iter, bool zeroCopy) {
+  RebatchingQueue queue(FLAGS_capacity, FLAGS_num_blobs, zeroCopy);
+
+  Timer timer;
+  std::vector<int64_t> numRows(FLAGS_num_readers);
+  std::vector<std::thread> readers;
+  for (int i = 0; i < FLAGS_num_readers; ++i) {
+    readers.emplace_back(DequeueBatches, &queue, &numRows[i]);
+  }
+  std::vector<std::thread> writers;
+  for (int i = 0; i < FLAGS_num_writers; ++i) {
+    writers.emplace_back(EnqueueBatches, &queue);
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  // Readers drain the queue before they observe that it is closed.
+  queue.close();
+  int64_t total = 0;
+  for (int i = 0; i < FLAGS_num_readers; ++i) {
+    readers[i].join();
+    total += numRows[i];
+  }
+  const double elapsed_seconds = timer.Seconds();
+  CAFFE_ENFORCE_EQ(
+      total,
+      int64_t(FLAGS_num_writers) * FLAGS_batches * FLAGS_input_batch_size);
+  const double bytes =
+      double(total) * FLAGS_num_blobs * FLAGS_feature_dim * sizeof(float);
+  printf(
+      "Run %03d, %s, took %4.5f seconds, throughput %f rows/sec, "
+      "%f MB/sec.\n",
+      iter,
+      zeroCopy ? "zero copy" : "split    ",
+      elapsed_seconds,
+      total / elapsed_seconds,
+      bytes / elapsed_seconds / 1e6);
+}
+
+} // namespace caffe2
+
+int main(int argc, char** argv) {
+  caffe2::GlobalInit(&argc, &argv);
+  for (int i = 0; i < FLAGS_repeat; ++i) {
+    caffe2::RunBenchmark(i, false);
+    caffe2::RunBenchmark(i, true);
+  }
+  return 0;
+}
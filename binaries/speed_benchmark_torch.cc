@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2016-present, Facebook, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "ATen/ATen.h"
+#include "caffe2/core/init.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/utils/string_utils.h"
+#include "torch/csrc/jit/import.h"
+
+C10_DEFINE_string(model, "", "The given TorchScript model to benchmark.");
+C10_DEFINE_string(
+    input_dims,
+    "",
+    "The dimensions of the randomly generated inputs, as comma "
+    "separated numbers. If multiple inputs are needed, use "
+    "semicolon to separate the dimension of different "
+    "tensors.");
+C10_DEFINE_string(
+    input_type,
+    "",
+    "Input type (uint8_t/float). If multiple inputs are needed, use "
+    "semicolon to separate the types.");
+C10_DEFINE_string(
+    qengine,
+    "",
+    "The engine that runs the quantized operators (fbgemm/qnnpack). "
+    "Uses the default engine of the build if empty.");
+C10_DEFINE_int(warmup, 0, "The number of iterations to warm up.");
+C10_DEFINE_int(iter, 10, "The number of iterations to run.");
+
+using std::string;
+using std::vector;
+
+namespace {
+
+at::QEngine parseQEngine(const string& qengine) {
+  if (qengine == "fbgemm") {
+    return at::kFBGEMM;
+  } else if (qengine == "qnnpack") {
+    return at::kQNNPACK;
+  }
+  CAFFE_THROW("Unknown quantized engine: ", qengine);
+}
+
+vector<c10::IValue> createInputs() {
+  CAFFE_ENFORCE(!FLAGS_input_dims.empty(), "Input dims must be specified.");
+  CAFFE_ENFORCE(!FLAGS_input_type.empty(), "Input type must be specified.");
+
+  vector<string> input_dims_list = caffe2::split(';', FLAGS_input_dims);
+  vector<string> input_type_list = caffe2::split(';', FLAGS_input_type);
+  CAFFE_ENFORCE_EQ(
+      input_dims_list.size(),
+      input_type_list.size(),
+      "Input dims and type should have the same number of items.");
+
+  vector<c10::IValue> inputs;
+  for (size_t i = 0; i < input_dims_list.size(); ++i) {
+    vector<int64_t> input_dims;
+    for (const string& s : caffe2::split(',', input_dims_list[i])) {
+      input_dims.push_back(c10::stoi(s));
+    }
+    if (input_type_list[i] == "float") {
+      inputs.push_back(at::rand(input_dims, at::kFloat));
+    } else if (input_type_list[i] == "uint8_t") {
+      inputs.push_back(at::randint(0, 256, input_dims, at::kByte));
+    } else {
+      CAFFE_THROW("Unsupported input type: ", input_type_list[i]);
+    }
+  }
+  return inputs;
+}
+
+} // namespace
+
+// The TorchScript counterpart of speed_benchmark: loads a model saved with
+// torch.jit.save and times its forward method. Quantized models can be run
+// on either quantized engine with --qengine, e.g.
+//
+//   speed_benchmark_torch --model=model.pt --input_dims=1,3,224,224 \
+//     --input_type=float --qengine=qnnpack
+//
+// The engines do not always do the same work: with QNNPACK, dynamically
+// quantized linear layers run their GEMM twice and requantize the result to
+// uint8, so they are slower and less accurate than with FBGEMM, which
+// returns the float result directly.
+int main(int argc, char** argv) {
+  caffe2::GlobalInit(&argc, &argv);
+  CAFFE_ENFORCE(!FLAGS_model.empty(), "Model must be specified.");
+
+  // The packed weights of the quantized operators are created for the engine
+  // that is selected when the model is loaded.
+  if (!FLAGS_qengine.empty()) {
+    at::globalContext().setQEngine(parseQEngine(FLAGS_qengine));
+  }
+  LOG(INFO) << "Quantized engine: " << toString(at::globalContext().qEngine());
+
+  at::AutoGradMode guard(false);
+  auto module = torch::jit::load(FLAGS_model);
+  auto inputs = createInputs();
+
+  CAFFE_ENFORCE(FLAGS_warmup >= 0, "Number of warm up runs should be >= 0");
+  CAFFE_ENFORCE(FLAGS_iter >= 0, "Number of main runs should be >= 0");
+
+  LOG(INFO) << "Starting benchmark.";
+  LOG(INFO) << "Running warmup runs.";
+  for (int i = 0; i < FLAGS_warmup; ++i) {
+    module.forward(inputs);
+  }
+
+  LOG(INFO) << "Main runs.";
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < FLAGS_iter; ++i) {
+    module.forward(inputs);
+  }
+  auto end = std::chrono::steady_clock::now();
+  auto millis =
+      std::chrono::duration<double, std::milli>(end - start).count();
+  LOG(INFO) << "Main run finished. Milliseconds per iter: "
+            << (FLAGS_iter > 0 ? millis / FLAGS_iter : 0.0)
+            << ". Iters per second: "
+            << (millis > 0 ? 1000.0 * FLAGS_iter / millis : 0.0);
+  return 0;
+}
@@ -444,6 +444,10 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
     return type_id() == MkldnnCPUTensorId();
   }
 
+  bool is_sparse_csr() const {
+    return type_id() == SparseCsrCPUTensorId();
+  }
+
   int64_t get_device() const {
     TORCH_CHECK(
         device_opt_.has_value(),
@@ -468,6 +472,8 @@ struct C10_API TensorImpl : public c10::intrusive_ptr_target {
       return kSparse;
     } else if (is_mkldnn()) {
       return kMkldnn;
+    } else if (is_sparse_csr()) {
+      return kSparseCsr;
     } else {
       return kStrided;
     }
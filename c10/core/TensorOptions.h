@@ -404,6 +404,13 @@ struct C10_API TensorOptions {
           default:
             AT_ERROR("Unsupported device type for mkldnn layout: ", device().type());
         }
+      case Layout::SparseCsr:
+        switch (device().type()) {
+          case DeviceType::CPU:
+            return SparseCsrCPUTensorId();
+          default:
+            AT_ERROR("Unsupported device type for sparse CSR layout: ", device().type());
+        }
       default:
         AT_ERROR("Unsupported layout: ", layout());
     }
@@ -609,6 +616,8 @@ inline DeviceType computeDeviceType(TensorTypeId tid) {
     return DeviceType::HIP;
   } else if (tid == MkldnnCPUTensorId()) {
     return DeviceType::CPU;
+  } else if (tid == SparseCsrCPUTensorId()) {
+    return DeviceType::CPU;
   } else {
     AT_ASSERTM(false, "Unknown TensorTypeId: ", tid);
   }
@@ -91,6 +91,7 @@ C10_DEFINE_TENSOR_TYPE(SparseHIPTensorId);
 C10_DEFINE_TENSOR_TYPE(MSNPUTensorId);
 C10_DEFINE_TENSOR_TYPE(XLATensorId);
 C10_DEFINE_TENSOR_TYPE(MkldnnCPUTensorId);
+C10_DEFINE_TENSOR_TYPE(SparseCsrCPUTensorId);
 C10_DEFINE_TENSOR_TYPE(QuantizedCPUTensorId);
 C10_DEFINE_TENSOR_TYPE(ComplexCPUTensorId);
 C10_DEFINE_TENSOR_TYPE(ComplexCUDATensorId);
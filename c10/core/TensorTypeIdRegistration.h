@@ -119,6 +119,7 @@ C10_DECLARE_TENSOR_TYPE(SparseHIPTensorId); // PyTorch only
 C10_DECLARE_TENSOR_TYPE(MSNPUTensorId); // PyTorch only
 C10_DECLARE_TENSOR_TYPE(XLATensorId); // PyTorch only
 C10_DECLARE_TENSOR_TYPE(MkldnnCPUTensorId);
+C10_DECLARE_TENSOR_TYPE(SparseCsrCPUTensorId); // PyTorch only
 C10_DECLARE_TENSOR_TYPE(QuantizedCPUTensorId); // PyTorch only
 C10_DECLARE_TENSOR_TYPE(ComplexCPUTensorId); // PyTorch only
 C10_DECLARE_TENSOR_TYPE(ComplexCUDATensorId); // PyTorch only
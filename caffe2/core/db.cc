@@ -1,9 +1,17 @@
 #include "caffe2/core/db.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
 #include <mutex>
+#include <thread>
 
 #include "caffe2/core/blob_serialization.h"
 #include "caffe2/core/logging.h"
+#include "caffe2/core/stats.h"
+#include "caffe2/core/timer.h"
 
 namespace caffe2 {
 
@@ -171,6 +179,395 @@ class MiniDB : public DB {
 REGISTER_CAFFE2_DB(MiniDB, MiniDB);
 REGISTER_CAFFE2_DB(minidb, MiniDB);
 
+// Reads the records of a shard of a db on background threads. Each thread
+// owns a cursor, a range of the records and a bounded buffer of them. Read()
+// hands out the records of the buffers in turn, by ticket, skipping the
+// buffers whose range has no record left in the current pass over the shard,
+// so the records are returned in a deterministic order whatever the number of
+// concurrent readers, and each pass returns every record once.
+class DBPrefetcher {
+ public:
+  DBPrefetcher(
+      DB* db,
+      const string& source,
+      uint32_t num_shards,
+      uint32_t shard_id,
+      int num_threads,
+      int readahead,
+      int64_t position)
+      : db_(db),
+        num_shards_(num_shards),
+        shard_id_(shard_id),
+        next_ticket_(position),
+        stats_(source) {
+    CAFFE_ENFORCE_GT(num_threads, 0);
+    CAFFE_ENFORCE_GT(readahead, 0);
+    CAFFE_ENFORCE_GE(position, 0);
+    splitShard(num_threads);
+    capacity_ = std::max<size_t>(
+        1, (readahead + ranges_.size() - 1) / ranges_.size());
+    const auto heads = recordsBefore(position);
+    for (size_t i = 0; i < ranges_.size(); ++i) {
+      buffers_.emplace_back(new Buffer());
+      buffers_.back()->head = heads[i];
+    }
+    for (size_t i = 0; i < ranges_.size(); ++i) {
+      threads_.emplace_back(&DBPrefetcher::prefetch, this, i);
+    }
+  }
+
+  ~DBPrefetcher() {
+    stopped_ = true;
+    for (auto& buffer : buffers_) {
+      std::lock_guard<std::mutex> lock(buffer->mutex);
+      buffer->cv.notify_all();
+    }
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void Read(string* key, string* value) {
+    const int64_t ticket = next_ticket_++;
+    size_t buffer_id;
+    int64_t position;
+    locate(ticket, &buffer_id, &position);
+    auto& buffer = *buffers_[buffer_id];
+    Timer timer;
+    {
+      std::unique_lock<std::mutex> lock(buffer.mutex);
+      buffer.cv.wait(lock, [&]() {
+        return buffer.error ||
+            (buffer.head == position && !buffer.records.empty());
+      });
+      if (buffer.error) {
+        std::rethrow_exception(buffer.error);
+      }
+      key->swap(buffer.records.front().first);
+      value->swap(buffer.records.front().second);
+      buffer.records.pop_front();
+      ++buffer.head;
+    }
+    // wakes up the thread filling the buffer and the readers waiting for
+    // the next records
+    buffer.cv.notify_all();
+
+    const auto wait_ns = timer.NanoSeconds();
+    wait_ns_ += static_cast<int64_t>(wait_ns);
+    ++records_;
+    bytes_ += key->size() + value->size();
+    CAFFE_EVENT(stats_, prefetched_records, 1);
+    CAFFE_EVENT(stats_, read_wait_time_ns, wait_ns);
+  }
+
+  // The number of records handed out by Read().
+  int64_t Position() const {
+    return next_ticket_;
+  }
+
+  DBPrefetchStats Stats() const {
+    DBPrefetchStats stats;
+    stats.records = records_;
+    stats.bytes = bytes_;
+    stats.read_seconds = cursor_ns_ / 1e9;
+    stats.wait_seconds = wait_ns_ / 1e9;
+    return stats;
+  }
+
+ private:
+  // A thread reads the shard records from the begin key up to the end key,
+  // an empty begin key stands for the first record of the shard and an empty
+  // end key for the end of the db. records is the number of records of the
+  // range, unknown (0) when the shard is read by a single thread.
+  struct Range {
+    string begin;
+    string end;
+    int64_t records = 0;
+  };
+
+  // The ranges with at least records records. In a pass, the tickets go
+  // round robin over the ranges of the first level until the shortest range
+  // is exhausted, then over those of the next level, and so on.
+  struct Level {
+    int64_t records;
+    std::vector<size_t> ranges;
+  };
+
+  struct Buffer {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::pair<string, string>> records;
+    // number of records of the buffer already read
+    int64_t head = 0;
+    std::exception_ptr error;
+  };
+
+  // The maximum number of keys per thread kept by the scan splitting the
+  // shard. The sizes of the ranges differ by up to 1 / kSplitKeysPerThread
+  // of the size of the shard.
+  static constexpr int64_t kSplitKeysPerThread = 64;
+
+  void splitShard(int num_threads) {
+    std::unique_ptr<Cursor> cursor = db_->NewCursor();
+    if (num_threads == 1 || !cursor->SupportsSeek()) {
+      ranges_.resize(1);
+      return;
+    }
+    // A single scan keeps the keys of evenly spaced records of the shard,
+    // doubling the spacing whenever there are too many of them. The ranges
+    // start at some of those keys, whose positions in the shard are known.
+    const size_t max_keys = 2 * kSplitKeysPerThread * num_threads;
+    std::vector<string> keys;
+    int64_t spacing = 1;
+    int64_t shard_records = 0;
+    int64_t position = 0;
+    for (cursor->SeekToFirst(); cursor->Valid(); cursor->Next(), ++position) {
+      if (position % num_shards_ != shard_id_) {
+        continue;
+      }
+      if (shard_records % spacing == 0) {
+        keys.push_back(cursor->key());
+        if (keys.size() == max_keys) {
+          for (size_t i = 1; i < max_keys / 2; ++i) {
+            keys[i] = std::move(keys[2 * i]);
+          }
+          keys.resize(max_keys / 2);
+          spacing *= 2;
+        }
+      }
+      ++shard_records;
+    }
+    CAFFE_ENFORCE_GT(
+        shard_records, 0, "Db has fewer rows than shard id: ", shard_id_);
+    shard_records_ = shard_records;
+
+    num_threads = std::min<int64_t>(num_threads, keys.size());
+    ranges_.resize(num_threads);
+    int64_t begin = 0;
+    for (int i = 0; i < num_threads; ++i) {
+      int64_t end = shard_records;
+      if (i + 1 < num_threads) {
+        const size_t split = (i + 1) * keys.size() / num_threads;
+        ranges_[i].end = keys[split];
+        ranges_[i + 1].begin = keys[split];
+        end = split * spacing;
+      }
+      ranges_[i].records = end - begin;
+      begin = end;
+    }
+
+    std::vector<int64_t> sizes;
+    for (const auto& range : ranges_) {
+      sizes.push_back(range.records);
+    }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    for (const auto size : sizes) {
+      levels_.push_back(Level{size, {}});
+      for (size_t i = 0; i < ranges_.size(); ++i) {
+        if (ranges_[i].records >= size) {
+          levels_.back().ranges.push_back(i);
+        }
+      }
+    }
+  }
+
+  // The buffer of the record returned for ticket and its index among the
+  // records of the buffer.
+  void locate(int64_t ticket, size_t* buffer, int64_t* index) const {
+    if (ranges_.size() == 1) {
+      *buffer = 0;
+      *index = ticket;
+      return;
+    }
+    const int64_t pass = ticket / shard_records_;
+    int64_t rest = ticket % shard_records_;
+    int64_t round = 0;
+    for (const auto& level : levels_) {
+      const int64_t active = level.ranges.size();
+      const int64_t tickets = (level.records - round) * active;
+      if (rest < tickets) {
+        *buffer = level.ranges[rest % active];
+        *index = pass * ranges_[*buffer].records + round + rest / active;
+        return;
+      }
+      rest -= tickets;
+      round = level.records;
+    }
+    CAFFE_THROW("Ticket ", ticket, " is past the end of the shard");
+  }
+
+  // The number of records of each buffer returned for the tickets before
+  // ticket.
+  std::vector<int64_t> recordsBefore(int64_t ticket) const {
+    if (ranges_.size() == 1) {
+      return {ticket};
+    }
+    const int64_t pass = ticket / shard_records_;
+    int64_t rest = ticket % shard_records_;
+    std::vector<int64_t> records(ranges_.size());
+    for (size_t i = 0; i < ranges_.size(); ++i) {
+      records[i] = pass * ranges_[i].records;
+    }
+    int64_t round = 0;
+    for (const auto& level : levels_) {
+      const int64_t active = level.ranges.size();
+      const int64_t rounds = std::min(level.records - round, rest / active);
+      for (size_t j = 0; j < level.ranges.size(); ++j) {
+        records[level.ranges[j]] += rounds +
+            (rounds < level.records - round &&
+             static_cast<int64_t>(j) < rest % active);
+      }
+      if (rounds < level.records - round) {
+        break;
+      }
+      rest -= rounds * active;
+      round = level.records;
+    }
+    return records;
+  }
+
+  void prefetch(int thread_id) {
+    auto& buffer = *buffers_[thread_id];
+    const auto& range = ranges_[thread_id];
+    try {
+      std::unique_ptr<Cursor> cursor;
+      {
+        std::lock_guard<std::mutex> lock(cursor_mutex_);
+        cursor = db_->NewCursor();
+      }
+      auto moveToBegin = [&]() {
+        if (!range.begin.empty()) {
+          cursor->Seek(range.begin);
+          return;
+        }
+        cursor->SeekToFirst();
+        for (uint32_t s = 0; s < shard_id_; s++) {
+          cursor->Next();
+          CAFFE_ENFORCE(
+              cursor->Valid(), "Db has fewer rows than shard id: ", shard_id_);
+        }
+      };
+      auto moveToNext = [&]() {
+        // In sharded mode, each read skips num_shards_ records
+        for (uint32_t s = 0; s < num_shards_; s++) {
+          cursor->Next();
+          if (!cursor->Valid()) {
+            break;
+          }
+        }
+        if (!cursor->Valid() ||
+            (!range.end.empty() && cursor->key() == range.end)) {
+          moveToBegin();
+        }
+      };
+      moveToBegin();
+      // skips the records returned before the starting position
+      int64_t skip = buffer.head;
+      if (range.records > 0) {
+        skip %= range.records;
+      }
+      for (; skip > 0 && !stopped_; --skip) {
+        moveToNext();
+      }
+
+      while (!stopped_) {
+        Timer timer;
+        auto record = std::make_pair(cursor->key(), cursor->value());
+        moveToNext();
+        const auto read_ns = timer.NanoSeconds();
+        cursor_ns_ += static_cast<int64_t>(read_ns);
+        CAFFE_EVENT(stats_, cursor_read_time_ns, read_ns);
+
+        std::unique_lock<std::mutex> lock(buffer.mutex);
+        buffer.cv.wait(lock, [&]() {
+          return stopped_ || buffer.records.size() < capacity_;
+        });
+        if (stopped_) {
+          break;
+        }
+        buffer.records.push_back(std::move(record));
+        lock.unlock();
+        buffer.cv.notify_all();
+      }
+    } catch (...) {
+      LOG(ERROR) << "Prefetching thread " << thread_id << " failed";
+      {
+        std::lock_guard<std::mutex> lock(buffer.mutex);
+        buffer.error = std::current_exception();
+      }
+      buffer.cv.notify_all();
+    }
+  }
+
+  DB* db_;
+  const uint32_t num_shards_;
+  const uint32_t shard_id_;
+  std::vector<Range> ranges_;
+  std::vector<Level> levels_;
+  int64_t shard_records_ = 0;
+  size_t capacity_;
+
+  // creating cursors concurrently is not safe for every db
+  std::mutex cursor_mutex_;
+  std::vector<std::unique_ptr<Buffer>> buffers_;
+  std::vector<std::thread> threads_;
+  std::atomic<bool> stopped_{false};
+  std::atomic<int64_t> next_ticket_;
+
+  std::atomic<int64_t> records_{0};
+  std::atomic<int64_t> bytes_{0};
+  std::atomic<int64_t> cursor_ns_{0};
+  std::atomic<int64_t> wait_ns_{0};
+
+  struct PrefetchStats {
+    CAFFE_STAT_CTOR(PrefetchStats);
+    CAFFE_EXPORTED_STAT(prefetched_records);
+    CAFFE_AVG_EXPORTED_STAT(cursor_read_time_ns);
+    CAFFE_AVG_EXPORTED_STAT(read_wait_time_ns);
+  } stats_;
+};
+
+constexpr int64_t DBPrefetcher::kSplitKeysPerThread;
+
+void DBReader::StartPrefetching(
+    int num_threads,
+    int readahead,
+    int64_t position) {
+  CAFFE_ENFORCE(db_ != nullptr, "Reader not initialized.");
+  prefetcher_.reset();
+  // Some dbs, like minidb, allow a single cursor at a time
+  cursor_.reset();
+  prefetcher_ = std::make_shared<DBPrefetcher>(
+      db_.get(),
+      source_,
+      num_shards_,
+      shard_id_,
+      num_threads,
+      readahead,
+      position);
+  prefetch_threads_ = num_threads;
+  readahead_ = readahead;
+  VLOG(1) << "Prefetching " << source_ << " with " << num_threads
+          << " threads and a readahead of " << readahead << " records";
+}
+
+void DBReader::StopPrefetching() {
+  if (!prefetcher_) {
+    return;
+  }
+  prefetcher_.reset();
+  InitializeCursor(num_shards_, shard_id_);
+}
+
+DBPrefetchStats DBReader::PrefetchStats() const {
+  return prefetcher_ ? prefetcher_->Stats() : DBPrefetchStats();
+}
+
+void DBReader::ReadPrefetched(string* key, string* value) const {
+  prefetcher_->Read(key, value);
+}
+
 void DBReaderSerializer::Serialize(
     const void* pointer,
     TypeMeta typeMeta,
@@ -182,7 +579,14 @@ void DBReaderSerializer::Serialize(
   proto.set_name(name);
   proto.set_source(reader.source_);
   proto.set_db_type(reader.db_type_);
-  if (reader.cursor() && reader.cursor()->SupportsSeek()) {
+  proto.set_num_shards(reader.num_shards_);
+  proto.set_shard_id(reader.shard_id_);
+  if (reader.prefetcher_) {
+    // restored by prefetching again from the same position
+    proto.set_prefetch_threads(reader.prefetch_threads_);
+    proto.set_readahead(reader.readahead_);
+    proto.set_prefetch_position(reader.prefetcher_->Position());
+  } else if (reader.cursor_ && reader.cursor_->SupportsSeek()) {
     proto.set_key(reader.cursor()->key());
   }
   BlobProto blob_proto;
@@ -1,6 +1,7 @@
 #ifndef CAFFE2_CORE_DB_H_
 #define CAFFE2_CORE_DB_H_
 
+#include <memory>
 #include <mutex>
 
 #include "c10/util/Registry.h"
@@ -138,6 +139,21 @@ inline bool DBExists(const string& db_type, const string& full_db_name) {
   }
 }
 
+/**
+ * Counters of the prefetching of a DBReader since the prefetching started.
+ */
+struct CAFFE2_API DBPrefetchStats {
+  // records and bytes of the keys and values returned by Read()
+  int64_t records = 0;
+  int64_t bytes = 0;
+  // time spent by the prefetching threads reading the db
+  double read_seconds = 0;
+  // time spent by Read() waiting for records that were not prefetched yet
+  double wait_seconds = 0;
+};
+
+class DBPrefetcher;
+
 /**
  * A reader wrapper for DB that also allows us to serialize it.
  */
@@ -156,15 +172,24 @@ class CAFFE2_API DBReader {
   }
 
   explicit DBReader(const DBReaderProto& proto) {
-    Open(proto.db_type(), proto.source());
+    Open(
+        proto.db_type(),
+        proto.source(),
+        proto.has_num_shards() ? proto.num_shards() : 1,
+        proto.shard_id());
+    if (proto.has_prefetch_threads()) {
+      StartPrefetching(
+          proto.prefetch_threads(),
+          proto.readahead(),
+          proto.prefetch_position());
+      return;
+    }
     if (proto.has_key()) {
       CAFFE_ENFORCE(cursor_->SupportsSeek(),
           "Encountering a proto that needs seeking but the db type "
           "does not support it.");
       cursor_->Seek(proto.key());
     }
-    num_shards_ = 1;
-    shard_id_ = 0;
   }
 
   explicit DBReader(std::unique_ptr<DB> db)
@@ -182,6 +207,7 @@ class CAFFE2_API DBReader {
       const int32_t shard_id = 0) {
     // Note(jiayq): resetting is needed when we re-open e.g. leveldb where no
     // concurrent access is allowed.
+    prefetcher_.reset();
     cursor_.reset();
     db_.reset();
     db_type_ = db_type;
@@ -201,6 +227,7 @@ class CAFFE2_API DBReader {
       unique_ptr<DB>&& db,
       const int32_t num_shards = 1,
       const int32_t shard_id = 0) {
+    prefetcher_.reset();
     cursor_.reset();
     db_.reset();
     db_ = std::move(db);
@@ -226,6 +253,10 @@ class CAFFE2_API DBReader {
    * output blob.
    */
   void Read(string* key, string* value) const {
+    if (prefetcher_) {
+      ReadPrefetched(key, value);
+      return;
+    }
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
     *key = cursor_->key();
@@ -245,6 +276,7 @@ class CAFFE2_API DBReader {
    * @brief Seeks to the first key. Thread safe.
    */
   void SeekToFirst() const {
+    CAFFE_ENFORCE(!prefetcher_, "Cannot seek while prefetching.");
     CAFFE_ENFORCE(cursor_ != nullptr, "Reader not initialized.");
     std::unique_lock<std::mutex> mutex_lock(reader_mutex_);
     MoveToBeginning();
@@ -263,7 +295,40 @@ class CAFFE2_API DBReader {
     return cursor_.get();
   }
 
+  /**
+   * Starts reading the records on num_threads background threads, which keep
+   * up to readahead records ahead of Read() in total. Reading restarts from
+   * the beginning of the shard of the reader, or continues after the first
+   * position records that a reader prefetching with the same arguments
+   * returns. Not thread safe.
+   *
+   * For dbs supporting Seek(), like LMDB and LevelDB, the records of the
+   * shard are split into up to num_threads contiguous key ranges of nearly
+   * the same size, one per thread, found with a scan of the db. Read()
+   * returns the records of the threads in turn, skipping the threads whose
+   * range is exhausted, so that every pass returns each record of the shard
+   * exactly once. The order of the records is deterministic, but differs
+   * from the order of the db. Other dbs are read by a single thread.
+   *
+   * The cursor of the reader is released while prefetching.
+   */
+  void StartPrefetching(int num_threads, int readahead, int64_t position = 0);
+
+  /**
+   * Stops the prefetching threads, reading continues from the beginning of
+   * the shard. Not thread safe.
+   */
+  void StopPrefetching();
+
+  bool IsPrefetching() const {
+    return prefetcher_ != nullptr;
+  }
+
+  DBPrefetchStats PrefetchStats() const;
+
  private:
+  void ReadPrefetched(string* key, string* value) const;
+
   void InitializeCursor(const int32_t num_shards, const int32_t shard_id) {
     CAFFE_ENFORCE(num_shards >= 1);
     CAFFE_ENFORCE(shard_id >= 0);
@@ -290,6 +355,10 @@ class CAFFE2_API DBReader {
   mutable std::mutex reader_mutex_;
   uint32_t num_shards_{};
   uint32_t shard_id_{};
+  int prefetch_threads_{};
+  int readahead_{};
+  // the prefetching threads read db_, declared last to be stopped first
+  std::shared_ptr<DBPrefetcher> prefetcher_;
 
   C10_DISABLE_COPY_AND_ASSIGN(DBReader);
 };
@@ -56,6 +56,16 @@ C10_DEFINE_bool(
     false,
     "Run root tasks in current thread instread of scheduling to threadpool");
 
+C10_DEFINE_bool(
+    caffe2_net_async_critical_path_scheduling,
+    false,
+    "Dispatch ready tasks in the order of their critical path length");
+
+C10_DEFINE_bool(
+    caffe2_net_async_memory_planning,
+    false,
+    "Place intermediate CPU tensors into an arena reused across runs");
+
 namespace caffe2 {
 
 std::vector<int>& AsyncNetBase::getStreamCounters() {
@@ -75,6 +85,10 @@ AsyncNetBase::AsyncNetBase(
     op_ptr->SetExecutorHelper(helper_.get());
     operators_.push_back(op_ptr);
   }
+  if (options_.use_memory_planning_) {
+    memory_planner_ =
+        caffe2::make_unique<NetMemoryPlanner>(*net_def, operator_nodes_, ws);
+  }
 
   if (FLAGS_caffe2_net_async_inference_mode) {
     execution_chains_ = dag_utils::computeGroups(operator_nodes_);
@@ -532,6 +546,9 @@ ExecutionOptions::ExecutionOptions(
   }
 
   use_dfs_scheduling_ = false;
+  use_critical_path_scheduling_ =
+      FLAGS_caffe2_net_async_critical_path_scheduling;
+  use_memory_planning_ = FLAGS_caffe2_net_async_memory_planning;
 
   for (int arg_idx = 0; arg_idx < net_def->arg_size(); ++arg_idx) {
     auto& arg = net_def->arg(arg_idx);
@@ -543,6 +560,14 @@ ExecutionOptions::ExecutionOptions(
       CAFFE_ENFORCE(arg.has_i(), "deferrable_mode should be an int");
       use_dfs_scheduling_ = arg.i() == 1; // corr. to DFS scheduling
     }
+    if (arg.has_name() && arg.name() == "critical_path_scheduling") {
+      CAFFE_ENFORCE(arg.has_i(), "critical_path_scheduling should be an int");
+      use_critical_path_scheduling_ = arg.i() == 1;
+    }
+    if (arg.has_name() && arg.name() == "memory_planning") {
+      CAFFE_ENFORCE(arg.has_i(), "memory_planning should be an int");
+      use_memory_planning_ = arg.i() == 1;
+    }
   }
 
   if (FLAGS_caffe2_net_async_profile_operators) {
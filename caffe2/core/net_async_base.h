@@ -6,6 +6,7 @@
 #include "caffe2/core/common.h"
 #include "caffe2/core/net.h"
 #include "caffe2/core/net_dag_utils.h"
+#include "caffe2/core/net_memory_planner.h"
 #include "caffe2/core/prof_dag_counters.h"
 #include "caffe2/core/stats.h"
 #include "caffe2/core/timer.h"
@@ -23,6 +24,8 @@ C10_DECLARE_bool(caffe2_net_async_use_single_pool);
 C10_DECLARE_bool(caffe2_net_async_use_per_net_pools);
 C10_DECLARE_bool(caffe2_net_async_run_root_tasks_inline);
 C10_DECLARE_bool(caffe2_net_async_profile_operators);
+C10_DECLARE_bool(caffe2_net_async_critical_path_scheduling);
+C10_DECLARE_bool(caffe2_net_async_memory_planning);
 
 namespace caffe2 {
 
@@ -54,6 +57,11 @@ struct ExecutionOptions {
   bool use_dfs_scheduling_ = false;
   // run net's root tasks in RunAsync thread instead of in thread pool
   bool run_root_tasks_inline_ = false;
+  // dispatch ready tasks by the estimated length of the longest path from
+  // the task to the end of the net instead of in FIFO order
+  bool use_critical_path_scheduling_ = false;
+  // place intermediate CPU tensors into an arena reused across runs
+  bool use_memory_planning_ = false;
 };
 
 class CAFFE2_API AsyncNetBase : public NetBase {
@@ -75,6 +83,12 @@ class CAFFE2_API AsyncNetBase : public NetBase {
     return execution_chains_;
   }
 
+  // The planner of the intermediate CPU tensors, or nullptr if memory
+  // planning is disabled
+  const NetMemoryPlanner* memoryPlanner() const {
+    return memory_planner_.get();
+  }
+
   ProfDAGProtos GetOperatorStats() const;
   ProfDAGProtos GetPerOperatorCost() const;
   ProfDAGReport GetProfReport() const;
@@ -156,6 +170,9 @@ class CAFFE2_API AsyncNetBase : public NetBase {
 
   ProfDAGCounters counters_;
 
+  // set if options_.use_memory_planning_
+  std::unique_ptr<NetMemoryPlanner> memory_planner_;
+
   C10_DISABLE_COPY_AND_ASSIGN(AsyncNetBase);
 
  private:
@@ -1,13 +1,27 @@
 #include "caffe2/core/net_async_scheduling.h"
 
+#include <algorithm>
+
 #include "caffe2/core/net_async_tracing.h"
+#include "caffe2/core/operator_schema.h"
 
 namespace caffe2 {
 
+namespace {
+// With profiling enabled, re-estimate task priorities from the measured
+// operator times every kPriorityUpdateRuns runs
+constexpr int kPriorityUpdateRuns = 100;
+} // namespace
+
 AsyncSchedulingNet::AsyncSchedulingNet(
     const std::shared_ptr<const NetDef>& net_def,
     Workspace* ws)
-    : AsyncNetBase(net_def, ws), running_(false) {}
+    : AsyncNetBase(net_def, ws), running_(false) {
+  if (options_.use_critical_path_scheduling_) {
+    ready_task_funcs_.resize(tasksNum());
+    updateTaskPriorities();
+  }
+}
 
 void AsyncSchedulingNet::reset() {
   AsyncNetBase::reset();
@@ -185,12 +199,137 @@ void AsyncSchedulingNet::schedule(int task_id, bool run_inline) noexcept {
 
   if (run_inline) {
     schedule_func();
+  } else if (options_.use_critical_path_scheduling_) {
+    enqueueReadyTask(task_id, std::move(schedule_func));
   } else {
     const auto& device_option = event(task_id).GetDeviceOption();
     pool(device_option)->run(schedule_func);
   }
 }
 
+void AsyncSchedulingNet::enqueueReadyTask(
+    int task_id,
+    std::function<void()> task_func) {
+  auto* task_pool = pool(event(task_id).GetDeviceOption());
+  {
+    std::unique_lock<std::mutex> lock(ready_tasks_mutex_);
+    ready_task_funcs_[task_id] = std::move(task_func);
+    // ties are broken in favor of the earlier task
+    ready_tasks_[task_pool].emplace(task_priorities_[task_id], -task_id);
+  }
+  // Every job runs the ready task with the highest priority at the moment
+  // it starts, which is not necessarily the one that was enqueued with it;
+  // as there is one job per task, all tasks get to run.
+  task_pool->run(
+      std::bind(&AsyncSchedulingNet::runReadyTask, this, task_pool));
+}
+
+void AsyncSchedulingNet::runReadyTask(TaskThreadPoolBase* task_pool) {
+  std::function<void()> task_func;
+  {
+    std::unique_lock<std::mutex> lock(ready_tasks_mutex_);
+    auto& ready_tasks = ready_tasks_[task_pool];
+    CAFFE_ENFORCE(!ready_tasks.empty(), "No ready task to run");
+    const int task_id = -ready_tasks.top().second;
+    ready_tasks.pop();
+    task_func = std::move(ready_task_funcs_[task_id]);
+  }
+  // the net may be destroyed once the last task finishes
+  task_func();
+}
+
+std::vector<float> AsyncSchedulingNet::estimateOperatorCosts() const {
+  std::vector<float> costs(operators_.size(), 0.0f);
+
+  // Prefer the mean times measured in the previous runs
+  if (options_.report_stats_) {
+    const auto stats = counters_.GetReport().GetPerOperatorCost();
+    if (stats.stats_size() == static_cast<int>(operators_.size())) {
+      for (int op_id = 0; op_id < stats.stats_size(); ++op_id) {
+        costs[op_id] = stats.stats(op_id).mean();
+      }
+      return costs;
+    }
+  }
+
+  // Otherwise use the number of flops and bytes moved by the operators
+  // that have a cost inference function and inputs of known shapes, and
+  // assume that the other operators take the average time
+  std::vector<bool> known(operators_.size(), false);
+  double known_sum = 0;
+  int known_num = 0;
+  for (size_t op_id = 0; op_id < operators_.size(); ++op_id) {
+    const auto* op = operators_[op_id];
+    if (!op->has_debug_def()) {
+      continue;
+    }
+    const auto* schema = OpSchemaRegistry::Schema(op->debug_def().type());
+    if (!schema || !schema->HasCostInferenceFunction()) {
+      continue;
+    }
+    const auto shapes = op->InputTensorShapes();
+    const bool all_good_shapes = std::all_of(
+        shapes.begin(), shapes.end(), [](const TensorShape& shape) {
+          return !shape.unknown_shape();
+        });
+    if (!all_good_shapes) {
+      continue;
+    }
+    try {
+      const auto cost = schema->InferCost(op->debug_def(), shapes);
+      costs[op_id] = cost.flops + cost.bytes_read + cost.bytes_written;
+      known[op_id] = true;
+      known_sum += costs[op_id];
+      ++known_num;
+    } catch (const std::exception& e) {
+      VLOG(1) << "Failed to infer the cost of operator " << op_id << ": "
+              << e.what();
+    }
+  }
+  const float default_cost = known_num > 0 ? known_sum / known_num : 1.0f;
+  for (size_t op_id = 0; op_id < operators_.size(); ++op_id) {
+    if (!known[op_id]) {
+      costs[op_id] = default_cost;
+    }
+  }
+  return costs;
+}
+
+void AsyncSchedulingNet::updateTaskPriorities() {
+  const auto op_costs = estimateOperatorCosts();
+  const int tasks_num = tasksNum();
+  task_priorities_.assign(tasks_num, 0.0f);
+
+  // Upward rank: the cost of a task plus the highest rank among its
+  // children, computed from the leaves up
+  std::vector<int> pending_children(tasks_num);
+  std::vector<int> ready;
+  for (int task_id = 0; task_id < tasks_num; ++task_id) {
+    pending_children[task_id] = children(task_id).size();
+    if (pending_children[task_id] == 0) {
+      ready.push_back(task_id);
+    }
+  }
+  while (!ready.empty()) {
+    const int task_id = ready.back();
+    ready.pop_back();
+    float children_rank = 0.0f;
+    for (auto child_id : children(task_id)) {
+      children_rank = std::max(children_rank, task_priorities_[child_id]);
+    }
+    float task_cost = 0.0f;
+    for (auto op_id : chains_[task_id]) {
+      task_cost += op_costs[op_id];
+    }
+    task_priorities_[task_id] = task_cost + children_rank;
+    for (auto parent_id : parents(task_id)) {
+      if (--pending_children[parent_id] == 0) {
+        ready.push_back(parent_id);
+      }
+    }
+  }
+}
+
 void AsyncSchedulingNet::parentCallback(int parent_id) {
   if (event(parent_id).Query() != EventStatus::EVENT_SUCCESS) {
     success_ = false;
@@ -228,6 +367,9 @@ void AsyncSchedulingNet::finishRun() {
   std::unique_lock<std::mutex> lock(running_mutex_);
   // wait for scheduled ops and make sure all events are marked as finished
   finalizeEvents();
+  if (memory_planner_ && success_) {
+    memory_planner_->FinishRun();
+  }
   if (options_.report_stats_) {
     counters_.ReportRunEnd();
   }
@@ -247,6 +389,18 @@ bool AsyncSchedulingNet::RunAsync() {
     running_ = true;
     reset();
 
+    if (options_.use_critical_path_scheduling_) {
+      // Input shapes of all the operators are known after the first run
+      ++runs_num_;
+      if (runs_num_ == 2 ||
+          (options_.report_stats_ && runs_num_ % kPriorityUpdateRuns == 0)) {
+        updateTaskPriorities();
+      }
+    }
+    if (memory_planner_) {
+      memory_planner_->PrepareRun();
+    }
+
     StartAllObservers();
     tracing::startIter(tracer_);
     if (options_.report_stats_) {
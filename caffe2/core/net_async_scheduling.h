@@ -1,6 +1,12 @@
 #ifndef CAFFE2_CORE_NET_ASYNC_SCHEDULING_H_
 #define CAFFE2_CORE_NET_ASYNC_SCHEDULING_H_
 
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "caffe2/core/net_async_base.h"
 
 namespace caffe2 {
@@ -14,6 +20,10 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
 
   void Wait() override;
 
+  const std::vector<float>& TEST_task_priorities() const {
+    return task_priorities_;
+  }
+
  protected:
   bool RunAsync() override;
 
@@ -24,12 +34,29 @@ class CAFFE2_API AsyncSchedulingNet : public AsyncNetBase {
   void parentCallback(int parent_id);
   bool isInlineTask(int parent_id, int child_id) const;
 
+  // Critical path scheduling: ready tasks wait in a per-pool heap ordered by
+  // their upward rank, i.e. the estimated cost of the longest path from the
+  // task to the end of the net, and every pool job runs the top task.
+  void updateTaskPriorities();
+  std::vector<float> estimateOperatorCosts() const;
+  void enqueueReadyTask(int task_id, std::function<void()> task_func);
+  void runReadyTask(TaskThreadPoolBase* task_pool);
+
   std::mutex running_mutex_;
   std::condition_variable running_cv_;
   std::atomic<bool> running_;
 
   std::atomic<int> processed_tasks_num_;
 
+  std::vector<float> task_priorities_;
+  int runs_num_ = 0;
+  std::mutex ready_tasks_mutex_;
+  std::unordered_map<
+      TaskThreadPoolBase*,
+      std::priority_queue<std::pair<float, int>>>
+      ready_tasks_;
+  std::vector<std::function<void()>> ready_task_funcs_;
+
   C10_DISABLE_COPY_AND_ASSIGN(AsyncSchedulingNet);
 };
 
@@ -0,0 +1,337 @@
+#include "caffe2/core/net_memory_planner.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "caffe2/core/operator.h"
+#include "caffe2/core/tensor.h"
+
+namespace caffe2 {
+
+namespace {
+
+// Keep every tensor on its own cache lines
+constexpr size_t kArenaAlignment = 64;
+
+// Cached plans are dropped when the number of signatures exceeds this
+constexpr size_t kMaxPlans = 16;
+
+size_t alignBytes(size_t bytes) {
+  return (bytes + kArenaAlignment - 1) / kArenaAlignment * kArenaAlignment;
+}
+
+const Tensor* cpuTensor(const Blob* blob) {
+  if (!BlobIsTensorType(*blob, CPU)) {
+    return nullptr;
+  }
+  const auto& tensor = blob->Get<Tensor>();
+  return tensor.defined() && tensor.storage_initialized() ? &tensor : nullptr;
+}
+
+const Storage& storage(const Tensor& tensor) {
+  return tensor.getIntrusivePtr()->storage();
+}
+
+} // namespace
+
+// The arena is shared by the plan and by the tensors bound to it, so that it
+// outlives the tensors even if the net is destroyed first.
+struct NetMemoryPlanner::Arena {
+  at::DataPtr data;
+};
+
+namespace {
+
+void releaseArena(void* ctx) {
+  delete static_cast<std::shared_ptr<NetMemoryPlanner::Arena>*>(ctx);
+}
+
+bool inArena(const Tensor& tensor) {
+  return storage(tensor).data_ptr().get_deleter() == &releaseArena;
+}
+
+} // namespace
+
+NetMemoryPlanner::NetMemoryPlanner(
+    const NetDef& net_def,
+    const std::vector<dag_utils::OperatorNode>& operator_nodes,
+    Workspace* ws) {
+  const int num_ops = operator_nodes.size();
+  CAFFE_ENFORCE_EQ(num_ops, net_def.op_size());
+
+  // Ops are topologically sorted, parents come first
+  const int words = (num_ops + 63) / 64;
+  ancestors_.assign(num_ops, std::vector<uint64_t>(words, 0));
+  for (int op_id = 0; op_id < num_ops; ++op_id) {
+    auto& mask = ancestors_[op_id];
+    for (auto parent_id : operator_nodes[op_id].parents_) {
+      CAFFE_ENFORCE_LT(parent_id, op_id);
+      const auto& parent_mask = ancestors_[parent_id];
+      for (int w = 0; w < words; ++w) {
+        mask[w] |= parent_mask[w];
+      }
+      mask[parent_id / 64] |= uint64_t(1) << (parent_id % 64);
+    }
+  }
+
+  struct BlobInfo {
+    std::vector<int> uses;
+    int first_producer = -1;
+    bool read_before_written = false;
+    bool plannable = true;
+  };
+  std::unordered_map<std::string, BlobInfo> blobs;
+  std::vector<std::string> blob_order;
+  auto info = [&](const std::string& name) -> BlobInfo& {
+    auto it = blobs.find(name);
+    if (it == blobs.end()) {
+      blob_order.push_back(name);
+      it = blobs.emplace(name, BlobInfo()).first;
+    }
+    return it->second;
+  };
+  for (int op_id = 0; op_id < num_ops; ++op_id) {
+    const auto& op_def = net_def.op(op_id);
+    const auto* op = operator_nodes[op_id].operator_.get();
+    const bool sync_cpu_op =
+        IsCPUDeviceType(op->device_option().device_type()) &&
+        !op->HasAsyncPart();
+    for (const auto& name : op_def.input()) {
+      auto& blob_info = info(name);
+      if (blob_info.first_producer < 0) {
+        blob_info.read_before_written = true;
+      }
+      if (blob_info.uses.empty() || blob_info.uses.back() != op_id) {
+        blob_info.uses.push_back(op_id);
+      }
+      blob_info.plannable &= sync_cpu_op;
+    }
+    for (const auto& name : op_def.output()) {
+      auto& blob_info = info(name);
+      if (blob_info.first_producer < 0) {
+        blob_info.first_producer = op_id;
+      }
+      if (blob_info.uses.empty() || blob_info.uses.back() != op_id) {
+        blob_info.uses.push_back(op_id);
+      }
+      blob_info.plannable &= sync_cpu_op;
+    }
+  }
+  const std::unordered_set<std::string> external_outputs(
+      net_def.external_output().begin(), net_def.external_output().end());
+
+  for (const auto& name : blob_order) {
+    const auto& blob_info = blobs[name];
+    auto* blob = ws->GetBlob(name);
+    if (!blob) {
+      continue;
+    }
+    net_blobs_.push_back(blob);
+    if (blob_info.read_before_written) {
+      input_blobs_.push_back(blob);
+      continue;
+    }
+    // a blob that is only written is an output of the net
+    const bool consumed = blob_info.uses.back() != blob_info.first_producer;
+    if (blob_info.plannable && consumed && !external_outputs.count(name)) {
+      candidates_.push_back(
+          Candidate{blob, blob_info.uses, blob_info.first_producer});
+    }
+  }
+  VLOG(1) << "Memory planner of net " << net_def.name() << " can plan "
+          << candidates_.size() << " out of " << net_blobs_.size() << " blobs";
+}
+
+std::string NetMemoryPlanner::inputSignature() const {
+  std::ostringstream signature;
+  for (const auto* blob : input_blobs_) {
+    if (!blob->GetRaw()) {
+      signature << "-;";
+      continue;
+    }
+    signature << blob->meta().name();
+    if (blob->IsType<Tensor>()) {
+      const auto& tensor = blob->Get<Tensor>();
+      if (tensor.defined()) {
+        signature << ":" << tensor.dtype().name();
+        for (auto dim : tensor.sizes()) {
+          signature << "," << dim;
+        }
+      }
+    }
+    signature << ";";
+  }
+  return signature.str();
+}
+
+bool NetMemoryPlanner::precedes(int a, int b) const {
+  const int producer = candidates_[b].first_producer;
+  const auto& mask = ancestors_[producer];
+  for (auto op_id : candidates_[a].uses) {
+    if (!(mask[op_id / 64] & (uint64_t(1) << (op_id % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<NetMemoryPlanner::Plan> NetMemoryPlanner::buildPlan() const {
+  struct Placement {
+    int candidate;
+    size_t bytes;
+    size_t offset;
+  };
+  std::vector<Placement> placements;
+  for (int c = 0; c < static_cast<int>(candidates_.size()); ++c) {
+    if (excluded_.count(c)) {
+      continue;
+    }
+    const auto* tensor = cpuTensor(candidates_[c].blob);
+    if (!tensor || tensor->nbytes() == 0 || tensor->dtype().placementNew() ||
+        !tensor->is_contiguous() || !storage(*tensor).unique()) {
+      continue;
+    }
+    placements.push_back({c, alignBytes(tensor->nbytes()), 0});
+  }
+
+  // Greedy by size: place the largest tensors first, each at the lowest
+  // offset that does not overlap with the tensors placed so far whose
+  // lifetimes may overlap with its own
+  std::stable_sort(
+      placements.begin(),
+      placements.end(),
+      [](const Placement& a, const Placement& b) { return a.bytes > b.bytes; });
+  size_t arena_bytes = 0;
+  std::vector<const Placement*> conflicts;
+  for (size_t i = 0; i < placements.size(); ++i) {
+    auto& placement = placements[i];
+    conflicts.clear();
+    for (size_t j = 0; j < i; ++j) {
+      const auto& other = placements[j];
+      if (!precedes(placement.candidate, other.candidate) &&
+          !precedes(other.candidate, placement.candidate)) {
+        conflicts.push_back(&other);
+      }
+    }
+    std::sort(
+        conflicts.begin(),
+        conflicts.end(),
+        [](const Placement* a, const Placement* b) {
+          return a->offset < b->offset;
+        });
+    size_t offset = 0;
+    for (const auto* other : conflicts) {
+      if (offset + placement.bytes <= other->offset) {
+        break;
+      }
+      offset = std::max(offset, other->offset + other->bytes);
+    }
+    placement.offset = offset;
+    arena_bytes = std::max(arena_bytes, offset + placement.bytes);
+  }
+
+  std::unique_ptr<Plan> plan(new Plan());
+  plan->arena_bytes = arena_bytes;
+  size_t total_bytes = 0;
+  for (const auto& placement : placements) {
+    const auto& tensor = *cpuTensor(candidates_[placement.candidate].blob);
+    plan->candidates.push_back(placement.candidate);
+    plan->offsets.push_back(placement.offset);
+    plan->bytes.push_back(placement.bytes);
+    plan->dims.push_back(tensor.sizes().vec());
+    plan->types.push_back(tensor.dtype());
+    total_bytes += placement.bytes;
+  }
+  VLOG(1) << "Planned " << placements.size() << " blobs of " << total_bytes
+          << " bytes in an arena of " << arena_bytes << " bytes";
+  return plan;
+}
+
+void NetMemoryPlanner::bindPlan(Plan* plan) {
+  if (!plan->arena) {
+    plan->arena = std::make_shared<Arena>();
+    plan->arena->data = GetCPUAllocator()->allocate(plan->arena_bytes);
+  }
+  auto* base = static_cast<char*>(plan->arena->data.get());
+  for (size_t i = 0; i < plan->candidates.size(); ++i) {
+    auto* slot = base + plan->offsets[i];
+    auto* blob = candidates_[plan->candidates[i]].blob;
+    auto* tensor = BlobGetMutableTensor(blob, CPU);
+    if (tensor->storage_initialized() && storage(*tensor).data() == slot) {
+      // still bound since the previous run
+      continue;
+    }
+    tensor->Resize(plan->dims[i]);
+    tensor->ShareExternalPointer(
+        at::DataPtr(
+            slot,
+            new std::shared_ptr<Arena>(plan->arena),
+            &releaseArena,
+            at::Device(CPU)),
+        plan->types[i],
+        plan->bytes[i]);
+  }
+}
+
+void NetMemoryPlanner::PrepareRun() {
+  signature_ = inputSignature();
+  auto it = plans_.find(signature_);
+  plan_ = it != plans_.end() ? it->second.get() : nullptr;
+  if (plan_) {
+    bindPlan(plan_);
+  }
+}
+
+void NetMemoryPlanner::FinishRun() {
+  if (plan_) {
+    // An op that made another blob share the storage of a planned tensor
+    // would let the other blob see the range reused; stop planning the
+    // tensor.
+    bool aliased = false;
+    for (auto c : plan_->candidates) {
+      const auto* tensor = cpuTensor(candidates_[c].blob);
+      if (tensor && !storage(*tensor).unique()) {
+        excluded_.insert(c);
+        aliased = true;
+      }
+    }
+    if (aliased) {
+      plans_.clear();
+      plan_ = nullptr;
+    }
+    return;
+  }
+
+  // Tensors that share memory with other blobs cannot be planned. Tensors
+  // bound to the arena of another plan may legitimately start at the same
+  // address, they are checked when their plan is used.
+  std::unordered_map<const void*, int> owners;
+  for (const auto* blob : net_blobs_) {
+    const auto* tensor = cpuTensor(blob);
+    if (tensor && !inArena(*tensor)) {
+      ++owners[storage(*tensor).data()];
+    }
+  }
+  for (int c = 0; c < static_cast<int>(candidates_.size()); ++c) {
+    const auto* tensor = cpuTensor(candidates_[c].blob);
+    if (tensor && !inArena(*tensor) &&
+        (owners[storage(*tensor).data()] > 1 || !storage(*tensor).unique())) {
+      excluded_.insert(c);
+    }
+  }
+
+  if (plans_.size() >= kMaxPlans) {
+    plans_.clear();
+  }
+  plans_[signature_] = buildPlan();
+}
+
+size_t NetMemoryPlanner::ArenaBytes() const {
+  return plan_ ? plan_->arena_bytes : 0;
+}
+
+size_t NetMemoryPlanner::PlannedBlobsNum() const {
+  return plan_ ? plan_->candidates.size() : 0;
+}
+
+} // namespace caffe2
@@ -0,0 +1,105 @@
+#ifndef CAFFE2_CORE_NET_MEMORY_PLANNER_H_
+#define CAFFE2_CORE_NET_MEMORY_PLANNER_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "caffe2/core/blob.h"
+#include "caffe2/core/common.h"
+#include "caffe2/core/net_dag_utils.h"
+#include "caffe2/core/workspace.h"
+#include "caffe2/proto/caffe2_pb.h"
+
+namespace caffe2 {
+
+/**
+ * Places the intermediate CPU tensors of a net into one reusable arena at run
+ * time. Unlike SimpleRefCountNet, which frees blobs after their last use in
+ * the sequential order of the ops, lifetimes are derived from the operator
+ * DAG: two tensors only share memory if every use of one of them is an
+ * ancestor of the first op producing the other, so the plan is valid for any
+ * order the async executors may run the ops in.
+ *
+ * A plan is computed after a run from the sizes the tensors ended up with and
+ * is cached per signature of the input shapes of the net. The following runs
+ * with the same signature bind the tensors to their ranges of the arena before
+ * any op runs, so that the ops write into the arena instead of allocating. A
+ * tensor that outgrows its range is reallocated by its op as usual and just
+ * leaves the arena.
+ *
+ * Planned blobs are the blobs that are produced and consumed by the net, are
+ * not external outputs, are not read before being written and are only used by
+ * synchronous CPU ops.
+ */
+class CAFFE2_API NetMemoryPlanner {
+ public:
+  NetMemoryPlanner(
+      const NetDef& net_def,
+      const std::vector<dag_utils::OperatorNode>& operator_nodes,
+      Workspace* ws);
+
+  // Binds the planned tensors to the arena, must be called before the ops of
+  // a run are scheduled
+  void PrepareRun();
+  // Records the tensor sizes of a successful run, must be called once all the
+  // ops of the run are finished
+  void FinishRun();
+
+  // Size of the arena of the plan of the current run, 0 if there is no plan
+  size_t ArenaBytes() const;
+  // Number of blobs placed in the arena by the plan of the current run
+  size_t PlannedBlobsNum() const;
+  // Number of blobs that could be planned
+  size_t CandidatesNum() const {
+    return candidates_.size();
+  }
+
+ private:
+  struct Candidate {
+    Blob* blob;
+    // ops reading or writing the blob, in net order
+    std::vector<int> uses;
+    int first_producer;
+  };
+
+  struct Arena;
+
+  struct Plan {
+    std::vector<int> candidates;
+    std::vector<size_t> offsets;
+    std::vector<size_t> bytes;
+    std::vector<std::vector<int64_t>> dims;
+    std::vector<TypeMeta> types;
+    size_t arena_bytes = 0;
+    // allocated the first time the plan is used
+    std::shared_ptr<Arena> arena;
+  };
+
+  std::string inputSignature() const;
+  std::unique_ptr<Plan> buildPlan() const;
+  void bindPlan(Plan* plan);
+  // Whether all uses of candidate a happen before candidate b is produced
+  bool precedes(int a, int b) const;
+
+  std::vector<Candidate> candidates_;
+  // blobs read by the net before being written, their shapes determine the
+  // signature
+  std::vector<Blob*> input_blobs_;
+  // all blobs used by the net, to detect aliasing
+  std::vector<Blob*> net_blobs_;
+  // ancestors_[i] is a bitmask of the ops that op i transitively depends on
+  std::vector<std::vector<uint64_t>> ancestors_;
+  // candidates found sharing storage with other blobs
+  std::unordered_set<int> excluded_;
+
+  std::unordered_map<std::string, std::unique_ptr<Plan>> plans_;
+  std::string signature_;
+  Plan* plan_ = nullptr;
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_CORE_NET_MEMORY_PLANNER_H_
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "caffe2/core/net.h"
+#include "caffe2/core/net_async_scheduling.h"
+#include "caffe2/core/operator.h"
+
+namespace caffe2 {
+
+namespace {
+
+class NetMemoryPlannerTestOp final : public Operator<CPUContext> {
+ public:
+  NetMemoryPlannerTestOp(const OperatorDef& operator_def, Workspace* ws)
+      : Operator<CPUContext>(operator_def, ws) {}
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+
+  bool RunOnDevice() override {
+    const auto& input = Input(0);
+    auto* output = Output(0);
+    output->ResizeLike(input);
+    const auto* input_data = input.data<float>();
+    auto* output_data = output->mutable_data<float>();
+    for (int64_t i = 0; i < input.numel(); ++i) {
+      output_data[i] = input_data[i] + 1;
+    }
+    return true;
+  }
+};
+
+REGISTER_CPU_OPERATOR(NetMemoryPlannerTest, NetMemoryPlannerTestOp);
+
+OPERATOR_SCHEMA(NetMemoryPlannerTest).NumInputs(1).NumOutputs(1);
+
+void setInput(Workspace* ws, int64_t size, float value) {
+  auto* tensor =
+      BlobGetMutableTensor(ws->CreateBlob("a"), {size}, at::dtype<float>());
+  for (int64_t i = 0; i < size; ++i) {
+    tensor->mutable_data<float>()[i] = value;
+  }
+}
+
+const float* blobData(Workspace* ws, const std::string& name) {
+  return ws->GetBlob(name)->Get<Tensor>().data<float>();
+}
+
+} // namespace
+
+TEST(NetMemoryPlannerTest, ReusesMemoryOfDeadTensors) {
+  Workspace ws;
+  setInput(&ws, 16, 1);
+  NetDef net_def;
+  net_def.set_type("async_scheduling");
+  net_def.add_external_input("a");
+  net_def.add_external_output("e");
+  auto* arg = net_def.add_arg();
+  arg->set_name("memory_planning");
+  arg->set_i(1);
+  // a -> b -> c -> d -> e, the ranges of b and d can be shared
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetMemoryPlannerTest", "", {"a"}, {"b"}));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetMemoryPlannerTest", "", {"b"}, {"c"}));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetMemoryPlannerTest", "", {"c"}, {"d"}));
+  net_def.add_op()->CopyFrom(
+      CreateOperatorDef("NetMemoryPlannerTest", "", {"d"}, {"e"}));
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  auto* async_net = dynamic_cast<AsyncSchedulingNet*>(net.get());
+  ASSERT_TRUE(async_net);
+  const auto* planner = async_net->memoryPlanner();
+  ASSERT_TRUE(planner);
+  EXPECT_EQ(planner->CandidatesNum(), 3u);
+
+  for (int run = 0; run < 3; ++run) {
+    ASSERT_TRUE(net->Run());
+    EXPECT_EQ(blobData(&ws, "e")[0], 5);
+    EXPECT_EQ(blobData(&ws, "e")[15], 5);
+  }
+  EXPECT_EQ(planner->PlannedBlobsNum(), 3u);
+  EXPECT_EQ(planner->ArenaBytes(), 2 * 16 * sizeof(float));
+  EXPECT_EQ(blobData(&ws, "b"), blobData(&ws, "d"));
+  EXPECT_NE(blobData(&ws, "b"), blobData(&ws, "c"));
+
+  // A new input shape gets its own plan, tensors outgrowing the ranges of the
+  // previous plan leave its arena
+  setInput(&ws, 1024, 2);
+  for (int run = 0; run < 2; ++run) {
+    ASSERT_TRUE(net->Run());
+    EXPECT_EQ(blobData(&ws, "e")[0], 6);
+    EXPECT_EQ(blobData(&ws, "e")[1023], 6);
+  }
+  EXPECT_EQ(planner->ArenaBytes(), 2 * 1024 * sizeof(float));
+
+  setInput(&ws, 16, 3);
+  ASSERT_TRUE(net->Run());
+  EXPECT_EQ(blobData(&ws, "e")[15], 7);
+  EXPECT_EQ(planner->ArenaBytes(), 2 * 16 * sizeof(float));
+}
+
+} // namespace caffe2
@@ -29,6 +29,10 @@ ParallelNet::ParallelNet(
     op->SetExecutorHelper(helper_.get());
     operators_.push_back(op);
   }
+  if (options_.use_memory_planning_) {
+    memory_planner_ =
+        caffe2::make_unique<NetMemoryPlanner>(*net_def, operator_nodes_, ws);
+  }
 
   task_graph_ = TaskGraphRegistry()->Create(
       FLAGS_caffe2_task_graph_engine, helper_.get(), options_);
@@ -79,7 +83,11 @@ ParallelNet::ParallelNet(
   // Freeze graph and initialize graph execution future
   task_graph_->FreezeGraph();
   run_future_ = task_graph_->GetFuture();
-  run_future_->SetCallback([this](const AsyncTaskFuture* /* unused */) {
+  run_future_->SetCallback([this](const AsyncTaskFuture* future) {
+    // runs before the waiters of the run are notified
+    if (memory_planner_ && !future->IsFailed()) {
+      memory_planner_->FinishRun();
+    }
     StopAllObservers();
     finishRun();
   });
@@ -93,6 +101,9 @@ ParallelNet::ParallelNet(
 
 bool ParallelNet::RunAsync() {
   reset();
+  if (memory_planner_) {
+    memory_planner_->PrepareRun();
+  }
   StartAllObservers();
 
   try {
@@ -36,6 +36,8 @@ class CAFFE2_API ParallelNet : public NetBase {
 
   std::vector<dag_utils::OperatorNode> operator_nodes_;
   std::vector<OperatorBase*> operators_;
+  // set if options_.use_memory_planning_
+  std::unique_ptr<NetMemoryPlanner> memory_planner_;
 
   std::mutex pools_mutex_;
   typedef std::unordered_map<
@@ -1101,4 +1101,69 @@ TEST(NetTest, ProfDAGNetErrorTest) {
   testProfDAGNetErrorCase(/*test_error=*/true);
 }
 
+TEST(NetTest, CriticalPathScheduling) {
+  // A long chain next to a few short ones, so that the chains have
+  // different priorities
+  const auto spec = R"DOC(
+        name: "example"
+        type: "async_scheduling"
+        external_input: "in"
+        arg {
+          name: "critical_path_scheduling"
+          i: 1
+        }
+        op { input: "in" output: "long1" type: "NetTestDummy" }
+        op { input: "long1" output: "long2" type: "NetTestDummy" }
+        op { input: "long2" output: "long3" type: "NetTestDummy" }
+        op { input: "long3" output: "long4" type: "NetTestDummy" }
+        op { input: "in" output: "short1" type: "NetTestDummy" }
+        op { input: "in" output: "short2" type: "NetTestDummy" }
+        op { input: "in" output: "short3" type: "NetTestDummy" }
+        op {
+          input: "long4"
+          input: "short1"
+          input: "short2"
+          input: "short3"
+          output: "out"
+          type: "NetTestDummy"
+        }
+  )DOC";
+
+  Workspace ws;
+  ws.CreateBlob("in");
+  NetDef net_def;
+  CAFFE_ENFORCE(TextFormat::ParseFromString(spec, &net_def));
+  net_def.set_num_workers(kTestPoolSize);
+  std::unique_ptr<NetBase> net(CreateNet(net_def, &ws));
+  auto* scheduling_net = dynamic_cast_if_rtti<AsyncSchedulingNet*>(net.get());
+  ASSERT_TRUE(scheduling_net != nullptr);
+
+  // NetTestDummy has no cost inference function, so every operator gets the
+  // same unit cost and the rank of a task is the number of operators on the
+  // longest path from its first operator to the end of the net, whichever way
+  // the operators are chained into tasks
+  const std::vector<float> expected_ranks = {5, 4, 3, 2, 2, 2, 2, 1};
+  auto checkRanks = [&]() {
+    const auto& chains = scheduling_net->TEST_execution_chains();
+    const auto& priorities = scheduling_net->TEST_task_priorities();
+    ASSERT_EQ(priorities.size(), chains.size());
+    // Tasks are numbered in the iteration order of the execution chains
+    int task_id = 0;
+    for (const auto& chain : chains) {
+      EXPECT_FLOAT_EQ(priorities[task_id], expected_ranks[chain.first])
+          << "task starting with operator " << chain.first;
+      ++task_id;
+    }
+  };
+  checkRanks();
+
+  for (int num_runs = 0; num_runs < 5; ++num_runs) {
+    counter.exchange(0);
+    ASSERT_TRUE(net->Run());
+    ASSERT_EQ(counter.load(), net_def.op_size());
+  }
+  // The ranks are estimated again on the second run
+  checkRanks();
+}
+
 } // namespace caffe2
@@ -1,5 +1,6 @@
 #include <cstdio>
 #include <iomanip>
+#include <map>
 #include <sstream>
 #include <thread>
 
@@ -196,5 +197,140 @@ TEST(DBReaderShardedTest, Reader) {
   EXPECT_EQ(value, "05");
 }
 
+TEST(DBReaderPrefetchTest, Reader) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+
+  // Two threads reading the key ranges [00, 05) and [05, 09] in turn.
+  std::unique_ptr<DBReader> reader(new DBReader("leveldb", name));
+  reader->StartPrefetching(2, 4);
+  EXPECT_TRUE(reader->IsPrefetching());
+  EXPECT_TRUE(reader->cursor() == nullptr);
+  const std::vector<string> expected_keys = {
+      "00", "05", "01", "06", "02", "07", "03", "08", "04", "09", "00", "05"};
+  string key;
+  string value;
+  for (const auto& expected_key : expected_keys) {
+    reader->Read(&key, &value);
+    EXPECT_EQ(key, expected_key);
+    EXPECT_EQ(value, expected_key);
+  }
+  const auto stats = reader->PrefetchStats();
+  EXPECT_EQ(stats.records, static_cast<int64_t>(expected_keys.size()));
+  EXPECT_EQ(stats.bytes, 4 * stats.records);
+
+  // Reading continues from the beginning once prefetching is stopped.
+  reader->StopPrefetching();
+  EXPECT_FALSE(reader->IsPrefetching());
+  reader->Read(&key, &value);
+  EXPECT_EQ(key, "00");
+
+  // The threads split the records of the shard of the reader, [01] and
+  // [04, 07], and each pass returns every record once.
+  CreateAndFill("leveldb", name + "1");
+  std::unique_ptr<DBReader> reader1(new DBReader("leveldb", name + "1", 3, 1));
+  reader1->StartPrefetching(2, 4);
+  for (const auto& expected_key : {"01", "04", "07", "01", "04", "07"}) {
+    reader1->Read(&key, &value);
+    EXPECT_EQ(key, expected_key);
+  }
+}
+
+TEST(DBReaderPrefetchTest, UnevenRanges) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+
+  // Three threads reading [00, 03), [03, 06) and [06, 09], the last one
+  // alone once the shorter ranges are exhausted.
+  DBReader reader("leveldb", name);
+  reader.StartPrefetching(3, 6);
+  const std::vector<string> expected_keys = {
+      "00", "03", "06", "01", "04", "07", "02", "05", "08", "09"};
+  string key;
+  string value;
+  for (int pass = 0; pass < 3; ++pass) {
+    for (const auto& expected_key : expected_keys) {
+      reader.Read(&key, &value);
+      EXPECT_EQ(key, expected_key);
+    }
+  }
+}
+
+TEST(DBReaderPrefetchTest, Serialize) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  std::unique_ptr<DBReader> reader(new DBReader("leveldb", name, 2, 1));
+  reader->StartPrefetching(2, 4);
+  string key;
+  string value;
+  for (int i = 0; i < 7; ++i) {
+    reader->Read(&key, &value);
+  }
+
+  Blob reader_blob;
+  reader_blob.Reset(reader.release());
+  std::string str = SerializeBlob(reader_blob, "saved_reader");
+  DBReaderProto proto;
+  BlobProto blob_proto;
+  CHECK(blob_proto.ParseFromString(str));
+  CHECK(proto.ParseFromString(blob_proto.content()));
+  EXPECT_EQ(proto.num_shards(), 2);
+  EXPECT_EQ(proto.shard_id(), 1);
+  EXPECT_EQ(proto.prefetch_threads(), 2);
+  EXPECT_EQ(proto.readahead(), 4);
+  EXPECT_EQ(proto.prefetch_position(), 7);
+
+  // The restored reader continues where the saved one stopped.
+  std::vector<string> expected_keys;
+  for (int i = 0; i < 12; ++i) {
+    reader_blob.Get<DBReader>().Read(&key, &value);
+    expected_keys.push_back(key);
+  }
+  reader_blob.Reset();
+  Blob new_reader_blob;
+  DeserializeBlob(str, &new_reader_blob);
+  const DBReader& new_reader = new_reader_blob.Get<DBReader>();
+  EXPECT_TRUE(new_reader.IsPrefetching());
+  for (const auto& expected_key : expected_keys) {
+    new_reader.Read(&key, &value);
+    EXPECT_EQ(key, expected_key);
+  }
+}
+
+TEST(DBReaderPrefetchTest, ConcurrentReads) {
+  std::string name = std::tmpnam(nullptr);
+  CreateAndFill("leveldb", name);
+  DBReader reader("leveldb", name);
+  reader.StartPrefetching(2, 8);
+
+  // The two key ranges have the same size, so every record is read once per
+  // pass over the db.
+  constexpr int kNumThreads = 4;
+  constexpr int kReadsPerThread = 5 * kMaxItems;
+  std::vector<std::thread> threads;
+  std::vector<std::vector<string>> keys(kNumThreads);
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&reader, &keys, i]() {
+      string key;
+      string value;
+      for (int j = 0; j < kReadsPerThread; ++j) {
+        reader.Read(&key, &value);
+        keys[i].push_back(key);
+      }
+    });
+  }
+  std::map<string, int> counts;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads[i].join();
+    for (const auto& key : keys[i]) {
+      ++counts[key];
+    }
+  }
+  EXPECT_EQ(counts.size(), kMaxItems);
+  for (const auto& count : counts) {
+    EXPECT_EQ(count.second, kNumThreads * kReadsPerThread / kMaxItems);
+  }
+}
+
 }  // namespace db
 }  // namespace caffe2
@@ -0,0 +1,361 @@
+#include "latency_histogram_observer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+#include "c10/util/llvmMathExtras.h"
+#include "caffe2/core/init.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/core/stats.h"
+
+C10_DEFINE_bool(
+    caffe2_latency_histogram_observer,
+    false,
+    "If true, attach a LatencyHistogramObserver to every net");
+C10_DEFINE_int(
+    caffe2_latency_histogram_sample_rate,
+    1,
+    "LatencyHistogramObserver times one in N runs of a net");
+C10_DEFINE_int(
+    caffe2_latency_histogram_export_interval,
+    0,
+    "LatencyHistogramObserver publishes the latency percentiles to the "
+    "StatRegistry every N timed runs, 0 to never publish them");
+C10_DEFINE_bool(
+    caffe2_latency_histogram_observe_operators,
+    true,
+    "If true, LatencyHistogramObserver also times the operators of a net");
+
+namespace caffe2 {
+
+namespace {
+
+int threadShardIndex() {
+  static std::atomic<int> nextThread{0};
+  thread_local int index = nextThread++ % LatencyHistogram::kMaxShards;
+  return index;
+}
+
+uint64_t elapsedNanos(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+void exportSnapshot(
+    const std::string& prefix,
+    const LatencyHistogramSnapshot& snapshot) {
+  auto& registry = StatRegistry::get();
+  auto set = [&](const std::string& name, double value) {
+    registry.add(prefix + "/" + name)->reset(std::llround(value));
+  };
+  set("count", snapshot.count);
+  set("mean_us", snapshot.MeanMicros());
+  set("p50_us", snapshot.PercentileMicros(0.5));
+  set("p90_us", snapshot.PercentileMicros(0.9));
+  set("p99_us", snapshot.PercentileMicros(0.99));
+  set("p999_us", snapshot.PercentileMicros(0.999));
+  set("max_us", snapshot.MaxMicros());
+}
+
+void printSnapshot(
+    std::ostream& out,
+    const std::string& name,
+    const LatencyHistogramSnapshot& snapshot) {
+  out << std::setw(32) << std::left << name << std::right << std::fixed
+      << std::setprecision(1) << " count " << snapshot.count << " mean "
+      << snapshot.MeanMicros() << " p50 " << snapshot.PercentileMicros(0.5)
+      << " p90 " << snapshot.PercentileMicros(0.9) << " p99 "
+      << snapshot.PercentileMicros(0.99) << " p999 "
+      << snapshot.PercentileMicros(0.999) << " max " << snapshot.MaxMicros()
+      << " us\n";
+}
+
+} // namespace
+
+void LatencyHistogramSnapshot::Merge(const LatencyHistogramSnapshot& other) {
+  if (counts.size() < other.counts.size()) {
+    counts.resize(other.counts.size(), 0);
+  }
+  for (size_t i = 0; i < other.counts.size(); ++i) {
+    counts[i] += other.counts[i];
+  }
+  count += other.count;
+  sumNanos += other.sumNanos;
+  maxNanos = std::max(maxNanos, other.maxNanos);
+}
+
+double LatencyHistogramSnapshot::MeanMicros() const {
+  return count ? sumNanos / 1000.0 / count : 0.0;
+}
+
+double LatencyHistogramSnapshot::MaxMicros() const {
+  return maxNanos / 1000.0;
+}
+
+double LatencyHistogramSnapshot::PercentileMicros(double q) const {
+  if (count == 0) {
+    return 0.0;
+  }
+  const uint64_t rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(std::min(q, 1.0) * count)));
+  uint64_t seen = 0;
+  for (size_t i = 0; i < counts.size(); ++i) {
+    seen += counts[i];
+    if (seen >= rank) {
+      // The middle of the bucket is within half a bucket of any value in it
+      const uint64_t value = LatencyHistogram::BucketLowerBound(i) +
+          LatencyHistogram::BucketWidth(i) / 2;
+      return std::min(value, maxNanos) / 1000.0;
+    }
+  }
+  return MaxMicros();
+}
+
+struct LatencyHistogram::Shard {
+  std::array<std::atomic<uint64_t>, kNumBuckets> counts;
+  std::atomic<uint64_t> sumNanos;
+  std::atomic<uint64_t> maxNanos;
+};
+
+LatencyHistogram::LatencyHistogram() {
+  for (auto& shard : shards_) {
+    shard.store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+LatencyHistogram::~LatencyHistogram() {
+  for (auto& shard : shards_) {
+    delete shard.load(std::memory_order_relaxed);
+  }
+}
+
+int LatencyHistogram::BucketIndex(uint64_t nanos) {
+  if (nanos < kSubBuckets) {
+    return nanos;
+  }
+  const int msb = llvm::Log2_64(nanos);
+  if (msb >= kMaxBits) {
+    return kNumBuckets - 1;
+  }
+  const int shift = msb - kSubBucketBits;
+  return (shift + 1) * kSubBuckets + ((nanos >> shift) - kSubBuckets);
+}
+
+uint64_t LatencyHistogram::BucketLowerBound(int index) {
+  const int group = index / kSubBuckets;
+  const uint64_t subBucket = index % kSubBuckets;
+  if (group == 0) {
+    return subBucket;
+  }
+  return (kSubBuckets + subBucket) << (group - 1);
+}
+
+uint64_t LatencyHistogram::BucketWidth(int index) {
+  const int group = index / kSubBuckets;
+  return group == 0 ? 1 : uint64_t(1) << (group - 1);
+}
+
+LatencyHistogram::Shard* LatencyHistogram::shard() {
+  auto& slot = shards_[threadShardIndex()];
+  auto* current = slot.load(std::memory_order_acquire);
+  if (!current) {
+    // Value-initialized, all the counters start at zero
+    auto* created = new Shard();
+    if (slot.compare_exchange_strong(
+            current, created, std::memory_order_acq_rel)) {
+      current = created;
+    } else {
+      delete created;
+    }
+  }
+  return current;
+}
+
+void LatencyHistogram::Record(int64_t nanos) {
+  const uint64_t value = nanos > 0 ? nanos : 0;
+  auto* current = shard();
+  current->counts[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+  current->sumNanos.fetch_add(value, std::memory_order_relaxed);
+  auto max = current->maxNanos.load(std::memory_order_relaxed);
+  while (value > max &&
+         !current->maxNanos.compare_exchange_weak(
+             max, value, std::memory_order_relaxed)) {
+  }
+}
+
+LatencyHistogramSnapshot LatencyHistogram::Snapshot(bool reset) {
+  auto take = [reset](std::atomic<uint64_t>& counter) {
+    return reset ? counter.exchange(0, std::memory_order_relaxed)
+                 : counter.load(std::memory_order_relaxed);
+  };
+  LatencyHistogramSnapshot snapshot;
+  snapshot.counts.assign(kNumBuckets, 0);
+  for (auto& slot : shards_) {
+    auto* current = slot.load(std::memory_order_acquire);
+    if (!current) {
+      continue;
+    }
+    for (int i = 0; i < kNumBuckets; ++i) {
+      const auto count = take(current->counts[i]);
+      snapshot.counts[i] += count;
+      snapshot.count += count;
+    }
+    snapshot.sumNanos += take(current->sumNanos);
+    snapshot.maxNanos = std::max(snapshot.maxNanos, take(current->maxNanos));
+  }
+  return snapshot;
+}
+
+LatencyHistogramOperatorObserver::LatencyHistogramOperatorObserver(
+    OperatorBase* subject,
+    std::shared_ptr<const std::atomic<bool>> sampled,
+    std::shared_ptr<LatencyHistogram> histogram,
+    std::shared_ptr<LatencyHistogramAttachedObservers> attached)
+    : ObserverBase<OperatorBase>(subject),
+      sampled_(std::move(sampled)),
+      histogram_(std::move(histogram)),
+      attached_(std::move(attached)) {}
+
+LatencyHistogramOperatorObserver::~LatencyHistogramOperatorObserver() {
+  if (attached_) {
+    attached_->erase(subject_);
+  }
+}
+
+std::unique_ptr<ObserverBase<OperatorBase>>
+LatencyHistogramOperatorObserver::rnnCopy(
+    OperatorBase* subject,
+    int /* rnn_order */) const {
+  return std::unique_ptr<ObserverBase<OperatorBase>>(
+      new LatencyHistogramOperatorObserver(subject, sampled_, histogram_));
+}
+
+void LatencyHistogramOperatorObserver::Start() {
+  if (sampled_->load(std::memory_order_relaxed)) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+void LatencyHistogramOperatorObserver::Stop() {
+  if (sampled_->load(std::memory_order_relaxed)) {
+    histogram_->Record(elapsedNanos(start_));
+  }
+}
+
+LatencyHistogramObserver::LatencyHistogramObserver(NetBase* subject)
+    : LatencyHistogramObserver(
+          subject,
+          FLAGS_caffe2_latency_histogram_sample_rate,
+          FLAGS_caffe2_latency_histogram_export_interval,
+          FLAGS_caffe2_latency_histogram_observe_operators) {}
+
+LatencyHistogramObserver::LatencyHistogramObserver(
+    NetBase* subject,
+    int sampleRate,
+    int exportInterval,
+    bool observeOperators)
+    : NetObserver(subject),
+      sampleRate_(sampleRate),
+      exportInterval_(exportInterval),
+      sampled_(std::make_shared<std::atomic<bool>>(false)),
+      netHistogram_(std::make_shared<LatencyHistogram>()),
+      attached_(std::make_shared<LatencyHistogramAttachedObservers>()) {
+  CAFFE_ENFORCE_GE(sampleRate_, 1);
+  CAFFE_ENFORCE_GE(exportInterval_, 0);
+  if (!observeOperators) {
+    return;
+  }
+  for (auto* op : subject->GetOperators()) {
+    const std::string type =
+        op->has_debug_def() ? op->debug_def().type() : "NO_TYPE";
+    auto& histogram = opHistograms_[type];
+    if (!histogram) {
+      histogram = std::make_shared<LatencyHistogram>();
+    }
+    auto observer = caffe2::make_unique<LatencyHistogramOperatorObserver>(
+        op, sampled_, histogram, attached_);
+    (*attached_)[op] = op->AttachObserver(std::move(observer));
+  }
+}
+
+LatencyHistogramObserver::~LatencyHistogramObserver() {
+  // The detached observers erase themselves from attached_ when they are
+  // destroyed, so iterate over a copy
+  const auto attached = *attached_;
+  for (const auto& it : attached) {
+    it.first->DetachObserver(it.second);
+  }
+}
+
+void LatencyHistogramObserver::Start() {
+  const bool sampled = numRuns_++ % sampleRate_ == 0;
+  sampled_->store(sampled, std::memory_order_relaxed);
+  if (sampled) {
+    start_ = std::chrono::steady_clock::now();
+  }
+}
+
+void LatencyHistogramObserver::Stop() {
+  if (!sampled_->load(std::memory_order_relaxed)) {
+    return;
+  }
+  netHistogram_->Record(elapsedNanos(start_));
+  sampled_->store(false, std::memory_order_relaxed);
+  if (exportInterval_ > 0 && ++numSampledRuns_ % exportInterval_ == 0) {
+    Export();
+  }
+}
+
+LatencyHistogramSnapshot LatencyHistogramObserver::NetSnapshot() const {
+  return netHistogram_->Snapshot();
+}
+
+std::map<std::string, LatencyHistogramSnapshot>
+LatencyHistogramObserver::OperatorSnapshots() const {
+  std::map<std::string, LatencyHistogramSnapshot> snapshots;
+  for (const auto& it : opHistograms_) {
+    snapshots[it.first] = it.second->Snapshot();
+  }
+  return snapshots;
+}
+
+void LatencyHistogramObserver::Export(bool reset) {
+  const auto prefix = "latency_histogram/" + subject_->Name();
+  exportSnapshot(prefix, netHistogram_->Snapshot(reset));
+  for (const auto& it : opHistograms_) {
+    exportSnapshot(prefix + "/" + it.first, it.second->Snapshot(reset));
+  }
+}
+
+std::string LatencyHistogramObserver::debugInfo() {
+  std::ostringstream out;
+  printSnapshot(out, subject_->Name(), NetSnapshot());
+  for (const auto& it : OperatorSnapshots()) {
+    printSnapshot(out, "  " + it.first, it.second);
+  }
+  return out.str();
+}
+
+namespace {
+
+bool registerGlobalLatencyHistogramObserverCreator(int*, char***) {
+  if (FLAGS_caffe2_latency_histogram_observer) {
+    AddGlobalNetObserverCreator([](NetBase* subject) {
+      return caffe2::make_unique<LatencyHistogramObserver>(subject);
+    });
+  }
+  return true;
+}
+
+} // namespace
+
+REGISTER_CAFFE2_INIT_FUNCTION(
+    registerGlobalLatencyHistogramObserverCreator,
+    &registerGlobalLatencyHistogramObserverCreator,
+    "Attaches a LatencyHistogramObserver to every net if "
+    "--caffe2_latency_histogram_observer is set");
+
+} // namespace caffe2
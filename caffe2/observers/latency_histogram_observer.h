@@ -0,0 +1,161 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+
+namespace caffe2 {
+
+// Counts of a LatencyHistogram at some point in time, latencies are returned
+// in microseconds
+struct CAFFE2_API LatencyHistogramSnapshot {
+  std::vector<uint64_t> counts;
+  uint64_t count = 0;
+  uint64_t sumNanos = 0;
+  uint64_t maxNanos = 0;
+
+  void Merge(const LatencyHistogramSnapshot& other);
+  double MeanMicros() const;
+  double MaxMicros() const;
+  // q in [0, 1], e.g. 0.99 for the 99th percentile
+  double PercentileMicros(double q) const;
+};
+
+/**
+ * HDR-style histogram of latencies in nanoseconds. Buckets are linear below
+ * kSubBuckets and log-linear above: every power of two is split into
+ * kSubBuckets buckets, so a recorded value is known with a relative error
+ * below 1 / kSubBuckets over the whole range, with a fixed number of
+ * counters.
+ *
+ * Recording is lock-free: every thread records into its own shard of
+ * counters, allocated the first time the thread records, and shards are only
+ * merged when a snapshot is taken.
+ */
+class CAFFE2_API LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 5;
+  static constexpr int kSubBuckets = 1 << kSubBucketBits;
+  // Values above 2^kMaxBits ns, about 18 minutes, go to the last bucket
+  static constexpr int kMaxBits = 40;
+  static constexpr int kNumBuckets =
+      (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+  // Threads beyond kMaxShards share shards
+  static constexpr int kMaxShards = 16;
+
+  LatencyHistogram();
+  ~LatencyHistogram();
+
+  void Record(int64_t nanos);
+  // If `reset` is true, counters are reset to zero. It is guaranteed that no
+  // count recorded concurrently is lost.
+  LatencyHistogramSnapshot Snapshot(bool reset = false);
+
+  static int BucketIndex(uint64_t nanos);
+  static uint64_t BucketLowerBound(int index);
+  static uint64_t BucketWidth(int index);
+
+ private:
+  struct Shard;
+
+  Shard* shard();
+
+  std::array<std::atomic<Shard*>, kMaxShards> shards_;
+};
+
+// The operator observers attached by a LatencyHistogramObserver that still
+// exist, by operator
+using LatencyHistogramAttachedObservers =
+    std::unordered_map<OperatorBase*, const ObserverBase<OperatorBase>*>;
+
+class CAFFE2_API LatencyHistogramOperatorObserver final
+    : public ObserverBase<OperatorBase> {
+ public:
+  explicit LatencyHistogramOperatorObserver(OperatorBase* subject) = delete;
+  // If `attached` is given, the observer removes itself from it when it is
+  // destroyed
+  LatencyHistogramOperatorObserver(
+      OperatorBase* subject,
+      std::shared_ptr<const std::atomic<bool>> sampled,
+      std::shared_ptr<LatencyHistogram> histogram,
+      std::shared_ptr<LatencyHistogramAttachedObservers> attached = nullptr);
+  ~LatencyHistogramOperatorObserver();
+  std::unique_ptr<ObserverBase<OperatorBase>> rnnCopy(
+      OperatorBase* subject,
+      int rnn_order) const override;
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  // Shared with the net observer, which may be detached before the ops are
+  // destroyed
+  std::shared_ptr<const std::atomic<bool>> sampled_;
+  std::shared_ptr<LatencyHistogram> histogram_;
+  std::shared_ptr<LatencyHistogramAttachedObservers> attached_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+/**
+ * Records the latency distribution of the runs of a net and of its operators,
+ * aggregated per operator type, into LatencyHistograms.
+ *
+ * Only one in `sampleRate` runs is timed; operator observers check a flag
+ * and return right away during the other runs. Every `exportInterval` timed
+ * runs, the percentiles of the runs timed since the previous export are
+ * published to the StatRegistry as
+ * `latency_histogram/<net>[/<op type>]/{count,mean,p50,p90,p99,p999,max}_us`.
+ *
+ * It can be attached to every net with --caffe2_latency_histogram_observer.
+ * The operator observers are detached when the net observer is destroyed.
+ */
+class CAFFE2_API LatencyHistogramObserver final : public NetObserver {
+ public:
+  // Configured by the --caffe2_latency_histogram_* flags
+  explicit LatencyHistogramObserver(NetBase* subject);
+  LatencyHistogramObserver(
+      NetBase* subject,
+      int sampleRate,
+      int exportInterval,
+      bool observeOperators);
+  ~LatencyHistogramObserver();
+
+  LatencyHistogramSnapshot NetSnapshot() const;
+  // Per operator type
+  std::map<std::string, LatencyHistogramSnapshot> OperatorSnapshots() const;
+  // Publishes the percentiles to the StatRegistry, and resets the histograms
+  // if `reset` is true
+  void Export(bool reset = true);
+
+  std::string debugInfo() override;
+
+ private:
+  void Start() override;
+  void Stop() override;
+
+  const int sampleRate_;
+  const int exportInterval_;
+  std::atomic<uint64_t> numRuns_{0};
+  uint64_t numSampledRuns_ = 0;
+  std::shared_ptr<std::atomic<bool>> sampled_;
+  std::chrono::steady_clock::time_point start_;
+
+  std::shared_ptr<LatencyHistogram> netHistogram_;
+  std::map<std::string, std::shared_ptr<LatencyHistogram>> opHistograms_;
+  // Operators are destroyed before the observers of their net, and their
+  // observers with them, so only the observers of the operators that outlive
+  // this one are left to detach
+  std::shared_ptr<LatencyHistogramAttachedObservers> attached_;
+};
+
+} // namespace caffe2
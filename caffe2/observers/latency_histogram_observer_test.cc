@@ -0,0 +1,160 @@
+#include "caffe2/core/common.h"
+#include "caffe2/core/net.h"
+#include "caffe2/core/observer.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/stats.h"
+#include "latency_histogram_observer.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+class LatencyHistogramSleepOp final : public OperatorBase {
+ public:
+  LatencyHistogramSleepOp(const OperatorDef& operator_def, Workspace* ws)
+      : OperatorBase(operator_def, ws),
+        ms_(GetSingleArgument<int>("ms", 1)) {}
+
+  bool Run(int /* unused */) override {
+    StartAllObservers();
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms_));
+    StopAllObservers();
+    return true;
+  }
+
+ private:
+  int ms_;
+};
+
+REGISTER_CPU_OPERATOR(LatencyHistogramSleep, LatencyHistogramSleepOp);
+
+OPERATOR_SCHEMA(LatencyHistogramSleep)
+    .NumInputs(0, INT_MAX)
+    .NumOutputs(0, INT_MAX);
+
+std::unique_ptr<NetBase> createNet(Workspace* ws) {
+  NetDef net_def;
+  net_def.set_name("latency_histogram_test_net");
+  for (int ms : {1, 5}) {
+    auto& op = *net_def.add_op();
+    op.set_type("LatencyHistogramSleep");
+    auto& arg = *op.add_arg();
+    arg.set_name("ms");
+    arg.set_i(ms);
+  }
+  return CreateNet(net_def, ws);
+}
+
+int64_t statValue(const std::string& name) {
+  for (const auto& stat : StatRegistry::get().publish()) {
+    if (stat.key == name) {
+      return stat.value;
+    }
+  }
+  return -1;
+}
+
+} // namespace
+
+TEST(LatencyHistogramTest, BucketsCoverAllValues) {
+  for (int i = 0; i + 1 < LatencyHistogram::kNumBuckets; ++i) {
+    EXPECT_EQ(
+        LatencyHistogram::BucketLowerBound(i) +
+            LatencyHistogram::BucketWidth(i),
+        LatencyHistogram::BucketLowerBound(i + 1));
+  }
+  for (uint64_t value : {0, 1, 31, 32, 33, 1000, 123456789}) {
+    const int index = LatencyHistogram::BucketIndex(value);
+    EXPECT_LE(LatencyHistogram::BucketLowerBound(index), value);
+    EXPECT_GT(
+        LatencyHistogram::BucketLowerBound(index) +
+            LatencyHistogram::BucketWidth(index),
+        value);
+  }
+  EXPECT_EQ(
+      LatencyHistogram::BucketIndex(uint64_t(1) << 50),
+      LatencyHistogram::kNumBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&histogram]() {
+      for (int i = 1; i <= 1000; ++i) {
+        histogram.Record(i * 1000);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto snapshot = histogram.Snapshot(/* reset */ true);
+  EXPECT_EQ(snapshot.count, 4000u);
+  EXPECT_NEAR(snapshot.MeanMicros(), 500.5, 1e-6);
+  EXPECT_EQ(snapshot.MaxMicros(), 1000);
+  const double tolerance = 1.0 / LatencyHistogram::kSubBuckets;
+  EXPECT_NEAR(snapshot.PercentileMicros(0.5), 500, 500 * tolerance);
+  EXPECT_NEAR(snapshot.PercentileMicros(0.99), 990, 990 * tolerance);
+  EXPECT_EQ(histogram.Snapshot().count, 0u);
+}
+
+TEST(LatencyHistogramObserverTest, SamplesAndExports) {
+  Workspace ws;
+  auto net = createNet(&ws);
+  auto net_ob = caffe2::make_unique<LatencyHistogramObserver>(
+      net.get(), /* sampleRate */ 2, /* exportInterval */ 2, true);
+  const auto* ob = net_ob.get();
+  net->AttachObserver(std::move(net_ob));
+
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_TRUE(net->Run());
+  }
+  // only the first run is timed
+  auto snapshot = ob->NetSnapshot();
+  EXPECT_EQ(snapshot.count, 1u);
+  EXPECT_GE(snapshot.PercentileMicros(0.5), 6000 * 0.95);
+  auto op_snapshots = ob->OperatorSnapshots();
+  ASSERT_EQ(op_snapshots.size(), 1u);
+  EXPECT_EQ(op_snapshots["LatencyHistogramSleep"].count, 2u);
+
+  // the second timed run publishes the percentiles and resets the
+  // histograms, the third one is recorded after the reset
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_TRUE(net->Run());
+  }
+  EXPECT_EQ(ob->NetSnapshot().count, 1u);
+  const std::string prefix = "latency_histogram/latency_histogram_test_net";
+  EXPECT_EQ(statValue(prefix + "/count"), 2);
+  EXPECT_GE(statValue(prefix + "/p99_us"), 6000 * 0.95);
+  EXPECT_EQ(statValue(prefix + "/LatencyHistogramSleep/count"), 4);
+  EXPECT_GE(statValue(prefix + "/LatencyHistogramSleep/max_us"), 5000);
+}
+
+TEST(LatencyHistogramObserverTest, DetachesOperatorObservers) {
+  Workspace ws;
+  auto net = createNet(&ws);
+  const auto* ob = net->AttachObserver(
+      caffe2::make_unique<LatencyHistogramObserver>(net.get()));
+  for (auto* op : net->GetOperators()) {
+    EXPECT_EQ(op->NumObservers(), 1u);
+  }
+
+  net->DetachObserver(ob);
+  for (auto* op : net->GetOperators()) {
+    EXPECT_EQ(op->NumObservers(), 0u);
+  }
+  ASSERT_TRUE(net->Run());
+
+  // Destroying the net with the observer attached must not touch the
+  // destroyed operators
+  net->AttachObserver(caffe2::make_unique<LatencyHistogramObserver>(net.get()));
+  net.reset();
+}
+
+} // namespace caffe2
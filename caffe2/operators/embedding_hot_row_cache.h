@@ -0,0 +1,173 @@
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+
+// Keeps a compact copy of the most frequently accessed rows of an embedding
+// table, such that lookups of hot rows hit a small, cache-resident buffer
+// instead of random locations in a table of many GB.
+//
+// Update() is called once per run with the indices of that run. Every
+// sample_period-th index is counted, and every refresh_interval runs the
+// `capacity` rows with the highest counts are copied into the cache. Counts
+// are halved on every refresh, so that the cache follows shifts of the index
+// distribution.
+//
+// The cache keys on the address and shape of the table, and is dropped when
+// either changes, but it does not notice in-place updates of the table. It is
+// only meant for tables that are not modified while the cache is in use, such
+// as embeddings at inference time.
+class EmbeddingHotRowCache {
+ public:
+  EmbeddingHotRowCache(
+      int64_t capacity,
+      int64_t refresh_interval,
+      int64_t sample_period)
+      : capacity_(capacity),
+        refreshInterval_(refresh_interval),
+        samplePeriod_(sample_period) {
+    CAFFE_ENFORCE_GT(capacity_, 0);
+    CAFFE_ENFORCE_GT(refreshInterval_, 0);
+    CAFFE_ENFORCE_GT(samplePeriod_, 0);
+    // Keep the hash table at most half full, with a power of two size.
+    tableSize_ = 2;
+    hashShift_ = 63;
+    while (tableSize_ < 2 * capacity_) {
+      tableSize_ *= 2;
+      --hashShift_;
+    }
+  }
+
+  // Records the accesses of a run against a table of `rows` rows of
+  // `row_bytes` bytes each, and refreshes the cache if it is due.
+  template <typename IndexType>
+  void Update(
+      const void* data,
+      int64_t rows,
+      int64_t row_bytes,
+      const IndexType* indices,
+      int64_t index_size) {
+    if (data != data_ || rows != rows_ || row_bytes != rowBytes_) {
+      Reset(data, rows, row_bytes);
+    }
+    for (; nextSample_ < index_size; nextSample_ += samplePeriod_) {
+      const int64_t row = indices[nextSample_];
+      // Out of bounds indices are reported by the lookup.
+      if (row >= 0 && row < rows_) {
+        ++counts_[row];
+      }
+    }
+    nextSample_ -= index_size;
+    if (++runs_ % refreshInterval_ == 0) {
+      Refresh();
+    }
+  }
+
+  // Returns the slot of `row` in the cache, or -1 if the row is not cached.
+  int64_t Find(int64_t row) const {
+    if (cached_ == 0) {
+      return -1;
+    }
+    for (auto i = Hash(row);; i = (i + 1) & (tableSize_ - 1)) {
+      if (keys_[i] == row) {
+        return slots_[i];
+      }
+      if (keys_[i] == -1) {
+        return -1;
+      }
+    }
+  }
+
+  // Number of cached rows.
+  int64_t size() const {
+    return cached_;
+  }
+
+  // The cached rows, laid out like the table; row Find(r) holds row r.
+  template <typename T>
+  const T* data() const {
+    return reinterpret_cast<const T*>(rowData_.data());
+  }
+
+ private:
+  void Reset(const void* data, int64_t rows, int64_t row_bytes) {
+    data_ = data;
+    rows_ = rows;
+    rowBytes_ = row_bytes;
+    counts_.clear();
+    cached_ = 0;
+    runs_ = 0;
+    nextSample_ = 0;
+  }
+
+  void Refresh() {
+    std::vector<std::pair<int64_t, int64_t>> hot(
+        counts_.begin(), counts_.end());
+    const auto cached = std::min<int64_t>(capacity_, hot.size());
+    std::partial_sort(
+        hot.begin(),
+        hot.begin() + cached,
+        hot.end(),
+        [](const std::pair<int64_t, int64_t>& a,
+           const std::pair<int64_t, int64_t>& b) {
+          return a.second > b.second;
+        });
+
+    keys_.assign(tableSize_, -1);
+    slots_.resize(tableSize_);
+    rowData_.resize(cached * rowBytes_);
+    const auto* src = static_cast<const char*>(data_);
+    for (int64_t slot = 0; slot < cached; ++slot) {
+      const auto row = hot[slot].first;
+      auto i = Hash(row);
+      while (keys_[i] != -1) {
+        i = (i + 1) & (tableSize_ - 1);
+      }
+      keys_[i] = row;
+      slots_[i] = slot;
+      std::memcpy(
+          rowData_.data() + slot * rowBytes_, src + row * rowBytes_, rowBytes_);
+    }
+    cached_ = cached;
+
+    for (auto it = counts_.begin(); it != counts_.end();) {
+      it->second /= 2;
+      it = it->second == 0 ? counts_.erase(it) : std::next(it);
+    }
+  }
+
+  int64_t Hash(int64_t row) const {
+    // Fibonacci hashing spreads consecutive rows over the whole table.
+    return static_cast<int64_t>(
+        (static_cast<uint64_t>(row) * 0x9E3779B97F4A7C15ULL) >> hashShift_);
+  }
+
+  const int64_t capacity_;
+  const int64_t refreshInterval_;
+  const int64_t samplePeriod_;
+  int64_t tableSize_;
+  int hashShift_;
+
+  const void* data_ = nullptr;
+  int64_t rows_ = 0;
+  int64_t rowBytes_ = 0;
+
+  std::unordered_map<int64_t, int64_t> counts_;
+  int64_t runs_ = 0;
+  int64_t nextSample_ = 0;
+
+  // Open addressing hash table from row to slot, with -1 for empty entries.
+  std::vector<int64_t> keys_;
+  std::vector<int64_t> slots_;
+  std::vector<char> rowData_;
+  int64_t cached_ = 0;
+};
+
+} // namespace caffe2
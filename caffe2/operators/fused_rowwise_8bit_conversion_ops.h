@@ -5,6 +5,7 @@
 #include "caffe2/core/logging.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/operators/reducer_functors.h"
+#include "caffe2/perfkernels/fused_8bit_rowwise_conversion.h"
 #include "caffe2/utils/eigen_utils.h"
 #include "caffe2/utils/math.h"
 
@@ -22,8 +23,6 @@ template <
     class Context>
 class FloatToFused8BitRowwiseQuantizedOp : public Operator<Context> {
  public:
-  static constexpr float kEpsilon = 1e-8f;
-
   USE_OPERATOR_CONTEXT_FUNCTIONS;
   USE_SIMPLE_CTOR_DTOR(FloatToFused8BitRowwiseQuantizedOp)
 
@@ -60,22 +59,8 @@ class FloatToFused8BitRowwiseQuantizedOp : public Operator<Context> {
 
     for (size_t row = 0; row < input_rows; ++row) {
       convert(tmp.data(), input_data + row * input_columns, input_columns);
-      ConstEigenVectorArrayMap<float> input_row(tmp.data(), input_columns);
-      uint8_t* output_row = output_data + row * output_columns;
-      EigenVectorArrayMap<uint8_t> output_row_values(output_row, input_columns);
-      EigenVectorArrayMap<float> output_row_scale_bias(
-          reinterpret_cast<float*>(output_row + input_columns), 2);
-
-      const float minimum_element = input_row.minCoeff();
-      const float maximum_element = input_row.maxCoeff();
-      const float range = maximum_element - minimum_element;
-
-      output_row_scale_bias(0) = range / 255.0f;
-      output_row_scale_bias(1) = minimum_element;
-      const auto inverse_scale = 255.0f / (range + kEpsilon);
-      output_row_values = ((input_row - minimum_element) * inverse_scale)
-                              .round()
-                              .cast<uint8_t>();
+      FloatToFused8BitRowwiseQuantized(
+          tmp.data(), 1, input_columns, output_data + row * output_columns);
     }
 
     return true;
@@ -118,16 +103,8 @@ class Fused8BitRowwiseQuantizedToFloatOp : public Operator<Context> {
     tmp.resize(input_columns, 0.0);
 
     for (size_t row = 0; row < input_rows; ++row) {
-      const uint8_t* input_row = input_data + row * input_columns;
-      ConstEigenVectorArrayMap<uint8_t> input_row_values(
-          input_row, output_columns);
-      ConstEigenVectorArrayMap<float> input_row_scale_bias(
-          reinterpret_cast<const float*>(input_row + output_columns), 2);
-
-      EigenVectorArrayMap<float> output_row(tmp.data(), output_columns);
-      output_row = input_row_values.cast<float>() * input_row_scale_bias(0) +
-          input_row_scale_bias(1);
-
+      Fused8BitRowwiseQuantizedToFloat(
+          input_data + row * input_columns, 1, input_columns, tmp.data());
       convert(output_data + row * output_columns, tmp.data(), output_columns);
     }
     return true;
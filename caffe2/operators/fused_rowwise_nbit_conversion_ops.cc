@@ -0,0 +1,145 @@
+#include "caffe2/operators/fused_rowwise_nbit_conversion_ops.h"
+#include "c10/util/Registry.h"
+
+namespace caffe2 {
+
+namespace {
+void convertfp32fp32(float* dst, const float* src, size_t N) {
+  memcpy(dst, src, sizeof(float) * N);
+}
+
+void convertfp16fp32(float* dst, const at::Half* src, size_t N) {
+  for (size_t i = 0; i < N; i++) {
+    dst[i] = src[i];
+  }
+}
+
+void convertfp32fp16(at::Half* dst, const float* src, size_t N) {
+  for (size_t i = 0; i < N; i++) {
+    dst[i] = src[i];
+  }
+}
+} // namespace
+
+#define REGISTER_FUSED_NBIT_ROWWISE_CONVERSION_OPS(BIT_RATE)                    \
+  REGISTER_CPU_OPERATOR(                                                        \
+      FloatToFused##BIT_RATE##BitRowwiseQuantized,                              \
+      FloatToFusedNBitRowwiseQuantizedOp<BIT_RATE, float, convertfp32fp32>);    \
+  OPERATOR_SCHEMA(FloatToFused##BIT_RATE##BitRowwiseQuantized)                  \
+      .NumInputs(1)                                                             \
+      .NumOutputs(1)                                                            \
+      .TensorInferenceFunction([](const OperatorDef& /* def */,                 \
+                                  const vector<TensorShape>& in) {              \
+        vector<TensorShape> out;                                                \
+        TensorShape X = in[0];                                                  \
+        X.set_dims(1, FusedNBitRowwiseRowBytes(BIT_RATE, X.dims(1)));           \
+        out.push_back(std::move(X));                                            \
+        out[0].set_data_type(TensorProto_DataType_UINT8);                       \
+        return out;                                                             \
+      })                                                                        \
+      .SetDoc(                                                                  \
+          "Applies " #BIT_RATE "-bit row-wise quantization by determining "     \
+          "the range (maximum - minimum) and offset (minimum value) of each "   \
+          "row in the input matrix, and then scaling each element to an "       \
+          "integer between 0 and 2^" #BIT_RATE " - 1. The quantized values "    \
+          "of a row are packed with the first value in the least significant "  \
+          "bits of the first byte, followed by the scale (range / "             \
+          "(2^" #BIT_RATE " - 1)) and the bias (minimum value) as 16-bit "      \
+          "floats.")                                                            \
+      .Input(0, "input", "Float32 input data")                                  \
+      .Output(0, "output", "Fused scale, bias and quantized data");             \
+  NO_GRADIENT(FloatToFused##BIT_RATE##BitRowwiseQuantized);                     \
+                                                                                \
+  REGISTER_CPU_OPERATOR(                                                        \
+      HalfToFused##BIT_RATE##BitRowwiseQuantized,                               \
+      FloatToFusedNBitRowwiseQuantizedOp<BIT_RATE, at::Half, convertfp16fp32>); \
+  OPERATOR_SCHEMA(HalfToFused##BIT_RATE##BitRowwiseQuantized)                   \
+      .NumInputs(1)                                                             \
+      .NumOutputs(1)                                                            \
+      .TensorInferenceFunction([](const OperatorDef& /* def */,                 \
+                                  const vector<TensorShape>& in) {              \
+        vector<TensorShape> out;                                                \
+        TensorShape X = in[0];                                                  \
+        X.set_dims(1, FusedNBitRowwiseRowBytes(BIT_RATE, X.dims(1)));           \
+        out.push_back(std::move(X));                                            \
+        out[0].set_data_type(TensorProto_DataType_UINT8);                       \
+        return out;                                                             \
+      })                                                                        \
+      .SetDoc(                                                                  \
+          "Same as FloatToFused" #BIT_RATE "BitRowwiseQuantized, but for "      \
+          "float16 input.")                                                     \
+      .Input(0, "input", "Float16 input data")                                  \
+      .Output(0, "output", "Fused scale, bias and quantized data");             \
+  NO_GRADIENT(HalfToFused##BIT_RATE##BitRowwiseQuantized);                      \
+                                                                                \
+  REGISTER_CPU_OPERATOR(                                                        \
+      Fused##BIT_RATE##BitRowwiseQuantizedToFloat,                              \
+      FusedNBitRowwiseQuantizedToFloatOp<BIT_RATE, float, convertfp32fp32>);    \
+  OPERATOR_SCHEMA(Fused##BIT_RATE##BitRowwiseQuantizedToFloat)                  \
+      .NumInputs(1)                                                             \
+      .NumOutputs(1)                                                            \
+      .TensorInferenceFunction([](const OperatorDef& def,                       \
+                                  const vector<TensorShape>& in) {              \
+        vector<TensorShape> out;                                                \
+        TensorShape X = in[0];                                                  \
+        X.set_dims(                                                             \
+            1,                                                                  \
+            ArgumentHelper(def).GetSingleArgument<int64_t>(                     \
+                "embedding_dim", 0));                                           \
+        out.push_back(std::move(X));                                            \
+        out[0].set_data_type(TensorProto_DataType_FLOAT);                       \
+        return out;                                                             \
+      })                                                                        \
+      .SetDoc(                                                                  \
+          "De-quantizes the result of the FloatToFused" #BIT_RATE               \
+          "BitRowwiseQuantized operator. The last 4 bytes of every row are "    \
+          "expected to hold the scale and the bias as 16-bit floats. Every "    \
+          "byte before them holds 8 / " #BIT_RATE " values, so the number of "  \
+          "values of the rows is given by the embedding_dim argument.")         \
+      .Arg(                                                                     \
+          "embedding_dim",                                                      \
+          "(*int*): number of columns of the original matrix")                  \
+      .Input(                                                                   \
+          0,                                                                    \
+          "scale_bias_quantized_input",                                         \
+          "Fused scale, bias and quantized data")                               \
+      .Output(0, "float_output", "Float32 data");                               \
+  NO_GRADIENT(Fused##BIT_RATE##BitRowwiseQuantizedToFloat);                     \
+                                                                                \
+  REGISTER_CPU_OPERATOR(                                                        \
+      Fused##BIT_RATE##BitRowwiseQuantizedToHalf,                               \
+      FusedNBitRowwiseQuantizedToFloatOp<BIT_RATE, at::Half, convertfp32fp16>); \
+  OPERATOR_SCHEMA(Fused##BIT_RATE##BitRowwiseQuantizedToHalf)                   \
+      .NumInputs(1)                                                             \
+      .NumOutputs(1)                                                            \
+      .TensorInferenceFunction([](const OperatorDef& def,                       \
+                                  const vector<TensorShape>& in) {              \
+        vector<TensorShape> out;                                                \
+        TensorShape X = in[0];                                                  \
+        X.set_dims(                                                             \
+            1,                                                                  \
+            ArgumentHelper(def).GetSingleArgument<int64_t>(                     \
+                "embedding_dim", 0));                                           \
+        out.push_back(std::move(X));                                            \
+        out[0].set_data_type(TensorProto_DataType_FLOAT16);                     \
+        return out;                                                             \
+      })                                                                        \
+      .SetDoc(                                                                  \
+          "Same as Fused" #BIT_RATE "BitRowwiseQuantizedToFloat, but "          \
+          "produces float16 output.")                                           \
+      .Arg(                                                                     \
+          "embedding_dim",                                                      \
+          "(*int*): number of columns of the original matrix")                  \
+      .Input(                                                                   \
+          0,                                                                    \
+          "scale_bias_quantized_input",                                         \
+          "Fused scale, bias and quantized data")                               \
+      .Output(0, "float16_output", "Float16 data");                             \
+  NO_GRADIENT(Fused##BIT_RATE##BitRowwiseQuantizedToHalf);
+
+REGISTER_FUSED_NBIT_ROWWISE_CONVERSION_OPS(4)
+REGISTER_FUSED_NBIT_ROWWISE_CONVERSION_OPS(2)
+
+#undef REGISTER_FUSED_NBIT_ROWWISE_CONVERSION_OPS
+
+} // namespace caffe2
@@ -0,0 +1,150 @@
+#ifndef CAFFE2_OPERATORS_FUSED_ROWWISE_NBIT_CONVERSION_OPS_H_
+#define CAFFE2_OPERATORS_FUSED_ROWWISE_NBIT_CONVERSION_OPS_H_
+
+#include "caffe2/core/context.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/perfkernels/fused_nbit_rowwise_conversion.h"
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h"
+
+namespace caffe2 {
+
+#define IS_LITTLE_ENDIAN                                      \
+  [] {                                                        \
+    const int32_t kValue = 1;                                 \
+    return reinterpret_cast<const uint8_t*>(&kValue)[0] == 1; \
+  }()
+
+// Quantizes every row to BIT_RATE bits. The "fused" representation stores the
+// packed values of a row followed by its scale and bias as 16-bit floats, with
+// 8 / BIT_RATE values per byte and the first value in the least significant
+// bits:
+// | ... packed data ...                        | scale | bias |
+// | ceil(number_of_columns * BIT_RATE / 8)     |  2B   |  2B  |
+template <
+    int BIT_RATE,
+    typename T,
+    void (*convert)(float* dst, const T* src, size_t N)>
+class FloatToFusedNBitRowwiseQuantizedOp : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+  USE_SIMPLE_CTOR_DTOR(FloatToFusedNBitRowwiseQuantizedOp)
+
+  bool RunOnDevice() override {
+    CAFFE_ENFORCE(IS_LITTLE_ENDIAN, "Unsupported endianness");
+
+    const auto& input = Input(DATA_FLOAT);
+
+    CAFFE_ENFORCE_EQ(input.dim(), 2, "Expect input to be a matrix");
+    const auto input_rows = input.size(0);
+    const auto input_columns = input.size(1);
+    CAFFE_ENFORCE_GT(input_columns, 0, "Expect rows to be non-empty");
+
+    const auto output_columns =
+        FusedNBitRowwiseRowBytes(BIT_RATE, input_columns);
+    auto* output = Output(
+        DATA_FUSED_SCALE_BIAS,
+        {input_rows, output_columns},
+        at::dtype<uint8_t>());
+
+    const auto* input_data = input.template data<T>();
+    auto* output_data = output->template mutable_data<uint8_t>();
+
+    vector<float> tmp(input_columns);
+    for (int64_t row = 0; row < input_rows; ++row) {
+      convert(tmp.data(), input_data + row * input_columns, input_columns);
+      FloatToFusedNBitRowwiseQuantizedSBHalf(
+          BIT_RATE,
+          tmp.data(),
+          1,
+          input_columns,
+          output_data + row * output_columns);
+    }
+    return true;
+  }
+
+ private:
+  INPUT_TAGS(DATA_FLOAT);
+  OUTPUT_TAGS(DATA_FUSED_SCALE_BIAS);
+};
+
+// A row of embedding_dim values takes as many bytes as a row of up to
+// 8 / BIT_RATE - 1 more values, so the operators reading the fused
+// representation take the number of values of a row as the embedding_dim
+// argument and check that it matches the number of bytes of the rows.
+inline void CheckFusedNBitRowwiseColumns(
+    int bit_rate,
+    int64_t fused_columns,
+    int64_t embedding_dim) {
+  CAFFE_ENFORCE_GT(embedding_dim, 0, "embedding_dim must be positive");
+  CAFFE_ENFORCE_EQ(
+      fused_columns,
+      FusedNBitRowwiseRowBytes(bit_rate, embedding_dim),
+      "Rows of ",
+      embedding_dim,
+      " values quantized to ",
+      bit_rate,
+      " bits are expected to take ",
+      FusedNBitRowwiseRowBytes(bit_rate, embedding_dim),
+      " bytes");
+}
+
+template <
+    int BIT_RATE,
+    typename T,
+    void (*convert)(T* dst, const float* src, size_t N)>
+class FusedNBitRowwiseQuantizedToFloatOp : public Operator<CPUContext> {
+ public:
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+
+  template <class... Args>
+  explicit FusedNBitRowwiseQuantizedToFloatOp(Args&&... args)
+      : Operator<CPUContext>(std::forward<Args>(args)...),
+        embedding_dim_(
+            this->template GetSingleArgument<int64_t>("embedding_dim", 0)) {
+    CAFFE_ENFORCE(
+        HasArgument("embedding_dim"), "embedding_dim must be specified");
+  }
+
+  bool RunOnDevice() override {
+    CAFFE_ENFORCE(IS_LITTLE_ENDIAN, "Unsupported endianness");
+
+    const auto& input = Input(DATA_FUSED_SCALE_BIAS);
+
+    CAFFE_ENFORCE_EQ(input.dim(), 2, "Expect input to be a matrix");
+    const auto input_rows = input.size(0);
+    const auto input_columns = input.size(1);
+    CheckFusedNBitRowwiseColumns(BIT_RATE, input_columns, embedding_dim_);
+
+    const auto output_columns = embedding_dim_;
+    auto* output =
+        Output(DATA_FLOAT, {input_rows, output_columns}, at::dtype<T>());
+
+    const auto* input_data = input.template data<uint8_t>();
+    T* output_data = output->template mutable_data<T>();
+
+    vector<float> tmp(output_columns);
+    for (int64_t row = 0; row < input_rows; ++row) {
+      FusedNBitRowwiseQuantizedSBHalfToFloat(
+          BIT_RATE,
+          input_data + row * input_columns,
+          1,
+          output_columns,
+          tmp.data());
+      convert(output_data + row * output_columns, tmp.data(), output_columns);
+    }
+    return true;
+  }
+
+ private:
+  INPUT_TAGS(DATA_FUSED_SCALE_BIAS);
+  OUTPUT_TAGS(DATA_FLOAT);
+
+  const int64_t embedding_dim_;
+};
+
+#undef IS_LITTLE_ENDIAN
+
+} // namespace caffe2
+
+#endif // CAFFE2_OPERATORS_FUSED_ROWWISE_NBIT_CONVERSION_OPS_H_
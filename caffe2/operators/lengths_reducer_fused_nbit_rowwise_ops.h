@@ -0,0 +1,89 @@
+#ifndef CAFFE2_OPERATORS_LENGTHS_REDUCER_FUSED_NBIT_ROWWISE_OPS_H_
+#define CAFFE2_OPERATORS_LENGTHS_REDUCER_FUSED_NBIT_ROWWISE_OPS_H_
+
+#include "caffe2/core/context.h"
+#include "caffe2/core/logging.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/operators/fused_rowwise_nbit_conversion_ops.h"
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h"
+
+namespace caffe2 {
+
+template <int BIT_RATE, bool with_weights = 0, bool is_mean = 0>
+class SparseLengthsFusedNBitRowwiseOp : public Operator<CPUContext> {
+ public:
+  static_assert(
+      !(with_weights && is_mean),
+      "Cannot have with_weights and is_mean a the same time");
+
+  USE_OPERATOR_FUNCTIONS(CPUContext);
+
+  template <class... Args>
+  explicit SparseLengthsFusedNBitRowwiseOp(Args&&... args)
+      : Operator<CPUContext>(std::forward<Args>(args)...),
+        embedding_dim_(
+            this->template GetSingleArgument<int64_t>("embedding_dim", 0)) {
+    CAFFE_ENFORCE(
+        HasArgument("embedding_dim"), "embedding_dim must be specified");
+  }
+
+  bool RunOnDevice() override {
+    return DispatchHelper<TensorTypes<int32_t, int64_t>>::call(
+        this, Input(INDICES));
+  }
+
+  template <typename IndexType>
+  bool DoRunWithType() {
+    const auto& data = Input(DATA);
+    const auto& indices = Input(INDICES);
+    const auto& lengths = Input(LENGTHS);
+
+    CAFFE_ENFORCE_EQ(data.dim(), 2, "DATA must be a matrix");
+    CAFFE_ENFORCE_EQ(indices.dim(), 1, "INDICES must be a vector");
+    CAFFE_ENFORCE_EQ(lengths.dim(), 1, "LENGTHS must be a vector");
+
+    const float* weights = nullptr;
+    if (with_weights) {
+      const auto& weights_input = Input(WEIGHTS);
+      CAFFE_ENFORCE_EQ(weights_input.dim(), 1, "WEIGHTS must be a vector");
+      CAFFE_ENFORCE_EQ(
+          weights_input.numel(),
+          indices.numel(),
+          "WEIGHTS should have the same length as INDICES.");
+      weights = weights_input.template data<float>();
+    }
+
+    CheckFusedNBitRowwiseColumns(BIT_RATE, data.size(1), embedding_dim_);
+    const std::vector<int64_t> shape = {lengths.size(0), embedding_dim_};
+    auto* output = Output(0, shape, at::dtype<float>());
+
+    FusedNBitRowwiseEmbeddingLookup(
+        /*bit_rate=*/BIT_RATE,
+        /*block_size=*/embedding_dim_,
+        /*output_size=*/output->size(0),
+        /*index_size=*/indices.numel(),
+        /*data_size=*/data.size(0),
+        /*input=*/data.template data<uint8_t>(),
+        /*indices=*/indices.template data<IndexType>(),
+        /*lengths=*/lengths.template data<int>(),
+        /*weights=*/weights,
+        /*normalize_by_lengths=*/is_mean,
+        /*out=*/output->template mutable_data<float>());
+
+    return true;
+  }
+
+  enum {
+    DATA = 0,
+    WEIGHTS = 1,
+    INDICES = 1 + with_weights,
+    LENGTHS = 2 + with_weights,
+  };
+
+ private:
+  const int64_t embedding_dim_;
+};
+
+} // namespace caffe2
+
+#endif // CAFFE2_OPERATORS_LENGTHS_REDUCER_FUSED_NBIT_ROWWISE_OPS_H_
@@ -20,6 +20,25 @@ REGISTER_CPU_OPERATOR(SparseLengthsSum, SparseLengthsSumOp);
 REGISTER_CPU_OPERATOR(SparseLengthsWeightedSum, SparseLengthsWeightedSumOp);
 REGISTER_CPU_OPERATOR(SparseLengthsMean, SparseLengthsMeanOp);
 
+namespace {
+
+void PopulateHotRowCacheArgs(OpSchema& schema) {
+  schema.Arg(
+      "hot_row_cache_size",
+      "(*int*): number of the most frequently accessed rows of DATA kept in a "
+      "compact copy by the operator; 0 (the default) disables the cache. The "
+      "copy is refreshed periodically, so DATA must not be modified in place "
+      "while the cache is enabled");
+  schema.Arg(
+      "hot_row_cache_refresh_interval",
+      "(*int*): number of runs between refreshes of the hot row cache");
+  schema.Arg(
+      "hot_row_cache_sample_period",
+      "(*int*): only every n-th index is counted to find the hot rows");
+}
+
+} // namespace
+
 OPERATOR_SCHEMA(SparseLengthsPositionalWeightedSum)
     .NumInputs(4)
     .NumOutputs(1)
@@ -48,7 +67,8 @@ SparseWeightedSum
         3,
         "LENGTHS",
         "Vector with the same sum of elements as the first dimension of DATA")
-    .Output(0, "output", "output");
+    .Output(0, "output", "output")
+    .FillUsing(PopulateHotRowCacheArgs);
 
 REGISTER_CPU_OPERATOR_STR(
     "SparseLengthsPositionalWeightedSum",
@@ -80,6 +100,7 @@ OPERATOR_SCHEMA(SparseLengthsSum)
     .SetDoc(FormatDoc<SparseLengthsSumDef>())
     .Output(0, "OUTPUT", "Aggregated tensor")
     .FillUsing(SparseLengthsSumDef::PopulateSchema)
+    .FillUsing(PopulateHotRowCacheArgs)
     .InheritOnnxSchema();
 REGISTER_CPU_OPERATOR(
     SparseLengthsSumGradient,
@@ -107,6 +128,7 @@ OPERATOR_SCHEMA(SparseLengthsWeightedSum)
     .SetDoc(FormatDoc<SparseLengthsWeightedSumDef>())
     .Output(0, "OUTPUT", "Aggregated tensor")
     .FillUsing(SparseLengthsWeightedSumDef::PopulateSchema)
+    .FillUsing(PopulateHotRowCacheArgs)
     .InheritOnnxSchema();
 REGISTER_CPU_OPERATOR(
     SparseLengthsWeightedSumGradient,
@@ -134,7 +156,8 @@ OPERATOR_SCHEMA(SparseLengthsMean)
         SparseLengthsMeanOp::LENGTHS)
     .SetDoc(FormatDoc<SparseLengthsMeanDef>())
     .Output(0, "OUTPUT", "Aggregated tensor")
-    .FillUsing(SparseLengthsMeanDef::PopulateSchema);
+    .FillUsing(SparseLengthsMeanDef::PopulateSchema)
+    .FillUsing(PopulateHotRowCacheArgs);
 REGISTER_CPU_OPERATOR(
     SparseLengthsMeanGradient,
     SparseLengthsMeanDef::BackwardOp);
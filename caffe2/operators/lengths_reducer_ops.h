@@ -1,7 +1,9 @@
 #pragma once
 #include "caffe2/core/context.h"
 #include "caffe2/core/operator.h"
+#include "caffe2/operators/embedding_hot_row_cache.h"
 #include "caffe2/perfkernels/embedding_lookup.h"
+#include "caffe2/utils/math.h"
 
 namespace caffe2 {
 
@@ -23,6 +25,16 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
       : Operator<CPUContext>(std::forward<Args>(args)...) {
     static_assert(
         !(USE_WEIGHT & USE_MEAN), "Cannot both specify weight and mean.");
+    const auto cache_size =
+        this->template GetSingleArgument<int64_t>("hot_row_cache_size", 0);
+    if (cache_size > 0) {
+      hot_row_cache_ = caffe2::make_unique<EmbeddingHotRowCache>(
+          cache_size,
+          this->template GetSingleArgument<int64_t>(
+              "hot_row_cache_refresh_interval", 100),
+          this->template GetSingleArgument<int64_t>(
+              "hot_row_cache_sample_period", 4));
+    }
   }
 
   ~CPUSparseLengthsReductionOp() {}
@@ -76,6 +88,24 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
       in_weight = weightInput.template data<T>();
     }
 
+    if (hot_row_cache_) {
+      hot_row_cache_->Update(
+          in_data, N, D * sizeof(InputType), indices, indices_size);
+      if (hot_row_cache_->size() > 0) {
+        LookupWithHotRowCache(
+            D,
+            M,
+            N,
+            indices_size,
+            in_data,
+            indices,
+            lengths,
+            in_weight,
+            out_data);
+        return true;
+      }
+    }
+
     // delegate work to perfkernel that branches based on architecture
     EmbeddingLookup<IndexType, InputType, T, USE_POSITIONAL_WEIGHT>(
         D,
@@ -92,6 +122,100 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
     return true;
   }
 
+  // Splits the lookups into rows that are cached and rows that are not, and
+  // reduces the two sets in separate passes over the cache and the table.
+  // Positional weights are expanded to one weight per index on the way.
+  template <typename InputType, typename IndexType>
+  void LookupWithHotRowCache(
+      const int D,
+      const int64_t M,
+      const int64_t N,
+      const int64_t indices_size,
+      const InputType* in_data,
+      const IndexType* indices,
+      const int* lengths,
+      const T* in_weight,
+      T* out_data) {
+    hot_indices_.clear();
+    cold_indices_.clear();
+    hot_weights_.clear();
+    cold_weights_.clear();
+    hot_lengths_.resize(M);
+    cold_lengths_.resize(M);
+
+    int64_t current = 0;
+    for (int64_t m = 0; m < M; ++m) {
+      CAFFE_ENFORCE_LE(
+          current + lengths[m],
+          indices_size,
+          "Your input seems to be incorrect: the sum of lengths values should "
+          "be the size of the indices tensor.");
+      hot_lengths_[m] = 0;
+      cold_lengths_[m] = 0;
+      for (int i = 0; i < lengths[m]; ++i, ++current) {
+        const int64_t row = indices[current];
+        const auto slot = hot_row_cache_->Find(row);
+        if (slot >= 0) {
+          hot_indices_.push_back(slot);
+          ++hot_lengths_[m];
+        } else {
+          cold_indices_.push_back(row);
+          ++cold_lengths_[m];
+        }
+        if (USE_WEIGHT) {
+          auto& weights = slot >= 0 ? hot_weights_ : cold_weights_;
+          weights.push_back(in_weight[USE_POSITIONAL_WEIGHT ? i : current]);
+        }
+      }
+    }
+    CAFFE_ENFORCE_EQ(
+        current,
+        indices_size,
+        "Your input seems to be incorrect: the sum of lengths values should be "
+        "the size of the indices tensor.");
+
+    hot_out_.resize(M * D);
+    EmbeddingLookup<int64_t, InputType, T, false>(
+        D,
+        M,
+        hot_indices_.size(),
+        hot_row_cache_->size(),
+        hot_row_cache_->template data<InputType>(),
+        hot_indices_.data(),
+        hot_lengths_.data(),
+        USE_WEIGHT ? hot_weights_.data() : nullptr,
+        nullptr,
+        false,
+        hot_out_.data());
+    EmbeddingLookup<int64_t, InputType, T, false>(
+        D,
+        M,
+        cold_indices_.size(),
+        N,
+        in_data,
+        cold_indices_.data(),
+        cold_lengths_.data(),
+        USE_WEIGHT ? cold_weights_.data() : nullptr,
+        nullptr,
+        false,
+        out_data);
+    math::Add<T, CPUContext>(
+        M * D, out_data, hot_out_.data(), out_data, &context_);
+
+    if (USE_MEAN) {
+      for (int64_t m = 0; m < M; ++m) {
+        if (lengths[m]) {
+          math::Scale<T, T, CPUContext>(
+              D,
+              T(1) / lengths[m],
+              out_data + m * D,
+              out_data + m * D,
+              &context_);
+        }
+      }
+    }
+  }
+
   enum {
     DATA = 0, // Data input.
     WEIGHT = 1, // Weight input used in SparseLengthsWeightedSum
@@ -100,6 +224,16 @@ class CPUSparseLengthsReductionOp : public Operator<CPUContext> {
     LENGTHS = 2 + USE_WEIGHT, // 2 in SparseLengths[Sum, Mean],
                               // 3 in SparseLengthsWeightedSum
   };
+
+ private:
+  std::unique_ptr<EmbeddingHotRowCache> hot_row_cache_;
+  std::vector<int64_t> hot_indices_;
+  std::vector<int64_t> cold_indices_;
+  std::vector<int> hot_lengths_;
+  std::vector<int> cold_lengths_;
+  std::vector<T> hot_weights_;
+  std::vector<T> cold_weights_;
+  std::vector<T> hot_out_;
 };
 
 } // namespace caffe2
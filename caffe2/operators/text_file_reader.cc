@@ -1,3 +1,12 @@
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
 #include "caffe2/core/context.h"
 #include "caffe2/core/operator.h"
 #include "caffe2/core/tensor.h"
@@ -7,13 +16,321 @@
 
 namespace caffe2 {
 
+inline void convert(
+    TensorProto_DataType dst_type,
+    const char* src_start,
+    const char* src_end,
+    void* dst) {
+  switch (dst_type) {
+    case TensorProto_DataType_STRING: {
+      static_cast<std::string*>(dst)->assign(src_start, src_end);
+    } break;
+    case TensorProto_DataType_FLOAT: {
+      // TODO(azzolini): avoid copy, use faster convertion
+      std::string str_copy(src_start, src_end);
+      const char* src_copy = str_copy.c_str();
+      char* src_copy_end;
+      float val = strtof(src_copy, &src_copy_end);
+      if (src_copy == src_copy_end) {
+        throw std::runtime_error("Invalid float: " + str_copy);
+      }
+      *static_cast<float*>(dst) = val;
+    } break;
+    default:
+      throw std::runtime_error("Unsupported type.");
+  }
+}
+
+// Bytes read at a time to complete the last line of a chunk
+constexpr int64_t kLineReadSize = 65536;
+
+// Reads a text file on several threads. The file is split into chunks of
+// chunkSize bytes, and every line belongs to the chunk its first byte is in.
+// Thread t parses the chunks t, t + numThreads, ... into blocks of converted
+// rows with its own Tokenizer. In ordered mode the blocks are returned in the
+// order of the file, otherwise in the order they are parsed.
+//
+// The chunks are split at newlines, so newlines cannot be escaped.
+class ShardedTextFileReader {
+ public:
+  ShardedTextFileReader(
+      const Tokenizer& tokenizer,
+      const std::string& filename,
+      int numPasses,
+      const std::vector<int>& fieldTypes,
+      int numThreads,
+      bool ordered,
+      int64_t chunkSize,
+      int readahead)
+      : tokenizer_(tokenizer),
+        filename_(filename),
+        fieldTypes_(fieldTypes),
+        ordered_(ordered),
+        chunkSize_(chunkSize) {
+    CAFFE_ENFORCE_GT(numThreads, 0);
+    CAFFE_ENFORCE_GT(chunkSize, 0);
+    CAFFE_ENFORCE_GT(readahead, 0);
+    for (const auto dt : fieldTypes_) {
+      fieldMetas_.push_back(
+          DataTypeToTypeMeta(static_cast<TensorProto_DataType>(dt)));
+    }
+    std::ifstream file(filename_, std::ios::binary | std::ios::ate);
+    CAFFE_ENFORCE(file, "Error opening file for reading: ", filename_);
+    fileSize_ = file.tellg();
+    chunksPerPass_ = (fileSize_ + chunkSize_ - 1) / chunkSize_;
+    numChunks_ = chunksPerPass_ * numPasses;
+    numThreads_ =
+        std::max<int64_t>(1, std::min<int64_t>(numThreads, numChunks_));
+
+    // Every thread keeps readahead blocks ahead of the reader.
+    queues_ = std::vector<Queue>(ordered_ ? numThreads_ : 1);
+    capacity_ = ordered_ ? readahead : readahead * numThreads_;
+    for (int t = 0; t < numThreads_; ++t) {
+      threads_.emplace_back(&ShardedTextFileReader::parse, this, t);
+    }
+  }
+
+  ~ShardedTextFileReader() {
+    stopped_ = true;
+    for (auto& queue : queues_) {
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      queue.cv.notify_all();
+    }
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Moves up to batchSize rows to the outputs, returns the number of rows.
+  int64_t read(int64_t batchSize, std::vector<char*>& datas) {
+    std::lock_guard<std::mutex> guard(readMutex_);
+    int64_t rowsRead = 0;
+    while (rowsRead < batchSize) {
+      if (!block_ || blockRow_ == block_->rows) {
+        if (!nextBlock()) {
+          break;
+        }
+        continue;
+      }
+      const auto rows =
+          std::min(batchSize - rowsRead, block_->rows - blockRow_);
+      for (size_t field = 0; field < datas.size(); ++field) {
+        const auto& meta = fieldMetas_[field];
+        auto* src =
+            static_cast<char*>(block_->fields[field].raw_mutable_data(meta)) +
+            blockRow_ * meta.itemsize();
+        if (fieldTypes_[field] == TensorProto_DataType_STRING) {
+          // the block is dropped once read, its strings can be moved
+          auto* srcStrings = reinterpret_cast<std::string*>(src);
+          auto* dstStrings = reinterpret_cast<std::string*>(datas[field]);
+          for (int64_t i = 0; i < rows; ++i) {
+            dstStrings[i] = std::move(srcStrings[i]);
+          }
+        } else {
+          std::memcpy(datas[field], src, rows * meta.itemsize());
+        }
+        datas[field] += rows * meta.itemsize();
+      }
+      blockRow_ += rows;
+      rowsRead += rows;
+    }
+    return rowsRead;
+  }
+
+ private:
+  struct Block {
+    std::vector<Tensor> fields;
+    int64_t rows{0};
+  };
+
+  struct Queue {
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::unique_ptr<Block>> blocks;
+    std::exception_ptr error;
+  };
+
+  bool nextBlock() {
+    if (nextChunk_ == numChunks_) {
+      return false;
+    }
+    auto& queue = queues_[ordered_ ? nextChunk_ % numThreads_ : 0];
+    {
+      std::unique_lock<std::mutex> lock(queue.mutex);
+      queue.cv.wait(
+          lock, [&]() { return queue.error || !queue.blocks.empty(); });
+      if (queue.error) {
+        std::rethrow_exception(queue.error);
+      }
+      block_ = std::move(queue.blocks.front());
+      queue.blocks.pop_front();
+    }
+    queue.cv.notify_all();
+    blockRow_ = 0;
+    ++nextChunk_;
+    return true;
+  }
+
+  void parse(int threadId) {
+    auto& queue = queues_[ordered_ ? threadId : 0];
+    try {
+      std::ifstream file(filename_, std::ios::binary);
+      CAFFE_ENFORCE(file, "Error opening file for reading: ", filename_);
+      Tokenizer tokenizer(tokenizer_);
+      TokenizedString tokenized;
+      std::string buffer;
+      for (int64_t chunk = threadId; chunk < numChunks_ && !stopped_;
+           chunk += numThreads_) {
+        auto block = parseChunk(chunk, file, tokenizer, tokenized, buffer);
+        std::unique_lock<std::mutex> lock(queue.mutex);
+        queue.cv.wait(lock, [&]() {
+          return stopped_ || queue.blocks.size() < capacity_;
+        });
+        if (stopped_) {
+          return;
+        }
+        queue.blocks.push_back(std::move(block));
+        lock.unlock();
+        queue.cv.notify_all();
+      }
+    } catch (...) {
+      {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.error = std::current_exception();
+      }
+      queue.cv.notify_all();
+    }
+  }
+
+  std::unique_ptr<Block> parseChunk(
+      int64_t chunk,
+      std::ifstream& file,
+      Tokenizer& tokenizer,
+      TokenizedString& tokenized,
+      std::string& buffer) {
+    // the chunks of the following passes read the file again
+    const int64_t begin = chunk % chunksPerPass_ * chunkSize_;
+    const int64_t end = std::min(begin + chunkSize_, fileSize_);
+    // read from the byte before the chunk to find out whether a line starts
+    // at its beginning
+    const int64_t readBegin = begin > 0 ? begin - 1 : 0;
+    auto readMore = [&](int64_t bytes) {
+      const auto size = buffer.size();
+      buffer.resize(size + bytes);
+      file.clear();
+      file.seekg(readBegin + size);
+      file.read(&buffer[size], bytes);
+      CAFFE_ENFORCE_EQ(file.gcount(), bytes, "Error reading ", filename_);
+    };
+    buffer.clear();
+    readMore(end - readBegin);
+
+    size_t lineStart = 0;
+    if (begin > 0) {
+      const auto newline = buffer.find('\n');
+      lineStart = newline == std::string::npos ? buffer.size() : newline + 1;
+    }
+    // complete the last line starting in the chunk
+    size_t lineEnd = buffer.size();
+    if (lineStart < buffer.size()) {
+      size_t from = buffer.size() - 1;
+      while (true) {
+        const auto newline = buffer.find('\n', from);
+        if (newline != std::string::npos) {
+          lineEnd = newline + 1;
+          break;
+        }
+        from = buffer.size();
+        const int64_t left = fileSize_ - readBegin - buffer.size();
+        if (left == 0) {
+          lineEnd = buffer.size();
+          break;
+        }
+        readMore(std::min<int64_t>(left, kLineReadSize));
+      }
+    } else {
+      lineStart = lineEnd;
+    }
+
+    tokenizer.reset();
+    tokenizer.next(&buffer[lineStart], &buffer[0] + lineEnd, tokenized);
+    const auto& tokens = tokenized.tokens();
+    const int numFields = fieldTypes_.size();
+
+    std::unique_ptr<Block> block(new Block());
+    std::vector<char*> datas(numFields);
+    for (int field = 0; field < numFields; ++field) {
+      block->fields.emplace_back(CPU);
+      block->fields.back().Resize(tokens.size() / numFields);
+      datas[field] = static_cast<char*>(
+          block->fields.back().raw_mutable_data(fieldMetas_[field]));
+    }
+    for (size_t i = 0; i < tokens.size(); i += numFields) {
+      CAFFE_ENFORCE_LE(
+          i + numFields,
+          tokens.size(),
+          "Invalid number of fields in the last line of bytes ",
+          begin,
+          " to ",
+          end,
+          " of ",
+          filename_);
+      for (int field = 0; field < numFields; ++field) {
+        const auto& token = tokens[i + field];
+        CAFFE_ENFORCE(
+            (field == 0) == (token.startDelimId == 0),
+            "Invalid number of columns in bytes ",
+            begin,
+            " to ",
+            end,
+            " of ",
+            filename_);
+        convert(
+            static_cast<TensorProto_DataType>(fieldTypes_[field]),
+            token.start,
+            token.end,
+            datas[field]);
+        datas[field] += fieldMetas_[field].itemsize();
+      }
+      ++block->rows;
+    }
+    return block;
+  }
+
+  const Tokenizer tokenizer_;
+  const std::string filename_;
+  const std::vector<int> fieldTypes_;
+  std::vector<TypeMeta> fieldMetas_;
+  const bool ordered_;
+  const int64_t chunkSize_;
+  int64_t fileSize_;
+  int64_t chunksPerPass_;
+  // number of chunks over all the passes
+  int64_t numChunks_;
+  int numThreads_;
+  size_t capacity_;
+
+  std::vector<Queue> queues_;
+  std::vector<std::thread> threads_;
+  std::atomic<bool> stopped_{false};
+
+  std::mutex readMutex_;
+  std::unique_ptr<Block> block_;
+  int64_t blockRow_{0};
+  int64_t nextChunk_{0};
+};
+
 struct TextFileReaderInstance {
   TextFileReaderInstance(
       const std::vector<char>& delims,
       char escape,
       const std::string& filename,
       int numPasses,
-      const std::vector<int>& types)
+      const std::vector<int>& types,
+      int numThreads = 1,
+      bool ordered = true,
+      int64_t chunkSize = 1 << 20,
+      int readahead = 2)
       : fileReader(filename),
         tokenizer(Tokenizer(delims, escape), &fileReader, numPasses),
         fieldTypes(types) {
@@ -22,6 +339,17 @@ struct TextFileReaderInstance {
           DataTypeToTypeMeta(static_cast<TensorProto_DataType>(dt)));
       fieldByteSizes.push_back(fieldMetas.back().itemsize());
     }
+    if (numThreads > 1) {
+      shardedReader.reset(new ShardedTextFileReader(
+          Tokenizer(delims, escape),
+          filename,
+          numPasses,
+          fieldTypes,
+          numThreads,
+          ordered,
+          chunkSize,
+          readahead));
+    }
   }
 
   FileReader fileReader;
@@ -30,6 +358,8 @@ struct TextFileReaderInstance {
   std::vector<TypeMeta> fieldMetas;
   std::vector<size_t> fieldByteSizes;
   size_t rowsRead{0};
+  // set when reading with several threads, replaces the tokenizer
+  std::unique_ptr<ShardedTextFileReader> shardedReader;
 
   // hack to guarantee thread-safeness of the read op
   // TODO(azzolini): support multi-threaded reading.
@@ -43,14 +373,26 @@ class CreateTextFileReaderOp : public Operator<CPUContext> {
       : Operator<CPUContext>(std::forward<Args>(args)...),
         filename_(GetSingleArgument<string>("filename", "")),
         numPasses_(GetSingleArgument<int>("num_passes", 1)),
-        fieldTypes_(GetRepeatedArgument<int>("field_types")) {
+        fieldTypes_(GetRepeatedArgument<int>("field_types")),
+        numThreads_(GetSingleArgument<int>("num_threads", 1)),
+        ordered_(GetSingleArgument<bool>("ordered", true)),
+        chunkSize_(GetSingleArgument<int64_t>("chunk_size", 1 << 20)),
+        readahead_(GetSingleArgument<int>("readahead", 2)) {
     CAFFE_ENFORCE(fieldTypes_.size() > 0, "field_types arg must be non-empty");
   }
 
   bool RunOnDevice() override {
     *OperatorBase::Output<std::unique_ptr<TextFileReaderInstance>>(0) =
         std::unique_ptr<TextFileReaderInstance>(new TextFileReaderInstance(
-            {'\n', '\t'}, '\0', filename_, numPasses_, fieldTypes_));
+            {'\n', '\t'},
+            '\0',
+            filename_,
+            numPasses_,
+            fieldTypes_,
+            numThreads_,
+            ordered_,
+            chunkSize_,
+            readahead_));
     return true;
   }
 
@@ -58,33 +400,12 @@ class CreateTextFileReaderOp : public Operator<CPUContext> {
   std::string filename_;
   int numPasses_;
   std::vector<int> fieldTypes_;
+  int numThreads_;
+  bool ordered_;
+  int64_t chunkSize_;
+  int readahead_;
 };
 
-inline void convert(
-    TensorProto_DataType dst_type,
-    const char* src_start,
-    const char* src_end,
-    void* dst) {
-  switch (dst_type) {
-    case TensorProto_DataType_STRING: {
-      static_cast<std::string*>(dst)->assign(src_start, src_end);
-    } break;
-    case TensorProto_DataType_FLOAT: {
-      // TODO(azzolini): avoid copy, use faster convertion
-      std::string str_copy(src_start, src_end);
-      const char* src_copy = str_copy.c_str();
-      char* src_copy_end;
-      float val = strtof(src_copy, &src_copy_end);
-      if (src_copy == src_copy_end) {
-        throw std::runtime_error("Invalid float: " + str_copy);
-      }
-      *static_cast<float*>(dst) = val;
-    } break;
-    default:
-      throw std::runtime_error("Unsupported type.");
-  }
-}
-
 class TextFileReaderReadOp : public Operator<CPUContext> {
  public:
   template <class... Args>
@@ -115,7 +436,11 @@ class TextFileReaderReadOp : public Operator<CPUContext> {
     }
 
     int rowsRead = 0;
-    {
+    if (instance->shardedReader) {
+      rowsRead = instance->shardedReader->read(batchSize_, datas);
+      std::lock_guard<std::mutex> guard(instance->globalMutex_);
+      instance->rowsRead += rowsRead;
+    } else {
       // TODO(azzolini): support multi-threaded reading
       std::lock_guard<std::mutex> guard(instance->globalMutex_);
 
@@ -176,6 +501,16 @@ OPERATOR_SCHEMA(CreateTextFileReader)
     .Arg(
         "field_types",
         "List with type of each field. Type enum is found at core.DataType.")
+    .Arg(
+        "num_threads",
+        "Number of threads parsing the file, splitting it into chunks at "
+        "line boundaries. Newlines cannot be escaped if greater than 1.")
+    .Arg(
+        "ordered",
+        "Whether the rows are returned in the order of the file when read "
+        "with several threads, otherwise in the order the chunks are parsed.")
+    .Arg("chunk_size", "Size of the chunks in bytes.")
+    .Arg("readahead", "Number of chunks every thread parses ahead.")
     .Output(0, "handler", "Pointer to the created TextFileReaderInstance.");
 
 OPERATOR_SCHEMA(TextFileReaderRead)
@@ -3,8 +3,23 @@
 #include "caffe2/core/types.h"
 #include "caffe2/perfkernels/common.h"
 
+#include <algorithm>
+
+#include <c10/util/Flags.h>
+
+C10_DEFINE_int(
+    caffe2_embedding_lookup_prefetch_distance,
+    16,
+    "The number of indices the generated embedding lookup kernels prefetch "
+    "ahead of the row being reduced. Larger tables and higher memory latency "
+    "benefit from a larger distance.");
+
 namespace caffe2 {
 
+int GetEmbeddingLookupPrefetchDistance() {
+  return std::max(FLAGS_caffe2_embedding_lookup_prefetch_distance, 0);
+}
+
 /**
  * Base implementation does runtime dispatch for each segment of reduction
  * @return false if there is an out-of-bound error
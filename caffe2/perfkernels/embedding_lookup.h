@@ -4,6 +4,13 @@
 
 namespace caffe2 {
 
+/**
+ * Number of indices the vectorized embedding lookup kernels prefetch ahead of
+ * the row currently being reduced, set by
+ * --caffe2_embedding_lookup_prefetch_distance.
+ */
+int GetEmbeddingLookupPrefetchDistance();
+
 /**
  * Embedding lookup with reduction.
  *
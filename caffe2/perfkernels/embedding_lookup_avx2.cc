@@ -9,6 +9,8 @@
 #include <immintrin.h>
 namespace caffe2 {
 
+int GetEmbeddingLookupPrefetchDistance();
+
 template <bool IS_WEIGHT_POSITIONAL>
 static bool EmbeddingLookup_int32_t_float_float__avx2_fma(
     const int64_t block_size,
@@ -22,7 +24,7 @@ static bool EmbeddingLookup_int32_t_float_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 0;
   int dataInd = 0;
   if (block_size == 128) {
@@ -449,7 +451,7 @@ static bool EmbeddingLookup_int64_t_float_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -876,7 +878,7 @@ static bool EmbeddingLookup_int32_t_half_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 0;
   int dataInd = 0;
   if (block_size == 128) {
@@ -1423,7 +1425,7 @@ static bool EmbeddingLookup_int64_t_half_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -1970,7 +1972,7 @@ static bool EmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 0;
   int dataInd = 0;
   if (block_size == 128) {
@@ -2530,7 +2532,7 @@ static bool EmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
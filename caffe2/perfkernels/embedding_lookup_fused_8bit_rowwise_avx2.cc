@@ -9,6 +9,8 @@
 #include <immintrin.h>
 namespace caffe2 {
 
+int GetEmbeddingLookupPrefetchDistance();
+
 template <bool IS_WEIGHT_POSITIONAL>
 static bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma(
     const int64_t block_size,
@@ -21,7 +23,7 @@ static bool Fused8BitRowwiseEmbeddingLookup_int32_t_float_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 2;
   int dataInd = 0;
   if (block_size == 128) {
@@ -443,7 +445,7 @@ static bool Fused8BitRowwiseEmbeddingLookup_int64_t_float_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 2;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -865,7 +867,7 @@ static bool Fused8BitRowwiseEmbeddingLookup_int32_t_half_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 4;
   int dataInd = 0;
   if (block_size == 128) {
@@ -1407,7 +1409,7 @@ static bool Fused8BitRowwiseEmbeddingLookup_int64_t_half_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 4;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -1949,7 +1951,7 @@ static bool Fused8BitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 8;
   int dataInd = 0;
   if (block_size == 128) {
@@ -2514,7 +2516,7 @@ static bool Fused8BitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
     const float* weights,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 8;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -9,6 +9,8 @@
 #include <immintrin.h>
 namespace caffe2 {
 
+int GetEmbeddingLookupPrefetchDistance();
+
 template <bool IS_WEIGHT_POSITIONAL>
 static bool EmbeddingLookupIdx_int32_t_float_float__avx2_fma(
     const int64_t block_size,
@@ -22,7 +24,7 @@ static bool EmbeddingLookupIdx_int32_t_float_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -464,7 +466,7 @@ static bool EmbeddingLookupIdx_int64_t_float_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -906,7 +908,7 @@ static bool EmbeddingLookupIdx_int32_t_half_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -1468,7 +1470,7 @@ static bool EmbeddingLookupIdx_int64_t_half_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -2030,7 +2032,7 @@ static bool EmbeddingLookupIdx_int32_t_uint8_t_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int prefdist_T0 = 16;
+  const int prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -2605,7 +2607,7 @@ static bool EmbeddingLookupIdx_int64_t_uint8_t_float__avx2_fma(
     const float* scale_bias,
     bool normalize_by_lengths,
     float* out) {
-  const int64_t prefdist_T0 = 16;
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
   const int64_t fused_block_size = block_size + 0;
   int64_t dataInd = 0;
   if (block_size == 128) {
@@ -0,0 +1,62 @@
+#include "caffe2/perfkernels/fused_8bit_rowwise_conversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "caffe2/core/logging.h"
+
+namespace caffe2 {
+
+void FloatToFused8BitRowwiseQuantized(
+    const float* input,
+    int64_t input_rows,
+    int64_t input_columns,
+    uint8_t* output) {
+  constexpr float kEpsilon = 1e-8f;
+  CAFFE_ENFORCE_GT(input_columns, 0, "Expect rows to be non-empty");
+  const int64_t output_columns = input_columns + 2 * sizeof(float);
+
+  for (int64_t row = 0; row < input_rows; ++row) {
+    const float* input_row = input + row * input_columns;
+    uint8_t* output_row = output + row * output_columns;
+
+    const float minimum_element =
+        *std::min_element(input_row, input_row + input_columns);
+    const float maximum_element =
+        *std::max_element(input_row, input_row + input_columns);
+    const float range = maximum_element - minimum_element;
+    const float inverse_scale = 255.0f / (range + kEpsilon);
+    for (int64_t col = 0; col < input_columns; ++col) {
+      output_row[col] = static_cast<uint8_t>(
+          std::round((input_row[col] - minimum_element) * inverse_scale));
+    }
+    const float scale_bias[2] = {range / 255.0f, minimum_element};
+    std::memcpy(output_row + input_columns, scale_bias, sizeof(scale_bias));
+  }
+}
+
+void Fused8BitRowwiseQuantizedToFloat(
+    const uint8_t* input,
+    int64_t input_rows,
+    int64_t input_columns,
+    float* output) {
+  const int64_t scale_bias_bytes = 2 * sizeof(float);
+  CAFFE_ENFORCE_GT(
+      input_columns,
+      scale_bias_bytes,
+      "Expect every row to hold the scale and bias");
+  const int64_t output_columns = input_columns - scale_bias_bytes;
+
+  for (int64_t row = 0; row < input_rows; ++row) {
+    const uint8_t* input_row = input + row * input_columns;
+    float* output_row = output + row * output_columns;
+    float scale_bias[2];
+    std::memcpy(scale_bias, input_row + output_columns, sizeof(scale_bias));
+    for (int64_t col = 0; col < output_columns; ++col) {
+      output_row[col] = scale_bias[0] * input_row[col] + scale_bias[1];
+    }
+  }
+}
+
+} // namespace caffe2
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+namespace caffe2 {
+
+/**
+ * Quantizes every row of the input_rows x input_columns matrix `input` to
+ * 8 bits, with a 32-bit float scale and bias per row, in the format of the
+ * FloatToFused8BitRowwiseQuantized operator read by
+ * Fused8BitRowwiseEmbeddingLookup. `output` has input_columns + 8 bytes per
+ * row.
+ */
+void FloatToFused8BitRowwiseQuantized(
+    const float* input,
+    std::int64_t input_rows,
+    std::int64_t input_columns,
+    std::uint8_t* output);
+
+/**
+ * Inverse of FloatToFused8BitRowwiseQuantized. `input` has input_columns
+ * bytes per row, and `output` has input_columns - 8 values per row.
+ */
+void Fused8BitRowwiseQuantizedToFloat(
+    const std::uint8_t* input,
+    std::int64_t input_rows,
+    std::int64_t input_columns,
+    float* output);
+
+} // namespace caffe2
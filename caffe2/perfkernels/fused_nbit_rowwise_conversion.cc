@@ -0,0 +1,91 @@
+#include "caffe2/perfkernels/fused_nbit_rowwise_conversion.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <c10/util/Half.h>
+
+#include "caffe2/core/logging.h"
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h"
+
+namespace caffe2 {
+
+void FloatToFusedNBitRowwiseQuantizedSBHalf(
+    int bit_rate,
+    const float* input,
+    int64_t input_rows,
+    int64_t input_columns,
+    uint8_t* output) {
+  CAFFE_ENFORCE(
+      bit_rate == 2 || bit_rate == 4, "Unsupported bit rate ", bit_rate);
+  CAFFE_ENFORCE_GT(input_columns, 0, "Expect rows to be non-empty");
+  const int num_elem_per_byte = 8 / bit_rate;
+  const int max_quantized = (1 << bit_rate) - 1;
+  const int64_t output_columns =
+      FusedNBitRowwiseRowBytes(bit_rate, input_columns);
+  const int64_t packed_bytes = output_columns - 2 * sizeof(at::Half);
+
+  for (int64_t row = 0; row < input_rows; ++row) {
+    const float* input_row = input + row * input_columns;
+    uint8_t* output_row = output + row * output_columns;
+
+    // Round the range to what can be represented in half precision, such that
+    // the values are quantized against the scale and bias that are stored.
+    const at::Half bias =
+        *std::min_element(input_row, input_row + input_columns);
+    const float minimum_element = bias;
+    const float maximum_element =
+        at::Half(*std::max_element(input_row, input_row + input_columns));
+    at::Half scale = (maximum_element - minimum_element) / max_quantized;
+    // A constant row is represented exactly by the bias alone.
+    if (static_cast<float>(scale) == 0.0f) {
+      scale = 1.0f;
+    }
+    const float inverse_scale = 1.0f / scale;
+
+    std::memset(output_row, 0, packed_bytes);
+    for (int64_t col = 0; col < input_columns; ++col) {
+      const float value = std::nearbyint(
+          (input_row[col] - minimum_element) * inverse_scale);
+      const auto quantized = static_cast<uint8_t>(
+          std::max(0.0f, std::min<float>(value, max_quantized)));
+      output_row[col / num_elem_per_byte] |=
+          quantized << ((col % num_elem_per_byte) * bit_rate);
+    }
+    at::Half scale_bias[2] = {scale, bias};
+    std::memcpy(output_row + packed_bytes, scale_bias, sizeof(scale_bias));
+  }
+}
+
+void FusedNBitRowwiseQuantizedSBHalfToFloat(
+    int bit_rate,
+    const uint8_t* input,
+    int64_t input_rows,
+    int64_t output_columns,
+    float* output) {
+  CAFFE_ENFORCE(
+      bit_rate == 2 || bit_rate == 4, "Unsupported bit rate ", bit_rate);
+  CAFFE_ENFORCE_GT(output_columns, 0, "Expect rows to be non-empty");
+  const int num_elem_per_byte = 8 / bit_rate;
+  const int64_t input_columns =
+      FusedNBitRowwiseRowBytes(bit_rate, output_columns);
+  const int64_t packed_bytes = input_columns - 2 * sizeof(at::Half);
+
+  for (int64_t row = 0; row < input_rows; ++row) {
+    const uint8_t* input_row = input + row * input_columns;
+    float* output_row = output + row * output_columns;
+    at::Half scale_bias[2];
+    std::memcpy(scale_bias, input_row + packed_bytes, sizeof(scale_bias));
+    const float scale = scale_bias[0];
+    const float bias = scale_bias[1];
+    for (int64_t col = 0; col < output_columns; ++col) {
+      const uint8_t quantized = (input_row[col / num_elem_per_byte] >>
+                                 ((col % num_elem_per_byte) * bit_rate)) &
+          ((1 << bit_rate) - 1);
+      output_row[col] = scale * quantized + bias;
+    }
+  }
+}
+
+} // namespace caffe2
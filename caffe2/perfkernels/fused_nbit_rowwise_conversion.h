@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+namespace caffe2 {
+
+/**
+ * Quantizes every row of the input_rows x input_columns matrix `input` to
+ * bit_rate (2 or 4) bits, with a 16-bit float scale and bias per row, in the
+ * format read by FusedNBitRowwiseEmbeddingLookup. `output` has
+ * FusedNBitRowwiseRowBytes(bit_rate, input_columns) bytes per row.
+ */
+void FloatToFusedNBitRowwiseQuantizedSBHalf(
+    int bit_rate,
+    const float* input,
+    std::int64_t input_rows,
+    std::int64_t input_columns,
+    std::uint8_t* output);
+
+/**
+ * Inverse of FloatToFusedNBitRowwiseQuantizedSBHalf. `output` has
+ * output_columns values per row, and `input` has
+ * FusedNBitRowwiseRowBytes(bit_rate, output_columns) bytes per row. The number
+ * of values can't be told from the packed rows alone, since the last byte of a
+ * row may be padded.
+ */
+void FusedNBitRowwiseQuantizedSBHalfToFloat(
+    int bit_rate,
+    const std::uint8_t* input,
+    std::int64_t input_rows,
+    std::int64_t output_columns,
+    float* output);
+
+} // namespace caffe2
@@ -0,0 +1,216 @@
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h"
+
+#include <c10/util/Half.h>
+
+#include "caffe2/core/types.h"
+#include "caffe2/perfkernels/common.h"
+#include "caffe2/perfkernels/embedding_lookup.h"
+#include "caffe2/utils/cpuid.h"
+
+namespace caffe2 {
+
+/**
+ * Base implementation does runtime dispatch for each segment of reduction
+ * @return false if there is an out-of-bound error
+ */
+template <typename IndexType, typename OutType>
+static bool FusedNBitRowwiseEmbeddingLookupGenericSlow(
+    const int bit_rate,
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const IndexType* indices,
+    const int* lengths,
+    const float* weights, // optional, can be null for sum reducer
+    bool normalize_by_lengths,
+    OutType* out) {
+  const int num_elem_per_byte = 8 / bit_rate;
+  const int64_t fused_block_size =
+      FusedNBitRowwiseRowBytes(bit_rate, block_size);
+  const int64_t prefdist = GetEmbeddingLookupPrefetchDistance();
+  int64_t current = 0;
+  for (int m = 0; m < output_size; ++m) {
+    memset(out, 0, sizeof(OutType) * block_size);
+    if (current + lengths[m] > index_size) {
+      return false;
+    }
+    for (int i = 0; i < lengths[m]; ++i) {
+      int64_t idx = indices[current];
+      if (idx < 0 || idx >= data_size) {
+        return false;
+      }
+#ifdef __GNUC__
+      if (current + prefdist < index_size) {
+        __builtin_prefetch(
+            input + fused_block_size * indices[current + prefdist], 0, 1);
+      }
+#endif // __GNUC__
+
+      const uint8_t* row = input + fused_block_size * idx;
+      const at::Half* scale_bias = reinterpret_cast<const at::Half*>(
+          row + fused_block_size - 2 * sizeof(at::Half));
+
+      float weight = 1.0f;
+      if (weights) {
+        weight = weights[current];
+      }
+      const float scale = weight * scale_bias[0];
+      const float bias = weight * scale_bias[1];
+
+      for (int j = 0; j < block_size; ++j) {
+        const uint8_t quantized = (row[j / num_elem_per_byte] >>
+                                   ((j % num_elem_per_byte) * bit_rate)) &
+            ((1 << bit_rate) - 1);
+        out[j] += scale * quantized + bias;
+      }
+
+      ++current;
+    }
+    if (normalize_by_lengths && lengths[m]) {
+      float scale = 1.f / lengths[m];
+      for (int j = 0; j < block_size; ++j) {
+        out[j] *= scale;
+      }
+    }
+    out += block_size;
+  }
+  return current == index_size;
+}
+
+// Proxy back to generic implementation
+#define FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(IndexType, OutType)             \
+  bool FusedNBitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##__base(     \
+      const int bit_rate,                                                           \
+      const int64_t block_size,                                                     \
+      const int64_t output_size,                                                    \
+      const int64_t index_size,                                                     \
+      const int64_t data_size,                                                      \
+      const uint8_t* input,                                                         \
+      const IndexType* indices,                                                     \
+      const int* lengths,                                                           \
+      const float* weights,                                                         \
+      bool normalize_by_lengths,                                                    \
+      OutType* out) {                                                               \
+    return FusedNBitRowwiseEmbeddingLookupGenericSlow<IndexType, OutType>(          \
+        bit_rate,                                                                   \
+        block_size,                                                                 \
+        output_size,                                                                \
+        index_size,                                                                 \
+        data_size,                                                                  \
+        input,                                                                      \
+        indices,                                                                    \
+        lengths,                                                                    \
+        weights,                                                                    \
+        normalize_by_lengths,                                                       \
+        out);                                                                       \
+  }                                                                                 \
+  decltype(                                                                         \
+      FusedNBitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##__base)      \
+      FusedNBitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType##__avx2_fma;  \
+  bool FusedNBitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType(             \
+      const int bit_rate,                                                           \
+      const int64_t block_size,                                                     \
+      const int64_t output_size,                                                    \
+      const int64_t index_size,                                                     \
+      const int64_t data_size,                                                      \
+      const uint8_t* input,                                                         \
+      const IndexType* indices,                                                     \
+      const int* lengths,                                                           \
+      const float* weights,                                                         \
+      bool normalize_by_lengths,                                                    \
+      OutType* out) {                                                               \
+    const int32_t one = 1;                                                          \
+    CAFFE_ENFORCE_EQ(                                                               \
+        reinterpret_cast<const uint8_t*>(&one)[0],                                  \
+        1,                                                                          \
+        "FusedNBitRowwiseEmbeddingLookup is not supported on this platform");       \
+    AVX2_FMA_DO(                                                                    \
+        FusedNBitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType,            \
+        bit_rate,                                                                   \
+        block_size,                                                                 \
+        output_size,                                                                \
+        index_size,                                                                 \
+        data_size,                                                                  \
+        input,                                                                      \
+        indices,                                                                    \
+        lengths,                                                                    \
+        weights,                                                                    \
+        normalize_by_lengths,                                                       \
+        out);                                                                       \
+    BASE_DO(                                                                        \
+        FusedNBitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType,            \
+        bit_rate,                                                                   \
+        block_size,                                                                 \
+        output_size,                                                                \
+        index_size,                                                                 \
+        data_size,                                                                  \
+        input,                                                                      \
+        indices,                                                                    \
+        lengths,                                                                    \
+        weights,                                                                    \
+        normalize_by_lengths,                                                       \
+        out);                                                                       \
+  }                                                                                 \
+  template <>                                                                       \
+  void FusedNBitRowwiseEmbeddingLookup<IndexType, OutType>(                         \
+      const int bit_rate,                                                           \
+      const int64_t block_size,                                                     \
+      const int64_t output_size,                                                    \
+      const int64_t index_size,                                                     \
+      const int64_t data_size,                                                      \
+      const uint8_t* input,                                                         \
+      const IndexType* indices,                                                     \
+      const int* lengths,                                                           \
+      const float* weights,                                                         \
+      bool normalize_by_lengths,                                                    \
+      OutType* out) {                                                               \
+    CAFFE_ENFORCE(                                                                  \
+        bit_rate == 2 || bit_rate == 4,                                             \
+        "Unsupported bit rate ",                                                    \
+        bit_rate);                                                                  \
+    bool success = FusedNBitRowwiseEmbeddingLookup_##IndexType##_uint8_t_##OutType( \
+        bit_rate,                                                                   \
+        block_size,                                                                 \
+        output_size,                                                                \
+        index_size,                                                                 \
+        data_size,                                                                  \
+        input,                                                                      \
+        indices,                                                                    \
+        lengths,                                                                    \
+        weights,                                                                    \
+        normalize_by_lengths,                                                       \
+        out);                                                                       \
+    if (success) {                                                                  \
+      return;                                                                       \
+    }                                                                               \
+    int64_t current = 0;                                                            \
+    for (int m = 0; m < output_size; ++m) {                                         \
+      for (int i = 0; i < lengths[m]; ++i) {                                        \
+        CAFFE_ENFORCE_LT(current, index_size);                                      \
+        IndexType idx = indices[current];                                           \
+        CAFFE_ENFORCE(                                                              \
+            0 <= idx && idx < data_size,                                            \
+            "Index ",                                                               \
+            current,                                                                \
+            " is out of bounds: ",                                                  \
+            idx,                                                                    \
+            ", range 0 to ",                                                        \
+            data_size);                                                             \
+        ++current;                                                                  \
+      }                                                                             \
+    }                                                                               \
+    CAFFE_ENFORCE_EQ(                                                               \
+        current,                                                                    \
+        index_size,                                                                 \
+        "Your input seems to be incorrect: the sum of lengths values should be "    \
+        "the size of the indices tensor, but it appears not.");                     \
+  }
+
+FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(int32_t, float);
+FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION(int64_t, float);
+
+#undef FUSED_NBIT_ROWWISE_EMBEDDING_SPECIALIZATION
+
+} // namespace caffe2
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+namespace caffe2 {
+
+/**
+ * Embedding lookup with reduction over N-bit (N = 2 or 4) rowwise quantized
+ * data with fused storage.
+ *
+ * `input` of size data_size * fused_block_size
+ * `indices` of size index_size
+ * `lengths` of size output_size
+ * `weights` nullptr or array of size index_size
+ * `out` of size output_size * block_size
+ * sum(lengths[i]) == index_size
+ *
+ * Each row packs block_size values of bit_rate bits, 8 / bit_rate values per
+ * byte with the first value in the least significant bits, followed by the
+ * scale and bias as 16-bit floats:
+ *
+ * | ... packed data ...                      | scale | bias |
+ * | (block_size * bit_rate + 7) / 8 bytes    |  2B   |  2B  |
+ *
+ * Behavior is roughly equivalent to pseudocode:
+ *
+ * pos = 0
+ * for (i = 0..output_size-1)
+ *   for (k = 0..block_size-1)
+ *     out[i*block_size + k] = 0
+ *   for (j = 0..lengths[i]-1)
+ *     for (k = 0..block_size-1)
+ *       out[i*block_size + k] += (scale * q(indices[pos], k) + bias) *
+ *           (weights ? weights[pos] : 1.0)
+ *     pos += 1
+ *   if (normalize_weights && lengths[i] > 0)
+ *     for (k = 0..block_size-1)
+ *       out[i*block_size + k] /= lengths[i]
+ *
+ * where q(r, k) is the k-th quantized value of row r, and scale and bias are
+ * the ones of row indices[pos].
+ */
+template <typename IndexType, typename OutType>
+void FusedNBitRowwiseEmbeddingLookup(
+    const int bit_rate,
+    const std::int64_t block_size,
+    const std::int64_t output_size,
+    const std::int64_t index_size,
+    const std::int64_t data_size,
+    const std::uint8_t* input,
+    const IndexType* indices,
+    const int* lengths,
+    const float* weights, // optional, can be null for non-weighted sum
+    bool normalize_by_lengths,
+    OutType* out);
+
+/**
+ * Size in bytes of a row of block_size values quantized to bit_rate bits,
+ * including the 16-bit scale and bias.
+ */
+inline std::int64_t FusedNBitRowwiseRowBytes(
+    const int bit_rate,
+    const std::int64_t block_size) {
+  const int num_elem_per_byte = 8 / bit_rate;
+  return (block_size + num_elem_per_byte - 1) / num_elem_per_byte +
+      2 * sizeof(std::uint16_t);
+}
+
+} // namespace caffe2
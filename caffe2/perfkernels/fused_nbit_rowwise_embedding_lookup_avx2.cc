@@ -0,0 +1,168 @@
+#include <immintrin.h>
+#include <cstring>
+
+#include "caffe2/perfkernels/embedding_lookup.h"
+#include "caffe2/perfkernels/fused_nbit_rowwise_embedding_lookup.h"
+
+namespace caffe2 {
+
+namespace {
+
+// Unpacks 8 values at a time by broadcasting the 32-bit word that holds them
+// and shifting every lane by its own amount, which works for any bit rate that
+// divides 8.
+template <typename IndexType>
+bool FusedNBitRowwiseEmbeddingLookupAvx2(
+    const int bit_rate,
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const IndexType* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  const int num_elem_per_byte = 8 / bit_rate;
+  const int64_t fused_block_size =
+      FusedNBitRowwiseRowBytes(bit_rate, block_size);
+  const int64_t prefdist_T0 = GetEmbeddingLookupPrefetchDistance();
+  const __m256i shifts = _mm256_set_epi32(
+      7 * bit_rate,
+      6 * bit_rate,
+      5 * bit_rate,
+      4 * bit_rate,
+      3 * bit_rate,
+      2 * bit_rate,
+      bit_rate,
+      0);
+  const __m256i mask = _mm256_set1_epi32((1 << bit_rate) - 1);
+  const int64_t vec_block_size = block_size / 8 * 8;
+
+  int64_t dataInd = 0;
+  for (int64_t rangeIndex = 0; rangeIndex < output_size; ++rangeIndex) {
+    float* op = &out[rangeIndex * block_size];
+    memset(op, 0, sizeof(float) * block_size);
+    if (dataInd + lengths[rangeIndex] > index_size) {
+      return false;
+    }
+    for (int64_t start = dataInd; dataInd < start + lengths[rangeIndex];
+         ++dataInd) {
+      const int64_t idx = indices[dataInd];
+      if (idx < 0 || idx >= data_size) {
+        return false;
+      }
+      if (dataInd + prefdist_T0 < index_size) {
+        const char* next = reinterpret_cast<const char*>(
+            input + fused_block_size * indices[dataInd + prefdist_T0]);
+        for (int64_t i = 0; i < fused_block_size; i += 64) {
+          _mm_prefetch(next + i, _MM_HINT_T0);
+        }
+      }
+
+      const uint8_t* row = input + fused_block_size * idx;
+      uint16_t scale_bias[2];
+      memcpy(
+          scale_bias,
+          row + fused_block_size - sizeof(scale_bias),
+          sizeof(scale_bias));
+      const float weight = weights ? weights[dataInd] : 1.0f;
+      const float scale = weight * _cvtsh_ss(scale_bias[0]);
+      const float bias = weight * _cvtsh_ss(scale_bias[1]);
+      const __m256 vscale = _mm256_set1_ps(scale);
+      const __m256 vbias = _mm256_set1_ps(bias);
+
+      int64_t j = 0;
+      for (; j < vec_block_size; j += 8) {
+        // Reading a full word may touch the bytes after the packed data,
+        // which still belong to the row (scale and bias).
+        int32_t packed;
+        memcpy(&packed, row + j / num_elem_per_byte, sizeof(packed));
+        const __m256i quantized = _mm256_and_si256(
+            _mm256_srlv_epi32(_mm256_set1_epi32(packed), shifts), mask);
+        _mm256_storeu_ps(
+            op + j,
+            _mm256_fmadd_ps(
+                vscale,
+                _mm256_cvtepi32_ps(quantized),
+                _mm256_add_ps(_mm256_loadu_ps(op + j), vbias)));
+      }
+      for (; j < block_size; ++j) {
+        const uint8_t quantized = (row[j / num_elem_per_byte] >>
+                                   ((j % num_elem_per_byte) * bit_rate)) &
+            ((1 << bit_rate) - 1);
+        op[j] += scale * quantized + bias;
+      }
+    }
+    if (normalize_by_lengths && lengths[rangeIndex]) {
+      const float len_inv = 1.0f / lengths[rangeIndex];
+      const __m256 vlen_inv = _mm256_set1_ps(len_inv);
+      int64_t j = 0;
+      for (; j < vec_block_size; j += 8) {
+        _mm256_storeu_ps(
+            op + j, _mm256_mul_ps(_mm256_loadu_ps(op + j), vlen_inv));
+      }
+      for (; j < block_size; ++j) {
+        op[j] *= len_inv;
+      }
+    }
+  }
+  return dataInd == index_size;
+}
+
+} // namespace
+
+bool FusedNBitRowwiseEmbeddingLookup_int32_t_uint8_t_float__avx2_fma(
+    const int bit_rate,
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int32_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return FusedNBitRowwiseEmbeddingLookupAvx2<int32_t>(
+      bit_rate,
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+bool FusedNBitRowwiseEmbeddingLookup_int64_t_uint8_t_float__avx2_fma(
+    const int bit_rate,
+    const int64_t block_size,
+    const int64_t output_size,
+    const int64_t index_size,
+    const int64_t data_size,
+    const uint8_t* input,
+    const int64_t* indices,
+    const int* lengths,
+    const float* weights,
+    bool normalize_by_lengths,
+    float* out) {
+  return FusedNBitRowwiseEmbeddingLookupAvx2<int64_t>(
+      bit_rate,
+      block_size,
+      output_size,
+      index_size,
+      data_size,
+      input,
+      indices,
+      lengths,
+      weights,
+      normalize_by_lengths,
+      out);
+}
+
+} // namespace caffe2
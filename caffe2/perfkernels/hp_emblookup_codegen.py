@@ -409,6 +409,9 @@ code.append("#include <c10/util/Half.h>")
 code.append("#include <immintrin.h>")
 
 code.append("namespace caffe2 {\n")
+# Defined in embedding_lookup.cc, so that the prefetch distance can be tuned at
+# runtime without pulling the flags headers into the AVX2 translation units.
+code.append("int GetEmbeddingLookupPrefetchDistance();\n")
 for o in options:
     [IndexTypeName, IndexType, InTypeName, InType, OutTypeName, OutType] = o
 
@@ -444,7 +447,9 @@ for o in options:
     args.append("    " + OutType + "* out) {")
     code += args
 
-    code.append("  const " + IndexType + " prefdist_T0 = 16;")
+    code.append(
+        "  const " + IndexType + " prefdist_T0 = GetEmbeddingLookupPrefetchDistance();"
+    )
     # block_size is the number of elements and fused_block_size is the size of
     # an entire row, including scale and bias.
     offset = (8 // sizeof[InType]) if opts.fused else 0
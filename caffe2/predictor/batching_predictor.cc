@@ -0,0 +1,309 @@
+#include "caffe2/predictor/batching_predictor.h"
+
+#include <future>
+
+#include "caffe2/core/context.h"
+
+namespace caffe2 {
+
+struct BatchingPredictor::Request {
+  const TensorList* inputs;
+  TensorList* outputs;
+  // Size of the first dimension of all inputs, or 0 if the request cannot be
+  // batched with other requests.
+  int64_t rows;
+  std::chrono::steady_clock::time_point queued;
+  std::promise<bool> result;
+};
+
+namespace {
+
+int64_t batchRows(const Predictor::TensorList& inputs) {
+  if (inputs.empty() || inputs[0].dim() < 1) {
+    return 0;
+  }
+  const auto rows = inputs[0].size(0);
+  for (const auto& input : inputs) {
+    if (input.dim() < 1 || input.size(0) != rows) {
+      return 0;
+    }
+  }
+  return rows;
+}
+
+bool compatible(
+    const Predictor::TensorList& a,
+    const Predictor::TensorList& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].dtype() != b[i].dtype() || a[i].dim() != b[i].dim()) {
+      return false;
+    }
+    for (int j = 1; j < a[i].dim(); j++) {
+      if (a[i].size(j) != b[i].size(j)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+uint64_t elapsedUs(
+    std::chrono::steady_clock::time_point from,
+    std::chrono::steady_clock::time_point to) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(to - from)
+      .count();
+}
+
+} // namespace
+
+BatchingPredictor::BatchingPredictor(
+    std::vector<std::unique_ptr<Predictor>> predictors,
+    BatchingPredictorOptions options)
+    : options_(options), predictors_(std::move(predictors)) {
+  CAFFE_ENFORCE(!predictors_.empty(), "At least one predictor is required");
+  CAFFE_ENFORCE_GT(options_.max_batch_size, 0);
+  for (auto& predictor : predictors_) {
+    threads_.emplace_back(&BatchingPredictor::runLoop, this, predictor.get());
+  }
+}
+
+BatchingPredictor::BatchingPredictor(
+    std::unique_ptr<Predictor> predictor,
+    BatchingPredictorOptions options)
+    : BatchingPredictor(
+          [&] {
+            std::vector<std::unique_ptr<Predictor>> predictors;
+            predictors.push_back(std::move(predictor));
+            return predictors;
+          }(),
+          options) {}
+
+BatchingPredictor::~BatchingPredictor() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+bool BatchingPredictor::operator()(
+    const TensorList& inputs,
+    TensorList* outputs) {
+  CAFFE_ENFORCE(outputs);
+  Request request;
+  request.inputs = &inputs;
+  request.outputs = outputs;
+  request.rows = batchRows(inputs);
+  request.queued = std::chrono::steady_clock::now();
+  auto result = request.result.get_future();
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    CAFFE_ENFORCE(!stop_, "BatchingPredictor is shutting down");
+    queue_.push_back(&request);
+  }
+  // Only the thread forming a batch waits on the condition variable.
+  cv_.notify_one();
+  return result.get();
+}
+
+BatchingPredictorStats BatchingPredictor::stats() const {
+  BatchingPredictorStats stats;
+  stats.requests = requests_;
+  stats.rows = rows_;
+  stats.batches = batches_;
+  stats.full_batches = fullBatches_;
+  stats.total_queue_latency_us = totalQueueLatencyUs_;
+  stats.max_queue_latency_us = maxQueueLatencyUs_;
+  stats.total_run_latency_us = totalRunLatencyUs_;
+  return stats;
+}
+
+void BatchingPredictor::runLoop(Predictor* predictor) {
+  while (true) {
+    std::vector<Request*> batch;
+    {
+      std::lock_guard<std::mutex> guard(batchMutex_);
+      batch = nextBatch();
+    }
+    if (batch.empty()) {
+      return;
+    }
+    runBatch(predictor, batch);
+  }
+}
+
+std::vector<BatchingPredictor::Request*> BatchingPredictor::nextBatch() {
+  std::vector<Request*> batch;
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait(lock, [&] { return stop_ || !queue_.empty(); });
+  if (queue_.empty()) {
+    return batch;
+  }
+
+  // Requests that fill a batch on their own, or cannot be batched, are run
+  // right away.
+  const auto runsAlone = [this](const Request* request) {
+    return request->rows == 0 || request->rows >= options_.max_batch_size;
+  };
+
+  auto* first = queue_.front();
+  queue_.pop_front();
+  batch.push_back(first);
+  if (runsAlone(first)) {
+    if (first->rows > 0) {
+      fullBatches_++;
+    }
+    return batch;
+  }
+
+  // Collect compatible requests in arrival order until the batch is full, or
+  // the oldest request has used up its latency budget. The batch is also run
+  // early when a request that runs alone is queued behind it, so that the
+  // latter doesn't wait for the latency budget of an unrelated batch.
+  auto rows = first->rows;
+  const auto deadline = first->queued + options_.max_queue_latency;
+  while (true) {
+    bool blocked = false;
+    for (auto it = queue_.begin();
+         it != queue_.end() && rows < options_.max_batch_size;) {
+      auto* request = *it;
+      if (runsAlone(request)) {
+        blocked = true;
+        ++it;
+      } else if (
+          rows + request->rows <= options_.max_batch_size &&
+          compatible(*first->inputs, *request->inputs)) {
+        rows += request->rows;
+        batch.push_back(request);
+        it = queue_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    if (rows >= options_.max_batch_size) {
+      fullBatches_++;
+      break;
+    }
+    if (blocked || stop_ || std::chrono::steady_clock::now() >= deadline) {
+      break;
+    }
+    cv_.wait_until(lock, deadline);
+  }
+  return batch;
+}
+
+void BatchingPredictor::runBatch(
+    Predictor* predictor,
+    const std::vector<Request*>& batch) {
+  const auto start = std::chrono::steady_clock::now();
+  int64_t rows = 0;
+  for (const auto* request : batch) {
+    rows += request->rows;
+    const auto latency = elapsedUs(request->queued, start);
+    totalQueueLatencyUs_ += latency;
+    auto max = maxQueueLatencyUs_.load();
+    while (latency > max &&
+           !maxQueueLatencyUs_.compare_exchange_weak(max, latency)) {
+    }
+  }
+  requests_ += batch.size();
+  rows_ += rows;
+  batches_++;
+
+  // Requests must not be touched after their result is set, as the caller
+  // may return and release them immediately.
+  try {
+    const auto success = runRequests(predictor, batch, rows);
+    for (auto* request : batch) {
+      request->result.set_value(success);
+    }
+  } catch (...) {
+    for (auto* request : batch) {
+      request->result.set_exception(std::current_exception());
+    }
+  }
+  totalRunLatencyUs_ += elapsedUs(start, std::chrono::steady_clock::now());
+}
+
+bool BatchingPredictor::runRequests(
+    Predictor* predictor,
+    const std::vector<Request*>& batch,
+    int64_t rows) {
+  TensorList outputs;
+
+  // Run a single request without copying its inputs. The outputs still
+  // have to be copied, because they are overwritten by the next batch.
+  if (batch.size() == 1) {
+    auto* request = batch.front();
+    if (!(*predictor)(*request->inputs, &outputs)) {
+      return false;
+    }
+    request->outputs->clear();
+    for (const auto& output : outputs) {
+      request->outputs->push_back(output.Clone());
+    }
+    return true;
+  }
+
+  CPUContext context;
+  const auto& first = *batch.front()->inputs;
+  TensorList inputs;
+  inputs.reserve(first.size());
+  for (size_t i = 0; i < first.size(); i++) {
+    auto dims = first[i].sizes().vec();
+    dims[0] = rows;
+    Tensor input(dims, CPU);
+    auto* dst = static_cast<char*>(input.raw_mutable_data(first[i].dtype()));
+    for (const auto* request : batch) {
+      const auto& src = (*request->inputs)[i];
+      context.CopyItemsSameDevice(
+          src.dtype(), src.numel(), src.raw_data(), dst);
+      dst += src.nbytes();
+    }
+    inputs.push_back(std::move(input));
+  }
+
+  if (!(*predictor)(inputs, &outputs)) {
+    return false;
+  }
+
+  for (size_t i = 0; i < outputs.size(); i++) {
+    CAFFE_ENFORCE(
+        outputs[i].dim() >= 1 && outputs[i].size(0) == rows,
+        "Output ",
+        i,
+        " of a batch of ",
+        rows,
+        " rows does not have the batch size as its first dimension: ",
+        outputs[i].sizes());
+  }
+
+  for (auto& request : batch) {
+    request->outputs->clear();
+  }
+  for (const auto& output : outputs) {
+    const auto rowItems = output.size_from_dim(1);
+    const auto* src = static_cast<const char*>(output.raw_data());
+    for (auto* request : batch) {
+      auto dims = output.sizes().vec();
+      dims[0] = request->rows;
+      Tensor split(dims, CPU);
+      context.CopyItemsSameDevice(
+          output.dtype(),
+          split.numel(),
+          src,
+          split.raw_mutable_data(output.dtype()));
+      src += request->rows * rowItems * output.itemsize();
+      request->outputs->push_back(std::move(split));
+    }
+  }
+  return true;
+}
+
+} // namespace caffe2
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "caffe2/predictor/predictor.h"
+
+namespace caffe2 {
+
+struct CAFFE2_API BatchingPredictorOptions {
+  // Maximum number of rows (the sum of the first dimension of all requests)
+  // that are run as one batch.
+  int64_t max_batch_size = 64;
+  // Maximum time the oldest request of a batch waits for more requests to
+  // arrive before the batch is run, even if it is not full.
+  std::chrono::microseconds max_queue_latency{1000};
+};
+
+// A snapshot of the counters kept by a BatchingPredictor.
+struct CAFFE2_API BatchingPredictorStats {
+  uint64_t requests = 0;
+  uint64_t rows = 0;
+  uint64_t batches = 0;
+  // Batches that were run because they reached max_batch_size, as opposed to
+  // reaching the latency budget of their oldest request. Includes requests
+  // that reach max_batch_size on their own.
+  uint64_t full_batches = 0;
+  // Time between a request being queued and its batch starting to run.
+  uint64_t total_queue_latency_us = 0;
+  uint64_t max_queue_latency_us = 0;
+  // Time spent running batches, including concatenation and splitting.
+  uint64_t total_run_latency_us = 0;
+
+  double mean_batch_size() const {
+    return batches ? static_cast<double>(rows) / batches : 0.0;
+  }
+};
+
+// Runs concurrent requests against a model in batches.
+//
+// Callers block in operator() like they would for a regular Predictor.
+// Queued requests whose inputs are compatible (same number of inputs, same
+// types and same sizes except for the first dimension) are concatenated along
+// the first dimension, run as one net execution, and every output is split
+// back along the first dimension. This trades a bounded amount of latency
+// (see BatchingPredictorOptions) for much better efficiency of small batches.
+//
+// Every input of a request must have the same, non-zero size of the first
+// dimension to be batched with other requests; other requests are run on
+// their own. Every output of the net must have the size of the batch as its
+// first dimension.
+//
+// Every predictor passed in runs batches on its own thread, so each of them
+// must own a separate workspace.
+class CAFFE2_API BatchingPredictor {
+ public:
+  using TensorList = Predictor::TensorList;
+
+  explicit BatchingPredictor(
+      std::vector<std::unique_ptr<Predictor>> predictors,
+      BatchingPredictorOptions options = BatchingPredictorOptions());
+
+  explicit BatchingPredictor(
+      std::unique_ptr<Predictor> predictor,
+      BatchingPredictorOptions options = BatchingPredictorOptions());
+
+  // Runs all pending requests before returning.
+  ~BatchingPredictor();
+
+  // Same contract as Predictor::operator(), except that the outputs are
+  // owned by the caller.
+  bool operator()(const TensorList& inputs, TensorList* outputs);
+
+  BatchingPredictorStats stats() const;
+
+  const BatchingPredictorOptions& options() const {
+    return options_;
+  }
+
+ private:
+  struct Request;
+
+  void runLoop(Predictor* predictor);
+
+  // Blocks until a batch is ready to run. Returns an empty batch if the
+  // predictor is stopped and no requests are pending.
+  std::vector<Request*> nextBatch();
+
+  void runBatch(Predictor* predictor, const std::vector<Request*>& batch);
+
+  bool runRequests(
+      Predictor* predictor,
+      const std::vector<Request*>& batch,
+      int64_t rows);
+
+  const BatchingPredictorOptions options_;
+  std::vector<std::unique_ptr<Predictor>> predictors_;
+  std::vector<std::thread> threads_;
+
+  // Only one thread forms a batch at a time, such that requests are not
+  // spread over partial batches.
+  std::mutex batchMutex_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request*> queue_;
+  bool stop_ = false;
+
+  std::atomic<uint64_t> requests_{0};
+  std::atomic<uint64_t> rows_{0};
+  std::atomic<uint64_t> batches_{0};
+  std::atomic<uint64_t> fullBatches_{0};
+  std::atomic<uint64_t> totalQueueLatencyUs_{0};
+  std::atomic<uint64_t> maxQueueLatencyUs_{0};
+  std::atomic<uint64_t> totalRunLatencyUs_{0};
+};
+
+} // namespace caffe2
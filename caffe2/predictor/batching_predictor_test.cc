@@ -0,0 +1,220 @@
+#include "caffe2/core/context.h"
+#include "caffe2/core/operator.h"
+#include "caffe2/core/tensor.h"
+#include "caffe2/predictor/batching_predictor.h"
+#include "caffe2/utils/math.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+namespace caffe2 {
+
+namespace {
+
+const char* predictSpec = R"DOC(
+        name: "predict"
+        type: "dag"
+        external_input: "data"
+        external_input: "W"
+        external_input: "b"
+        external_output: "y"
+        op {
+          input: "data"
+          input: "W"
+          input: "b"
+          output: "y"
+          type: "FC"
+        }
+)DOC";
+
+const char* initSpec = R"DOC(
+        name: "init"
+        type: "dag"
+        op {
+          type: "ConstantFill"
+          output: "W"
+          arg {
+            name: "shape"
+            ints: 10
+            ints: 4
+          }
+          arg {
+            name: "value"
+            f: 0.5
+          }
+        }
+        op {
+          type: "ConstantFill"
+          output: "b"
+          arg {
+            name: "shape"
+            ints: 10
+          }
+          arg {
+            name: "value"
+            f: 2.0
+          }
+        }
+)DOC";
+
+NetDef parseNetDef(const std::string& value) {
+  NetDef def;
+  CAFFE_ENFORCE(
+      TextFormat::ParseFromString(value, &def),
+      "Failed to parse NetDef with value: ",
+      value);
+  return def;
+}
+
+Tensor randomTensor(const std::vector<int64_t>& dims, CPUContext* ctx) {
+  Tensor t(dims, CPU);
+  math::RandUniform<float, CPUContext>(
+      t.numel(), -1.0, 1.0, t.template mutable_data<float>(), ctx);
+  return t;
+}
+
+} // namespace
+
+class BatchingPredictorTest : public testing::Test {
+ public:
+  void SetUp() override {
+    DeviceOption op;
+    op.set_random_seed(1701);
+    ctx_ = caffe2::make_unique<CPUContext>(op);
+    reference_ = makePredictor();
+  }
+
+  std::unique_ptr<Predictor> makePredictor() {
+    return caffe2::make_unique<Predictor>(
+        makePredictorConfig(parseNetDef(initSpec), parseNetDef(predictSpec)));
+  }
+
+  void expectMatchesReference(
+      const Tensor& input,
+      const Predictor::TensorList& output) {
+    Predictor::TensorList input_list, expected;
+    input_list.emplace_back(input.Alias());
+    ASSERT_TRUE((*reference_)(input_list, &expected));
+    ASSERT_EQ(output.size(), 1);
+    ASSERT_EQ(output.front().sizes(), expected.front().sizes());
+    for (int64_t i = 0; i < expected.front().numel(); i++) {
+      EXPECT_NEAR(
+          output.front().data<float>()[i],
+          expected.front().data<float>()[i],
+          1E-5);
+    }
+  }
+
+  std::unique_ptr<CPUContext> ctx_;
+  std::unique_ptr<Predictor> reference_;
+};
+
+TEST_F(BatchingPredictorTest, ConcurrentRequestsAreBatched) {
+  BatchingPredictorOptions options;
+  options.max_batch_size = 16;
+  options.max_queue_latency = std::chrono::milliseconds(50);
+  BatchingPredictor predictor(makePredictor(), options);
+
+  const int kRequests = 16;
+  std::vector<Tensor> inputs;
+  for (int i = 0; i < kRequests; i++) {
+    inputs.push_back(randomTensor({1 + i % 3, 4}, ctx_.get()));
+  }
+
+  std::vector<Predictor::TensorList> outputs(kRequests);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kRequests; i++) {
+    threads.emplace_back([&, i] {
+      Predictor::TensorList input;
+      input.emplace_back(inputs[i].Alias());
+      EXPECT_TRUE(predictor(input, &outputs[i]));
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (int i = 0; i < kRequests; i++) {
+    expectMatchesReference(inputs[i], outputs[i]);
+  }
+
+  const auto stats = predictor.stats();
+  EXPECT_EQ(stats.requests, kRequests);
+  EXPECT_LT(stats.batches, kRequests);
+  EXPECT_GT(stats.mean_batch_size(), 1.0);
+}
+
+TEST_F(BatchingPredictorTest, LargeRequestsRunOnTheirOwn) {
+  BatchingPredictorOptions options;
+  options.max_batch_size = 4;
+  std::vector<std::unique_ptr<Predictor>> predictors;
+  predictors.push_back(makePredictor());
+  predictors.push_back(makePredictor());
+  BatchingPredictor predictor(std::move(predictors), options);
+
+  auto input = randomTensor({10, 4}, ctx_.get());
+  Predictor::TensorList input_list, output;
+  input_list.emplace_back(input.Alias());
+  EXPECT_TRUE(predictor(input_list, &output));
+  expectMatchesReference(input, output);
+  EXPECT_EQ(predictor.stats().batches, 1);
+  EXPECT_EQ(predictor.stats().full_batches, 1);
+}
+
+TEST_F(BatchingPredictorTest, LargeRequestsDoNotWaitForOtherBatches) {
+  BatchingPredictorOptions options;
+  options.max_batch_size = 4;
+  options.max_queue_latency = std::chrono::seconds(10);
+  BatchingPredictor predictor(makePredictor(), options);
+
+  auto small = randomTensor({1, 4}, ctx_.get());
+  auto large = randomTensor({10, 4}, ctx_.get());
+  Predictor::TensorList small_output, large_output;
+  const auto start = std::chrono::steady_clock::now();
+  std::thread small_thread([&] {
+    Predictor::TensorList input;
+    input.emplace_back(small.Alias());
+    EXPECT_TRUE(predictor(input, &small_output));
+  });
+  // Let the small request start waiting for more requests first.
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  Predictor::TensorList input;
+  input.emplace_back(large.Alias());
+  EXPECT_TRUE(predictor(input, &large_output));
+  small_thread.join();
+
+  // Neither request waits for the latency budget of the small one.
+  EXPECT_LT(
+      std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+  expectMatchesReference(small, small_output);
+  expectMatchesReference(large, large_output);
+  EXPECT_EQ(predictor.stats().batches, 2);
+}
+
+TEST_F(BatchingPredictorTest, ErrorsArePropagated) {
+  BatchingPredictor predictor(makePredictor());
+
+  // FC expects 4 input features.
+  auto input = randomTensor({2, 5}, ctx_.get());
+  Predictor::TensorList input_list, output;
+  input_list.emplace_back(input.Alias());
+  // Depending on the net type, failures are reported by returning false
+  // or by throwing.
+  bool success = true;
+  try {
+    success = predictor(input_list, &output);
+  } catch (const std::exception&) {
+    success = false;
+  }
+  EXPECT_FALSE(success);
+
+  // The predictor keeps serving requests after a failure.
+  auto valid = randomTensor({2, 4}, ctx_.get());
+  input_list.clear();
+  input_list.emplace_back(valid.Alias());
+  EXPECT_TRUE(predictor(input_list, &output));
+  expectMatchesReference(valid, output);
+}
+
+} // namespace caffe2
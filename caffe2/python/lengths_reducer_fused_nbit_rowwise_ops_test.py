@@ -0,0 +1,119 @@
+from __future__ import absolute_import, division, print_function, unicode_literals
+
+import caffe2.python.hypothesis_test_util as hu
+import hypothesis.strategies as st
+import numpy as np
+from caffe2.python import core, workspace
+from hypothesis import given
+
+
+class TestLengthsReducerOpsFusedNBitRowwise(hu.HypothesisTestCase):
+    @given(
+        bit_rate=st.sampled_from([2, 4]),
+        batchsize=st.integers(1, 20),
+        blocksize=st.sampled_from([1, 7, 8, 16, 32, 64, 85, 96, 128, 163]),
+        fp16=st.booleans(),
+        seed=st.integers(0, 2 ** 32 - 1),
+    )
+    def test_quantize_and_dequantize_op(
+        self, bit_rate, batchsize, blocksize, fp16, seed
+    ):
+        np.random.seed(seed)
+        dtype = np.float16 if fp16 else np.float32
+        input_data = np.random.randn(batchsize, blocksize).astype(dtype)
+        prefix = "Half" if fp16 else "Float"
+        suffix = "Half" if fp16 else "Float"
+
+        workspace.FeedBlob("input_data", input_data)
+        workspace.RunOperatorOnce(core.CreateOperator(
+            "{}ToFused{}BitRowwiseQuantized".format(prefix, bit_rate),
+            ["input_data"],
+            ["quantized_data"],
+        ))
+        quantized_data = workspace.FetchBlob("quantized_data")
+        num_elem_per_byte = 8 // bit_rate
+        self.assertEqual(
+            quantized_data.shape,
+            (batchsize,
+             (blocksize + num_elem_per_byte - 1) // num_elem_per_byte + 4))
+
+        workspace.RunOperatorOnce(core.CreateOperator(
+            "Fused{}BitRowwiseQuantizedTo{}".format(bit_rate, suffix),
+            ["quantized_data"],
+            ["dequantized_data"],
+            embedding_dim=blocksize,
+        ))
+        dequantized_data = workspace.FetchBlob("dequantized_data")
+        self.assertEqual(dequantized_data.dtype, dtype)
+        self.assertEqual(dequantized_data.shape, input_data.shape)
+        dequantized_data = dequantized_data.astype(np.float32)
+
+        # Values are rounded to the nearest of 2^bit_rate levels spanning the
+        # range of the row, which is itself rounded to half precision.
+        input_data = input_data.astype(np.float32)
+        erange = np.amax(input_data, axis=1) - np.amin(input_data, axis=1)
+        atol = erange / ((1 << bit_rate) - 1) / 2 * 1.01 + 0.01 * (
+            np.amax(np.abs(input_data), axis=1) + 1)
+        for i in range(batchsize):
+            np.testing.assert_allclose(
+                dequantized_data[i], input_data[i], rtol=0, atol=atol[i])
+
+    @given(
+        bit_rate=st.sampled_from([2, 4]),
+        reducer=st.sampled_from(["Sum", "WeightedSum", "Mean"]),
+        batchsize=st.integers(1, 20),
+        blocksize=st.sampled_from([1, 7, 8, 16, 32, 64, 85, 96, 128, 163]),
+        index_dtype=st.sampled_from([np.int32, np.int64]),
+        empty_indices=st.booleans(),
+        seed=st.integers(0, 2 ** 32 - 1),
+    )
+    def test_sparse_lengths_reduction(
+        self,
+        bit_rate,
+        reducer,
+        batchsize,
+        blocksize,
+        index_dtype,
+        empty_indices,
+        seed,
+    ):
+        np.random.seed(seed)
+        input_data = np.random.rand(batchsize, blocksize).astype(np.float32)
+        if empty_indices:
+            lengths = np.zeros(batchsize, dtype=np.int32)
+        else:
+            lengths = np.random.randint(0, 10, size=batchsize).astype(np.int32)
+        indices = np.random.randint(
+            low=0, high=batchsize, size=[lengths.sum()]).astype(index_dtype)
+        weights = np.random.uniform(size=[len(indices)]).astype(np.float32)
+
+        net = core.Net("bench")
+        quantized_data = net.__getattr__(
+            "FloatToFused{}BitRowwiseQuantized".format(bit_rate)
+        )("input_data", "quantized_data")
+        dequantized_data = net.__getattr__(
+            "Fused{}BitRowwiseQuantizedToFloat".format(bit_rate)
+        )(quantized_data, "dequantized_data", embedding_dim=blocksize)
+        if reducer == "WeightedSum":
+            reference_inputs = [dequantized_data, "weights", "indices", "lengths"]
+            quantized_inputs = [quantized_data, "weights", "indices", "lengths"]
+        else:
+            reference_inputs = [dequantized_data, "indices", "lengths"]
+            quantized_inputs = [quantized_data, "indices", "lengths"]
+        net.__getattr__("SparseLengths" + reducer)(reference_inputs, "reference")
+        net.__getattr__(
+            "SparseLengths{}Fused{}BitRowwise".format(reducer, bit_rate)
+        )(quantized_inputs, "quantized", embedding_dim=blocksize)
+
+        workspace.FeedBlob("input_data", input_data)
+        workspace.FeedBlob("weights", weights)
+        workspace.FeedBlob("indices", indices)
+        workspace.FeedBlob("lengths", lengths)
+        workspace.RunNetOnce(net)
+
+        np.testing.assert_allclose(
+            workspace.FetchBlob("quantized"),
+            workspace.FetchBlob("reference"),
+            rtol=1e-5,
+            atol=1e-5,
+        )
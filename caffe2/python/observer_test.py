@@ -35,6 +35,15 @@ class TestObservers(unittest.TestCase):
         self.model.net.RemoveObserver(ob)
         assert(self.model.net.NumObservers() + 1 == num)
 
+    def testLatencyHistogramObserver(self):
+        ob = self.model.net.AddObserver("LatencyHistogramObserver")
+        for _ in range(3):
+            ws.RunNet(self.model.net)
+        info = ob.debug_info()
+        self.assertIn("count 3", info)
+        self.assertIn("FC", info)
+        self.model.net.RemoveObserver(ob)
+
     @given(
         num_layers=st.integers(1, 4),
         forward_only=st.booleans()
@@ -165,23 +165,79 @@ class TestReBatchingQueue(TestCase):
                 workspace.FetchBlob(tensors[idx])[:5]
             )
 
+    def test_rebatching_queue_zero_copy(self):
+        NUM_BLOBS = 2
+
+        net = core.Net('net')
+
+        workspace.FeedBlob(
+            'features',
+            np.array([[x, x + 0.5] for x in range(6)], dtype=np.float32)
+        )
+        workspace.FeedBlob('ids', np.arange(6, dtype=np.int64))
+        workspace.FeedBlob('single_feature', np.array([6, 6.5], np.float32))
+        workspace.FeedBlob('single_id', np.array(6, np.int64))
+        tensors = ['features', 'ids']
+
+        queue = net.CreateRebatchingQueue(
+            [], 1, capacity=20, num_blobs=NUM_BLOBS, zero_copy=True
+        )
+
+        net.EnqueueRebatchingQueue([queue] + tensors, [], enqueue_batch=True)
+        net.EnqueueRebatchingQueue([queue] + tensors, [], enqueue_batch=True)
+        net.EnqueueRebatchingQueue(
+            [queue, 'single_feature', 'single_id'], []
+        )
+
+        # A whole batch, rows across two batches, then rows of a batch
+        # followed by a single element
+        results = [
+            net.DequeueRebatchingQueue([queue], NUM_BLOBS, num_elements=6),
+            net.DequeueRebatchingQueue([queue], NUM_BLOBS, num_elements=4),
+            net.DequeueRebatchingQueue([queue], NUM_BLOBS, num_elements=3),
+        ]
+
+        workspace.RunNetOnce(net)
+
+        all_features = np.concatenate([
+            workspace.FetchBlob('features'),
+            workspace.FetchBlob('features'),
+            workspace.FetchBlob('single_feature')[np.newaxis],
+        ])
+        all_ids = np.concatenate([
+            workspace.FetchBlob('ids'),
+            workspace.FetchBlob('ids'),
+            workspace.FetchBlob('single_id')[np.newaxis],
+        ])
+        begin = 0
+        for result in results:
+            features = workspace.FetchBlob(result[0])
+            end = begin + features.shape[0]
+            npt.assert_array_equal(features, all_features[begin:end])
+            npt.assert_array_equal(
+                workspace.FetchBlob(result[1]), all_ids[begin:end]
+            )
+            begin = end
+        self.assertEqual(begin, 13)
+
     @given(
         num_producers=st.integers(1, 5),
         num_consumers=st.integers(1, 5),
         producer_input_size=st.integers(1, 10),
         producer_num_iterations=st.integers(1, 10),
-        capacity=st.integers(1, 10)
+        capacity=st.integers(1, 10),
+        zero_copy=st.booleans()
     )
     def test_rebatching_parallel_producer_consumer(
         self, num_producers, num_consumers, producer_input_size,
-        producer_num_iterations, capacity
+        producer_num_iterations, capacity, zero_copy
     ):
         ### Init ###
         total_inputs = producer_num_iterations * producer_input_size * num_producers
         inputs = []
         init_net = core.Net('init_net')
         queue = init_net.CreateRebatchingQueue(
-            [], 1, capacity=capacity, num_blobs=1
+            [], 1, capacity=capacity, num_blobs=1, zero_copy=zero_copy
         )
 
         ### Producers ###
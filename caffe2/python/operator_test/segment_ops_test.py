@@ -672,6 +672,51 @@ class TestSegmentOps(hu.HypothesisTestCase):
         self.assertReferenceChecks(
             gc, op, [D, W, indices, L], ref_sparse)
 
+    @given(
+        op_name=st.sampled_from([
+            "SparseLengthsSum",
+            "SparseLengthsWeightedSum",
+            "SparseLengthsMean",
+            "SparseLengthsPositionalWeightedSum",
+        ]),
+        index_dtype=st.sampled_from([np.int32, np.int64]),
+        **hu.gcs_cpu_only)
+    def test_sparse_lengths_hot_row_cache(self, op_name, index_dtype, gc, dc):
+        D = np.random.rand(50, 3, 4).astype(np.float32)
+        W = np.random.rand(40).astype(np.float32)
+        # Half of the lookups hit one of four hot rows.
+        indices = np.where(
+            np.random.rand(40) < 0.5,
+            np.random.choice([3, 17, 29, 41], size=40),
+            np.random.randint(0, 50, size=40)).astype(index_dtype)
+        L = np.asarray([10, 0, 7, 13, 10]).astype(np.int32)
+        inputs = ["D", "W", "indices", "L"]
+        if op_name in ("SparseLengthsSum", "SparseLengthsMean"):
+            inputs = ["D", "indices", "L"]
+
+        for name, value in zip(["D", "W", "indices", "L"], [D, W, indices, L]):
+            workspace.FeedBlob(name, value)
+        net = core.Net("hot_row_cache")
+        net.Proto().op.extend([
+            core.CreateOperator(op_name, inputs, "ref"),
+            core.CreateOperator(
+                op_name,
+                inputs,
+                "out",
+                hot_row_cache_size=4,
+                hot_row_cache_refresh_interval=1,
+                hot_row_cache_sample_period=1),
+        ])
+        workspace.CreateNet(net)
+        # The cache is populated at the end of the first run.
+        for _ in range(3):
+            workspace.RunNet(net)
+            np.testing.assert_allclose(
+                workspace.FetchBlob("out"),
+                workspace.FetchBlob("ref"),
+                rtol=1e-5,
+                atol=1e-5)
+
    # @given(
    #     inputs=hu.lengths_tensor(
    #         dtype=np.float32,
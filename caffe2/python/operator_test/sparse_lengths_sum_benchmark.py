@@ -23,7 +23,9 @@ def benchmark_sparse_lengths_sum(
         embedding_size,
         average_len,
         batch_size,
-        iterations):
+        iterations,
+        zipf_alpha=0.0,
+        hot_row_cache_size=0):
     print('Preparing lookup table. ' + str(datetime.datetime.now()))
 
     # We will use a constant, but non-trivial value so we save initialization
@@ -41,6 +43,11 @@ def benchmark_sparse_lengths_sum(
     print('Data has shape {} {}'.format(data.shape, datetime.datetime.now()))
     workspace.FeedBlob("X", data.astype(DTYPES[dtype_str]))
 
+    # With a Zipfian distribution, the popularity rank of a row is scattered
+    # over the table by a fixed permutation, like ids of real sparse features.
+    if zipf_alpha > 0:
+        rows_by_rank = np.random.permutation(categorical_limit)
+
     # In order to produce truly random lengths and indices, we will embed a
     # Python operator in the net to generate them.
     def f(_, outputs):
@@ -48,8 +55,12 @@ def benchmark_sparse_lengths_sum(
             int(average_len * 0.75),
             int(average_len * 1.25),
             batch_size).astype(np.int32)
-        indices = np.random.randint(
-            0, categorical_limit, np.sum(lengths)).astype(np.int64)
+        if zipf_alpha > 0:
+            ranks = np.random.zipf(zipf_alpha, np.sum(lengths)) - 1
+            indices = rows_by_rank[ranks % categorical_limit].astype(np.int64)
+        else:
+            indices = np.random.randint(
+                0, categorical_limit, np.sum(lengths)).astype(np.int64)
         outputs[0].feed(indices)
         outputs[1].feed(lengths)
 
@@ -60,7 +71,9 @@ def benchmark_sparse_lengths_sum(
     elif dtype_str == "uint8_fused":
         net.SparseLengthsSumFused8BitRowwise(["X", "indices", "lengths"], "Y")
     else:
-        net.SparseLengthsSum(["X", "indices", "lengths"], "Y")
+        net.SparseLengthsSum(
+            ["X", "indices", "lengths"], "Y",
+            hot_row_cache_size=hot_row_cache_size)
     workspace.CreateNet(net)
 
     # Set random seed, so that repeated runs will keep the same sequence of
@@ -93,6 +106,15 @@ if __name__ == "__main__":
     parser.add_argument(
         '-i', "--iteration", type=int, default=100000,
         help="The number of iterations.")
+    parser.add_argument(
+        "--zipf-alpha", type=float, default=0.0,
+        help="Draw indices from a Zipfian distribution with this exponent "
+        "(must be > 1) instead of uniformly.")
+    parser.add_argument(
+        "--hot-row-cache-size", type=int, default=0,
+        help="The number of rows in the hot row cache of SparseLengthsSum "
+        "(float and float16 only). The prefetch distance of the kernels is "
+        "set with --caffe2_embedding_lookup_prefetch_distance.")
     args, extra_args = parser.parse_known_args()
     core.GlobalInit(['python'] + extra_args)
     benchmark_sparse_lengths_sum(
@@ -101,4 +123,6 @@ if __name__ == "__main__":
         args.embedding_dim,
         args.average_len,
         args.batch_size,
-        args.iteration)
+        args.iteration,
+        args.zipf_alpha,
+        args.hot_row_cache_size)
@@ -2,7 +2,7 @@ from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 from __future__ import unicode_literals
-from caffe2.python import core, workspace
+from caffe2.python import core, utils, workspace
 from caffe2.python.text_file_reader import TextFileReader
 from caffe2.python.test_util import TestCase
 from caffe2.python.schema import Struct, Scalar, FetchRecord
@@ -34,26 +34,8 @@ class TestTextFileReader(TestCase):
 
             for num_passes in range(1, 3):
                 for batch_size in range(1, len(row_data) + 2):
-                    init_net = core.Net('init_net')
-                    reader = TextFileReader(
-                        init_net,
-                        filename=txt_file.name,
-                        schema=schema,
-                        batch_size=batch_size,
-                        num_passes=num_passes)
-                    workspace.RunNetOnce(init_net)
-
-                    net = core.Net('read_net')
-                    should_stop, record = reader.read_record(net)
-
-                    results = [np.array([])] * num_fields
-                    while True:
-                        workspace.RunNetOnce(net)
-                        arrays = FetchRecord(record).field_blobs()
-                        for i in range(num_fields):
-                            results[i] = np.append(results[i], arrays[i])
-                        if workspace.FetchBlob(should_stop):
-                            break
+                    results = self._read_file(
+                        txt_file.name, schema, batch_size, num_passes)
                     for i in range(num_fields):
                         col_batch = np.tile(col_data[i], num_passes)
                         if col_batch.dtype in (np.float32, np.float64):
@@ -62,6 +44,65 @@ class TestTextFileReader(TestCase):
                         else:
                             np.testing.assert_array_equal(col_batch, results[i])
 
+    def test_text_file_reader_multithreaded(self):
+        schema = Struct(
+            ('field1', Scalar(dtype=str)),
+            ('field2', Scalar(dtype=np.float32)))
+        num_rows = 1000
+        words = ['w' * (i % 17) + str(i) for i in range(num_rows)]
+        with tempfile.NamedTemporaryFile(mode='w+', delete=False) as txt_file:
+            txt_file.write(''.join(
+                '{}\t{}\n'.format(words[i], i) for i in range(num_rows)))
+            txt_file.flush()
+
+            for num_threads in [2, 3]:
+                for ordered in [True, False]:
+                    # small chunks so that lines cross chunk boundaries
+                    results = self._read_file(
+                        txt_file.name, schema, batch_size=64, num_passes=2,
+                        num_threads=num_threads, ordered=ordered,
+                        chunk_size=100)
+                    expected_words = np.tile(words, 2)
+                    expected_values = np.tile(np.arange(num_rows), 2)
+                    if not ordered:
+                        order = np.argsort(results[1], kind='stable')
+                        results = [results[0][order], results[1][order]]
+                        order = np.argsort(expected_values, kind='stable')
+                        expected_words = expected_words[order]
+                        expected_values = expected_values[order]
+                    np.testing.assert_array_equal(expected_words, results[0])
+                    np.testing.assert_array_equal(expected_values, results[1])
+
+    def _read_file(self, filename, schema, batch_size, num_passes,
+                   num_threads=1, ordered=True, chunk_size=None):
+        init_net = core.Net('init_net')
+        reader = TextFileReader(
+            init_net,
+            filename=filename,
+            schema=schema,
+            batch_size=batch_size,
+            num_passes=num_passes,
+            num_threads=num_threads,
+            ordered=ordered)
+        if chunk_size is not None:
+            init_net.Proto().op[-1].arg.extend(
+                [utils.MakeArgument('chunk_size', chunk_size)])
+        workspace.RunNetOnce(init_net)
+
+        net = core.Net('read_net')
+        should_stop, record = reader.read_record(net)
+
+        num_fields = len(schema.field_names())
+        results = [np.array([])] * num_fields
+        while True:
+            workspace.RunNetOnce(net)
+            arrays = FetchRecord(record).field_blobs()
+            for i in range(num_fields):
+                results[i] = np.append(results[i], arrays[i])
+            if workspace.FetchBlob(should_stop):
+                break
+        return results
+
 if __name__ == "__main__":
     import unittest
     unittest.main()
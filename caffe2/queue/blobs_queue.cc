@@ -1,10 +1,13 @@
 #include "caffe2/queue/blobs_queue.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <thread>
 
 #include "caffe2/core/blob_stats.h"
 #include "caffe2/core/logging.h"
@@ -22,6 +25,81 @@ static constexpr uint64_t SDT_TIMEOUT = (uint64_t)-1;
 static constexpr uint64_t SDT_ABORT = (uint64_t)-2;
 static constexpr uint64_t SDT_CANCEL = (uint64_t)-3;
 
+namespace {
+
+// Number of attempts a blocked reader or writer makes before it parks.
+constexpr int kSpinCount = 64;
+
+// Claims a position with claim(), first spinning and then parking on cv until
+// a position is available, done() returns true or the timeout (if positive)
+// expires. Returns the claimed position or -1.
+template <typename Claim, typename Done>
+int64_t waitAndClaim(
+    Claim claim,
+    Done done,
+    std::mutex& mutex,
+    std::condition_variable& cv,
+    std::atomic<int>& parked,
+    float timeout_secs) {
+  for (int i = 0; i < kSpinCount && !done(); ++i) {
+    std::this_thread::yield();
+    const auto pos = claim();
+    if (pos >= 0) {
+      return pos;
+    }
+  }
+  const auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(int(timeout_secs * 1000));
+  std::unique_lock<std::mutex> g(mutex);
+  parked.fetch_add(1);
+  // Pairs with the fence in wake(): either the waker sees us parked, or we
+  // see the position it published.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t pos = claim();
+  while (pos < 0 && !done()) {
+    if (timeout_secs > 0) {
+      if (cv.wait_until(g, deadline) == std::cv_status::timeout) {
+        pos = claim();
+        break;
+      }
+    } else {
+      cv.wait(g);
+    }
+    pos = claim();
+  }
+  parked.fetch_sub(1);
+  return pos;
+}
+
+void wake(
+    std::mutex& mutex,
+    std::condition_variable& cv,
+    const std::atomic<int>& parked) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (parked.load(std::memory_order_relaxed) > 0) {
+    // Taking the mutex makes sure that the parked thread is either waiting on
+    // the condition variable or yet to check for the published position.
+    { std::lock_guard<std::mutex> g(mutex); }
+    cv.notify_one();
+  }
+}
+
+// Once the queue is closed, the parked readers also wait for every claimed
+// write to be read, not just for a published position, so they are all woken
+// up on every read and write.
+void wakeAllIfClosing(
+    const std::atomic<bool>& closing,
+    std::mutex& mutex,
+    std::condition_variable& cv) {
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (closing.load(std::memory_order_relaxed)) {
+    std::lock_guard<std::mutex> g(mutex);
+    cv.notify_all();
+  }
+}
+
+} // namespace
+
 BlobsQueue::BlobsQueue(
     Workspace* ws,
     const std::string& queueName,
@@ -29,13 +107,17 @@ BlobsQueue::BlobsQueue(
     size_t numBlobs,
     bool enforceUniqueName,
     const std::vector<std::string>& fieldNames)
-    : numBlobs_(numBlobs), name_(queueName), stats_(queueName) {
+    : numBlobs_(numBlobs),
+      capacity_(capacity),
+      queue_(capacity),
+      name_(queueName),
+      stats_(queueName) {
+  CAFFE_ENFORCE_GT(capacity, 0, "The capacity of the queue must be positive");
   if (!fieldNames.empty()) {
     CAFFE_ENFORCE_EQ(
         fieldNames.size(), numBlobs, "Wrong number of fieldNames provided.");
     stats_.queue_dequeued_bytes.setDetails(fieldNames);
   }
-  queue_.reserve(capacity);
   for (size_t i = 0; i < capacity; ++i) {
     std::vector<Blob*> blobs;
     blobs.reserve(numBlobs);
@@ -49,7 +131,7 @@ BlobsQueue::BlobsQueue(
       }
       blobs.push_back(ws->CreateBlob(blobName));
     }
-    queue_.push_back(blobs);
+    queue_[i].blobs = std::move(blobs);
   }
   DCHECK_EQ(queue_.size(), capacity);
 }
@@ -61,22 +143,22 @@ bool BlobsQueue::blockingRead(
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_read_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  auto canRead = [this]() {
-    CAFFE_ENFORCE_LE(reader_, writer_);
-    return reader_ != writer_;
-  };
   // Decrease queue balance before reading to indicate queue read pressure
   // is being increased (-ve queue balance indicates more reads than writes)
   CAFFE_EVENT(stats_, queue_balance, -1);
-  if (timeout_secs > 0) {
-    std::chrono::milliseconds timeout_ms(int(timeout_secs * 1000));
-    cv_.wait_for(
-        g, timeout_ms, [this, canRead]() { return closing_ || canRead(); });
-  } else {
-    cv_.wait(g, [this, canRead]() { return closing_ || canRead(); });
-  }
-  if (!canRead()) {
+  // Closing the queue still lets the readers drain it, including the writes
+  // that were claimed before the close but are still being published.
+  auto pos = tryClaimRead();
+  if (pos < 0) {
+    pos = waitAndClaim(
+        [this]() { return tryClaimRead(); },
+        [this]() { return drained(); },
+        readMutex_,
+        notEmpty_,
+        parkedReaders_,
+        timeout_secs);
+  }
+  if (pos < 0) {
     if (timeout_secs > 0 && !closing_) {
       LOG(ERROR) << "DequeueBlobs timed out in " << timeout_secs << " secs";
       CAFFE_SDT(queue_read_end, name, (void*)this, SDT_TIMEOUT);
@@ -85,19 +167,7 @@ bool BlobsQueue::blockingRead(
     }
     return false;
   }
-  DCHECK(canRead());
-  auto& result = queue_[reader_ % queue_.size()];
-  CAFFE_ENFORCE(inputs.size() >= result.size());
-  for (auto i = 0; i < result.size(); ++i) {
-    auto bytes = BlobStat::sizeBytes(*result[i]);
-    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
-    using std::swap;
-    swap(*(inputs[i]), *(result[i]));
-  }
-  CAFFE_SDT(queue_read_end, name, (void*)this, writer_ - reader_);
-  CAFFE_EVENT(stats_, queue_dequeued_records);
-  ++reader_;
-  cv_.notify_all();
+  doRead(pos, inputs);
   CAFFE_EVENT(stats_, read_time_ns, readTimer.NanoSeconds());
   return true;
 }
@@ -107,16 +177,15 @@ bool BlobsQueue::tryWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_NONBLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
-  if (!canWrite()) {
+  const auto pos = tryClaimWrite();
+  if (pos < 0) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  DCHECK(canWrite());
-  doWrite(inputs);
+  doWrite(pos, inputs);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
@@ -126,17 +195,24 @@ bool BlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
   auto keeper = this->shared_from_this();
   const auto& name = name_.c_str();
   CAFFE_SDT(queue_write_start, name, (void*)this, SDT_BLOCKING_OP);
-  std::unique_lock<std::mutex> g(mutex_);
   // Increase queue balance before writing to indicate queue write pressure is
   // being increased (+ve queue balance indicates more writes than reads)
   CAFFE_EVENT(stats_, queue_balance, 1);
-  cv_.wait(g, [this]() { return closing_ || canWrite(); });
-  if (!canWrite()) {
+  auto pos = tryClaimWrite();
+  if (pos < 0) {
+    pos = waitAndClaim(
+        [this]() { return tryClaimWrite(); },
+        [this]() { return closing_.load(); },
+        writeMutex_,
+        notFull_,
+        parkedWriters_,
+        0.0f);
+  }
+  if (pos < 0) {
     CAFFE_SDT(queue_write_end, name, (void*)this, SDT_ABORT);
     return false;
   }
-  DCHECK(canWrite());
-  doWrite(inputs);
+  doWrite(pos, inputs);
   CAFFE_EVENT(stats_, write_time_ns, writeTimer.NanoSeconds());
   return true;
 }
@@ -144,30 +220,98 @@ bool BlobsQueue::blockingWrite(const std::vector<Blob*>& inputs) {
 void BlobsQueue::close() {
   closing_ = true;
 
-  std::lock_guard<std::mutex> g(mutex_);
-  cv_.notify_all();
+  {
+    std::lock_guard<std::mutex> g(readMutex_);
+    notEmpty_.notify_all();
+  }
+  std::lock_guard<std::mutex> g(writeMutex_);
+  notFull_.notify_all();
+}
+
+int64_t BlobsQueue::tryClaimRead() {
+  auto pos = reader_.load(std::memory_order_relaxed);
+  for (;;) {
+    const auto seq =
+        queue_[pos % capacity_].sequence.load(std::memory_order_acquire);
+    const auto diff = seq - (2 * (pos / capacity_) + 1);
+    if (diff == 0) {
+      if (reader_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        return pos;
+      }
+    } else if (diff < 0) {
+      // The slot has not been written yet, the queue is empty.
+      return -1;
+    } else {
+      // Another reader took the position.
+      pos = reader_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+int64_t BlobsQueue::tryClaimWrite() {
+  auto pos = writer_.load(std::memory_order_relaxed);
+  for (;;) {
+    const auto seq =
+        queue_[pos % capacity_].sequence.load(std::memory_order_acquire);
+    const auto diff = seq - 2 * (pos / capacity_);
+    if (diff == 0) {
+      if (writer_.compare_exchange_weak(
+              pos, pos + 1, std::memory_order_relaxed)) {
+        return pos;
+      }
+    } else if (diff < 0) {
+      // The slot has not been read yet, the queue is full.
+      return -1;
+    } else {
+      // Another writer took the position.
+      pos = writer_.load(std::memory_order_relaxed);
+    }
+  }
 }
 
-bool BlobsQueue::canWrite() {
-  // writer is always within [reader, reader + size)
-  // we can write if reader is within [reader, reader + size)
-  CAFFE_ENFORCE_LE(reader_, writer_);
-  CAFFE_ENFORCE_LE(writer_, reader_ + queue_.size());
-  return writer_ != reader_ + queue_.size();
+bool BlobsQueue::drained() const {
+  return closing_ && writer_.load() <= reader_.load();
+}
+
+int64_t BlobsQueue::size() const {
+  return std::max<int64_t>(
+      writer_.load(std::memory_order_relaxed) -
+          reader_.load(std::memory_order_relaxed),
+      0);
+}
+
+void BlobsQueue::doRead(int64_t pos, const std::vector<Blob*>& inputs) {
+  auto& slot = queue_[pos % capacity_];
+  auto& result = slot.blobs;
+  CAFFE_ENFORCE(inputs.size() >= result.size());
+  const auto& name = name_.c_str();
+  for (auto i = 0; i < result.size(); ++i) {
+    auto bytes = BlobStat::sizeBytes(*result[i]);
+    CAFFE_EVENT(stats_, queue_dequeued_bytes, bytes, i);
+    using std::swap;
+    swap(*(inputs[i]), *(result[i]));
+  }
+  CAFFE_SDT(queue_read_end, name, (void*)this, size());
+  CAFFE_EVENT(stats_, queue_dequeued_records);
+  slot.sequence.store(2 * (pos / capacity_) + 2, std::memory_order_release);
+  wake(writeMutex_, notFull_, parkedWriters_);
+  wakeAllIfClosing(closing_, readMutex_, notEmpty_);
 }
 
-void BlobsQueue::doWrite(const std::vector<Blob*>& inputs) {
-  auto& result = queue_[writer_ % queue_.size()];
+void BlobsQueue::doWrite(int64_t pos, const std::vector<Blob*>& inputs) {
+  auto& slot = queue_[pos % capacity_];
+  auto& result = slot.blobs;
   CAFFE_ENFORCE(inputs.size() >= result.size());
   const auto& name = name_.c_str();
   for (auto i = 0; i < result.size(); ++i) {
     using std::swap;
     swap(*(inputs[i]), *(result[i]));
   }
-  CAFFE_SDT(
-      queue_write_end, name, (void*)this, reader_ + queue_.size() - writer_);
-  ++writer_;
-  cv_.notify_all();
+  CAFFE_SDT(queue_write_end, name, (void*)this, capacity_ - size());
+  slot.sequence.store(2 * (pos / capacity_) + 1, std::memory_order_release);
+  wake(readMutex_, notEmpty_, parkedReaders_);
+  wakeAllIfClosing(closing_, readMutex_, notEmpty_);
 }
 
 } // namespace caffe2
@@ -5,6 +5,7 @@
 #include <memory>
 #include <mutex>
 #include <queue>
+#include <vector>
 
 #include "caffe2/core/blob_stats.h"
 #include "caffe2/core/logging.h"
@@ -15,7 +16,11 @@
 namespace caffe2 {
 
 // A thread-safe, bounded, blocking queue.
-// Modelled as a circular buffer.
+// Modelled as a circular buffer of slots, each tagged with a sequence number
+// (D. Vyukov's bounded MPMC queue): readers and writers claim a position with
+// a single compare-and-swap and never contend on a lock unless the queue is
+// empty (full), in which case they spin for a short while and then park on
+// a condition variable that is only signalled while someone is parked.
 
 // Containing blobs are owned by the workspace.
 // On read, we swap out the underlying data for the blob passed in for blobs
@@ -45,17 +50,43 @@ class CAFFE2_API BlobsQueue : public std::enable_shared_from_this<BlobsQueue> {
   }
 
  private:
-  bool canWrite();
-  void doWrite(const std::vector<Blob*>& inputs);
+  struct Slot {
+    // Position p maps to the slot p % capacity on turn p / capacity. On turn
+    // t, a writer can fill the slot when sequence == 2 * t and a reader can
+    // empty it when sequence == 2 * t + 1.
+    std::atomic<int64_t> sequence{0};
+    std::vector<Blob*> blobs;
+  };
+
+  // Returns the claimed position, or -1 if the queue is empty (full).
+  int64_t tryClaimRead();
+  int64_t tryClaimWrite();
+  void doRead(int64_t pos, const std::vector<Blob*>& inputs);
+  void doWrite(int64_t pos, const std::vector<Blob*>& inputs);
+  // Whether the queue is closed and every claimed write has been read.
+  bool drained() const;
+  int64_t size() const;
 
   std::atomic<bool> closing_{false};
 
   size_t numBlobs_;
-  std::mutex mutex_; // protects all variables in the class.
-  std::condition_variable cv_;
-  int64_t reader_{0};
-  int64_t writer_{0};
-  std::vector<std::vector<Blob*>> queue_;
+  const int64_t capacity_;
+  std::vector<Slot> queue_;
+  // Keep the read and write positions on separate cache lines. They count the
+  // claimed positions, so writer_ > reader_ after a close means that there
+  // are writes left for the readers, even if they are not published yet.
+  alignas(64) std::atomic<int64_t> reader_{0};
+  alignas(64) std::atomic<int64_t> writer_{0};
+
+  // Parking lots for blocked readers and writers. The counters let the other
+  // side skip taking the mutex when nobody is parked.
+  alignas(64) std::mutex readMutex_;
+  std::condition_variable notEmpty_;
+  std::atomic<int> parkedReaders_{0};
+  std::mutex writeMutex_;
+  std::condition_variable notFull_;
+  std::atomic<int> parkedWriters_{0};
+
   const std::string name_;
 
   struct QueueStats {
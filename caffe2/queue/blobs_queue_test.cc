@@ -0,0 +1,100 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "caffe2/queue/blobs_queue.h"
+
+namespace caffe2 {
+namespace {
+
+void testConcurrentReadsAndWrites(int capacity) {
+  constexpr int kNumWriters = 4;
+  constexpr int kNumReaders = 4;
+  constexpr int kRecordsPerWriter = 2000;
+
+  Workspace ws;
+  auto queue = std::make_shared<BlobsQueue>(&ws, "queue", capacity, 1, true);
+  std::vector<std::atomic<int>> seen(kNumWriters * kRecordsPerWriter);
+  for (auto& count : seen) {
+    count = 0;
+  }
+
+  std::vector<std::thread> writers;
+  for (int w = 0; w < kNumWriters; ++w) {
+    writers.emplace_back([&queue, w]() {
+      Blob blob;
+      for (int i = 0; i < kRecordsPerWriter; ++i) {
+        *blob.GetMutable<int>() = w * kRecordsPerWriter + i;
+        EXPECT_TRUE(queue->blockingWrite({&blob}));
+      }
+    });
+  }
+  std::atomic<int> numRead{0};
+  std::vector<std::thread> readers;
+  for (int r = 0; r < kNumReaders; ++r) {
+    readers.emplace_back([&queue, &seen, &numRead]() {
+      Blob blob;
+      while (queue->blockingRead({&blob})) {
+        ++seen[blob.Get<int>()];
+        ++numRead;
+      }
+    });
+  }
+
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  while (numRead < int(seen.size())) {
+    std::this_thread::yield();
+  }
+  queue->close();
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  for (const auto& count : seen) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+} // namespace
+
+TEST(BlobsQueueTest, ConcurrentReadsAndWrites) {
+  for (int capacity : {1, 2, 7, 64}) {
+    testConcurrentReadsAndWrites(capacity);
+  }
+}
+
+TEST(BlobsQueueTest, TryWriteOnFullQueue) {
+  Workspace ws;
+  auto queue = std::make_shared<BlobsQueue>(&ws, "queue", 2, 1, true);
+  Blob blob;
+  for (int i = 0; i < 2; ++i) {
+    *blob.GetMutable<int>() = i;
+    EXPECT_TRUE(queue->tryWrite({&blob}));
+  }
+  *blob.GetMutable<int>() = 2;
+  EXPECT_FALSE(queue->tryWrite({&blob}));
+
+  // Records are read in the order they were written.
+  for (int i = 0; i < 2; ++i) {
+    EXPECT_TRUE(queue->blockingRead({&blob}, 0.1f));
+    EXPECT_EQ(blob.Get<int>(), i);
+  }
+  EXPECT_FALSE(queue->blockingRead({&blob}, 0.01f));
+}
+
+TEST(BlobsQueueTest, CloseWakesBlockedReaders) {
+  Workspace ws;
+  auto queue = std::make_shared<BlobsQueue>(&ws, "queue", 4, 1, true);
+  std::thread reader([&queue]() {
+    Blob blob;
+    EXPECT_FALSE(queue->blockingRead({&blob}));
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  queue->close();
+  reader.join();
+}
+
+} // namespace caffe2
@@ -97,8 +97,115 @@ std::vector<std::vector<TensorCPU>> split(
 }
 } // anonymous namespace
 
-RebatchingQueue::RebatchingQueue(size_t capacity, size_t numBlobs)
-    : capacity_(capacity), numBlobs_(numBlobs), queue_(capacity) {}
+RebatchingQueue::RebatchingQueue(
+    size_t capacity,
+    size_t numBlobs,
+    bool zeroCopy)
+    : capacity_(capacity),
+      numBlobs_(numBlobs),
+      zeroCopy_(zeroCopy),
+      queue_(capacity) {}
+
+std::vector<RebatchingQueue::Element> RebatchingQueue::sliceBatch(
+    const std::vector<const TensorCPU*>& inputs,
+    bool single) {
+  CAFFE_ENFORCE(!inputs.empty());
+
+  auto batch = std::make_shared<Batch>();
+  batch->single = single;
+  int64_t numRows = 1;
+  for (const auto* inputPtr : inputs) {
+    CAFFE_ENFORCE(inputPtr);
+    if (!single) {
+      CAFFE_ENFORCE_GT(inputPtr->dim(), 0);
+      if (batch->tensors.empty()) {
+        numRows = inputPtr->size(0);
+      }
+      CAFFE_ENFORCE_EQ(inputPtr->size(0), numRows);
+    }
+    // The one copy of the batch, the inputs may be overwritten as soon as
+    // the enqueue returns
+    batch->tensors.push_back(inputPtr->Clone());
+  }
+
+  std::vector<Element> elements(numRows);
+  for (int64_t row = 0; row < numRows; ++row) {
+    elements[row].batch = batch;
+    elements[row].row = row;
+  }
+  return elements;
+}
+
+void RebatchingQueue::gatherRows(
+    CPUContext& context,
+    const std::vector<Element>& elements,
+    const std::vector<TensorCPU*>& outputs) {
+  CAFFE_ENFORCE(!elements.empty());
+
+  const auto& batchZero = *elements[0].batch;
+  const auto numTensors = batchZero.tensors.size();
+  const int64_t numRows = elements.size();
+  CAFFE_ENFORCE_EQ(outputs.size(), numTensors);
+
+  // A whole batch dequeued at once is returned without copying
+  bool wholeBatch =
+      !batchZero.single && batchZero.tensors[0].size(0) == numRows;
+  for (int64_t i = 0; wholeBatch && i < numRows; ++i) {
+    wholeBatch = elements[i].batch == elements[0].batch && elements[i].row == i;
+  }
+  if (wholeBatch) {
+    for (size_t j = 0; j < numTensors; ++j) {
+      const auto& input = batchZero.tensors[j];
+      outputs[j]->Resize(input.sizes());
+      outputs[j]->ShareData(input);
+    }
+    return;
+  }
+
+  for (size_t j = 0; j < numTensors; ++j) {
+    const auto& inputZero = batchZero.tensors[j];
+    const int batchDims = batchZero.single ? 0 : 1;
+    const auto rowDims = inputZero.sizes().slice(batchDims);
+    const auto rowSize =
+        inputZero.size_from_dim(batchDims) * inputZero.itemsize();
+
+    std::vector<int64_t> outputDims(rowDims.begin(), rowDims.end());
+    outputDims.insert(outputDims.begin(), numRows);
+    outputs[j]->Resize(outputDims);
+    auto* destination =
+        static_cast<char*>(outputs[j]->raw_mutable_data(inputZero.dtype()));
+
+    // Copy the consecutive rows of a batch at once
+    int64_t begin = 0;
+    while (begin < numRows) {
+      const auto& element = elements[begin];
+      int64_t end = begin + 1;
+      while (end < numRows && elements[end].batch == element.batch &&
+             elements[end].row == elements[end - 1].row + 1) {
+        ++end;
+      }
+
+      CAFFE_ENFORCE_EQ(element.batch->tensors.size(), numTensors);
+      const auto& input = element.batch->tensors[j];
+      CAFFE_ENFORCE(inputZero.dtype() == input.dtype());
+      CAFFE_ENFORCE(
+          input.sizes().slice(element.batch->single ? 0 : 1) == rowDims,
+          "All the elements of a component must have the same shape");
+
+      const auto numBytes = (end - begin) * rowSize;
+      if (numBytes > 0) {
+        context.CopyItemsToCPU(
+            input.dtype(),
+            numBytes / input.itemsize(),
+            static_cast<const char*>(input.raw_data()) +
+                element.row * rowSize /* src */,
+            destination /* dst */);
+        destination += numBytes;
+      }
+      begin = end;
+    }
+  }
+}
 
 RebatchingQueue::~RebatchingQueue() {
   close();
@@ -112,7 +219,7 @@ bool RebatchingQueue::dequeue(
     CPUContext& context,
     size_t numElements,
     const std::vector<TensorCPU*>& outputs) {
-  std::vector<std::vector<TensorCPU>> results;
+  std::vector<Element> results;
   results.reserve(numElements);
 
   for (;;) {
@@ -146,7 +253,17 @@ bool RebatchingQueue::dequeue(
     return false;
   }
 
-  concat(context, results, outputs);
+  if (zeroCopy_) {
+    gatherRows(context, results, outputs);
+    return true;
+  }
+
+  std::vector<std::vector<TensorCPU>> rows;
+  rows.reserve(results.size());
+  for (auto& result : results) {
+    rows.push_back(std::move(result.tensors));
+  }
+  concat(context, rows, outputs);
 
   return true;
 }
@@ -158,9 +275,13 @@ bool RebatchingQueue::canWrite() const {
 bool RebatchingQueue::enqueueOne(
     CPUContext& /*context*/,
     const std::vector<const TensorCPU*>& inputs) {
-  std::vector<std::vector<TensorCPU>> splittedInputs;
+  if (zeroCopy_) {
+    return enqueue(sliceBatch(inputs, /*single=*/true));
+  }
+
+  std::vector<Element> splittedInputs;
   splittedInputs.emplace_back();
-  auto& tensorVector = splittedInputs.back();
+  auto& tensorVector = splittedInputs.back().tensors;
   tensorVector.reserve(inputs.size());
   for (const auto* tensorPtr : inputs) {
     tensorVector.push_back(tensorPtr->Clone());
@@ -174,13 +295,19 @@ bool RebatchingQueue::enqueueMany(
     const std::vector<const TensorCPU*>& inputs) {
   CAFFE_ENFORCE_EQ(numBlobs_, inputs.size());
 
-  std::vector<std::vector<TensorCPU>> splittedInputs;
-  splittedInputs = split(context, inputs);
+  if (zeroCopy_) {
+    return enqueue(sliceBatch(inputs, /*single=*/false));
+  }
+
+  auto splittedTensors = split(context, inputs);
+  std::vector<Element> splittedInputs(splittedTensors.size());
+  for (size_t i = 0; i < splittedTensors.size(); ++i) {
+    splittedInputs[i].tensors = std::move(splittedTensors[i]);
+  }
   return enqueue(std::move(splittedInputs));
 }
 
-bool RebatchingQueue::enqueue(
-    std::vector<std::vector<TensorCPU>> splittedInputs) {
+bool RebatchingQueue::enqueue(std::vector<Element> splittedInputs) {
   int idx = 0;
   for (;;) {
     if (idx >= splittedInputs.size()) {
@@ -19,7 +19,12 @@ namespace caffe2 {
 
 class RebatchingQueue {
  public:
-  RebatchingQueue(size_t capacity, size_t numBlobs);
+  // In zero copy mode the queue does not split the enqueued batches into
+  // single element tensors. It keeps one copy of every batch and queues
+  // references to its rows, dequeue copies the rows straight into the
+  // outputs, or shares the memory of the batch if exactly one whole batch is
+  // dequeued.
+  RebatchingQueue(size_t capacity, size_t numBlobs, bool zeroCopy = false);
 
   ~RebatchingQueue();
 
@@ -45,13 +50,37 @@ class RebatchingQueue {
   void close();
 
  private:
-  bool enqueue(std::vector<std::vector<TensorCPU>> splittedInputs);
+  // Tensors of an enqueued batch, shared by the elements referring to it
+  struct Batch {
+    std::vector<TensorCPU> tensors;
+    // the tensors are a single element without the batch dimension
+    bool single{false};
+  };
+
+  // Either the tensors of the element, or a row of a batch in zero copy mode
+  struct Element {
+    std::vector<TensorCPU> tensors;
+    std::shared_ptr<const Batch> batch;
+    int64_t row{0};
+  };
+
+  bool enqueue(std::vector<Element> elements);
+
+  static std::vector<Element> sliceBatch(
+      const std::vector<const TensorCPU*>& inputs,
+      bool single);
+
+  static void gatherRows(
+      CPUContext& context,
+      const std::vector<Element>& elements,
+      const std::vector<TensorCPU*>& outputs);
 
   bool canWrite() const;
   bool canRead() const;
 
   const size_t capacity_;
   const size_t numBlobs_;
+  const bool zeroCopy_;
 
   mutable std::mutex mutex_;
 
@@ -63,6 +92,6 @@ class RebatchingQueue {
   std::condition_variable cvEmpty_;
   std::condition_variable cvOverflow_;
 
-  std::vector<std::vector<TensorCPU>> queue_;
+  std::vector<Element> queue_;
 };
 } // caffe2
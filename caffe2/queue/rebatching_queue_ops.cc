@@ -26,7 +26,12 @@ Creates the Queue.
     .Arg("num_blobs", "Number of input tensors the queue will support")
     .Arg(
         "capacity",
-        "Maximal number of elements the queue can hold at any given point");
+        "Maximal number of elements the queue can hold at any given point")
+    .Arg(
+        "zero_copy",
+        "Keep enqueued batches whole and copy the dequeued elements once, "
+        "straight from the batches into the outputs. A dequeue of exactly "
+        "one whole batch shares its memory without copying.");
 
 OPERATOR_SCHEMA(CloseRebatchingQueue)
     .NumInputs(1)
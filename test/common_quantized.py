@@ -30,6 +30,22 @@ def _dequantize(qx, scale, zero_point):
     return x
 
 
+def _quantize_fp32(x, scale, zero_point, dtype=np.uint8):
+    """Quantizes a numpy array in float32, with the arithmetic of the quantized
+    CPU kernels."""
+    qx = np.round(x.astype(np.float32) / np.float32(scale)
+                  + np.float32(zero_point)).astype(np.float64)
+    qx = np.clip(qx, np.iinfo(dtype).min, np.iinfo(dtype).max)
+    return qx.astype(dtype)
+
+
+def _dequantize_fp32(qx, scale, zero_point):
+    """Dequantizes a numpy array in float32, with the arithmetic of the
+    quantized CPU kernels."""
+    x = (qx.astype(np.int64) - zero_point).astype(np.float32)
+    return x * np.float32(scale)
+
+
 def _requantize(x, multiplier, zero_point, qmin=0, qmax=255, qtype=np.uint8):
     """Requantizes a numpy array, i.e., intermediate int32 or int16 values are
     converted back to given type"""
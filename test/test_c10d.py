@@ -171,6 +171,36 @@ class StoreTestBase(object):
     def test_set_get(self):
         self._test_set_get(self._create_store())
 
+    def _test_multi_set_get(self, fs):
+        fs.multi_set(["key0", "key1", "key2"], ["value0", "value1", "value2"])
+        self.assertEqual(b"value1", fs.get("key1"))
+        self.assertEqual(
+            [b"value2", b"value0"], fs.multi_get(["key2", "key0"]))
+
+    def test_multi_set_get(self):
+        self._test_multi_set_get(self._create_store())
+
+    def _test_compare_set(self, fs):
+        self.assertEqual(b"first", fs.compare_set("cas", "", "first"))
+        self.assertEqual(b"first", fs.compare_set("cas", "other", "second"))
+        self.assertEqual(b"second", fs.compare_set("cas", "first", "second"))
+        self.assertEqual(b"second", fs.get("cas"))
+
+    def test_compare_set(self):
+        self._test_compare_set(self._create_store())
+
+    def _test_watch_prefix(self, fs):
+        fs.set("rank/0", "a")
+        fs.set("other", "b")
+        fs.set("rank/1", "c")
+        self.assertEqual(
+            {"rank/0": b"a", "rank/1": b"c"}, fs.watch_prefix("rank/", 2))
+        with self.assertRaises(RuntimeError):
+            fs.watch_prefix("rank/", 3, timedelta(milliseconds=100))
+
+    def test_watch_prefix(self):
+        self._test_watch_prefix(self._create_store())
+
 
 class FileStoreTest(TestCase, StoreTestBase):
     def setUp(self):
@@ -708,6 +738,39 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
         inputs = [torch.Tensor([i + self.rank]).cuda() for i in range(1000)]
         self._test_allreduce_stress(inputs)
 
+    def _test_allreduce_chunked(self, fn):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        opts = self.opts(threads=4)
+        # Split every input into chunks of 7 floats.
+        opts.chunkBytes = 28
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, opts)
+
+        # Sizes that are smaller than, equal to, and not a multiple of a chunk.
+        sizes = [3, 7, 17, 100, 256]
+        expected = self.world_size * (self.world_size - 1) / 2
+        work_handles = []
+        inputs = []
+        for size in sizes:
+            tensors = [
+                fn(torch.arange(size, dtype=torch.float) + self.rank),
+                fn(torch.arange(size, dtype=torch.float)),
+            ]
+            inputs.append(tensors)
+            work_handles.append(pg.allreduce(tensors))
+
+        for size, tensors, work in zip(sizes, inputs, work_handles):
+            work.wait()
+            output = torch.arange(size, dtype=torch.float) * 2 * self.world_size
+            for tensor in tensors:
+                self.assertEqual(fn(output + expected), tensor)
+
+    def test_allreduce_chunked(self):
+        self._test_allreduce_chunked(lambda t: t.clone())
+
+    @skip_if_not_multigpu
+    def test_allreduce_chunked_cuda(self):
+        self._test_allreduce_chunked(lambda t: t.clone().cuda())
+
     def test_sparse_allreduce_checks(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -756,6 +819,29 @@ class ProcessGroupGlooTest(MultiProcessTestCase):
     def test_sparse_allreduce_basics_cuda(self):
         self._test_sparse_allreduce_basics(lambda t: t.clone().cuda())
 
+    def _test_sparse_allreduce_coalesced_basics(self, fn):
+        store = c10d.FileStore(self.file.name, self.world_size)
+        pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
+
+        tests = simple_sparse_reduce_tests(self.rank, self.world_size)
+        inputs = [fn(inputs[0]) for (inputs, _) in tests]
+        outputs = [outputs[0] for (_, outputs) in tests]
+
+        # Reduce all tensors sparsely, then cross over to dense for all.
+        for threshold in [float('inf'), 0.0]:
+            opts = c10d.AllreduceCoalescedOptions()
+            opts.sparseDensityThreshold = threshold
+            work = pg.allreduce_coalesced(inputs, opts)
+            work.wait()
+            self.assertEqual(work.result(), outputs)
+
+    def test_sparse_allreduce_coalesced_basics(self):
+        self._test_sparse_allreduce_coalesced_basics(lambda t: t)
+
+    @skip_if_not_multigpu
+    def test_sparse_allreduce_coalesced_basics_cuda(self):
+        self._test_sparse_allreduce_coalesced_basics(lambda t: t.clone().cuda())
+
     def test_scatter_checks(self):
         store = c10d.FileStore(self.file.name, self.world_size)
         pg = c10d.ProcessGroupGloo(store, self.rank, self.world_size, self.opts())
@@ -2793,6 +2879,29 @@ class ComputeBucketAssignmentTest(TestCase):
         result = dist._compute_bucket_assignment_by_size(tensors, [200, 400])
         self.assertEqual([[0], [1], [2, 4], [3, 5]], result)
 
+    def test_sparse_gradients_share_bucket(self):
+        tensors = [
+            torch.empty([10], dtype=torch.float),
+            torch.empty([10], dtype=torch.float),
+            torch.empty([10], dtype=torch.float),
+            torch.empty([10], dtype=torch.float),
+        ]
+        result = dist._compute_bucket_assignment_by_size(
+            tensors, [400], [True, False, True, False])
+        self.assertEqual([[0, 2], [1, 3]], result)
+
+    def test_sparse_gradients_size_limit(self):
+        tensors = [
+            torch.empty([60], dtype=torch.float),
+            torch.empty([60], dtype=torch.float),
+            torch.empty([1000], dtype=torch.float),
+            torch.empty([10], dtype=torch.float),
+            torch.empty([60], dtype=torch.float),
+        ]
+        result = dist._compute_bucket_assignment_by_size(
+            tensors, [400], [True, True, True, False, True])
+        self.assertEqual([[0, 1], [2], [3], [4]], result)
+
 
 class CommTest(MultiProcessTestCase):
 
@@ -12,7 +12,7 @@ aten_native_yaml = os.path.join(path, '../aten/src/ATen/native/native_functions.
 all_operators_with_namedtuple_return = {
     'max', 'min', 'median', 'mode', 'kthvalue', 'svd', 'symeig', 'eig',
     'qr', 'geqrf', 'solve', 'slogdet', 'sort', 'topk', 'lstsq',
-    'triangular_solve'
+    'triangular_solve', 'cdist_topk'
 }
 
 
@@ -63,6 +63,10 @@ class TestNamedTupleAPI(unittest.TestCase):
             op(operators=['triangular_solve'], input=(a,), names=('solution', 'cloned_coefficient'), hasout=True),
             op(operators=['lstsq'], input=(a,), names=('solution', 'QR'), hasout=True),
         ]
+        # operators that are only available as functions
+        function_operators = [
+            op(operators=['cdist_topk'], input=(a, 2), names=('values', 'indices'), hasout=False),
+        ]
 
         for op in operators:
             for f in op.operators:
@@ -74,7 +78,13 @@ class TestNamedTupleAPI(unittest.TestCase):
                     for i, name in enumerate(op.names):
                         self.assertIs(getattr(ret, name), ret[i])
 
-        all_covered_operators = set([x for y in operators for x in y.operators])
+        for op in function_operators:
+            for f in op.operators:
+                ret = getattr(torch, f)(a, *op.input)
+                for i, name in enumerate(op.names):
+                    self.assertIs(getattr(ret, name), ret[i])
+
+        all_covered_operators = set([x for y in operators + function_operators for x in y.operators])
 
         self.assertEqual(all_operators_with_namedtuple_return, all_covered_operators, textwrap.dedent('''
         The set of covered operators does not match the `all_operators_with_namedtuple_return` of
@@ -2952,6 +2952,42 @@ class TestNN(NNTestCase):
             self._test_EmbeddingBag(False, 'sum', True, test_backward=test_backward, dtype=dtype)
             self._test_EmbeddingBag(False, 'mean', True, test_backward=test_backward, dtype=dtype)
 
+    def test_embedding_bag_parallel_cpu(self):
+        # Enough bags for the float forward to be split into several chunks,
+        # compared with the double forward which does not take the fast path
+        num_bags = 2000
+        lengths = torch.randint(0, 5, (num_bags,))
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long),
+                             lengths.cumsum(0)[:-1]])
+        indices = torch.randint(0, 100, (int(lengths.sum()),))
+        weight = torch.randn(100, 64)
+        per_sample_weights = torch.rand(indices.numel())
+        for mode in ['sum', 'mean']:
+            output = F.embedding_bag(indices, weight, offsets, mode=mode)
+            expected = F.embedding_bag(indices, weight.double(), offsets,
+                                       mode=mode)
+            self.assertEqual(output, expected.float(), prec=1e-5)
+        output = F.embedding_bag(indices, weight, offsets, mode='sum',
+                                 per_sample_weights=per_sample_weights)
+        expected = self._embedding_bag_reference_impl(
+            indices, weight, offsets, 'sum', per_sample_weights)
+        self.assertEqual(output, expected, prec=1e-5)
+
+        # Bag sizes are computed by the fast path for the backward of mean
+        weight.requires_grad_()
+        F.embedding_bag(indices, weight, offsets, mode='mean').sum().backward()
+        expected_grad = torch.zeros(100, 64, dtype=torch.double)
+        bag_sizes = lengths.clamp(min=1).double()
+        expected_grad.index_add_(
+            0, indices,
+            torch.repeat_interleave(1 / bag_sizes, lengths)
+            .unsqueeze(1).expand(-1, 64).contiguous())
+        self.assertEqual(weight.grad, expected_grad.float(), prec=1e-5)
+
+        with self.assertRaisesRegex(IndexError, "out of range"):
+            F.embedding_bag(torch.tensor([0, 100]), weight.detach(),
+                            torch.tensor([0]))
+
     def _test_embedding_bag_empty_input(self, device):
         m = 4
         n = 3
@@ -5398,6 +5434,64 @@ class TestNN(NNTestCase):
                              torch.cat([m1.weight.grad.data, m2.weight.grad.data], 0),
                              1e-1 if dtype == torch.half else dtype2prec[dtype])
 
+    def test_Conv2d_cpu_algorithms(self):
+        # every algorithm the override can select must match im2col + GEMM
+        configs = [
+            # in_c, out_c, kernel, stride, padding, dilation, groups, size
+            (16, 16, 3, 1, 1, 1, 1, 20),
+            (5, 7, 3, 1, 0, 1, 1, 9),
+            (3, 8, 3, 2, 1, 1, 1, 11),
+            (8, 8, 3, 1, 1, 1, 8, 10),
+            (4, 8, 5, 1, 2, 2, 4, 12),
+            (6, 6, 1, 1, 0, 1, 3, 7),
+        ]
+        previous = torch._C._get_cpu_conv_algorithm()
+        try:
+            for dtype in (torch.float, torch.double):
+                for in_c, out_c, kernel, stride, padding, dilation, groups, size in configs:
+                    m = nn.Conv2d(in_c, out_c, kernel, stride=stride, padding=padding,
+                                  dilation=dilation, groups=groups).to(dtype)
+                    x = torch.randn(2, in_c, size, size + 1, dtype=dtype)
+                    grad_output = None
+                    results = {}
+                    for algorithm in ('gemm', 'winograd', 'direct', 'auto'):
+                        torch._C._set_cpu_conv_algorithm(algorithm)
+                        i = x.clone().requires_grad_()
+                        m.zero_grad()
+                        output = m(i)
+                        if grad_output is None:
+                            grad_output = torch.randn_like(output)
+                        output.backward(grad_output)
+                        results[algorithm] = (output, i.grad, m.weight.grad, m.bias.grad)
+                    prec = 1e-3 if dtype == torch.float else 1e-10
+                    for algorithm in ('winograd', 'direct', 'auto'):
+                        for actual, expected in zip(results[algorithm], results['gemm']):
+                            self.assertEqual(actual, expected, prec)
+        finally:
+            torch._C._set_cpu_conv_algorithm(previous)
+        self.assertRaises(RuntimeError, lambda: torch._C._set_cpu_conv_algorithm('fft'))
+
+    def test_Conv2d_cpu_direct_no_channels(self):
+        x = torch.randn(2, 0, 5, 6)
+        weight = torch.randn(3, 0, 3, 3)
+        bias = torch.randn(3)
+        output = torch._direct_convolution2d(x, weight, bias, (1, 1), (1, 1), (1, 1), 1)
+        self.assertEqual(output, bias.view(1, 3, 1, 1).expand(2, 3, 5, 6))
+
+    def test_Conv2d_cpu_algorithms_gradgrad(self):
+        previous = torch._C._get_cpu_conv_algorithm()
+        try:
+            for algorithm, groups in (('winograd', 1), ('direct', 1), ('direct', 2)):
+                torch._C._set_cpu_conv_algorithm(algorithm)
+                x = torch.randn(2, 4, 6, 5, dtype=torch.double, requires_grad=True)
+                weight = torch.randn(4, 4 // groups, 3, 3, dtype=torch.double, requires_grad=True)
+                bias = torch.randn(4, dtype=torch.double, requires_grad=True)
+                func = lambda x, weight, bias: F.conv2d(x, weight, bias, padding=1, groups=groups)
+                self.assertTrue(gradcheck(func, (x, weight, bias)))
+                self.assertTrue(gradgradcheck(func, (x, weight, bias)))
+        finally:
+            torch._C._set_cpu_conv_algorithm(previous)
+
     # Very similar to test_Conv2d_naive_groups but with special care to handle
     # the number of groups == number of input channels
     @unittest.skipIf(not TEST_CUDA, 'CUDA not available')
@@ -5538,6 +5632,33 @@ class TestNN(NNTestCase):
         for reduction in ['mean', 'none']:
             F.nll_loss(x, t, ignore_index=255, reduction=reduction).sum().backward()
 
+    def test_cross_entropy_fused(self):
+        # wide enough to be streamed in several chunks
+        x = torch.randn(6, 5000, dtype=torch.double) * 10
+        t = torch.tensor([0, 4999, 255, 17, 255, 2500])
+        weight = torch.rand(5000, dtype=torch.double)
+        for reduction, w in product(['mean', 'sum', 'none'], [None, weight]):
+            input = x.clone().requires_grad_()
+            expected_input = x.clone().requires_grad_()
+            output = F.cross_entropy(input, t, w, ignore_index=255, reduction=reduction)
+            expected = F.nll_loss(F.log_softmax(expected_input, 1), t, w, ignore_index=255, reduction=reduction)
+            self.assertEqual(output, expected)
+            output.sum().backward()
+            expected.sum().backward()
+            self.assertEqual(input.grad, expected_input.grad)
+
+        # every row ignored
+        output = F.cross_entropy(x.requires_grad_(), torch.full((6,), 255, dtype=torch.long), ignore_index=255)
+        self.assertEqual(output.item(), 0)
+
+        input = torch.randn(4, 7, dtype=torch.double, requires_grad=True)
+        t = torch.tensor([1, 6, -100, 0])
+        for reduction in ['mean', 'sum', 'none']:
+            self.assertTrue(gradgradcheck(lambda i: F.cross_entropy(i, t, reduction=reduction), (input,)))
+
+        with self.assertRaisesRegex(RuntimeError, 'target out of bounds'):
+            F.cross_entropy(torch.randn(2, 3), torch.tensor([0, 3]))
+
     def test_poisson_nll_loss_reduction_modes(self):
         input = torch.tensor([0.5, 1.5, 2.5])
         target = torch.tensor([1., 2., 3.])
@@ -6700,6 +6821,37 @@ class TestNN(NNTestCase):
             self.assertEqual(output1, output2)
             self.assertEqual(hidden1, hidden2)
 
+    def test_RNN_cpu_fused_inference(self):
+        # without grad the whole stack runs in the fused CPU kernels
+        for mode, nonlinearity in [('LSTM', None), ('GRU', None), ('RNN', 'tanh'), ('RNN', 'relu')]:
+            for num_layers, bidirectional, batch_first, bias in product([1, 3], [False, True], [False, True],
+                                                                        [False, True]):
+                kwargs = dict(num_layers=num_layers, bidirectional=bidirectional, batch_first=batch_first, bias=bias)
+                if nonlinearity is not None:
+                    kwargs['nonlinearity'] = nonlinearity
+                rnn = getattr(nn, mode)(7, 9, **kwargs).double()
+                input = torch.randn(5, 4, 7, dtype=torch.double)
+                batch_size = input.size(0 if batch_first else 1)
+                hx = torch.randn(num_layers * (2 if bidirectional else 1), batch_size, 9, dtype=torch.double)
+                hidden = (hx, torch.randn_like(hx)) if mode == 'LSTM' else hx
+
+                output, hy = rnn(input, hidden)
+                with torch.no_grad():
+                    output_fused, hy_fused = rnn(input, hidden)
+                self.assertEqual(output_fused, output)
+                self.assertEqual(hy_fused, hy)
+
+        # the weights of every layer are checked against the hidden size
+        rnn = nn.LSTM(7, 9, num_layers=2).double()
+        input = torch.randn(5, 4, 7, dtype=torch.double)
+        hx = torch.randn(2, 4, 9, dtype=torch.double)
+        for index, size, name in [(4, (36, 5), 'weight_ih of layer 1'), (5, (36, 5), 'weight_hh of layer 1'),
+                                  (7, (18,), 'biases of layer 1')]:
+            weights = [w.detach() for w in rnn._flat_weights]
+            weights[index] = torch.randn(size, dtype=torch.double)
+            with torch.no_grad(), self.assertRaisesRegex(RuntimeError, name):
+                torch.lstm(input, (hx, hx), weights, True, 2, 0.0, False, False, False)
+
     def _test_rnn_retain_variables(self, device="cpu", dtype=torch.double):
         rnns = [nn.LSTM(10, 20, num_layers=2).to(device, dtype),
                 nn.GRU(10, 20, num_layers=2).to(device, dtype),
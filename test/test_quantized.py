@@ -2,6 +2,7 @@ from __future__ import absolute_import, division, print_function, unicode_litera
 
 import numpy as np
 import unittest
+from contextlib import contextmanager
 
 import torch
 import torch.jit
@@ -13,7 +14,14 @@ from hypothesis import strategies as st
 import hypothesis_utils as hu
 
 from common_utils import TEST_WITH_UBSAN, TestCase, run_tests, IS_WINDOWS, IS_PPC
-from common_quantized import _quantize, _dequantize, _calculate_dynamic_qparams
+from common_quantized import _quantize, _dequantize, _calculate_dynamic_qparams, \
+    _quantize_fp32, _dequantize_fp32
+
+def _np_dtype(qtype):
+    """The numpy type of the integer representation of qtype."""
+    return {torch.quint8: np.uint8, torch.qint8: np.int8,
+            torch.qint32: np.int32}[qtype]
+
 
 # Make sure we won't have overflows from vpmaddubsw instruction used in FBGEMM.
 # On the current Intel x86 architecture, we need to utilize vpmaddubsw instruction
@@ -516,6 +524,93 @@ class TestQuantizedOps(TestCase):
             cat_q = q_cat_op(tensors_q, dim=ch_axis, scale=scale,
                              zero_point=zero_point)
 
+    """Tests quantized concatenation of inputs with different qparams."""
+    @given(X=hu.tensor(shapes=hu.array_shapes(min_dims=2, max_dims=4,
+                                              min_side=1, max_side=40),
+                       qparams=hu.qparams()),
+           dim=st.integers(0, 3),
+           relu=st.booleans())
+    def test_cat_requantize(self, X, dim, relu):
+        X, (scale, zero_point, torch_type) = X
+        assume(dim < X.ndim)
+        X = torch.from_numpy(X)
+        tensors_q = [
+            torch.quantize_linear(X, scale, zero_point, torch_type),
+            torch.quantize_linear(X, scale * 2, zero_point // 2, torch_type),
+            torch.quantize_linear(-X, scale / 2, zero_point, torch_type),
+        ]
+        np_type = _np_dtype(torch_type)
+
+        def requantize(qx):
+            # inputs with the parameters of the result are copied
+            if (not relu and qx.q_scale() == scale
+                    and qx.q_zero_point() == zero_point):
+                return qx.int_repr().numpy()
+            x = _dequantize_fp32(qx.int_repr().numpy(), qx.q_scale(),
+                                 qx.q_zero_point())
+            return _quantize_fp32(x, scale, zero_point, np_type)
+
+        cat_ref = np.concatenate([requantize(qx) for qx in tensors_q], axis=dim)
+        if relu:
+            cat_ref = np.maximum(cat_ref, np_type(zero_point))
+            q_cat_op = torch.ops.quantized.cat_relu
+        else:
+            q_cat_op = torch.ops.quantized.cat
+
+        cat_q = q_cat_op(tensors_q, dim=dim, scale=scale,
+                         zero_point=zero_point)
+        np.testing.assert_equal(cat_q.int_repr().numpy(), cat_ref)
+
+    """Tests that the elements after the last full vector are quantized like
+    the others in the kernels that requantize."""
+    def test_requantize_vector_tails(self):
+        np.random.seed(0)
+        scale, zero_point = 0.37, 3
+        for torch_type in [torch.quint8, torch.qint8, torch.qint32]:
+            np_type = _np_dtype(torch_type)
+            # the vectors hold 32 8 bit or 8 32 bit values
+            for n in [1, 7, 31, 33, 67, 100]:
+                X = np.random.uniform(-40, 40, (3, n)).astype(np.float32)
+                # half way between two quantized values
+                X[:, ::2] = (np.round(X[:, ::2] / scale) + 0.5) * scale
+                # per channel quantization of each row
+                scales = np.array([scale, scale * 3, scale / 7])
+                zero_points = np.array([zero_point, 0, -zero_point])
+                if torch_type == torch.quint8:
+                    zero_points += 10
+                qX = torch.quantize_linear_per_channel(
+                    torch.from_numpy(X), torch.from_numpy(scales),
+                    torch.from_numpy(zero_points), axis=[0],
+                    dtype=torch_type)
+                qX_ref = np.stack([
+                    _quantize_fp32(X[c], scales[c], zero_points[c], np_type)
+                    for c in range(3)])
+                np.testing.assert_equal(qX.int_repr().numpy(), qX_ref)
+                X_ref = np.stack([
+                    _dequantize_fp32(qX_ref[c], scales[c], zero_points[c])
+                    for c in range(3)])
+                np.testing.assert_equal(qX.dequantize().numpy(), X_ref)
+
+                # add and mul of operands with different parameters
+                if torch_type != torch.qint32:
+                    qA = torch.quantize_linear(torch.from_numpy(X), scale,
+                                               zero_point, torch_type)
+                    qB = torch.quantize_linear(torch.from_numpy(X[::-1].copy()),
+                                               scale * 2, zero_point, torch_type)
+                    A = _dequantize_fp32(qA.int_repr().numpy(), scale, zero_point)
+                    B = _dequantize_fp32(qB.int_repr().numpy(), scale * 2,
+                                         zero_point)
+                    qC = torch.ops.quantized.add(qA, qB, scale=scale / 3,
+                                                 zero_point=zero_point)
+                    np.testing.assert_equal(
+                        qC.int_repr().numpy(),
+                        _quantize_fp32(A + B, scale / 3, zero_point, np_type))
+                    qC = torch.ops.quantized.mul(qA, qB, scale=scale * 9,
+                                                 zero_point=zero_point)
+                    np.testing.assert_equal(
+                        qC.int_repr().numpy(),
+                        _quantize_fp32(A * B, scale * 9, zero_point, np_type))
+
     """Tests the correctness of the quantized equal op."""
     @given(X=hu.tensor(shapes=hu.array_shapes(1, 5, 1, 5),
                        qparams=hu.qparams()),
@@ -1057,6 +1152,87 @@ class TestQuantizedConv(unittest.TestCase):
             np.testing.assert_equal(np.float32(W_q.q_scale()), np.float32(W_unpacked.q_scale()))
             np.testing.assert_equal(W_q.q_zero_point(), W_unpacked.q_zero_point())
 
+class TestQuantizedEmbeddingBag(TestCase):
+    """Tests the correctness of the quantized::embedding_bag_{byte,4bit,2bit} ops."""
+    @given(bit_rate=st.sampled_from([2, 4]),
+           num_embeddings=st.integers(1, 50),
+           embedding_dim=st.sampled_from([1, 7, 8, 16, 33, 64]),
+           num_bags=st.integers(1, 10),
+           mode=st.sampled_from([0, 1]),
+           weighted=st.booleans(),
+           index_dtype=st.sampled_from([torch.int32, torch.int64]))
+    def test_embedding_bag_nbit(self, bit_rate, num_embeddings, embedding_dim,
+                                num_bags, mode, weighted, index_dtype):
+        assume(not weighted or mode == 0)
+        prepack = getattr(torch.ops.quantized,
+                          "embedding_bag_{}bit_prepack".format(bit_rate))
+        unpack = getattr(torch.ops.quantized,
+                         "embedding_bag_{}bit_unpack".format(bit_rate))
+        embedding_bag = getattr(torch.ops.quantized,
+                                "embedding_bag_{}bit".format(bit_rate))
+
+        weight = torch.rand(num_embeddings, embedding_dim)
+        packed_weight = prepack(weight)
+        unpacked_weight = unpack(packed_weight, embedding_dim)
+        self.assertEqual(unpacked_weight.shape, weight.shape)
+        with self.assertRaisesRegex(RuntimeError, "can't hold embeddings"):
+            unpack(packed_weight, embedding_dim + 8 // bit_rate)
+        step = (weight.max(dim=1)[0] - weight.min(dim=1)[0]) / ((1 << bit_rate) - 1)
+        self.assertTrue(((unpacked_weight - weight).abs().max(dim=1)[0] <=
+                         step / 2 * 1.01 + 1e-2).all())
+
+        lengths = torch.randint(0, 5, (num_bags,))
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long),
+                             lengths.cumsum(0)[:-1]])
+        indices = torch.randint(0, num_embeddings, (int(lengths.sum()),))
+        per_sample_weights = torch.rand(indices.numel()) if weighted else None
+
+        Y = embedding_bag(packed_weight, indices.to(index_dtype),
+                          offsets.to(index_dtype), mode, per_sample_weights,
+                          embedding_dim)
+        Y_ref = F.embedding_bag(indices, unpacked_weight, offsets,
+                                mode="sum" if mode == 0 else "mean",
+                                per_sample_weights=per_sample_weights)
+        np.testing.assert_allclose(Y.numpy(), Y_ref.numpy(),
+                                   rtol=1e-5, atol=1e-5)
+
+    @given(num_embeddings=st.integers(1, 50),
+           embedding_dim=st.sampled_from([1, 7, 8, 16, 33, 64]),
+           num_bags=st.integers(1, 300),
+           mode=st.sampled_from([0, 1]),
+           weighted=st.booleans(),
+           index_dtype=st.sampled_from([torch.int32, torch.int64]))
+    def test_embedding_bag_byte(self, num_embeddings, embedding_dim, num_bags,
+                                mode, weighted, index_dtype):
+        assume(not weighted or mode == 0)
+        prepack = torch.ops.quantized.embedding_bag_byte_prepack
+        unpack = torch.ops.quantized.embedding_bag_byte_unpack
+        embedding_bag = torch.ops.quantized.embedding_bag_byte
+
+        weight = torch.rand(num_embeddings, embedding_dim)
+        packed_weight = prepack(weight)
+        self.assertEqual(packed_weight.shape,
+                         (num_embeddings, embedding_dim + 8))
+        unpacked_weight = unpack(packed_weight)
+        step = (weight.max(dim=1)[0] - weight.min(dim=1)[0]) / 255
+        self.assertTrue(((unpacked_weight - weight).abs().max(dim=1)[0] <=
+                         step / 2 * 1.01 + 1e-6).all())
+
+        lengths = torch.randint(0, 5, (num_bags,))
+        offsets = torch.cat([torch.zeros(1, dtype=torch.long),
+                             lengths.cumsum(0)[:-1]])
+        indices = torch.randint(0, num_embeddings, (int(lengths.sum()),))
+        per_sample_weights = torch.rand(indices.numel()) if weighted else None
+
+        Y = embedding_bag(packed_weight, indices.to(index_dtype),
+                          offsets.to(index_dtype), mode, per_sample_weights)
+        Y_ref = F.embedding_bag(indices, unpacked_weight, offsets,
+                                mode="sum" if mode == 0 else "mean",
+                                per_sample_weights=per_sample_weights)
+        np.testing.assert_allclose(Y.numpy(), Y_ref.numpy(),
+                                   rtol=1e-5, atol=1e-5)
+
+
 @unittest.skipIf(IS_WINDOWS, "QNNPACK has not been built for Windows")
 @unittest.skipIf(IS_PPC, "QNNPACK is not currently supported on ppc64le")
 @unittest.skipIf(TEST_WITH_UBSAN,
@@ -1153,5 +1329,243 @@ class TestQNNPackOps(TestCase):
         # Assert equal
         np.testing.assert_array_almost_equal(Y_q_ref2.dequantize().numpy(), Y_q.dequantize().numpy(), decimal=4)
 
+
+@contextmanager
+def override_quantized_engine(qengine):
+    previous = torch.backends.quantized.engine
+    torch.backends.quantized.engine = qengine
+    try:
+        yield
+    finally:
+        torch.backends.quantized.engine = previous
+
+
+@unittest.skipIf('qnnpack' not in torch.backends.quantized.supported_engines,
+                 "QNNPACK is not built into this binary")
+@unittest.skipIf(TEST_WITH_UBSAN,
+                 " QNNPACK does not play well with UBSAN at the moment,"
+                 " so we skip the test if we are in a UBSAN environment.")
+class TestQNNPackEngine(TestCase):
+    """Tests the engine neutral quantized ops with the QNNPACK engine selected."""
+    def test_qengine(self):
+        with override_quantized_engine('qnnpack'):
+            self.assertEqual(torch.backends.quantized.engine, 'qnnpack')
+        with self.assertRaises(RuntimeError):
+            torch.backends.quantized.engine = 'unknown'
+
+    """Tests that weights packed for one engine are rejected by the other."""
+    @unittest.skipIf('fbgemm' not in torch.backends.quantized.supported_engines,
+                     "FBGEMM is not built into this binary")
+    def test_packed_weights_engine(self):
+        X_q = torch.quantize_linear(torch.randn(2, 8), 0.1, 16, torch.quint8)
+        W_q = torch.quantize_linear(torch.randn(4, 8), 0.05, 0, torch.qint8)
+        with override_quantized_engine('fbgemm'):
+            W_prepack_fbgemm = torch.ops.quantized.linear_prepack(W_q)
+        with override_quantized_engine('qnnpack'):
+            W_prepack_qnnpack = torch.ops.quantized.linear_prepack(W_q)
+            with self.assertRaisesRegex(RuntimeError,
+                                        "not packed for the QNNPACK .*re-pack"):
+                torch.ops.quantized.linear(X_q, W_prepack_fbgemm, None, 0.5, 100)
+            with self.assertRaisesRegex(RuntimeError,
+                                        "not packed for the QNNPACK .*re-pack"):
+                torch.ops.quantized.linear_unpack(W_prepack_fbgemm)
+        with override_quantized_engine('fbgemm'):
+            with self.assertRaisesRegex(RuntimeError,
+                                        "not packed for the FBGEMM .*re-pack"):
+                torch.ops.quantized.linear_dynamic(X_q.dequantize(),
+                                                   W_prepack_qnnpack, None)
+
+    """Tests quantized::linear_prepack, quantized::linear and
+    quantized::linear_unpack."""
+    @given(batch_size=st.integers(1, 4),
+           input_channels=st.integers(8, 32),
+           output_channels=st.integers(4, 32),
+           W_dtype=st.sampled_from([torch.qint8, torch.quint8]),
+           use_bias=st.booleans(),
+           use_relu=st.booleans())
+    def test_linear(self, batch_size, input_channels, output_channels,
+                    W_dtype, use_bias, use_relu):
+        X_scale, X_zp = 0.1, 16
+        W_scale, W_zp = 0.05, 0 if W_dtype == torch.qint8 else 128
+        Y_scale, Y_zp = 0.5, 100
+        X = torch.randn(batch_size, input_channels)
+        W = torch.randn(output_channels, input_channels)
+        X_q = torch.quantize_linear(X, X_scale, X_zp, torch.quint8)
+        W_q = torch.quantize_linear(W, W_scale, W_zp, W_dtype)
+        b_q = torch.quantize_linear(torch.randn(output_channels), X_scale * W_scale,
+                                    0, torch.qint32) if use_bias else None
+
+        linear = torch.ops.quantized.linear_relu if use_relu else torch.ops.quantized.linear
+        with override_quantized_engine('qnnpack'):
+            W_prepack = torch.ops.quantized.linear_prepack(W_q)
+            Y_q = linear(X_q, W_prepack, b_q, Y_scale, Y_zp)
+            W_unpacked = torch.ops.quantized.linear_unpack(W_prepack)
+
+        # The weights come back in the representation they were packed from.
+        self.assertEqual(W_unpacked.dtype, W_dtype)
+        self.assertEqual(W_unpacked.q_scale(), W_scale)
+        self.assertEqual(W_unpacked.q_zero_point(), W_zp)
+        np.testing.assert_equal(W_unpacked.int_repr().numpy(), W_q.int_repr().numpy())
+
+        Y_ref = F.linear(X_q.dequantize(), W_q.dequantize(),
+                         b_q.dequantize() if use_bias else None)
+        if use_relu:
+            Y_ref = F.relu(Y_ref)
+        Y_q_ref = torch.quantize_linear(Y_ref, Y_scale, Y_zp, torch.quint8)
+        np.testing.assert_allclose(Y_q.int_repr().numpy().astype(np.int32),
+                                   Y_q_ref.int_repr().numpy().astype(np.int32),
+                                   atol=1, rtol=0)
+
+    """Tests quantized::linear_dynamic."""
+    @given(batch_size=st.integers(1, 4),
+           input_channels=st.integers(8, 32),
+           output_channels=st.integers(4, 32),
+           use_bias=st.booleans())
+    def test_linear_dynamic(self, batch_size, input_channels, output_channels,
+                            use_bias):
+        # The inputs lie on the grid that the dynamic quantization picks for
+        # them, so the only error left is the one of the output requantization.
+        X_scale = 0.02
+        X_q0 = torch.randint(0, 256, (batch_size, input_channels), dtype=torch.int32)
+        X_q0[0, 0], X_q0[0, 1] = 0, 255
+        X = X_q0.to(torch.float) * X_scale
+        W_q = torch.quantize_linear(torch.randn(output_channels, input_channels),
+                                    0.05, 0, torch.qint8)
+        b = torch.randn(output_channels) if use_bias else None
+
+        with override_quantized_engine('qnnpack'):
+            W_prepack = torch.ops.quantized.linear_prepack(W_q)
+            Y = torch.ops.quantized.linear_dynamic(X, W_prepack, b)
+
+        Y_ref = F.linear(X, W_q.dequantize(), b)
+        Y_range = max(Y_ref.max().item(), 0.0) - min(Y_ref.min().item(), 0.0)
+        np.testing.assert_allclose(Y.numpy(), Y_ref.numpy(),
+                                   atol=2 * Y_range / 255 + 1e-3, rtol=0)
+
+    """Tests quantized::linear_dynamic against the float linear."""
+    @given(batch_size=st.integers(1, 4),
+           input_channels=st.integers(8, 32),
+           output_channels=st.integers(4, 32),
+           use_bias=st.booleans())
+    def test_linear_dynamic_float_reference(self, batch_size, input_channels,
+                                            output_channels, use_bias):
+        X = torch.randn(batch_size, input_channels)
+        W = torch.randn(output_channels, input_channels)
+        b = torch.randn(output_channels) if use_bias else None
+        W_scale = W.abs().max().item() / 127
+        W_q = torch.quantize_linear(W, W_scale, 0, torch.qint8)
+
+        with override_quantized_engine('qnnpack'):
+            W_prepack = torch.ops.quantized.linear_prepack(W_q)
+            Y = torch.ops.quantized.linear_dynamic(X, W_prepack, b)
+
+        # The rounding of the weight and of the input, which may be off by a
+        # step at the ends of its range once the zero point is rounded, and
+        # the requantization of the output, which the FBGEMM path does not
+        # have.
+        Y_ref = F.linear(X, W, b)
+        X_scale = (max(X.max().item(), 0.0) - min(X.min().item(), 0.0)) / 255
+        Y_range = max(Y_ref.max().item(), 0.0) - min(Y_ref.min().item(), 0.0)
+        bound = (X.abs().sum(1, keepdim=True) * W_scale / 2 +
+                 W_q.dequantize().abs().sum(1) * X_scale +
+                 2 * Y_range / 255 + 1e-3)
+        self.assertTrue(((Y - Y_ref).abs() <= bound).all())
+
+    """Tests quantized::conv_prepack, quantized::conv2d and
+    quantized::conv_unpack."""
+    @given(batch_size=st.integers(1, 2),
+           groups=st.integers(1, 3),
+           input_channels_per_group=st.sampled_from([1, 2, 4, 8]),
+           output_channels_per_group=st.integers(1, 4),
+           kernel=st.integers(1, 3),
+           stride=st.integers(1, 2),
+           pad=st.integers(0, 1),
+           dilation=st.integers(1, 2),
+           W_dtype=st.sampled_from([torch.qint8, torch.quint8]),
+           use_bias=st.booleans(),
+           use_relu=st.booleans())
+    def test_conv2d(self, batch_size, groups, input_channels_per_group,
+                    output_channels_per_group, kernel, stride, pad, dilation,
+                    W_dtype, use_bias, use_relu):
+        input_channels = groups * input_channels_per_group
+        output_channels = groups * output_channels_per_group
+        X_scale, X_zp = 0.1, 16
+        W_scale, W_zp = 0.05, 0 if W_dtype == torch.qint8 else 128
+        Y_scale, Y_zp = 0.5, 100
+        X = torch.randn(batch_size, input_channels, 7, 7)
+        W = torch.randn(output_channels, input_channels_per_group, kernel, kernel)
+        X_q = torch.quantize_linear(X, X_scale, X_zp, torch.quint8)
+        W_q = torch.quantize_linear(W, W_scale, W_zp, W_dtype)
+        b_q = torch.quantize_linear(torch.randn(output_channels), X_scale * W_scale,
+                                    0, torch.qint32) if use_bias else None
+        stride, pad, dilation = _pair(stride), _pair(pad), _pair(dilation)
+
+        conv = torch.ops.quantized.conv2d_relu if use_relu else torch.ops.quantized.conv2d
+        with override_quantized_engine('qnnpack'):
+            W_prepack = torch.ops.quantized.conv_prepack(
+                W_q.permute([0, 2, 3, 1]), stride, pad, dilation, groups)
+            Y_q = conv(X_q.permute([0, 2, 3, 1]), W_prepack, b_q, stride, pad,
+                       dilation, groups, Y_scale, Y_zp).permute([0, 3, 1, 2])
+            W_unpacked = torch.ops.quantized.conv_unpack(W_prepack)
+
+        self.assertEqual(W_unpacked.dtype, W_dtype)
+        np.testing.assert_equal(W_unpacked.permute([0, 3, 1, 2]).int_repr().numpy(),
+                                W_q.int_repr().numpy())
+
+        Y_ref = F.conv2d(X_q.dequantize(), W_q.dequantize(),
+                         b_q.dequantize() if use_bias else None,
+                         stride, pad, dilation, groups)
+        if use_relu:
+            Y_ref = F.relu(Y_ref)
+        Y_q_ref = torch.quantize_linear(Y_ref, Y_scale, Y_zp, torch.quint8)
+        np.testing.assert_allclose(Y_q.int_repr().numpy().astype(np.int32),
+                                   Y_q_ref.int_repr().numpy().astype(np.int32),
+                                   atol=1, rtol=0)
+
+    """Tests quantized::add with the QNNPACK engine."""
+    @given(use_relu=st.booleans())
+    def test_add(self, use_relu):
+        A = torch.randn(2, 3, 8, 8)
+        B = torch.randn(2, 3, 8, 8)
+        qA = torch.quantize_linear(A, 0.05, 128, torch.quint8)
+        qB = torch.quantize_linear(B, 0.1, 120, torch.quint8)
+        scale, zero_point = 0.2, 110
+
+        add = torch.ops.quantized.add_relu if use_relu else torch.ops.quantized.add
+        with override_quantized_engine('qnnpack'):
+            qC = add(qA, qB, scale, zero_point)
+
+        C_ref = qA.dequantize() + qB.dequantize()
+        if use_relu:
+            C_ref = F.relu(C_ref)
+        qC_ref = torch.quantize_linear(C_ref, scale, zero_point, torch.quint8)
+        np.testing.assert_allclose(qC.int_repr().numpy().astype(np.int32),
+                                   qC_ref.int_repr().numpy().astype(np.int32),
+                                   atol=1, rtol=0)
+
+    """Tests max_pool2d and adaptive_avg_pool2d with the QNNPACK engine."""
+    @given(kernel=st.integers(2, 3),
+           stride=st.integers(1, 2),
+           pad=st.integers(0, 1),
+           output_size=st.sampled_from([1, 2, 4]))
+    def test_pool2d(self, kernel, stride, pad, output_size):
+        X = torch.randn(2, 3, 8, 8)
+        qX = torch.quantize_linear(X, 0.05, 128, torch.quint8)
+
+        with override_quantized_engine('qnnpack'):
+            qY = F.max_pool2d(qX, kernel, stride, pad)
+            qZ = F.adaptive_avg_pool2d(qX, output_size)
+
+        # The maximum of the quantized values is exact.
+        Y_ref = F.max_pool2d(qX.dequantize(), kernel, stride, pad)
+        qY_ref = torch.quantize_linear(Y_ref, 0.05, 128, torch.quint8)
+        np.testing.assert_equal(qY.int_repr().numpy(), qY_ref.int_repr().numpy())
+
+        Z_ref = F.adaptive_avg_pool2d(qX.dequantize(), output_size)
+        qZ_ref = torch.quantize_linear(Z_ref, 0.05, 128, torch.quint8)
+        np.testing.assert_allclose(qZ.int_repr().numpy().astype(np.int32),
+                                   qZ_ref.int_repr().numpy().astype(np.int32),
+                                   atol=1, rtol=0)
+
 if __name__ == "__main__":
     run_tests()
@@ -2069,5 +2069,116 @@ class TestSparseOneOff(TestCase):
             x + sparse_y
 
 
+class TestSparseCsr(TestCase):
+
+    def _random_csr(self, rows, cols, density=0.3, dtype=torch.double):
+        dense = (10 * torch.randn(rows, cols)).to(dtype)
+        dense[torch.rand(rows, cols) > density] = 0
+        return dense, dense.to_sparse_csr()
+
+    def test_layout(self):
+        self.assertEqual(str(torch.sparse_csr), 'torch.sparse_csr')
+        _, s = self._random_csr(3, 4)
+        self.assertEqual(s.layout, torch.sparse_csr)
+        self.assertTrue(s.is_sparse_csr)
+        self.assertFalse(s.is_sparse)
+
+    def test_constructor(self):
+        s = torch.sparse_csr_tensor([0, 1, 3], [2, 0, 2], [3., 4., 5.], [2, 4])
+        self.assertEqual(s.shape, (2, 4))
+        self.assertEqual(s._nnz(), 3)
+        self.assertEqual(s.crow_indices(), torch.tensor([0, 1, 3]))
+        self.assertEqual(s.col_indices(), torch.tensor([2, 0, 2]))
+        self.assertEqual(s.values(), torch.tensor([3., 4., 5.]))
+        self.assertEqual(s.to_dense(), torch.tensor([[0., 0., 3., 0.], [4., 0., 5., 0.]]))
+
+        s = torch.sparse_csr_tensor([0, 0, 0], [], [], [2, 3], dtype=torch.float)
+        self.assertEqual(s._nnz(), 0)
+        self.assertEqual(s.to_dense(), torch.zeros(2, 3))
+
+    def test_constructor_invalid(self):
+        with self.assertRaisesRegex(RuntimeError, "crow_indices must have rows"):
+            torch.sparse_csr_tensor([0, 1], [0], [1.], [2, 2])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices must start with 0"):
+            torch.sparse_csr_tensor([1, 1, 1], [0], [1.], [2, 2])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices must end with the number of entries"):
+            torch.sparse_csr_tensor([0, 1, 1], [0, 1], [1., 2.], [2, 2])
+        with self.assertRaisesRegex(RuntimeError, "crow_indices must be non-decreasing"):
+            torch.sparse_csr_tensor([0, 2, 1, 2], [0, 1], [1., 2.], [3, 2])
+        with self.assertRaisesRegex(RuntimeError, "size is inconsistent with col_indices"):
+            torch.sparse_csr_tensor([0, 1, 1], [2], [1.], [2, 2])
+        with self.assertRaisesRegex(RuntimeError, "col_indices must be sorted and unique"):
+            torch.sparse_csr_tensor([0, 2, 2], [1, 1], [1., 2.], [2, 2])
+
+    def test_conversions(self):
+        for rows, cols in [(5, 7), (1, 1), (0, 3), (3, 0), (64, 33)]:
+            dense, s = self._random_csr(rows, cols)
+            self.assertEqual(s._nnz(), (dense != 0).sum().item())
+            self.assertEqual(s.to_dense(), dense)
+
+            coo = s.to_sparse()
+            self.assertTrue(coo.is_coalesced())
+            self.assertEqual(coo.to_dense(), dense)
+            self.assertEqual(coo.to_sparse_csr().to_dense(), dense)
+
+            # an uncoalesced COO tensor is summed up first
+            uncoalesced = torch.sparse_coo_tensor(
+                torch.cat([coo._indices(), coo._indices()], 1),
+                torch.cat([coo._values(), coo._values()]), coo.shape)
+            self.assertEqual(uncoalesced.to_sparse_csr().to_dense(), 2 * dense)
+
+        with self.assertRaisesRegex(RuntimeError, "only matrices can be converted"):
+            torch.randn(2, 3, 4).to_sparse_csr()
+
+    def test_mm(self):
+        for dtype in [torch.double, torch.float, torch.long]:
+            dense, s = self._random_csr(20, 30, dtype=dtype)
+            other = torch.randn(30, 17).to(dtype)
+            self.assertEqual(torch.mm(s, other), torch.mm(dense, other))
+            self.assertEqual(s.mm(other.t().contiguous().t()), dense.mm(other))
+            out = torch.empty(0, dtype=dtype)
+            torch.mm(s, other, out=out)
+            self.assertEqual(out, dense.mm(other))
+
+        _, s = self._random_csr(20, 30)
+        with self.assertRaisesRegex(RuntimeError, "Expected dim 0 size 30"):
+            s.mm(torch.randn(29, 4, dtype=torch.double))
+
+    def test_addmm(self):
+        dense, s = self._random_csr(20, 30)
+        other = torch.randn(30, 17, dtype=torch.double)
+        t = torch.randn(20, 17, dtype=torch.double)
+        expected = 0.5 * t + 2 * dense.mm(other)
+        self.assertEqual(torch.addmm(t, s, other, beta=0.5, alpha=2), expected)
+        # broadcasts `self` like the dense version
+        self.assertEqual(torch.addmm(t[0], s, other), t[0] + dense.mm(other))
+        t.addmm_(s, other, beta=0.5, alpha=2)
+        self.assertEqual(t, expected)
+
+    def test_mv(self):
+        dense, s = self._random_csr(20, 30)
+        vec = torch.randn(30, dtype=torch.double)
+        self.assertEqual(s.mv(vec), dense.mv(vec))
+        strided_vec = torch.randn(60, dtype=torch.double)[::2]
+        self.assertEqual(s.mv(strided_vec), dense.mv(strided_vec))
+        with self.assertRaisesRegex(RuntimeError, "Expected size 30"):
+            s.mv(torch.randn(29, dtype=torch.double))
+
+    def test_mm_backward(self):
+        _, s = self._random_csr(10, 8)
+        other = torch.randn(8, 5, dtype=torch.double, requires_grad=True)
+        vec = torch.randn(8, dtype=torch.double, requires_grad=True)
+        gradcheck(lambda x: torch.mm(s, x), (other,))
+        gradcheck(lambda x: torch.addmm(torch.ones(10, 5, dtype=torch.double), s, x, beta=0.5, alpha=3), (other,))
+        gradcheck(lambda x: s.mv(x), (vec,))
+
+    def test_print(self):
+        s = torch.sparse_csr_tensor([0, 1, 3], [2, 0, 2], [3., 4., 5.], [2, 4])
+        self.assertEqual(str(s), "tensor(crow_indices=tensor([0, 1, 3]),\n"
+                                 "       col_indices=tensor([2, 0, 2]),\n"
+                                 "       values=tensor([3., 4., 5.]),\n"
+                                 "       size=(2, 4), nnz=3, layout=torch.sparse_csr)")
+
+
 if __name__ == '__main__':
     run_tests()
@@ -1432,6 +1432,25 @@ class _TestTorchMixin(torchtest):
             expected = brute_cdist(x, y, p=2)
             self.assertTrue(torch.allclose(expected, actual))
 
+    def test_cdist_topk(self):
+        for device in torch.testing.get_all_device_types():
+            for x_shape, y_shape in [((300, 20), (500, 20)), ((2, 1, 40, 7), (3, 600, 7))]:
+                for p in [2, 1, float('inf')]:
+                    x = torch.randn(x_shape, device=device, dtype=torch.double)
+                    y = torch.randn(y_shape, device=device, dtype=torch.double)
+                    # a few exact neighbours
+                    y[..., :10, :] = x.view(-1, x.size(-1))[:10]
+                    for k in [0, 1, 5]:
+                        values, indices = torch.cdist_topk(x, y, k, p=p)
+                        expected_values, expected_indices = torch.cdist(x, y, p=p).topk(k, largest=False)
+                        self.assertEqual(values, expected_values)
+                        self.assertEqual(indices, expected_indices)
+
+            x = torch.randn(20, 4, device=device, dtype=torch.double, requires_grad=True)
+            y = torch.randn(30, 4, device=device, dtype=torch.double, requires_grad=True)
+            self.assertTrue(torch.autograd.gradcheck(lambda x, y: torch.cdist_topk(x, y, 3)[0], (x, y)))
+            self.assertRaisesRegex(RuntimeError, "must be between 0", lambda: torch.cdist_topk(x, y, 31))
+
     def test_cdist_non_contiguous(self):
         for device in torch.testing.get_all_device_types():
             x = torch.randn(5, 7, device=device).transpose(-1, -2)
@@ -4946,6 +4965,35 @@ class _TestTorchMixin(torchtest):
         self.assertIsOrdered('descending', x, res2val, res2ind,
                              'random with NaNs')
 
+    def test_sort_large(self):
+        # a single slice large enough to be sorted by several threads
+        for dtype in [torch.uint8, torch.int, torch.long, torch.float, torch.double]:
+            x = torch.randint(0, 200, (200000,)).to(dtype)
+            if dtype.is_floating_point:
+                x[::1000] = float('NaN')
+            for descending in [False, True]:
+                res_val, res_ind = torch.sort(x, descending=descending)
+                self.assertEqual(res_ind.sort()[0], torch.arange(x.numel()))
+                # NaNs are the largest values
+                nan = res_val != res_val
+                num_nan = int(nan.sum())
+                self.assertEqual(num_nan, int((x != x).sum()))
+                self.assertTrue((x[res_ind] == res_val)[~nan].all())
+                if descending:
+                    self.assertTrue(nan[:num_nan].all())
+                    rest = res_val[num_nan:]
+                    self.assertTrue((rest[:-1] >= rest[1:]).all())
+                else:
+                    self.assertTrue(nan[x.numel() - num_nan:].all())
+                    rest = res_val[:x.numel() - num_nan]
+                    self.assertTrue((rest[:-1] <= rest[1:]).all())
+
+        x = torch.randn(2, 100000).t()
+        for k, largest in [(1, True), (10, False), (1000, True), (60000, False)]:
+            val, ind = x.topk(k, dim=0, largest=largest)
+            self.assertEqual(val, x.sort(dim=0, descending=largest)[0][:k], 0)
+            self.assertEqual(x.gather(0, ind), val, 0)
+
     @unittest.skipIf(not TEST_NUMPY, 'Numpy not found')
     def test_tensordot(self):
         for d in torch.testing.get_all_device_types():
@@ -7280,6 +7328,48 @@ class _TestTorchMixin(torchtest):
     def test_cholesky_batched(self):
         self._test_cholesky_batched(self, lambda t: t)
 
+    @skipIfNoLapack
+    def test_small_matrix_batched_linalg(self):
+        # batches of matrices up to 8 x 8 go to the fixed-size CPU kernels,
+        # single matrices to LAPACK
+        from common_utils import random_fullrank_matrix_distinct_singular_value as fullrank
+        from common_utils import random_symmetric_pd_matrix
+
+        def per_matrix(fn, *batches):
+            return torch.stack([fn(*ms) for ms in zip(*[b.unbind(0) for b in batches])])
+
+        for dtype, n, upper in product([torch.float, torch.double], range(2, 9), [True, False]):
+            prec = 1e-3 if dtype == torch.float else 1e-8
+            # 13 matrices do not fill a whole number of vectors
+            A = fullrank(n, 13).to(dtype)
+            b = torch.randn(13, n, 3, dtype=dtype)
+            x, lu = torch.solve(b, A)
+            self.assertEqual(x, per_matrix(lambda b, A: torch.solve(b, A)[0], b, A), prec)
+            self.assertEqual(lu, per_matrix(lambda b, A: torch.solve(b, A)[1], b, A), prec)
+            self.assertEqual(A.inverse(), per_matrix(torch.inverse, A), prec)
+            self.assertEqual(A.det(), per_matrix(torch.det, A), prec)
+            self.assertEqual(A.transpose(-2, -1).det(), A.det(), prec)
+            P = random_symmetric_pd_matrix(n, 13).add_(torch.eye(n)).to(dtype)
+            self.assertEqual(P.cholesky(upper), per_matrix(lambda m: m.cholesky(upper), P), prec)
+            self.assertEqual(torch.bmm(A, b), per_matrix(torch.mm, A, b), prec)
+            self.assertEqual(torch.bmm(A.transpose(-2, -1), b),
+                             per_matrix(torch.mm, A.transpose(-2, -1), b), prec)
+            C = torch.randn(13, n, 3, dtype=dtype)
+            self.assertEqual(torch.baddbmm(C, A, b, beta=0.5, alpha=2),
+                             0.5 * C + 2 * per_matrix(torch.mm, A, b), prec)
+
+            # errors name the first failing matrix, as with LAPACK
+            A[4].zero_()
+            A[9].zero_()
+            self.assertEqual(A.det()[4], 0)
+            with self.assertRaisesRegex(RuntimeError, r'For batch 4: U\(1,1\) is zero'):
+                A.inverse()
+            with self.assertRaisesRegex(RuntimeError, r'For batch 4: U\(1,1\) is zero'):
+                torch.solve(b, A)
+            P[6, n - 1, n - 1] = -1
+            with self.assertRaisesRegex(RuntimeError, r'For batch 6: U\({0},{0}\) is zero'.format(n)):
+                P.cholesky(upper)
+
     @staticmethod
     def _test_cholesky_solve(self, cast):
         a = torch.Tensor(((6.80, -2.11, 5.66, 5.97, 8.23),
@@ -8563,6 +8653,44 @@ class _TestTorchMixin(torchtest):
                                                 [False, True, False, True, False],
                                                 [True, False, True, False, True]], device=device))
 
+    def test_scatter_add_large(self):
+        # large enough to sum on several threads, with few and many duplicates
+        for dim, num_rows in ((0, 1), (0, 4), (1, 2)):
+            for num_targets in (7, 100000):
+                size = [num_rows, num_rows]
+                size[dim] = num_targets
+                idx_size = [num_rows, num_rows]
+                idx_size[dim] = 1 << 17
+                base = torch.randn(*size, dtype=torch.double)
+                src = torch.randn(*idx_size, dtype=torch.double)
+                idx = torch.randint(num_targets, idx_size)
+                actual = base.clone().scatter_add_(dim, idx, src)
+                expected = base.clone()
+                for i in range(num_rows):
+                    if dim == 0:
+                        expected[:, i] += torch.zeros(num_targets, dtype=torch.double).index_add_(0, idx[:, i], src[:, i])
+                    else:
+                        expected[i] += torch.zeros(num_targets, dtype=torch.double).index_add_(0, idx[i], src[i])
+                self.assertEqual(actual, expected, 1e-9)
+
+                idx.view(-1)[-1] = num_targets
+                self.assertRaises(RuntimeError, lambda: base.clone().scatter_add_(dim, idx, src))
+
+    def test_index_put_accumulate_large(self):
+        # large enough to sum on several threads, with few and many duplicates
+        for num_targets in (7, 100000):
+            base = torch.randn(num_targets, 3, dtype=torch.double)
+            src = torch.randn(1 << 16, 3, dtype=torch.double)
+            idx = torch.randint(num_targets, (1 << 16,))
+            actual = base.clone().index_put_((idx,), src, accumulate=True)
+            expected = base.clone().index_add_(0, idx, src)
+            self.assertEqual(actual, expected, 1e-9)
+
+            ints = torch.randint(100, (num_targets, 3))
+            int_src = torch.randint(100, (1 << 16, 3))
+            self.assertEqual(ints.clone().index_put_((idx,), int_src, accumulate=True),
+                             ints.clone().index_add_(0, idx, int_src))
+
     def test_masked_scatter(self):
         with warnings.catch_warnings(record=True) as w:
             for maskType in [torch.uint8, torch.bool]:
@@ -12166,6 +12294,32 @@ tensor([[[1., 1., 1.,  ..., 1., 1., 1.],
         if torch.cuda.is_available():
             run_test(torch.device('cuda'))
 
+    @unittest.skipIf(not TEST_NUMPY, "Numpy not found")
+    def test_unique_large(self):
+        # large enough to be split between threads
+        for dtype in [torch.long, torch.int, torch.double]:
+            x = torch.randint(-1000, 1000, (300000,)).to(dtype)
+            unique, inverse, counts = torch.unique(x, sorted=True, return_inverse=True, return_counts=True)
+            expected_unique, expected_inverse, expected_counts = np.unique(
+                x.numpy(), return_inverse=True, return_counts=True)
+            self.assertEqual(unique, torch.from_numpy(expected_unique))
+            self.assertEqual(inverse, torch.from_numpy(expected_inverse))
+            self.assertEqual(counts, torch.from_numpy(expected_counts))
+
+            unique, inverse, counts = torch.unique(x, sorted=False, return_inverse=True, return_counts=True)
+            self.assertEqual(unique.sort()[0], torch.from_numpy(expected_unique))
+            self.assertEqual(unique[inverse], x)
+            self.assertEqual(counts.sum(), x.numel())
+            self.assertEqual(counts[inverse], torch.from_numpy(expected_counts)[expected_inverse])
+
+        x = torch.randint(0, 3, (100000, 4))
+        unique, inverse, counts = torch.unique(x, dim=0, return_inverse=True, return_counts=True)
+        expected_unique, expected_inverse, expected_counts = np.unique(
+            x.numpy(), axis=0, return_inverse=True, return_counts=True)
+        self.assertEqual(unique, torch.from_numpy(expected_unique))
+        self.assertEqual(inverse, torch.from_numpy(expected_inverse))
+        self.assertEqual(counts, torch.from_numpy(expected_counts))
+
     def test_unique_dim(self):
         self.assertFalse(hasattr(torch, 'unique_dim'))
 
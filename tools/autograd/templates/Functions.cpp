@@ -13,6 +13,7 @@
 #include <ATen/SparseTensorUtils.h>
 #include <ATen/ExpandUtils.h>
 #include <ATen/core/Reduction.h>
+#include <ATen/native/Loss.h>
 
 #include <ciso646>
 #include <algorithm>
@@ -505,7 +506,7 @@ Tensor clamp_backward(const Tensor & grad, const Tensor &self, const optional<Sc
 
 Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, const Tensor & mat1, const Scalar & alpha) {
   // if input was column-major, return grad as column-order for efficiency
-  if (mat1.is_sparse()) {
+  if (mat1.is_sparse() || mat1.is_sparse_csr()) {
     throw std::runtime_error("calculating the gradient of a sparse Tensor argument to mm is not supported.");
   }
   at::IntArrayRef sizes = mat1.sizes();
@@ -518,6 +519,11 @@ Tensor mm_mat1_backward(const Tensor & grad, const Tensor & mat2, const Tensor &
 }
 
 Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef sizes, IntArrayRef strides, const Scalar & alpha) {
+  if (mat1.is_sparse_csr()) {
+    // CSR kernels are row-parallel, multiply by the transposed matrix
+    // instead of scattering into the rows of the gradient
+    return maybe_multiply(at::_sparse_csr_transpose(mat1).mm(grad), alpha);
+  }
   // if input was column-major, return grad as column-order for efficiency
   if (strides[0] == 1 && strides[1] == sizes[0]) {
     if (mat1.is_sparse()) {
@@ -537,6 +543,20 @@ Tensor mm_mat2_backward(const Tensor & grad, const Tensor & mat1, IntArrayRef si
   }
 }
 
+Tensor mv_vec_backward(const Tensor & grad, const Tensor & self) {
+  if (self.is_sparse_csr()) {
+    return at::_sparse_csr_transpose(self).mv(grad);
+  }
+  return self.t().mv(grad);
+}
+
+Tensor values_backward(const Tensor & grad, const Tensor & self) {
+  if (self.is_sparse_csr()) {
+    return at::_sparse_csr_tensor_unsafe(self.crow_indices(), self.col_indices(), grad, self.sizes(), grad.options().layout(kSparseCsr));
+  }
+  return at::_sparse_coo_tensor_unsafe(self.indices(), grad, self.sizes())._coalesced_(true);
+}
+
 Tensor _sparse_addmm_sparse_backward(const Tensor& grad, const Tensor& sparse_, const Tensor& dense, const Scalar& alpha) {
   AT_ASSERT(sparse_.is_sparse());
   auto sparse = sparse_.coalesce();
@@ -896,6 +916,33 @@ Tensor l1_loss_double_backward_grad_output(const Tensor & grad, const Tensor & i
   return output;
 }
 
+// The gradient of the cross entropy is row_scale * (softmax(input) - one_hot(target)).
+Tensor cross_entropy_double_backward(const Tensor & grad, const Tensor & grad_output, const Tensor & input, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index) {
+  Tensor safe_target, row_weights;
+  std::tie(safe_target, row_weights) = at::native::cross_entropy_row_weights(input, target, weight, ignore_index);
+  auto row_scale = row_weights * grad_output;
+  auto total_weight = row_weights.sum();
+  if (reduction == Reduction::Mean && total_weight.item<double>() != 0) {
+    row_scale = row_scale / total_weight;
+  }
+  auto probs = at::softmax(input, 1);
+  return row_scale.unsqueeze(1) * probs * (grad - (grad * probs).sum(1, true));
+}
+
+Tensor cross_entropy_double_backward_grad_output(const Tensor & grad, const Tensor & input, const Tensor & target, const Tensor & weight, int64_t reduction, int64_t ignore_index) {
+  Tensor safe_target, row_weights;
+  std::tie(safe_target, row_weights) = at::native::cross_entropy_row_weights(input, target, weight, ignore_index);
+  auto probs = at::softmax(input, 1);
+  auto output = row_weights * ((grad * probs).sum(1) - grad.gather(1, safe_target.unsqueeze(1)).squeeze(1));
+  auto total_weight = row_weights.sum();
+  if (reduction == Reduction::Mean && total_weight.item<double>() != 0) {
+    return output.sum() / total_weight;
+  } else if (reduction != Reduction::None) {
+    return output.sum();
+  }
+  return output;
+}
+
 Tensor smooth_l1_loss_double_backward(const Tensor & grad, const Tensor & input, const Tensor & target, int64_t reduction) {
   auto d = (input - target).abs();
   auto grad_input = grad * (d < 1).type_as(grad);
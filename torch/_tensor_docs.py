@@ -610,6 +610,17 @@ type as :attr:`self`.
     propagating to the cloned tensor will propagate to the original tensor.
 """)
 
+add_docstr_all('col_indices',
+               r"""
+col_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of the column indices of its non-zero values, stored row
+after row. Otherwise, this throws an error.
+
+See also :meth:`Tensor.crow_indices` and :meth:`Tensor.values`.
+""")
+
 add_docstr_all('contiguous',
                r"""
 contiguous() -> Tensor
@@ -675,6 +686,18 @@ If this object is already in CPU memory and on the correct device,
 then no copy is performed and the original object is returned.
 """)
 
+add_docstr_all('crow_indices',
+               r"""
+crow_indices() -> Tensor
+
+If :attr:`self` is a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout),
+this returns a view of its compressed row indices. The tensor has one more
+element than :attr:`self` has rows, and the non-zero values of row ``i`` are
+stored at positions ``crow_indices[i]`` to ``crow_indices[i + 1] - 1`` of
+:meth:`Tensor.col_indices` and :meth:`Tensor.values`. Otherwise, this throws
+an error.
+""")
+
 add_docstr_all('cross',
                r"""
 cross(other, dim=-1) -> Tensor
@@ -1129,11 +1152,11 @@ add_docstr_all('values',
                r"""
 values() -> Tensor
 
-If :attr:`self` is a sparse COO tensor (i.e., with ``torch.sparse_coo`` layout),
-this returns a view of the contained values tensor. Otherwise, this throws an
-error.
+If :attr:`self` is a sparse COO tensor (i.e., with ``torch.sparse_coo`` layout)
+or a sparse CSR tensor (i.e., with ``torch.sparse_csr`` layout), this returns a
+view of the contained values tensor. Otherwise, this throws an error.
 
-See also :meth:`Tensor.indices`.
+See also :meth:`Tensor.indices` and :meth:`Tensor.col_indices`.
 
 .. note::
   This method can only be called on a coalesced sparse tensor. See
@@ -2783,6 +2806,23 @@ Example::
            size=(3, 3), nnz=1, layout=torch.sparse_coo)
 """)
 
+add_docstr_all('to_sparse_csr',
+               r"""
+to_sparse_csr() -> Tensor
+Returns a copy of the matrix in compressed sparse row (CSR) format, i.e. with
+``torch.sparse_csr`` layout. Only 2-D strided and sparse COO tensors are
+supported.
+
+Example::
+
+    >>> d = torch.tensor([[0, 0, 0], [9, 0, 10], [0, 0, 0]])
+    >>> d.to_sparse_csr()
+    tensor(crow_indices=tensor([0, 0, 2, 2]),
+           col_indices=tensor([0, 2]),
+           values=tensor([ 9, 10]),
+           size=(3, 3), nnz=2, layout=torch.sparse_csr)
+""")
+
 add_docstr_all('to_mkldnn',
                r"""
 to_mkldnn() -> Tensor
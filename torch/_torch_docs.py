@@ -4734,6 +4734,45 @@ Example::
 .. _torch.sparse: https://pytorch.org/docs/stable/sparse.html
 """.format(**factory_common_args))
 
+add_docstr(torch.sparse_csr_tensor,
+           r"""
+sparse_csr_tensor(crow_indices, col_indices, values, size, dtype=None, device=None, requires_grad=False) -> Tensor
+
+Constructs a matrix in compressed sparse row (CSR) format with the given
+:attr:`values` at the given :attr:`col_indices`. The non-zero values of row
+``i`` are ``values[crow_indices[i]:crow_indices[i + 1]]``, and the column
+indices within a row must be sorted and unique. Compared to a sparse COO
+matrix, a CSR matrix stores one index per row instead of one per non-zero
+value, and its rows can be multiplied by a dense matrix independently of each
+other.
+
+Args:
+    crow_indices (array_like): 1-D data of size ``size[0] + 1`` with the
+        compressed row indices, starting at ``0`` and ending at the number of
+        non-zero values. Will be cast to a :class:`torch.LongTensor` internally.
+    col_indices (array_like): 1-D data with the column index of every
+        non-zero value. Will be cast to a :class:`torch.LongTensor` internally.
+    values (array_like): 1-D data with the non-zero values. Can be a list,
+        tuple, NumPy ``ndarray``, scalar, and other types.
+    size (list, tuple, or :class:`torch.Size`): size of the 2-D sparse tensor.
+    dtype (:class:`torch.dtype`, optional): the desired data type of returned tensor.
+        Default: if None, infers data type from :attr:`values`.
+    device (:class:`torch.device`, optional): the desired device of returned tensor.
+        Only the CPU is supported.
+    {requires_grad}
+
+Example::
+
+    >>> crow_indices = torch.tensor([0, 1, 3])
+    >>> col_indices = torch.tensor([2, 0, 2])
+    >>> values = torch.tensor([3., 4., 5.])
+    >>> torch.sparse_csr_tensor(crow_indices, col_indices, values, [2, 4])
+    tensor(crow_indices=tensor([0, 1, 3]),
+           col_indices=tensor([2, 0, 2]),
+           values=tensor([3., 4., 5.]),
+           size=(2, 4), nnz=3, layout=torch.sparse_csr)
+""".format(**factory_common_args))
+
 add_docstr(torch.sqrt,
            r"""
 sqrt(input, out=None) -> Tensor
@@ -0,0 +1,56 @@
+import sys
+import torch
+import types
+
+# This is the python mirror of c10::QEngine (c10/core/QEngine.h); keep the
+# two in sync.
+_qengines = ['fbgemm', 'qnnpack']
+
+
+def _get_qengine_id(qengine):
+    if qengine not in _qengines:
+        raise RuntimeError("unknown quantized engine: {}, expected one of {}".format(qengine, _qengines))
+    return _qengines.index(qengine)
+
+
+def _get_qengine_str(qengine):
+    return _qengines[qengine]
+
+
+class _QEngineProp(object):
+    def __get__(self, obj, objtype):
+        return _get_qengine_str(torch._C._get_qengine())
+
+    def __set__(self, obj, val):
+        torch._C._set_qengine(_get_qengine_id(val))
+
+
+class _SupportedQEnginesProp(object):
+    def __get__(self, obj, objtype):
+        return [_get_qengine_str(qe) for qe in torch._C._supported_qengines()]
+
+    def __set__(self, obj, val):
+        raise RuntimeError("Assignment not supported")
+
+
+class QuantizedEngine(types.ModuleType):
+    def __init__(self, m, name):
+        super(QuantizedEngine, self).__init__(name)
+        self.m = m
+
+    def __getattr__(self, attr):
+        return self.m.__getattribute__(attr)
+
+    # The engine that runs quantized::conv2d, quantized::linear and the other
+    # quantized operators with both an FBGEMM and a QNNPACK implementation:
+    #
+    #   torch.backends.quantized.engine = 'qnnpack'
+    #
+    # Packed weights are specific to the engine that created them, so set the
+    # engine before creating (or loading) the quantized model.
+    engine = _QEngineProp()
+    supported_engines = _SupportedQEnginesProp()
+
+# This is the sys.modules replacement trick, see
+# https://stackoverflow.com/questions/2447353/getattr-on-a-module/7668273#7668273
+sys.modules[__name__] = QuantizedEngine(sys.modules[__name__], __name__)
@@ -130,6 +130,18 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def_readwrite("reduceOp", &::c10d::AllreduceOptions::reduceOp)
       .def_readwrite("timeout", &::c10d::AllreduceOptions::timeout);
 
+  py::class_<::c10d::AllreduceCoalescedOptions>(
+      module, "AllreduceCoalescedOptions")
+      .def(py::init<>())
+      .def_readwrite("reduceOp", &::c10d::AllreduceCoalescedOptions::reduceOp)
+      .def_readwrite(
+          "sparseDensityThreshold",
+          &::c10d::AllreduceCoalescedOptions::sparseDensityThreshold)
+      .def_readwrite(
+          "sparseCoalesceInputs",
+          &::c10d::AllreduceCoalescedOptions::sparseCoalesceInputs)
+      .def_readwrite("timeout", &::c10d::AllreduceCoalescedOptions::timeout);
+
   py::class_<::c10d::ReduceOptions>(module, "ReduceOptions")
       .def(py::init<>())
       .def_readwrite("reduceOp", &::c10d::ReduceOptions::reduceOp)
@@ -203,7 +215,94 @@ They are used in specifying strategies for reduction collectives, e.g.,
                  const std::chrono::milliseconds& timeout) {
                 store.wait(keys, timeout);
               },
-              py::call_guard<py::gil_scoped_release>());
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_set",
+              [](::c10d::Store& store,
+                 const std::vector<std::string>& keys,
+                 const std::vector<std::string>& values) {
+                std::vector<std::vector<uint8_t>> values_;
+                values_.reserve(values.size());
+                for (const auto& value : values) {
+                  values_.emplace_back(value.begin(), value.end());
+                }
+                store.multiSet(keys, values_);
+              },
+              py::call_guard<py::gil_scoped_release>())
+          .def(
+              "multi_get",
+              [](::c10d::Store& store, const std::vector<std::string>& keys) {
+                std::vector<std::vector<uint8_t>> values;
+                {
+                  py::gil_scoped_release release;
+                  values = store.multiGet(keys);
+                }
+                py::list result;
+                for (const auto& value : values) {
+                  result.append(py::bytes(
+                      reinterpret_cast<const char*>(value.data()),
+                      value.size()));
+                }
+                return result;
+              })
+          .def(
+              "compare_set",
+              [](::c10d::Store& store,
+                 const std::string& key,
+                 const std::string& expected_value,
+                 const std::string& desired_value) {
+                std::vector<uint8_t> value;
+                {
+                  py::gil_scoped_release release;
+                  value = store.compareSet(
+                      key,
+                      std::vector<uint8_t>(
+                          expected_value.begin(), expected_value.end()),
+                      std::vector<uint8_t>(
+                          desired_value.begin(), desired_value.end()));
+                }
+                return py::bytes(
+                    reinterpret_cast<const char*>(value.data()), value.size());
+              })
+          .def(
+              "watch_prefix",
+              [](::c10d::Store& store,
+                 const std::string& prefix,
+                 size_t min_keys) {
+                std::vector<std::pair<std::string, std::vector<uint8_t>>>
+                    entries;
+                {
+                  py::gil_scoped_release release;
+                  entries = store.watchPrefix(prefix, min_keys);
+                }
+                py::dict result;
+                for (const auto& entry : entries) {
+                  result[py::str(entry.first)] = py::bytes(
+                      reinterpret_cast<const char*>(entry.second.data()),
+                      entry.second.size());
+                }
+                return result;
+              })
+          .def(
+              "watch_prefix",
+              [](::c10d::Store& store,
+                 const std::string& prefix,
+                 size_t min_keys,
+                 const std::chrono::milliseconds& timeout) {
+                std::vector<std::pair<std::string, std::vector<uint8_t>>>
+                    entries;
+                {
+                  py::gil_scoped_release release;
+                  entries = store.watchPrefix(prefix, min_keys, timeout);
+                }
+                py::dict result;
+                for (const auto& entry : entries) {
+                  result[py::str(entry.first)] = py::bytes(
+                      reinterpret_cast<const char*>(entry.second.data()),
+                      entry.second.size());
+                }
+                return result;
+              });
 
   shared_ptr_class_<::c10d::FileStore>(module, "FileStore", store)
       .def(py::init<const std::string&, int>());
@@ -270,6 +369,13 @@ They are used in specifying strategies for reduction collectives, e.g.,
               py::arg("op") = ::c10d::ReduceOp::SUM,
               py::call_guard<py::gil_scoped_release>())
 
+          .def(
+              "allreduce_coalesced",
+              &::c10d::ProcessGroup::allreduce_coalesced,
+              py::arg("tensors"),
+              py::arg("opts") = ::c10d::AllreduceCoalescedOptions(),
+              py::call_guard<py::gil_scoped_release>())
+
           .def(
               "reduce",
               &::c10d::ProcessGroup::reduce,
@@ -426,7 +532,9 @@ They are used in specifying strategies for reduction collectives, e.g.,
       .def(py::init<>())
       .def_readwrite("devices", &::c10d::ProcessGroupGloo::Options::devices)
       .def_readwrite("timeout", &::c10d::ProcessGroupGloo::Options::timeout)
-      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads);
+      .def_readwrite("threads", &::c10d::ProcessGroupGloo::Options::threads)
+      .def_readwrite(
+          "chunkBytes", &::c10d::ProcessGroupGloo::Options::chunkBytes);
 
   processGroupGloo.def_static(
       "create_tcp_device",
@@ -224,12 +224,13 @@ void Reducer::mark_variable_ready_sparse(VariableIndex index) {
       grad.options().layout() == c10::kSparse,
       "Expected variable to have sparse gradient.");
 
-  // Sparse tensors cannot be grouped together with other sparse tensors
-  // in a single reduction operation like we can for dense tensors.
-  // Therefore, the `offsets` and `lengths` vectors in the bucket replica
-  // struct are empty, and there is no pre-existing accumulation tensor.
-  // Directly assign the sparse tensor to the `contents` field.
-  replica.contents = grad;
+  // Sparse tensors cannot be flattened into a single accumulation tensor
+  // like we can for dense tensors. Therefore, the `offsets` and `lengths`
+  // vectors in the bucket replica struct are empty, and there is no
+  // `contents` tensor. The gradients are reduced in place of the variables
+  // and handed to `allreduce_coalesced` as a list.
+  // Prescale to turn the global sum into the global average.
+  grad.div_(process_group_->getSize());
 }
 
 // The function `autograd_hook` is called after the gradient for a
@@ -319,7 +320,10 @@ void Reducer::mark_variable_ready(VariableIndex index) {
   // Check if this was the final gradient for this bucket.
   if (--replica.pending == 0) {
     // Prescale bucket contents to turn the global sum into the global average.
-    replica.contents.div_(process_group_->getSize());
+    // Sparse gradients have already been prescaled when marked ready.
+    if (!bucket.expect_sparse_gradient) {
+      replica.contents.div_(process_group_->getSize());
+    }
     // Kick off reduction if all replicas for this bucket are ready.
     if (--bucket.pending == 0) {
       mark_bucket_ready(bucket_index.bucket_index);
@@ -351,6 +355,11 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
   for (; next_bucket_ < buckets_.size() && buckets_[next_bucket_].pending == 0;
        next_bucket_++) {
     auto& bucket = buckets_[next_bucket_];
+    if (bucket.expect_sparse_gradient) {
+      bucket.work = reduce_bucket_sparse(bucket);
+      continue;
+    }
+
     std::vector<at::Tensor> tensors;
     tensors.reserve(bucket.replicas.size());
     for (const auto& replica : bucket.replicas) {
@@ -369,6 +378,28 @@ void Reducer::mark_bucket_ready(size_t bucket_index) {
   }
 }
 
+// All sparse gradients in a bucket are reduced by a single coalesced
+// allreduce, so that the number of collective rounds doesn't grow with the
+// number of sparse gradients. Process groups without a coalesced
+// implementation fall back to one allreduce per gradient. The gradients of
+// multiple model replicas are summed locally first.
+std::shared_ptr<c10d::ProcessGroup::Work> Reducer::reduce_bucket_sparse(
+    Bucket& bucket) {
+  const auto& replicas = bucket.replicas;
+  std::vector<at::Tensor> tensors;
+  tensors.reserve(replicas[0].variables.size());
+  for (size_t i = 0; i < replicas[0].variables.size(); i++) {
+    at::Tensor grad = replicas[0].variables[i].grad();
+    for (size_t replica_index = 1; replica_index < replicas.size();
+         replica_index++) {
+      const auto& other = replicas[replica_index].variables[i].grad();
+      grad = grad + other.to(grad.device());
+    }
+    tensors.push_back(std::move(grad));
+  }
+  return process_group_->allreduce_coalesced(tensors);
+}
+
 void Reducer::initialize_buckets(
     std::vector<std::vector<size_t>> bucket_indices) {
   std::lock_guard<std::mutex> lock(mutex_);
@@ -397,18 +428,16 @@ void Reducer::initialize_buckets(
     AT_ASSERTM(
         bucket_indices[bucket_index].size() > 0, "Empty bucket specified.");
 
-    // Variables that expect sparse gradients must have their own bucket.
-    if (bucket_indices[bucket_index].size() == 1) {
-      const auto variable_index = bucket_indices[bucket_index].front();
-      bucket.expect_sparse_gradient =
-          expect_sparse_gradients_[0][variable_index];
-    } else {
-      for (const auto variable_index : bucket_indices[bucket_index]) {
-        AT_ASSERTM(
-            !expect_sparse_gradients_[0][variable_index],
-            "Buckets with more than one variable cannot include variables ",
-            "that expect a sparse gradient.");
-      }
+    // Variables that expect sparse gradients can only share a bucket with
+    // other variables that expect sparse gradients.
+    bucket.expect_sparse_gradient =
+        expect_sparse_gradients_[0][bucket_indices[bucket_index].front()];
+    for (const auto variable_index : bucket_indices[bucket_index]) {
+      AT_ASSERTM(
+          expect_sparse_gradients_[0][variable_index] ==
+              bucket.expect_sparse_gradient,
+          "Buckets cannot mix variables that expect a sparse gradient ",
+          "with variables that expect a dense gradient.");
     }
 
     // Iterate over model replicas.
@@ -417,10 +446,24 @@ void Reducer::initialize_buckets(
       BucketReplica replica;
 
       if (bucket.expect_sparse_gradient) {
-        const auto variable_index = bucket_indices[bucket_index].front();
-        const auto& variable = replicas_[replica_index][variable_index];
-        AT_ASSERT(bucket_indices[bucket_index].size() == 1);
-        replica.variables = {variable};
+        // Sparse gradients are reduced with a single coalesced allreduce,
+        // which requires identical device and dtype.
+        for (const auto variable_index : bucket_indices[bucket_index]) {
+          AT_ASSERTM(
+              variable_index < replicas_[replica_index].size(),
+              "Out of range variable index specified.");
+          const auto& variable = replicas_[replica_index][variable_index];
+          if (!replica.variables.empty()) {
+            AT_ASSERTM(
+                variable.device() == replica.variables.front().device(),
+                "All parameters in a bucket must be ",
+                "placed on the same device.");
+            AT_ASSERTM(
+                variable.dtype() == replica.variables.front().dtype(),
+                "All parameters in a bucket must have the same dtype.");
+          }
+          replica.variables.push_back(variable);
+        }
       } else {
         at::TensorOptions options;
         size_t offset = 0;
@@ -594,18 +637,20 @@ void Reducer::finalize_bucket_dense(Bucket& bucket) {
   }
 }
 
-// A bucket with a single sparse tensor doesn't need to be unflattened,
-// but merely assigned to the corresponding variable its grad.
+// A bucket with sparse tensors doesn't need to be unflattened, but merely
+// assigned to the corresponding variables their grads. The coalesced
+// allreduce returns one result per variable, shared by all replicas.
 void Reducer::finalize_bucket_sparse(Bucket& bucket) {
   const auto result = bucket.work->result();
-  AT_ASSERT(bucket.replicas.size() == result.size());
-  for (size_t i = 0; i < bucket.replicas.size(); i++) {
-    auto& replica = bucket.replicas[i];
-    AT_ASSERT(replica.variables.size() == 1);
-    auto& variable = replica.variables.front();
-    // The c10d API doesn't work with torch::autograd::Variable. We have to
-    // manually box it when assigning to the grad. See #19145.
-    variable.grad() = torch::autograd::make_variable(result[i]);
+  for (auto& replica : bucket.replicas) {
+    AT_ASSERT(replica.variables.size() == result.size());
+    for (size_t i = 0; i < replica.variables.size(); i++) {
+      auto& variable = replica.variables[i];
+      // The c10d API doesn't work with torch::autograd::Variable. We have to
+      // manually box it when assigning to the grad. See #19145.
+      variable.grad() =
+          torch::autograd::make_variable(result[i].to(variable.device()));
+    }
   }
 }
 
@@ -692,28 +737,39 @@ std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
   std::unordered_map<BucketKey, BucketAccumulator, torch::hash<BucketKey>>
       buckets;
 
+  // Tensors that expect a sparse gradient are only grouped with each other,
+  // by type and device, with the same size limits as dense tensors applied
+  // to the size of their dense tensors.
+  std::unordered_map<
+      BucketKey,
+      std::vector<size_t>::const_iterator,
+      torch::hash<BucketKey>>
+      sparse_bucket_size_limit_iterators;
+  std::unordered_map<BucketKey, BucketAccumulator, torch::hash<BucketKey>>
+      sparse_buckets;
+
   for (size_t i = 0; i < tensors.size(); i++) {
     const auto& tensor = tensors[i];
     AT_ASSERTM(!tensor.is_sparse(), "No support for sparse tensors.");
 
-    // If we expect a sparse gradient to be produced for this tensor, it cannot
-    // be grouped together with other gradients and gets its own bucket.
-    if (!expect_sparse_gradient.empty() && expect_sparse_gradient[i]) {
-      result.push_back({i});
-      continue;
-    }
-
     auto key = BucketKey(tensor.scalar_type(), tensor.device());
-    auto& bucket = buckets[key];
+
+    // If we expect a sparse gradient to be produced for this tensor, it can
+    // only be grouped together with other sparse gradients.
+    const bool sparse =
+        !expect_sparse_gradient.empty() && expect_sparse_gradient[i];
+    auto& bucket = sparse ? sparse_buckets[key] : buckets[key];
+    auto& size_limit_iterators = sparse ? sparse_bucket_size_limit_iterators
+                                        : bucket_size_limit_iterators;
     bucket.indices.push_back(i);
     bucket.size += tensor.numel() * tensor.element_size();
 
     // Initialize bucket size limit iterator if necessary.
-    if (bucket_size_limit_iterators.count(key) == 0) {
-      bucket_size_limit_iterators[key] = bucket_size_limits.begin();
+    if (size_limit_iterators.count(key) == 0) {
+      size_limit_iterators[key] = bucket_size_limits.begin();
     }
 
-    auto& bucket_size_limit_iterator = bucket_size_limit_iterators[key];
+    auto& bucket_size_limit_iterator = size_limit_iterators[key];
     const auto bucket_size_limit = *bucket_size_limit_iterator;
     if (bucket.size >= bucket_size_limit) {
       result.emplace_back(std::move(bucket.indices));
@@ -735,6 +791,14 @@ std::vector<std::vector<size_t>> compute_bucket_assignment_by_size(
     }
   }
 
+  // Add remaining sparse buckets.
+  for (auto& it : sparse_buckets) {
+    auto& bucket = it.second;
+    if (!bucket.indices.empty()) {
+      result.emplace_back(std::move(bucket.indices));
+    }
+  }
+
   // Sort resulting buckets by the minimum tensor index they include.
   // We assume that the order of the tensors is the order in which they are
   // used (or the reverse order in which their gradients are produced).
@@ -85,6 +85,9 @@ class Reducer {
 
   void mark_bucket_ready(size_t bucket_index);
 
+  std::shared_ptr<c10d::ProcessGroup::Work> reduce_bucket_sparse(
+      Bucket& bucket);
+
   void finalize_bucket_dense(Bucket& replica);
 
   void finalize_bucket_sparse(Bucket& replica);
@@ -140,8 +143,9 @@ class Reducer {
     // Keep work handle around when this set of buckets is being reduced.
     std::shared_ptr<c10d::ProcessGroup::Work> work;
 
-    // If this bucket should expect a single sparse gradient.
-    // Implies: replicas[i].variables.size() == 1.
+    // If this bucket should expect sparse gradients.
+    // Implies: replicas[i].contents is undefined and the gradients of
+    // replicas[i].variables are reduced directly.
     bool expect_sparse_gradient = false;
   };
 
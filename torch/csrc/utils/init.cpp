@@ -54,6 +54,28 @@ void initThroughputBenchmarkBindings(PyObject* module) {
   m.def("_disable_mkldnn_conv", []() {
     at::native::disable_mkldnn_conv.exchange(true);
   });
+
+  m.def("_get_cpu_conv_algorithm", []() {
+    switch (at::native::cpu_conv_algorithm.load()) {
+      case at::native::CpuConvAlgorithm::Gemm: return "gemm";
+      case at::native::CpuConvAlgorithm::Winograd: return "winograd";
+      case at::native::CpuConvAlgorithm::Direct: return "direct";
+      default: return "auto";
+    }
+  });
+  m.def("_set_cpu_conv_algorithm", [](const std::string& algorithm) {
+    if (algorithm == "auto") {
+      at::native::cpu_conv_algorithm.store(at::native::CpuConvAlgorithm::Auto);
+    } else if (algorithm == "gemm") {
+      at::native::cpu_conv_algorithm.store(at::native::CpuConvAlgorithm::Gemm);
+    } else if (algorithm == "winograd") {
+      at::native::cpu_conv_algorithm.store(at::native::CpuConvAlgorithm::Winograd);
+    } else if (algorithm == "direct") {
+      at::native::cpu_conv_algorithm.store(at::native::CpuConvAlgorithm::Direct);
+    } else {
+      AT_ERROR("_set_cpu_conv_algorithm: expected one of 'auto', 'gemm', 'winograd' or 'direct', but got '", algorithm, "'");
+    }
+  });
 }
 
 } // namespace throughput_benchmark
@@ -39,6 +39,13 @@ void initializeLayouts() {
     throw python_error();
   }
   registerLayoutObject((THPLayout*)mkldnn_layout, at::Backend::MkldnnCPU);
+
+  PyObject *sparse_csr_layout = THPLayout_New(at::Layout::SparseCsr, "torch.sparse_csr");
+  Py_INCREF(sparse_csr_layout);
+  if (PyModule_AddObject(torch_module, "sparse_csr", sparse_csr_layout) != 0) {
+    throw python_error();
+  }
+  registerLayoutObject((THPLayout*)sparse_csr_layout, at::Backend::SparseCsrCPU);
 }
 
 }} // namespace torch::utils
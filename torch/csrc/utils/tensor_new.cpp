@@ -553,6 +553,27 @@ Tensor sparse_coo_tensor_ctor(c10::TensorTypeId type_id, at::ScalarType scalar_t
   throw std::runtime_error("sparse_coo_tensor(): invalid arguments");
 }
 
+Tensor sparse_csr_tensor_ctor(c10::TensorTypeId type_id, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
+  static PythonArgParser parser({
+    "sparse_csr_tensor(PyObject* crow_indices, PyObject* col_indices, PyObject* values, IntArrayRef size, *, ScalarType dtype=None, Device? device=None, bool requires_grad=False)",
+  });
+
+  ParsedArgs<7> parsed_args;
+  auto r = parser.parse(args, kwargs, parsed_args);
+  if (r.idx == 0) {
+    bool type_inference = r.isNone(4);
+    const auto inferred_type_id = denseTypeIdWithDefault(r, 5, type_id);
+    const auto inferred_scalar_type = r.scalartypeWithDefault(4, scalar_type);
+    at::OptionalDeviceGuard device_guard(r.deviceOptional(5));
+    // if no dtype provided, infer type based on value type.
+    Tensor values = internal_new_from_data(inferred_type_id, inferred_scalar_type, r.deviceOptional(5), r.pyobject(2), false, true, type_inference);
+    Tensor crow_indices = internal_new_from_data(values.type_id(), kLong, r.deviceOptional(5), r.pyobject(0), false, true, false);
+    Tensor col_indices = internal_new_from_data(values.type_id(), kLong, r.deviceOptional(5), r.pyobject(1), false, true, false);
+    return at::sparse_csr_tensor(crow_indices, col_indices, values, r.intlist(3), values.options().layout(at::kSparseCsr)).set_requires_grad(r.toBool(6));
+  }
+  throw std::runtime_error("sparse_csr_tensor(): invalid arguments");
+}
+
 Tensor tensor_ctor(c10::TensorTypeId type_id, at::ScalarType scalar_type, PyObject* args, PyObject* kwargs) {
   static PythonArgParser parser({
     "tensor(PyObject* data, *, ScalarType dtype=None, Device? device=None, bool pin_memory=False, bool requires_grad=False)",
@@ -7,6 +7,7 @@
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <functional>
@@ -239,6 +240,44 @@ void FileStore::set(const std::string& key, const std::vector<uint8_t>& value) {
   file.write(value);
 }
 
+void FileStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet requires the same number of keys and values");
+  }
+  File file(path_, O_RDWR | O_CREAT, timeout_);
+  auto lock = file.lockExclusive();
+  file.seek(0, SEEK_END);
+  for (size_t i = 0; i < keys.size(); i++) {
+    file.write(regularPrefix_ + keys[i]);
+    file.write(values[i]);
+  }
+}
+
+std::vector<uint8_t> FileStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  File file(path_, O_RDWR | O_CREAT, timeout_);
+  auto lock = file.lockExclusive();
+  pos_ = refresh(file, pos_, cache_);
+
+  auto it = cache_.find(regKey);
+  const bool matches = it == cache_.end() ? expectedValue.empty()
+                                          : it->second == expectedValue;
+  if (!matches) {
+    return it == cache_.end() ? std::vector<uint8_t>() : it->second;
+  }
+  // Always seek to the end to write
+  file.seek(0, SEEK_END);
+  file.write(regKey);
+  file.write(desiredValue);
+  return desiredValue;
+}
+
 std::vector<uint8_t> FileStore::get(const std::string& key) {
   std::string regKey = regularPrefix_ + key;
   const auto start = std::chrono::steady_clock::now();
@@ -331,4 +370,45 @@ void FileStore::wait(
   }
 }
 
+std::vector<std::pair<std::string, std::vector<uint8_t>>> FileStore::
+    watchPrefix(const std::string& prefix, size_t minKeys) {
+  return watchPrefix(prefix, minKeys, timeout_);
+}
+
+std::vector<std::pair<std::string, std::vector<uint8_t>>> FileStore::
+    watchPrefix(
+        const std::string& prefix,
+        size_t minKeys,
+        const std::chrono::milliseconds& timeout) {
+  std::string regPrefix = regularPrefix_ + prefix;
+  const auto start = std::chrono::steady_clock::now();
+  while (true) {
+    {
+      File file(path_, O_RDONLY, timeout_);
+      auto lock = file.lockShared();
+      pos_ = refresh(file, pos_, cache_);
+    }
+
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> entries;
+    for (const auto& entry : cache_) {
+      if (entry.first.compare(0, regPrefix.size(), regPrefix) == 0) {
+        entries.emplace_back(
+            entry.first.substr(regularPrefix_.size()), entry.second);
+      }
+    }
+    if (entries.size() >= minKeys) {
+      std::sort(entries.begin(), entries.end());
+      return entries;
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now() - start);
+    if (timeout != kNoTimeout && elapsed > timeout) {
+      throw std::runtime_error("Wait timeout");
+    }
+    /* sleep override */
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+}
+
 } // namespace c10d
@@ -28,6 +28,24 @@ class FileStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> watchPrefix(
+      const std::string& prefix,
+      size_t minKeys) override;
+
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> watchPrefix(
+      const std::string& prefix,
+      size_t minKeys,
+      const std::chrono::milliseconds& timeout) override;
+
  protected:
   int64_t addHelper(const std::string& key, int64_t i);
 
@@ -19,6 +19,16 @@ std::vector<std::string> PrefixStore::joinKeys(
   return joinedKeys;
 }
 
+std::vector<std::pair<std::string, std::vector<uint8_t>>> PrefixStore::
+    splitKeys(
+        std::vector<std::pair<std::string, std::vector<uint8_t>>> entries) {
+  const auto prefixSize = joinKey("").size();
+  for (auto& entry : entries) {
+    entry.first = entry.first.substr(prefixSize);
+  }
+  return entries;
+}
+
 void PrefixStore::set(
     const std::string& key,
     const std::vector<uint8_t>& value) {
@@ -50,4 +60,37 @@ void PrefixStore::wait(
   store_.wait(joinedKeys, timeout);
 }
 
+void PrefixStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  auto joinedKeys = joinKeys(keys);
+  store_.multiSet(joinedKeys, values);
+}
+
+std::vector<std::vector<uint8_t>> PrefixStore::multiGet(
+    const std::vector<std::string>& keys) {
+  auto joinedKeys = joinKeys(keys);
+  return store_.multiGet(joinedKeys);
+}
+
+std::vector<uint8_t> PrefixStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  return store_.compareSet(joinKey(key), expectedValue, desiredValue);
+}
+
+std::vector<std::pair<std::string, std::vector<uint8_t>>> PrefixStore::
+    watchPrefix(const std::string& prefix, size_t minKeys) {
+  return splitKeys(store_.watchPrefix(joinKey(prefix), minKeys));
+}
+
+std::vector<std::pair<std::string, std::vector<uint8_t>>> PrefixStore::
+    watchPrefix(
+        const std::string& prefix,
+        size_t minKeys,
+        const std::chrono::milliseconds& timeout) {
+  return splitKeys(store_.watchPrefix(joinKey(prefix), minKeys, timeout));
+}
+
 } // namespace c10d
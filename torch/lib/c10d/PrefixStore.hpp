@@ -24,12 +24,35 @@ class PrefixStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> watchPrefix(
+      const std::string& prefix,
+      size_t minKeys) override;
+
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> watchPrefix(
+      const std::string& prefix,
+      size_t minKeys,
+      const std::chrono::milliseconds& timeout) override;
+
  protected:
   std::string prefix_;
   Store& store_;
 
   std::string joinKey(const std::string& key);
   std::vector<std::string> joinKeys(const std::vector<std::string>& keys);
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> splitKeys(
+      std::vector<std::pair<std::string, std::vector<uint8_t>>> entries);
 };
 
 } // namespace c10d
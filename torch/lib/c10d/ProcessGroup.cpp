@@ -1,9 +1,75 @@
 #include <c10d/ProcessGroup.hpp>
 
+#include <algorithm>
+
 #include <c10/util/Logging.h>
 
 namespace c10d {
 
+namespace {
+
+// Work of the default allreduce_coalesced, which issues one allreduce per
+// tensor for process groups that have no coalesced implementation.
+class AllreduceCoalescedFallbackWork : public ProcessGroup::Work {
+ public:
+  explicit AllreduceCoalescedFallbackWork(
+      std::vector<std::shared_ptr<ProcessGroup::Work>> works)
+      : works_(std::move(works)) {}
+
+  bool isCompleted() override {
+    return std::all_of(
+        works_.begin(),
+        works_.end(),
+        [](const std::shared_ptr<ProcessGroup::Work>& work) {
+          return work->isCompleted();
+        });
+  }
+
+  bool isSuccess() const override {
+    return std::all_of(
+        works_.begin(),
+        works_.end(),
+        [](const std::shared_ptr<ProcessGroup::Work>& work) {
+          return work->isSuccess();
+        });
+  }
+
+  std::exception_ptr exception() const override {
+    for (const auto& work : works_) {
+      if (!work->isSuccess()) {
+        return work->exception();
+      }
+    }
+    return nullptr;
+  }
+
+  std::vector<at::Tensor> result() const override {
+    std::vector<at::Tensor> results;
+    results.reserve(works_.size());
+    for (const auto& work : works_) {
+      results.push_back(work->result().front());
+    }
+    return results;
+  }
+
+  void synchronize() override {
+    for (auto& work : works_) {
+      work->synchronize();
+    }
+  }
+
+  void wait() override {
+    for (auto& work : works_) {
+      work->wait();
+    }
+  }
+
+ private:
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works_;
+};
+
+} // namespace
+
 ProcessGroup::Work::~Work() {}
 
 bool ProcessGroup::Work::isCompleted() {
@@ -56,4 +122,19 @@ ProcessGroup::ProcessGroup(int rank, int size) : rank_(rank), size_(size) {
 
 ProcessGroup::~ProcessGroup() {}
 
+std::shared_ptr<ProcessGroup::Work> ProcessGroup::allreduce_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceCoalescedOptions& opts) {
+  AllreduceOptions allreduceOpts;
+  allreduceOpts.reduceOp = opts.reduceOp;
+  allreduceOpts.timeout = opts.timeout;
+  std::vector<std::shared_ptr<ProcessGroup::Work>> works;
+  works.reserve(tensors.size());
+  for (auto& tensor : tensors) {
+    std::vector<at::Tensor> data = {tensor};
+    works.push_back(allreduce(data, allreduceOpts));
+  }
+  return std::make_shared<AllreduceCoalescedFallbackWork>(std::move(works));
+}
+
 } // namespace c10d
@@ -111,6 +111,15 @@ class ProcessGroup {
       std::vector<at::Tensor>& data,
       const AllreduceOptions& opts = AllreduceOptions()) = 0;
 
+  // Reduces every tensor in the list across processes. Unlike `allreduce`,
+  // the tensors are distinct and may differ in shape; implementations batch
+  // them into as few collective operations as possible. The reduced tensors
+  // are available from `Work::result()`. The default implementation issues
+  // one `allreduce` per tensor.
+  virtual std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts = AllreduceCoalescedOptions());
+
   virtual std::shared_ptr<ProcessGroup::Work> reduce(
       std::vector<at::Tensor>& tensors,
       const ReduceOptions& opts = ReduceOptions()) = 0;
@@ -273,7 +273,9 @@ void ProcessGroupGloo::RecvWork::wait() {
 }
 
 ProcessGroupGloo::Options::Options()
-    : timeout(std::chrono::milliseconds(10 * 1000)), threads(2) {}
+    : timeout(std::chrono::milliseconds(10 * 1000)),
+      threads(2),
+      chunkBytes(4 * 1024 * 1024) {}
 
 ProcessGroupGloo::ProcessGroupGloo(
     const std::shared_ptr<Store>& store,
@@ -283,6 +285,7 @@ ProcessGroupGloo::ProcessGroupGloo(
     : ProcessGroup(rank, size),
       store_(new GlooStore(store)),
       stop_(false),
+      chunkBytes_(options.chunkBytes),
       collectiveCounter_(0) {
   auto& devices = options.devices;
   if (devices.empty()) {
@@ -340,8 +343,10 @@ ProcessGroupGloo::~ProcessGroupGloo() {
   }
 }
 
-uint32_t ProcessGroupGloo::nextTag() {
-  return collectiveCounter_++;
+uint32_t ProcessGroupGloo::nextTag(uint32_t count) {
+  auto tag = collectiveCounter_;
+  collectiveCounter_ += count;
+  return tag;
 }
 
 std::shared_ptr<::gloo::Context> ProcessGroupGloo::getContext(uint32_t tag) {
@@ -357,7 +362,8 @@ void ProcessGroupGloo::runLoop(int workerIndex) {
       continue;
     }
 
-    auto work = std::move(workQueue_.front());
+    auto work = std::move(workQueue_.front().first);
+    auto step = workQueue_.front().second;
     workQueue_.pop_front();
     workInProgress_[workerIndex] = work;
     lock.unlock();
@@ -366,20 +372,27 @@ void ProcessGroupGloo::runLoop(int workerIndex) {
     // does not immediately block.
     workConsumeCV_.notify_one();
 
-    AsyncWork::execute(std::move(work));
+    AsyncWork::execute(std::move(work), step);
     lock.lock();
     workInProgress_[workerIndex] = nullptr;
   }
 }
 
 void ProcessGroupGloo::enqueue(std::shared_ptr<AsyncWork> work) {
+  const auto steps = work->numSteps();
   std::unique_lock<std::mutex> lock(workMutex_);
-  workQueue_.push_back(std::move(work));
+  for (size_t step = 0; step < steps; step++) {
+    workQueue_.emplace_back(work, step);
+  }
   lock.unlock();
 
   // Notify after releasing the lock so that the waiter
   // does not immediately block.
-  workProduceCV_.notify_one();
+  if (steps == 1) {
+    workProduceCV_.notify_one();
+  } else {
+    workProduceCV_.notify_all();
+  }
 }
 
 namespace {
@@ -537,32 +550,88 @@ class AsyncAllreduceWork : public ProcessGroupGloo::AsyncWork {
       const std::shared_ptr<gloo::Context>& context,
       std::vector<at::Tensor>& inputs,
       ReduceOp reduceOp,
-      uint32_t tag)
-      : context(context), inputs(inputs), reduceOp(reduceOp), tag(tag) {}
+      uint32_t tag,
+      int64_t chunkSize)
+      : context(context),
+        inputs(inputs),
+        reduceOp(reduceOp),
+        tag(tag),
+        chunkSize(chunkSize),
+        chunks(numChunks(inputs, chunkSize)) {}
 
+  // The chunks may run concurrently on the same context, like any two work
+  // items do; their distinct tags keep their messages apart.
   std::shared_ptr<gloo::Context> context;
   std::vector<at::Tensor> inputs;
   const ReduceOp reduceOp;
+  // Chunk i is reduced with tag `tag + i`.
   const uint32_t tag;
+  // Number of elements per chunk (the last chunk may be smaller).
+  const int64_t chunkSize;
+  const size_t chunks;
+
+  // Returns the number of chunks the inputs are split into. Only contiguous
+  // tensors are chunked. The caller must reserve as many tags.
+  static size_t numChunks(
+      const std::vector<at::Tensor>& tensors,
+      int64_t chunkSize) {
+    const auto numel = tensors[0].numel();
+    if (chunkSize <= 0 || numel <= chunkSize) {
+      return 1;
+    }
+    for (const auto& tensor : tensors) {
+      if (!tensor.is_contiguous()) {
+        return 1;
+      }
+    }
+    return (numel + chunkSize - 1) / chunkSize;
+  }
+
+  // Returns flat views of the specified chunk of every tensor.
+  std::vector<at::Tensor> chunk(std::vector<at::Tensor>& tensors, size_t i) {
+    if (chunks == 1) {
+      return tensors;
+    }
+    const auto offset = static_cast<int64_t>(i) * chunkSize;
+    const auto length = std::min(chunkSize, tensors[0].numel() - offset);
+    std::vector<at::Tensor> views;
+    views.reserve(tensors.size());
+    for (auto& tensor : tensors) {
+      views.push_back(tensor.view(-1).narrow(0, offset, length));
+    }
+    return views;
+  }
 
-  void allreduce(std::vector<at::Tensor>& tensors) {
+  void allreduce(std::vector<at::Tensor>& tensors, size_t step) {
     const auto& scalarType = tensors[0].scalar_type();
     gloo::AllreduceOptions opts(context);
     opts.setReduceFunction(getFunction(scalarType, reduceOp));
-    opts.setTag(tag);
+    opts.setTag(tag + step);
     GENERATE_ALL_TYPES(scalarType, setOutputs, opts, tensors);
     gloo::allreduce(opts);
   }
 
+  size_t numSteps() const override {
+    return chunks;
+  }
+
   void run() override {
-    allreduce(inputs);
+    for (size_t i = 0; i < chunks; i++) {
+      runStep(i);
+    }
+  }
+
+  void runStep(size_t step) override {
+    auto tensors = chunk(inputs, step);
+    allreduce(tensors, step);
 
     // Only the first output in the tensor list contains the results.
     // See https://github.com/facebookincubator/gloo/issues/152.
     // The contents is the same for every entry in the tensor list, so
     // we can use the first entry as the source of the copy below.
-    for (size_t i = 1; i < inputs.size(); i++) {
-      inputs[i].copy_(inputs[0]);
+    // This copy overlaps with the reduction of the other chunks.
+    for (size_t i = 1; i < tensors.size(); i++) {
+      tensors[i].copy_(tensors[0]);
     }
   }
 
@@ -828,40 +897,57 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
       const std::shared_ptr<gloo::Context>& context,
       std::vector<at::Tensor>& inputs,
       ReduceOp reduceOp,
-      uint32_t tag)
-      : AsyncAllreduceWork(context, inputs, reduceOp, tag) {
+      uint32_t tag,
+      int64_t chunkSize)
+      : AsyncAllreduceWork(context, inputs, reduceOp, tag, chunkSize) {
+    std::vector<at::cuda::CUDAEvent> events;
     initializeStreamsEvents(inputs, streams, events);
 
-    // Kick off copy from CUDA tensors to pinned CPU tensors.
+    // Kick off copy from CUDA tensors to pinned CPU tensors, one chunk at a
+    // time, such that the reduction of the first chunk can start before the
+    // remaining chunks have been copied.
     tmp.reserve(inputs.size());
-    at::cuda::OptionalCUDAStreamGuard guard;
     for (size_t i = 0; i < inputs.size(); i++) {
-      guard.reset_stream(streams[i]);
-      tmp.push_back(pinnedLike(inputs[i]).copy_(inputs[i], true));
+      tmp.push_back(pinnedLike(inputs[i]));
+    }
+    copyInEvents.resize(chunks * inputs.size());
+    copyOutEvents.resize(chunks * inputs.size());
+    at::cuda::OptionalCUDAStreamGuard guard;
+    for (size_t c = 0; c < chunks; c++) {
+      auto src = chunk(inputs, c);
+      auto dst = chunk(tmp, c);
+      for (size_t i = 0; i < inputs.size(); i++) {
+        guard.reset_stream(streams[i]);
+        dst[i].copy_(src[i], /* non_blocking */ true);
+        copyInEvents[c * inputs.size() + i].record(streams[i]);
+      }
     }
   }
 
-  void run() override {
-    // Synchronize with copy operations.
+  void runStep(size_t step) override {
+    // Synchronize with copy operations for this chunk.
     at::cuda::OptionalCUDAGuard device_guard;
     for (size_t i = 0; i < inputs.size(); i++) {
       device_guard.set_index(inputs[i].device().index());
-      AT_CUDA_CHECK(cudaStreamSynchronize(streams[i]));
+      copyInEvents[step * inputs.size() + i].synchronize();
     }
 
     // Run allreduce on host side tensors.
-    allreduce(tmp);
+    auto src = chunk(tmp, step);
+    allreduce(src, step);
 
-    // Kick off copy back to the CUDA tensors.
+    // Kick off copy back to the CUDA tensors. This copy overlaps with the
+    // reduction of the next chunks.
     // Only the first output in the tensor list contains the results.
     // See https://github.com/facebookincubator/gloo/issues/152.
     // The contents is the same for every entry in the tensor list, so
     // we can use the first entry as the source of the copy below.
+    auto dst = chunk(inputs, step);
     at::cuda::OptionalCUDAStreamGuard stream_guard;
     for (size_t i = 0; i < inputs.size(); i++) {
       stream_guard.reset_stream(streams[i]);
-      inputs[i].copy_(tmp[0], /* non_blocking */ true);
-      events[i].record(streams[i]);
+      dst[i].copy_(src[0], /* non_blocking */ true);
+      copyOutEvents[step * inputs.size() + i].record(streams[i]);
     }
   }
 
@@ -870,13 +956,19 @@ class AsyncAllreduceCUDAWork : public AsyncAllreduceWork {
     at::cuda::OptionalCUDAGuard guard;
     for (size_t i = 0; i < inputs.size(); i++) {
       guard.set_index(inputs[i].device().index());
-      events[i].block(at::cuda::getCurrentCUDAStream());
+      for (size_t c = 0; c < chunks; c++) {
+        copyOutEvents[c * inputs.size() + i].block(
+            at::cuda::getCurrentCUDAStream());
+      }
     }
   }
 
   std::vector<at::Tensor> tmp;
   std::vector<at::cuda::CUDAStream> streams;
-  std::vector<at::cuda::CUDAEvent> events;
+  // Indexed by chunk * inputs.size() + input. Every event is only
+  // touched by the step that owns its chunk.
+  std::vector<at::cuda::CUDAEvent> copyInEvents;
+  std::vector<at::cuda::CUDAEvent> copyOutEvents;
 };
 
 class AsyncSparseAllreduceCUDAWork : public AsyncSparseAllreduceWork {
@@ -967,13 +1059,23 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
         "(allreduce of sparse tensors only works with ReduceOp.SUM)");
   }
 
+  // Large dense inputs are reduced in chunks of chunkBytes_, each with their
+  // own tag, on the context of the work.
+  int64_t chunkSize = 0;
+  uint32_t numTags = 1;
+  if (layout == c10::kStrided && chunkBytes_ > 0) {
+    chunkSize = std::max<int64_t>(1, chunkBytes_ / inputs[0].element_size());
+    numTags = static_cast<uint32_t>(
+        AsyncAllreduceWork::numChunks(inputs, chunkSize));
+  }
+
   std::shared_ptr<AsyncWork> work;
-  auto tag = nextTag();
+  auto tag = nextTag(numTags);
   auto context = getContext(tag);
   if (device.type() == at::kCPU) {
     if (layout == c10::kStrided) {
       work = std::make_shared<AsyncAllreduceWork>(
-          std::move(context), inputs, opts.reduceOp, tag);
+          std::move(context), inputs, opts.reduceOp, tag, chunkSize);
     } else if (layout == c10::kSparse) {
       work = std::make_shared<AsyncSparseAllreduceWork>(
           std::move(context), inputs, tag);
@@ -984,7 +1086,7 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
   } else if (device.type() == at::kCUDA) {
     if (layout == c10::kStrided) {
       work = std::make_shared<AsyncAllreduceCUDAWork>(
-          std::move(context), inputs, opts.reduceOp, tag);
+          std::move(context), inputs, opts.reduceOp, tag, chunkSize);
     } else if (layout == c10::kSparse) {
       work = std::make_shared<AsyncSparseAllreduceCUDAWork>(
           std::move(context), inputs, tag);
@@ -1002,6 +1104,387 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce(
 
 namespace {
 
+class AsyncSparseAllreduceCoalescedWork : public ProcessGroupGloo::AsyncWork {
+ public:
+  using SparseTensorMetadata = AsyncSparseAllreduceWork::SparseTensorMetadata;
+
+  AsyncSparseAllreduceCoalescedWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      const AllreduceCoalescedOptions& opts,
+      uint32_t tag)
+      : context(context),
+        inputs(inputs),
+        densityThreshold(opts.sparseDensityThreshold),
+        coalesceInputs(opts.sparseCoalesceInputs),
+        tag(tag) {}
+
+  std::shared_ptr<gloo::Context> context;
+  std::vector<at::Tensor> inputs;
+  std::vector<at::Tensor> outputs;
+  const double densityThreshold;
+  const bool coalesceInputs;
+  const uint32_t tag;
+
+  // All tensors in the bucket share every collective, so the number of
+  // rounds is independent of the number of tensors:
+  //
+  //   1) allgather the metadata of all tensors;
+  //   2) allreduce the tensors that are too dense for a sparse reduction,
+  //      flattened into a single buffer;
+  //   3) allgather the indices of the remaining tensors, concatenated;
+  //   4) allgather their values, concatenated.
+  //
+  // Every process then builds the result for each sparse tensor from the
+  // gathered indices and values and coalesces it once.
+  std::vector<at::Tensor> allreduce(std::vector<at::Tensor>& tensors) {
+    const auto ntensors = tensors.size();
+    std::vector<at::Tensor> local;
+    local.reserve(ntensors);
+    for (auto& tensor : tensors) {
+      local.push_back(coalesceInputs ? tensor.coalesce() : tensor);
+    }
+
+    auto metadata = allgather_metadata(local);
+
+    // Sanity check dimensionality across ranks and decide which tensors are
+    // reduced as dense tensors. All ranks see the same metadata and
+    // therefore make the same decision.
+    std::vector<bool> reduceDense(ntensors);
+    for (size_t i = 0; i < ntensors; i++) {
+      const auto expected = metadata[context->rank][i].sizes();
+      int64_t totalNnz = 0;
+      for (auto rank = 0; rank < context->size; rank++) {
+        AT_CHECK(
+            metadata[rank][i].sizes() == expected,
+            "Sparse dimensions do not match");
+        totalNnz += metadata[rank][i].nnz();
+      }
+      int64_t numRows = 1;
+      for (int64_t dim = 0; dim < local[i].sparse_dim(); dim++) {
+        numRows *= local[i].size(dim);
+      }
+      reduceDense[i] = numRows > 0 &&
+          static_cast<double>(totalNnz) / numRows > densityThreshold;
+    }
+
+    std::vector<at::Tensor> results(ntensors);
+    allreduce_dense(local, reduceDense, results);
+    allreduce_sparse(local, metadata, reduceDense, results);
+    return results;
+  }
+
+  void run() override {
+    outputs = allreduce(inputs);
+  }
+
+  std::vector<at::Tensor> result() const override {
+    return outputs;
+  }
+
+ private:
+  // Returns the metadata of every tensor for every rank, indexed by rank
+  // first and by tensor second.
+  std::vector<std::vector<SparseTensorMetadata>> allgather_metadata(
+      const std::vector<at::Tensor>& tensors) {
+    auto buffer = at::zeros(
+        {context->size,
+         static_cast<int64_t>(tensors.size()),
+         SparseTensorMetadata::dim},
+        at::kLong);
+
+    std::vector<std::vector<SparseTensorMetadata>> metadata(context->size);
+    for (auto rank = 0; rank < context->size; rank++) {
+      metadata[rank].reserve(tensors.size());
+      for (size_t i = 0; i < tensors.size(); i++) {
+        metadata[rank].emplace_back(buffer.select(0, rank).select(0, i));
+      }
+    }
+
+    // Populate data for this rank
+    for (size_t i = 0; i < tensors.size(); i++) {
+      metadata[context->rank][i].populate_from_sparse_tensor(tensors[i]);
+    }
+
+    gloo::AllgatherOptions opts(context);
+    opts.setOutput(buffer.data_ptr<long>(), buffer.numel());
+    opts.setTag(tag);
+    gloo::allgather(opts);
+
+    return metadata;
+  }
+
+  void allreduce_dense(
+      const std::vector<at::Tensor>& tensors,
+      const std::vector<bool>& reduceDense,
+      std::vector<at::Tensor>& results) {
+    std::vector<at::Tensor> flat;
+    for (size_t i = 0; i < tensors.size(); i++) {
+      if (reduceDense[i]) {
+        flat.push_back(tensors[i].to_dense().view({-1}));
+      }
+    }
+    if (flat.empty()) {
+      return;
+    }
+
+    auto buffer = at::cat(flat);
+    gloo::AllreduceOptions opts(context);
+    GENERATE_ALL_TYPES(buffer.scalar_type(), setOutput, opts, buffer);
+    GENERATE_ALL_TYPES(buffer.scalar_type(), setSumFunction, opts);
+    opts.setTag(tag);
+    gloo::allreduce(opts);
+
+    // Hand back sparse tensors, callers expect the input layout.
+    int64_t offset = 0;
+    for (size_t i = 0; i < tensors.size(); i++) {
+      if (!reduceDense[i]) {
+        continue;
+      }
+      const auto numel = tensors[i].numel();
+      results[i] = buffer.narrow(0, offset, numel)
+                       .view(tensors[i].sizes())
+                       .to_sparse(tensors[i].sparse_dim());
+      offset += numel;
+    }
+  }
+
+  template <typename T>
+  static void setSumFunction(gloo::AllreduceOptions& opts) {
+    opts.setReduceFunction(toFunction<T>(ReduceOp::SUM));
+  }
+
+  void allreduce_sparse(
+      const std::vector<at::Tensor>& tensors,
+      const std::vector<std::vector<SparseTensorMetadata>>& metadata,
+      const std::vector<bool>& reduceDense,
+      std::vector<at::Tensor>& results) {
+    // Number of index and value elements every rank contributes.
+    std::vector<int64_t> numIndices(context->size, 0);
+    std::vector<int64_t> numValues(context->size, 0);
+    at::ScalarType scalarType = at::ScalarType::Undefined;
+    for (size_t i = 0; i < tensors.size(); i++) {
+      if (reduceDense[i]) {
+        continue;
+      }
+      scalarType = tensors[i].scalar_type();
+      const auto sparseDim = tensors[i].sparse_dim();
+      const auto valueNumel = valueNumelOf(tensors[i]);
+      for (auto rank = 0; rank < context->size; rank++) {
+        numIndices[rank] += sparseDim * metadata[rank][i].nnz();
+        numValues[rank] += valueNumel * metadata[rank][i].nnz();
+      }
+    }
+    if (scalarType == at::ScalarType::Undefined) {
+      return;
+    }
+
+    const auto maxIndices =
+        *std::max_element(numIndices.begin(), numIndices.end());
+    const auto maxValues = *std::max_element(numValues.begin(), numValues.end());
+
+    auto indicesBuffer = at::empty({context->size, maxIndices}, at::kLong);
+    auto valuesBuffer = at::empty({context->size, maxValues}, scalarType);
+    {
+      std::vector<at::Tensor> localIndices;
+      std::vector<at::Tensor> localValues;
+      for (size_t i = 0; i < tensors.size(); i++) {
+        if (!reduceDense[i]) {
+          localIndices.push_back(tensors[i]._indices().reshape({-1}));
+          localValues.push_back(tensors[i]._values().reshape({-1}));
+        }
+      }
+      auto rankIndices = indicesBuffer.select(0, context->rank);
+      auto rankValues = valuesBuffer.select(0, context->rank);
+      at::cat_out(
+          rankIndices.narrow(0, 0, numIndices[context->rank]), localIndices);
+      at::cat_out(
+          rankValues.narrow(0, 0, numValues[context->rank]), localValues);
+    }
+
+    // Skip the collectives altogether if no rank has any entries.
+    if (maxIndices > 0) {
+      gloo::AllgatherOptions opts(context);
+      opts.setOutput(indicesBuffer.data_ptr<long>(), indicesBuffer.numel());
+      opts.setTag(tag);
+      gloo::allgather(opts);
+    }
+    if (maxValues > 0) {
+      gloo::AllgatherOptions opts(context);
+      GENERATE_ALL_TYPES(scalarType, setOutput, opts, valuesBuffer);
+      opts.setTag(tag);
+      gloo::allgather(opts);
+    }
+
+    // Slice the gathered buffers back into per tensor pieces.
+    std::vector<int64_t> indexOffsets(context->size, 0);
+    std::vector<int64_t> valueOffsets(context->size, 0);
+    for (size_t i = 0; i < tensors.size(); i++) {
+      if (reduceDense[i]) {
+        continue;
+      }
+      const auto& tensor = tensors[i];
+      const auto sparseDim = tensor.sparse_dim();
+      const auto valueNumel = valueNumelOf(tensor);
+      auto valueShape = std::vector<int64_t>({-1});
+      const auto denseSizes = tensor.sizes().slice(sparseDim);
+      valueShape.insert(valueShape.end(), denseSizes.begin(), denseSizes.end());
+
+      std::vector<at::Tensor> indices;
+      std::vector<at::Tensor> values;
+      indices.reserve(context->size);
+      values.reserve(context->size);
+      for (auto rank = 0; rank < context->size; rank++) {
+        const auto nnz = metadata[rank][i].nnz();
+        indices.push_back(indicesBuffer.select(0, rank)
+                              .narrow(0, indexOffsets[rank], sparseDim * nnz)
+                              .view({sparseDim, nnz}));
+        values.push_back(valuesBuffer.select(0, rank)
+                             .narrow(0, valueOffsets[rank], valueNumel * nnz)
+                             .view(valueShape));
+        indexOffsets[rank] += sparseDim * nnz;
+        valueOffsets[rank] += valueNumel * nnz;
+      }
+
+      results[i] = at::sparse_coo_tensor(
+                       at::cat(indices, 1),
+                       at::cat(values, 0),
+                       tensor.sizes(),
+                       tensor.options())
+                       .coalesce();
+    }
+  }
+
+  static int64_t valueNumelOf(const at::Tensor& tensor) {
+    int64_t numel = 1;
+    for (auto dim = tensor.sparse_dim(); dim < tensor.dim(); dim++) {
+      numel *= tensor.size(dim);
+    }
+    return numel;
+  }
+};
+
+#ifdef USE_CUDA
+
+class AsyncSparseAllreduceCoalescedCUDAWork
+    : public AsyncSparseAllreduceCoalescedWork {
+ public:
+  AsyncSparseAllreduceCoalescedCUDAWork(
+      const std::shared_ptr<gloo::Context>& context,
+      std::vector<at::Tensor>& inputs,
+      const AllreduceCoalescedOptions& opts,
+      uint32_t tag)
+      : AsyncSparseAllreduceCoalescedWork(context, inputs, opts, tag) {
+    initializeStreamsEvents(inputs, streams, events);
+
+    // Kick off copy from CUDA tensors to CPU tensors.
+    // Note that both coalescing the sparse tensor and copying it to CPU
+    // memory must be performed asynchronously, or we block the caller.
+    tmp.reserve(inputs.size());
+    at::cuda::OptionalCUDAStreamGuard guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.reset_stream(streams[i]);
+      auto input = coalesceInputs ? inputs[i].coalesce() : inputs[i];
+      tmp.push_back(input.to(at::DeviceType::CPU, /*non_blocking=*/true));
+    }
+  }
+
+  void run() override {
+    // Synchronize with copy operations.
+    at::cuda::OptionalCUDAGuard device_guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      device_guard.set_index(inputs[i].device().index());
+      AT_CUDA_CHECK(cudaStreamSynchronize(streams[i]));
+    }
+
+    // Run allreduce on host side tensors.
+    auto results = allreduce(tmp);
+
+    // Kick off copy back to the CUDA tensors.
+    at::cuda::OptionalCUDAStreamGuard stream_guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      stream_guard.reset_stream(streams[i]);
+      outputs.push_back(
+          results[i].to(inputs[i].device(), /*non_blocking=*/true));
+      events[i].record(streams[i]);
+    }
+  }
+
+  void synchronize() override {
+    // Synchronize with the copy back to CUDA tensors.
+    at::cuda::OptionalCUDAGuard guard;
+    for (size_t i = 0; i < inputs.size(); i++) {
+      guard.set_index(inputs[i].device().index());
+      events[i].block(at::cuda::getCurrentCUDAStream());
+    }
+  }
+
+  std::vector<at::Tensor> tmp;
+  std::vector<at::cuda::CUDAStream> streams;
+  std::vector<at::cuda::CUDAEvent> events;
+};
+
+#endif
+
+} // namespace
+
+std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::allreduce_coalesced(
+    std::vector<at::Tensor>& tensors,
+    const AllreduceCoalescedOptions& opts) {
+  static auto invalidArgument = [](const std::string& msg) {
+    throw std::invalid_argument("ProcessGroupGloo::allreduce_coalesced: " + msg);
+  };
+
+  assertNonEmpty(invalidArgument, tensors);
+  assertLayoutMatch(invalidArgument, tensors);
+  if (tensors[0].layout() != c10::kSparse) {
+    invalidArgument(
+        "unsupported layout (only sparse tensors are supported, "
+        "flatten dense tensors and use allreduce instead)");
+  }
+  if (opts.reduceOp != ReduceOp::SUM) {
+    invalidArgument(
+        "unsupported reduction operation "
+        "(allreduce of sparse tensors only works with ReduceOp.SUM)");
+  }
+
+  const auto& type = tensors[0].type();
+  for (size_t i = 1; i < tensors.size(); i++) {
+    assertTypeMatch(invalidArgument, type, tensors, i);
+  }
+
+  const auto& device = tensors[0].device();
+  switch (device.type()) {
+    case at::kCPU:
+#ifdef USE_CUDA
+    case at::kCUDA:
+#endif
+      break;
+    default:
+      invalidArgument("unsupported device type");
+  }
+
+  std::shared_ptr<AsyncWork> work;
+  auto tag = nextTag();
+  auto context = getContext(tag);
+  if (device.type() == at::kCPU) {
+    work = std::make_shared<AsyncSparseAllreduceCoalescedWork>(
+        std::move(context), tensors, opts, tag);
+#ifdef USE_CUDA
+  } else if (device.type() == at::kCUDA) {
+    work = std::make_shared<AsyncSparseAllreduceCoalescedCUDAWork>(
+        std::move(context), tensors, opts, tag);
+#endif
+  } else {
+    throw std::runtime_error("Invalid backend");
+  }
+
+  enqueue(work);
+  return work;
+}
+
+namespace {
+
 class AsyncReduceWork : public ProcessGroupGloo::AsyncWork {
  public:
   AsyncReduceWork(
@@ -1877,7 +2360,9 @@ std::shared_ptr<ProcessGroup::Work> ProcessGroupGloo::barrier(
     std::unique_lock<std::mutex> lock(workMutex_);
     priorWork.insert(
         priorWork.end(), workInProgress_.begin(), workInProgress_.end());
-    priorWork.insert(priorWork.end(), workQueue_.begin(), workQueue_.end());
+    for (const auto& entry : workQueue_) {
+      priorWork.push_back(entry.first);
+    }
   }
 
   auto tag = nextTag();
@@ -66,22 +66,57 @@ class ProcessGroupGloo : public ProcessGroup {
   // operations using the new AsyncWork base class. Over time we will port
   // all operations and perform needed cleanup.
   //
+  // Work can be split into a number of independent steps (e.g. the chunks
+  // of a large allreduce). Every step is queued separately, so steps of the
+  // same work can run concurrently on different worker threads, and work
+  // queued behind it can start as soon as its last step has been picked up,
+  // instead of when the entire work has completed. Steps are queued in
+  // submission order, which is identical across processes, so that every
+  // process starts them in the same order. The work is finished by whichever
+  // step completes last.
+  //
   class AsyncWork : public ProcessGroup::Work {
    public:
-    static void execute(std::shared_ptr<AsyncWork> work) {
+    static void execute(std::shared_ptr<AsyncWork> work, size_t step) {
       std::exception_ptr eptr;
       try {
-        work->run();
+        work->runStep(step);
       } catch (...) {
         eptr = std::current_exception();
       }
+
+      {
+        std::lock_guard<std::mutex> lock(work->stepMutex_);
+        if (eptr && !work->stepException_) {
+          work->stepException_ = eptr;
+        }
+        if (++work->stepsDone_ < work->numSteps()) {
+          return;
+        }
+        eptr = work->stepException_;
+      }
+
       work->finish(eptr);
     }
 
     virtual void run() = 0;
 
+    // Must not change after the work has been queued.
+    virtual size_t numSteps() const {
+      return 1;
+    }
+
+    virtual void runStep(size_t /* unused */) {
+      run();
+    }
+
    protected:
     friend class ProcessGroupGloo;
+
+   private:
+    std::mutex stepMutex_;
+    size_t stepsDone_ = 0;
+    std::exception_ptr stepException_;
   };
 
   // For send and recv operations there is no need to pass them to the
@@ -125,6 +160,14 @@ class ProcessGroupGloo : public ProcessGroup {
     std::vector<std::shared_ptr<::gloo::transport::Device>> devices;
     std::chrono::milliseconds timeout;
     int threads;
+
+    // Dense allreduce of contiguous tensors larger than this many bytes is
+    // split into chunks of at most this size. Every chunk is reduced with its
+    // own tag as a separate step (see AsyncWork), so that the chunks of a
+    // large bucket are pipelined across the worker threads, also with a
+    // single device. Must be identical on all processes. Set to 0 to disable
+    // chunking.
+    size_t chunkBytes;
   };
 
   explicit ProcessGroupGloo(
@@ -143,6 +186,15 @@ class ProcessGroupGloo : public ProcessGroup {
       std::vector<at::Tensor>& tensors,
       const AllreduceOptions& opts = AllreduceOptions()) override;
 
+  // Only supports sparse tensors. Every bucket of sparse tensors is reduced
+  // with one allgather for all metadata, one for all indices, and one for all
+  // values, plus one dense allreduce for the tensors that are too dense to
+  // benefit from a sparse reduction.
+  std::shared_ptr<ProcessGroup::Work> allreduce_coalesced(
+      std::vector<at::Tensor>& tensors,
+      const AllreduceCoalescedOptions& opts =
+          AllreduceCoalescedOptions()) override;
+
   std::shared_ptr<ProcessGroup::Work> reduce(
       std::vector<at::Tensor>& tensors,
       const ReduceOptions& opts = ReduceOptions()) override;
@@ -194,6 +246,9 @@ class ProcessGroupGloo : public ProcessGroup {
   std::vector<std::thread> threads_;
   bool stop_;
 
+  // See Options::chunkBytes.
+  const size_t chunkBytes_;
+
   // Incremented for every collective we kick off.
   // The value is used as tag for collective operations. Collectives are kicked
   // off in identical order across processes. Therefore the tag can be used
@@ -201,7 +256,9 @@ class ProcessGroupGloo : public ProcessGroup {
   uint32_t collectiveCounter_;
 
   // Returns next collective tag to use (uses collectiveCounter_).
-  uint32_t nextTag();
+  // If `count` is larger than 1, this reserves `count` consecutive
+  // tags and returns the first one.
+  uint32_t nextTag(uint32_t count = 1);
 
   // Returns the context to use for the specified tag.
   // With `nextTag` returning an increasing number, this should lead
@@ -214,13 +271,13 @@ class ProcessGroupGloo : public ProcessGroup {
   // Queue work to run on worker thread.
   void enqueue(std::shared_ptr<AsyncWork> work);
 
-  // Keep both a queue of pending work, and a vector with in progress work.
-  // Both of these can only be mutated when holding the queue lock.
+  // Keep both a queue of pending work steps, and a vector with in progress
+  // work. Both of these can only be mutated when holding the queue lock.
   // We keep both around instead of just the queue, so we can grab a weak_ptr
   // to all in progress and pending work when executing a barrier.
   // When executing a barrier, we need to ensure that all prior work
   // has completed before completing itself.
-  std::deque<std::shared_ptr<AsyncWork>> workQueue_;
+  std::deque<std::pair<std::shared_ptr<AsyncWork>, size_t>> workQueue_;
   std::vector<std::shared_ptr<AsyncWork>> workInProgress_;
   std::mutex workMutex_;
   std::condition_variable workProduceCV_;
@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace c10d {
@@ -35,6 +36,36 @@ class Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) = 0;
 
+  // Batched variants of set and get. The default implementations issue one
+  // call per key; stores that can serve a batch in a single round trip
+  // override them.
+  virtual void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values);
+
+  virtual std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys);
+
+  // Atomically replaces the value of `key` with `desiredValue` if its current
+  // value is `expectedValue`. An empty `expectedValue` matches a key that
+  // does not exist yet. Returns the value of `key` after the operation, which
+  // is empty if the key still does not exist.
+  virtual std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue);
+
+  // Blocks until at least `minKeys` keys starting with `prefix` exist and
+  // returns all of them together with their values.
+  virtual std::vector<std::pair<std::string, std::vector<uint8_t>>>
+  watchPrefix(const std::string& prefix, size_t minKeys);
+
+  virtual std::vector<std::pair<std::string, std::vector<uint8_t>>>
+  watchPrefix(
+      const std::string& prefix,
+      size_t minKeys,
+      const std::chrono::milliseconds& timeout);
+
   void setTimeout(const std::chrono::milliseconds& timeout);
 
  protected:
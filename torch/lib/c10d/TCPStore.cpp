@@ -1,6 +1,6 @@
 #include <c10d/TCPStore.hpp>
 
-#include <poll.h>
+#include <sys/epoll.h>
 
 #include <unistd.h>
 #include <algorithm>
@@ -10,37 +10,95 @@ namespace c10d {
 
 namespace {
 
-enum class QueryType : uint8_t { SET, GET, ADD, CHECK, WAIT };
+enum class QueryType : uint8_t {
+  SET,
+  GET,
+  ADD,
+  CHECK,
+  WAIT,
+  MULTI_SET,
+  MULTI_GET,
+  COMPARE_SET,
+  WATCH_PREFIX
+};
 
 enum class CheckResponseType : uint8_t { READY, NOT_READY };
 
 enum class WaitResponseType : uint8_t { STOP_WAITING };
 
+// Maximum number of events returned by a single epoll_wait call
+constexpr int kMaxEvents = 64;
+
+// Upper bound on the default number of daemon worker threads
+constexpr size_t kMaxDefaultNumWorkers = 8;
+
+bool hasPrefix(const std::string& key, const std::string& prefix) {
+  return key.compare(0, prefix.size(), prefix) == 0;
+}
+
+// The response to watch_prefix is
+// number of entries | size of key1 | key1 | size of val1 | val1 | ...
+void sendPrefixEntries(
+    int socket,
+    const std::vector<std::pair<std::string, std::vector<uint8_t>>>&
+        entries) {
+  SizeType numEntries = entries.size();
+  tcputil::sendBytes<SizeType>(socket, &numEntries, 1, (numEntries > 0));
+  for (size_t i = 0; i < entries.size(); i++) {
+    tcputil::sendString(socket, entries[i].first, true);
+    tcputil::sendVector<uint8_t>(
+        socket, entries[i].second, (i != (entries.size() - 1)));
+  }
+}
+
+void addToEpoll(int epollFd, int fd, uint32_t events) {
+  struct epoll_event event;
+  event.events = events;
+  event.data.fd = fd;
+  SYSCHECK_ERR_RETURN_NEG1(::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event));
+}
+
 } // anonymous namespace
 
 // TCPStoreDaemon class methods
-// Simply start the daemon thread
-TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket)
+// Simply start the daemon thread and its workers
+TCPStoreDaemon::TCPStoreDaemon(int storeListenSocket, size_t numWorkers)
     : storeListenSocket_(storeListenSocket) {
-  // Use control pipe to signal instance destruction to the daemon thread.
+  if (numWorkers == 0) {
+    throw std::invalid_argument(
+        "Number of TCPStoreDaemon workers should be greater than zero");
+  }
+  // Use control pipe to signal instance destruction to the daemon threads.
+  // Closing the write end raises EPOLLHUP in every epoll instance watching
+  // the read end.
   if (pipe(controlPipeFd_.data()) == -1) {
     throw std::runtime_error(
         "Failed to create the control pipe to start the "
         "TCPStoreDaemon run");
   }
+  for (size_t i = 0; i < numWorkers; i++) {
+    int epollFd;
+    SYSCHECK_ERR_RETURN_NEG1(epollFd = ::epoll_create1(EPOLL_CLOEXEC));
+    workerEpollFds_.push_back(epollFd);
+    addToEpoll(epollFd, controlPipeFd_[0], EPOLLIN);
+  }
+  for (size_t i = 0; i < numWorkers; i++) {
+    workerThreads_.emplace_back(&TCPStoreDaemon::runWorker, this, i);
+  }
   daemonThread_ = std::thread(&TCPStoreDaemon::run, this);
 }
 
 TCPStoreDaemon::~TCPStoreDaemon() {
   // Stop the run
   stop();
-  // Join the thread
+  // Join the threads
   join();
   // Close unclosed sockets
   for (auto socket : sockets_) {
-    if (socket != -1) {
-      ::close(socket);
-    }
+    ::close(socket);
+  }
+  for (auto fd : workerEpollFds_) {
+    ::close(fd);
   }
   // Now close the rest control pipe
   for (auto fd : controlPipeFd_) {
@@ -51,69 +109,81 @@ TCPStoreDaemon::~TCPStoreDaemon() {
 }
 
 void TCPStoreDaemon::join() {
-  daemonThread_.join();
+  if (daemonThread_.joinable()) {
+    daemonThread_.join();
+  }
+  for (auto& thread : workerThreads_) {
+    if (thread.joinable()) {
+      thread.join();
+    }
+  }
 }
 
+size_t TCPStoreDaemon::defaultNumWorkers() {
+  size_t numCores = std::thread::hardware_concurrency();
+  return std::max<size_t>(1, std::min(numCores, kMaxDefaultNumWorkers));
+}
+
+// run accepts new connections and distributes them round-robin over the
+// worker threads, which serve all queries on them.
 void TCPStoreDaemon::run() {
-  std::vector<struct pollfd> fds;
-  fds.push_back({.fd = storeListenSocket_, .events = POLLIN});
-  // Push the read end of the pipe to signal the stopping of the daemon run
-  fds.push_back({.fd = controlPipeFd_[0], .events = POLLHUP});
+  int epollFd;
+  SYSCHECK_ERR_RETURN_NEG1(epollFd = ::epoll_create1(EPOLL_CLOEXEC));
+  ResourceGuard epollGuard([epollFd]() { ::close(epollFd); });
 
-  // receive the queries
-  bool finished = false;
-  while (!finished) {
-    for (size_t i = 0; i < sockets_.size(); i++) {
-      fds[i].revents = 0;
-    }
+  addToEpoll(epollFd, storeListenSocket_, EPOLLIN);
+  // Push the read end of the pipe to signal the stopping of the daemon run
+  addToEpoll(epollFd, controlPipeFd_[0], EPOLLIN);
 
-    SYSCHECK_ERR_RETURN_NEG1(::poll(fds.data(), fds.size(), -1));
+  struct epoll_event events[2];
+  while (true) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(numEvents = ::epoll_wait(epollFd, events, 2, -1));
 
+    for (int i = 0; i < numEvents; i++) {
+      // The pipe receives an event which tells us to shutdown the daemon
+      if (events[i].data.fd == controlPipeFd_[0]) {
+        return;
+      }
+    }
     // TCPStore's listening socket has an event and it should now be able to
     // accept new connections.
-    if (fds[0].revents != 0) {
-      if (fds[0].revents ^ POLLIN) {
+    for (int i = 0; i < numEvents; i++) {
+      if (events[i].events ^ EPOLLIN) {
         throw std::system_error(
             ECONNABORTED,
             std::system_category(),
-            "Unexpected poll revent on the master's listening socket: " +
-                std::to_string(fds[0].revents));
+            "Unexpected epoll event on the master's listening socket: " +
+                std::to_string(events[i].events));
       }
       int sockFd = std::get<0>(tcputil::accept(storeListenSocket_));
-      sockets_.push_back(sockFd);
-      fds.push_back({.fd = sockFd, .events = POLLIN});
-    }
-    // The pipe receives an event which tells us to shutdown the daemon
-    if (fds[1].revents != 0) {
-      // Will be POLLUP when the pipe is closed
-      if (fds[1].revents ^ POLLHUP) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent on the control pipe's reading fd: " +
-                std::to_string(fds[1].revents));
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sockets_.insert(sockFd);
       }
-      finished = true;
-      break;
+      int workerEpollFd = workerEpollFds_[nextWorker_];
+      nextWorker_ = (nextWorker_ + 1) % workerEpollFds_.size();
+      addToEpoll(workerEpollFd, sockFd, EPOLLIN);
     }
-    // Skipping the fds[0] and fds[1],
-    // fds[0] is master's listening socket
-    // fds[1] is control pipe's reading fd
-    for (size_t fdIdx = 2; fdIdx < fds.size(); ++fdIdx) {
-      if (fds[fdIdx].revents == 0) {
-        continue;
-      }
+  }
+}
 
-      if (fds[fdIdx].revents ^ POLLIN) {
-        throw std::system_error(
-            ECONNABORTED,
-            std::system_category(),
-            "Unexpected poll revent: " + std::to_string(fds[fdIdx].revents) +
-                " on socket: " + std::to_string(fds[fdIdx].fd));
+void TCPStoreDaemon::runWorker(size_t workerIdx) {
+  const int epollFd = workerEpollFds_[workerIdx];
+  struct epoll_event events[kMaxEvents];
+  while (true) {
+    int numEvents;
+    SYSCHECK_ERR_RETURN_NEG1(
+        numEvents = ::epoll_wait(epollFd, events, kMaxEvents, -1));
+
+    for (int i = 0; i < numEvents; i++) {
+      const int fd = events[i].data.fd;
+      if (fd == controlPipeFd_[0]) {
+        return;
       }
       // Now query the socket that has the event
       try {
-        query(fds[fdIdx].fd);
+        query(fd);
       } catch (...) {
         // There was an error when processing query. Probably an exception
         // occurred in recv/send what would indicate that socket on the other
@@ -122,34 +192,7 @@ void TCPStoreDaemon::run() {
         // exception, other connections will get an exception once they try to
         // use the store. We will go ahead and close this connection whenever
         // we hit an exception here.
-        ::close(fds[fdIdx].fd);
-
-        // Remove all the tracking state of the close FD
-        for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
-          for (auto vecIt = it->second.begin(); vecIt != it->second.end();) {
-            if (*vecIt == fds[fdIdx].fd) {
-              vecIt = it->second.erase(vecIt);
-            } else {
-              ++vecIt;
-            }
-          }
-          if (it->second.size() == 0) {
-            it = waitingSockets_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        for (auto it = keysAwaited_.begin(); it != keysAwaited_.end();) {
-          if (it->first == fds[fdIdx].fd) {
-            it = keysAwaited_.erase(it);
-          } else {
-            ++it;
-          }
-        }
-        fds.erase(fds.begin() + fdIdx);
-        sockets_.erase(sockets_.begin() + fdIdx - 2);
-        --fdIdx;
-        continue;
+        closeSocket(fd, epollFd);
       }
     }
   }
@@ -163,11 +206,55 @@ void TCPStoreDaemon::stop() {
   }
 }
 
+void TCPStoreDaemon::closeSocket(int socket, int epollFd) {
+  ::epoll_ctl(epollFd, EPOLL_CTL_DEL, socket, nullptr);
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Remove all the tracking state of the closed FD
+  for (auto it = waitingSockets_.begin(); it != waitingSockets_.end();) {
+    auto& sockets = it->second;
+    sockets.erase(
+        std::remove(sockets.begin(), sockets.end(), socket), sockets.end());
+    if (sockets.empty()) {
+      it = waitingSockets_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  keysAwaited_.erase(socket);
+  for (auto it = prefixWatches_.begin(); it != prefixWatches_.end();) {
+    auto& watchers = it->second.watchers;
+    watchers.erase(
+        std::remove_if(
+            watchers.begin(),
+            watchers.end(),
+            [socket](const std::pair<int, SizeType>& watcher) {
+              return watcher.first == socket;
+            }),
+        watchers.end());
+    if (watchers.empty()) {
+      it = prefixWatches_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  sockets_.erase(socket);
+  // Another worker may still be sending a wakeup to this socket; the last
+  // one to finish closes it.
+  if (pendingWakeups_.count(socket) > 0) {
+    closingSockets_.insert(socket);
+  } else {
+    ::close(socket);
+  }
+}
+
 // query communicates with the worker. The format
 // of the query is as follows:
 // type of query | size of arg1 | arg1 | size of arg2 | arg2 | ...
-// or, in the case of wait
+// or, in the case of wait, check and multi_get
 // type of query | number of args | size of arg1 | arg1 | ...
+// or, in the case of multi_set
+// type of query | number of keys | size of key1 | key1 | size of val1 | val1
+// | ...
 void TCPStoreDaemon::query(int socket) {
   QueryType qt;
   tcputil::recvBytes<QueryType>(socket, &qt, 1);
@@ -187,55 +274,249 @@ void TCPStoreDaemon::query(int socket) {
   } else if (qt == QueryType::WAIT) {
     waitHandler(socket);
 
+  } else if (qt == QueryType::MULTI_SET) {
+    multiSetHandler(socket);
+
+  } else if (qt == QueryType::MULTI_GET) {
+    multiGetHandler(socket);
+
+  } else if (qt == QueryType::COMPARE_SET) {
+    compareSetHandler(socket);
+
+  } else if (qt == QueryType::WATCH_PREFIX) {
+    watchPrefixHandler(socket);
+
   } else {
     throw std::runtime_error("Unexpected query type");
   }
 }
 
-void TCPStoreDaemon::wakeupWaitingClients(const std::string& key) {
+void TCPStoreDaemon::setValue(
+    const std::string& key,
+    std::vector<uint8_t> value,
+    Wakeups& wakeups) {
+  auto it = tcpStore_.find(key);
+  const bool isNewKey = it == tcpStore_.end();
+  if (isNewKey) {
+    tcpStore_.emplace(key, std::move(value));
+  } else {
+    it->second = std::move(value);
+  }
+  // On every update, wake up all clients that have been waiting
+  wakeupWaitingClients(key, wakeups);
+  // Prefix watchers only care about the number of keys
+  if (isNewKey) {
+    wakeupPrefixWatchers(key, wakeups);
+  }
+}
+
+void TCPStoreDaemon::wakeupWaitingClients(
+    const std::string& key,
+    Wakeups& wakeups) {
   auto socketsToWait = waitingSockets_.find(key);
   if (socketsToWait != waitingSockets_.end()) {
     for (int socket : socketsToWait->second) {
-      if (--keysAwaited_[socket] == 0) {
-        tcputil::sendValue<WaitResponseType>(
-            socket, WaitResponseType::STOP_WAITING);
+      auto keysAwaited = keysAwaited_.find(socket);
+      if (--keysAwaited->second == 0) {
+        keysAwaited_.erase(keysAwaited);
+        retainSocket(socket);
+        wakeups.waitSockets.push_back(socket);
       }
     }
     waitingSockets_.erase(socketsToWait);
   }
 }
 
+void TCPStoreDaemon::wakeupPrefixWatchers(
+    const std::string& key,
+    Wakeups& wakeups) {
+  for (auto it = prefixWatches_.begin(); it != prefixWatches_.end();) {
+    if (!hasPrefix(key, it->first)) {
+      ++it;
+      continue;
+    }
+    auto& watch = it->second;
+    ++watch.numKeys;
+    for (auto watcher = watch.watchers.begin();
+         watcher != watch.watchers.end();) {
+      if (watcher->second > watch.numKeys) {
+        ++watcher;
+        continue;
+      }
+      retainSocket(watcher->first);
+      wakeups.prefixReplies.emplace_back(
+          watcher->first, prefixEntries(it->first));
+      watcher = watch.watchers.erase(watcher);
+    }
+    if (watch.watchers.empty()) {
+      it = prefixWatches_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+TCPStoreDaemon::PrefixEntries TCPStoreDaemon::prefixEntries(
+    const std::string& prefix) const {
+  PrefixEntries entries;
+  for (auto it = tcpStore_.lower_bound(prefix);
+       it != tcpStore_.end() && hasPrefix(it->first, prefix);
+       ++it) {
+    entries.emplace_back(it->first, it->second);
+  }
+  return entries;
+}
+
+void TCPStoreDaemon::retainSocket(int socket) {
+  ++pendingWakeups_[socket];
+}
+
+void TCPStoreDaemon::releaseSocket(int socket) {
+  auto it = pendingWakeups_.find(socket);
+  if (--it->second == 0) {
+    pendingWakeups_.erase(it);
+    if (closingSockets_.erase(socket) > 0) {
+      ::close(socket);
+    }
+  }
+}
+
+void TCPStoreDaemon::sendWakeups(const Wakeups& wakeups) {
+  if (wakeups.waitSockets.empty() && wakeups.prefixReplies.empty()) {
+    return;
+  }
+  // A failure here means the waiting client went away; its own worker
+  // notices the closed connection and cleans up after it.
+  for (int socket : wakeups.waitSockets) {
+    try {
+      tcputil::sendValue<WaitResponseType>(
+          socket, WaitResponseType::STOP_WAITING);
+    } catch (...) {
+    }
+  }
+  for (const auto& reply : wakeups.prefixReplies) {
+    try {
+      sendPrefixEntries(reply.first, reply.second);
+    } catch (...) {
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (int socket : wakeups.waitSockets) {
+    releaseSocket(socket);
+  }
+  for (const auto& reply : wakeups.prefixReplies) {
+    releaseSocket(reply.first);
+  }
+}
+
 void TCPStoreDaemon::setHandler(int socket) {
   std::string key = tcputil::recvString(socket);
-  tcpStore_[key] = tcputil::recvVector<uint8_t>(socket);
-  // On "set", wake up all clients that have been waiting
-  wakeupWaitingClients(key);
+  auto value = tcputil::recvVector<uint8_t>(socket);
+  Wakeups wakeups;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    setValue(key, std::move(value), wakeups);
+  }
+  sendWakeups(wakeups);
+}
+
+void TCPStoreDaemon::multiSetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  std::vector<std::vector<uint8_t>> values(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+    values[i] = tcputil::recvVector<uint8_t>(socket);
+  }
+  Wakeups wakeups;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < nargs; i++) {
+      setValue(keys[i], std::move(values[i]), wakeups);
+    }
+  }
+  sendWakeups(wakeups);
 }
 
 void TCPStoreDaemon::addHandler(int socket) {
   std::string key = tcputil::recvString(socket);
   int64_t addVal = tcputil::recvValue<int64_t>(socket);
 
-  if (tcpStore_.find(key) != tcpStore_.end()) {
-    auto buf = reinterpret_cast<const char*>(tcpStore_[key].data());
-    auto len = tcpStore_[key].size();
-    addVal += std::stoll(std::string(buf, len));
+  Wakeups wakeups;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tcpStore_.find(key);
+    if (it != tcpStore_.end()) {
+      auto buf = reinterpret_cast<const char*>(it->second.data());
+      auto len = it->second.size();
+      addVal += std::stoll(std::string(buf, len));
+    }
+    auto addValStr = std::to_string(addVal);
+    // On "add", wake up all clients that have been waiting
+    setValue(
+        key,
+        std::vector<uint8_t>(addValStr.begin(), addValStr.end()),
+        wakeups);
   }
-  auto addValStr = std::to_string(addVal);
-  tcpStore_[key] = std::vector<uint8_t>(addValStr.begin(), addValStr.end());
+  sendWakeups(wakeups);
   // Now send the new value
   tcputil::sendValue<int64_t>(socket, addVal);
-  // On "add", wake up all clients that have been waiting
-  wakeupWaitingClients(key);
 }
 
-void TCPStoreDaemon::getHandler(int socket) const {
+void TCPStoreDaemon::compareSetHandler(int socket) {
   std::string key = tcputil::recvString(socket);
-  auto data = tcpStore_.at(key);
+  auto expectedValue = tcputil::recvVector<uint8_t>(socket);
+  auto desiredValue = tcputil::recvVector<uint8_t>(socket);
+
+  std::vector<uint8_t> currentValue;
+  Wakeups wakeups;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = tcpStore_.find(key);
+    const bool matches = it == tcpStore_.end() ? expectedValue.empty()
+                                               : it->second == expectedValue;
+    if (matches) {
+      currentValue = desiredValue;
+      setValue(key, std::move(desiredValue), wakeups);
+    } else if (it != tcpStore_.end()) {
+      currentValue = it->second;
+    }
+  }
+  sendWakeups(wakeups);
+  tcputil::sendVector<uint8_t>(socket, currentValue);
+}
+
+void TCPStoreDaemon::getHandler(int socket) {
+  std::string key = tcputil::recvString(socket);
+  std::vector<uint8_t> data;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data = tcpStore_.at(key);
+  }
   tcputil::sendVector<uint8_t>(socket, data);
 }
 
-void TCPStoreDaemon::checkHandler(int socket) const {
+void TCPStoreDaemon::multiGetHandler(int socket) {
+  SizeType nargs;
+  tcputil::recvBytes<SizeType>(socket, &nargs, 1);
+  std::vector<std::string> keys(nargs);
+  for (size_t i = 0; i < nargs; i++) {
+    keys[i] = tcputil::recvString(socket);
+  }
+  std::vector<std::vector<uint8_t>> values(nargs);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < nargs; i++) {
+      values[i] = tcpStore_.at(keys[i]);
+    }
+  }
+  for (size_t i = 0; i < nargs; i++) {
+    tcputil::sendVector<uint8_t>(socket, values[i], (i != (nargs - 1)));
+  }
+}
+
+void TCPStoreDaemon::checkHandler(int socket) {
   SizeType nargs;
   tcputil::recvBytes<SizeType>(socket, &nargs, 1);
   std::vector<std::string> keys(nargs);
@@ -243,7 +524,12 @@ void TCPStoreDaemon::checkHandler(int socket) const {
     keys[i] = tcputil::recvString(socket);
   }
   // Now we have received all the keys
-  if (checkKeys(keys)) {
+  bool ready;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ready = checkKeys(keys);
+  }
+  if (ready) {
     tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::READY);
   } else {
     tcputil::sendValue<CheckResponseType>(socket, CheckResponseType::NOT_READY);
@@ -257,15 +543,41 @@ void TCPStoreDaemon::waitHandler(int socket) {
   for (size_t i = 0; i < nargs; i++) {
     keys[i] = tcputil::recvString(socket);
   }
-  if (checkKeys(keys)) {
-    tcputil::sendValue<WaitResponseType>(
-        socket, WaitResponseType::STOP_WAITING);
-  } else {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Only wait for the keys that do not exist yet, keys that are already
+    // present will not necessarily be set again.
+    size_t numMissing = 0;
     for (auto& key : keys) {
-      waitingSockets_[key].push_back(socket);
+      if (tcpStore_.count(key) == 0) {
+        waitingSockets_[key].push_back(socket);
+        ++numMissing;
+      }
+    }
+    if (numMissing > 0) {
+      keysAwaited_[socket] = numMissing;
+      return;
+    }
+  }
+  tcputil::sendValue<WaitResponseType>(socket, WaitResponseType::STOP_WAITING);
+}
+
+void TCPStoreDaemon::watchPrefixHandler(int socket) {
+  std::string prefix = tcputil::recvString(socket);
+  SizeType minKeys = tcputil::recvValue<SizeType>(socket);
+
+  PrefixEntries entries;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries = prefixEntries(prefix);
+    if (entries.size() < minKeys) {
+      auto& watch = prefixWatches_[prefix];
+      watch.numKeys = entries.size();
+      watch.watchers.emplace_back(socket, minKeys);
+      return;
     }
-    keysAwaited_[socket] = keys.size();
   }
+  sendPrefixEntries(socket, entries);
 }
 
 bool TCPStoreDaemon::checkKeys(const std::vector<std::string>& keys) const {
@@ -341,6 +653,24 @@ void TCPStore::set(const std::string& key, const std::vector<uint8_t>& data) {
   tcputil::sendVector<uint8_t>(storeSocket_, data);
 }
 
+void TCPStore::multiSet(
+    const std::vector<std::string>& keys,
+    const std::vector<std::vector<uint8_t>>& values) {
+  if (keys.size() != values.size()) {
+    throw std::invalid_argument(
+        "multiSet requires the same number of keys and values");
+  }
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_SET, true);
+  SizeType nkeys = keys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    std::string regKey = regularPrefix_ + keys[i];
+    tcputil::sendString(storeSocket_, regKey, true);
+    tcputil::sendVector<uint8_t>(
+        storeSocket_, values[i], (i != (nkeys - 1)));
+  }
+}
+
 std::vector<uint8_t> TCPStore::get(const std::string& key) {
   std::string regKey = regularPrefix_ + key;
   return getHelper_(regKey);
@@ -353,6 +683,28 @@ std::vector<uint8_t> TCPStore::getHelper_(const std::string& key) {
   return tcputil::recvVector<uint8_t>(storeSocket_);
 }
 
+std::vector<std::vector<uint8_t>> TCPStore::multiGet(
+    const std::vector<std::string>& keys) {
+  std::vector<std::string> regKeys(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    regKeys[i] = regularPrefix_ + keys[i];
+  }
+  // One round trip to wait for all keys and one to fetch them, regardless of
+  // the number of keys.
+  waitHelper_(regKeys, timeout_);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::MULTI_GET);
+  SizeType nkeys = regKeys.size();
+  tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
+  for (size_t i = 0; i < nkeys; i++) {
+    tcputil::sendString(storeSocket_, regKeys[i], (i != (nkeys - 1)));
+  }
+  std::vector<std::vector<uint8_t>> values(nkeys);
+  for (size_t i = 0; i < nkeys; i++) {
+    values[i] = tcputil::recvVector<uint8_t>(storeSocket_);
+  }
+  return values;
+}
+
 int64_t TCPStore::add(const std::string& key, int64_t value) {
   std::string regKey = regularPrefix_ + key;
   return addHelper_(regKey, value);
@@ -365,6 +717,18 @@ int64_t TCPStore::addHelper_(const std::string& key, int64_t value) {
   return tcputil::recvValue<int64_t>(storeSocket_);
 }
 
+std::vector<uint8_t> TCPStore::compareSet(
+    const std::string& key,
+    const std::vector<uint8_t>& expectedValue,
+    const std::vector<uint8_t>& desiredValue) {
+  std::string regKey = regularPrefix_ + key;
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::COMPARE_SET, true);
+  tcputil::sendString(storeSocket_, regKey, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, expectedValue, true);
+  tcputil::sendVector<uint8_t>(storeSocket_, desiredValue);
+  return tcputil::recvVector<uint8_t>(storeSocket_);
+}
+
 bool TCPStore::check(const std::vector<std::string>& keys) {
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::CHECK);
   SizeType nkeys = keys.size();
@@ -398,9 +762,7 @@ void TCPStore::wait(
   waitHelper_(regKeys, timeout);
 }
 
-void TCPStore::waitHelper_(
-    const std::vector<std::string>& keys,
-    const std::chrono::milliseconds& timeout) {
+void TCPStore::setTimeoutHelper_(const std::chrono::milliseconds& timeout) {
   // Set the socket timeout if there is a wait timeout
   if (timeout != kNoTimeout) {
     struct timeval timeoutTV = {.tv_sec = timeout.count() / 1000,
@@ -412,16 +774,76 @@ void TCPStore::waitHelper_(
         reinterpret_cast<char*>(&timeoutTV),
         sizeof(timeoutTV)));
   }
+}
+
+// When a blocking request fails on the client side, e.g. because it timed
+// out, the daemon still considers it pending and would answer it later, where
+// the answer would be read as the response to the next request. Reconnecting
+// makes the daemon drop the request together with the old connection.
+void TCPStore::reconnect_() {
+  ::close(storeSocket_);
+  storeSocket_ = -1;
+  try {
+    storeSocket_ = tcputil::connect(tcpStoreAddr_, tcpStorePort_);
+  } catch (...) {
+    // Leave the store disconnected; the error of the failed request is the
+    // one worth reporting, later requests fail on the closed socket.
+  }
+}
+
+void TCPStore::waitHelper_(
+    const std::vector<std::string>& keys,
+    const std::chrono::milliseconds& timeout) {
+  setTimeoutHelper_(timeout);
   tcputil::sendValue<QueryType>(storeSocket_, QueryType::WAIT);
   SizeType nkeys = keys.size();
   tcputil::sendBytes<SizeType>(storeSocket_, &nkeys, 1, (nkeys > 0));
   for (size_t i = 0; i < nkeys; i++) {
     tcputil::sendString(storeSocket_, keys[i], (i != (nkeys - 1)));
   }
-  auto waitResponse = tcputil::recvValue<WaitResponseType>(storeSocket_);
+  WaitResponseType waitResponse;
+  try {
+    waitResponse = tcputil::recvValue<WaitResponseType>(storeSocket_);
+  } catch (...) {
+    reconnect_();
+    throw;
+  }
   if (waitResponse != WaitResponseType::STOP_WAITING) {
     throw std::runtime_error("Stop_waiting response is expected");
   }
 }
 
+std::vector<std::pair<std::string, std::vector<uint8_t>>> TCPStore::watchPrefix(
+    const std::string& prefix,
+    size_t minKeys) {
+  return watchPrefix(prefix, minKeys, timeout_);
+}
+
+std::vector<std::pair<std::string, std::vector<uint8_t>>> TCPStore::watchPrefix(
+    const std::string& prefix,
+    size_t minKeys,
+    const std::chrono::milliseconds& timeout) {
+  setTimeoutHelper_(timeout);
+  tcputil::sendValue<QueryType>(storeSocket_, QueryType::WATCH_PREFIX, true);
+  tcputil::sendString(storeSocket_, regularPrefix_ + prefix, true);
+  tcputil::sendValue<SizeType>(storeSocket_, minKeys);
+
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> entries;
+  try {
+    auto numEntries = tcputil::recvValue<SizeType>(storeSocket_);
+    entries.reserve(numEntries);
+    for (size_t i = 0; i < numEntries; i++) {
+      // Strip the regular prefix so that keys look like they were set
+      auto key =
+          tcputil::recvString(storeSocket_).substr(regularPrefix_.size());
+      auto value = tcputil::recvVector<uint8_t>(storeSocket_);
+      entries.emplace_back(std::move(key), std::move(value));
+    }
+  } catch (...) {
+    reconnect_();
+    throw;
+  }
+  return entries;
+}
+
 } // namespace c10d
@@ -1,44 +1,106 @@
 #pragma once
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
 
 #include <c10d/Store.hpp>
 #include <c10d/Utils.hpp>
 
 namespace c10d {
 
+// The daemon accepts connections on a single thread and hands every accepted
+// socket to one of `numWorkers` worker threads. Each worker multiplexes its
+// share of the connections with its own epoll instance, so the daemon scales
+// to many thousands of concurrently connected clients. The key-value state is
+// shared by all workers and guarded by `mutex_`; requests are fully received
+// before the lock is taken, so a slow client only ever stalls its own worker.
 class TCPStoreDaemon {
  public:
-  explicit TCPStoreDaemon(int storeListenSocket);
+  explicit TCPStoreDaemon(
+      int storeListenSocket,
+      size_t numWorkers = defaultNumWorkers());
   ~TCPStoreDaemon();
 
   void join();
 
+  static size_t defaultNumWorkers();
+
  protected:
   void run();
+  void runWorker(size_t workerIdx);
   void stop();
 
   void query(int socket);
+  void closeSocket(int socket, int epollFd);
 
   void setHandler(int socket);
+  void multiSetHandler(int socket);
   void addHandler(int socket);
-  void getHandler(int socket) const;
-  void checkHandler(int socket) const;
+  void compareSetHandler(int socket);
+  void getHandler(int socket);
+  void multiGetHandler(int socket);
+  void checkHandler(int socket);
   void waitHandler(int socket);
+  void watchPrefixHandler(int socket);
+
+  using PrefixEntries =
+      std::vector<std::pair<std::string, std::vector<uint8_t>>>;
+
+  // Replies to blocked wait and watch_prefix requests. They are collected
+  // while `mutex_` is held and sent by sendWakeups after releasing it.
+  struct Wakeups {
+    std::vector<int> waitSockets;
+    std::vector<std::pair<int, PrefixEntries>> prefixReplies;
+  };
 
+  void sendWakeups(const Wakeups& wakeups);
+
+  // The following members must be called with `mutex_` held.
   bool checkKeys(const std::vector<std::string>& keys) const;
-  void wakeupWaitingClients(const std::string& key);
+  void setValue(
+      const std::string& key,
+      std::vector<uint8_t> value,
+      Wakeups& wakeups);
+  void wakeupWaitingClients(const std::string& key, Wakeups& wakeups);
+  void wakeupPrefixWatchers(const std::string& key, Wakeups& wakeups);
+  PrefixEntries prefixEntries(const std::string& prefix) const;
+  void retainSocket(int socket);
+  void releaseSocket(int socket);
+
+  struct PrefixWatch {
+    // Number of keys currently stored under the watched prefix
+    size_t numKeys;
+    // Sockets watching the prefix and the number of keys they wait for
+    std::vector<std::pair<int, SizeType>> watchers;
+  };
 
   std::thread daemonThread_;
-  std::unordered_map<std::string, std::vector<uint8_t>> tcpStore_;
+  std::vector<std::thread> workerThreads_;
+  // One epoll instance per worker thread
+  std::vector<int> workerEpollFds_;
+  size_t nextWorker_ = 0;
+
+  std::mutex mutex_;
+  // Ordered, so that all keys sharing a prefix form a contiguous range
+  std::map<std::string, std::vector<uint8_t>> tcpStore_;
   // From key -> the list of sockets waiting on it
   std::unordered_map<std::string, std::vector<int>> waitingSockets_;
   // From socket -> number of keys awaited
   std::unordered_map<int, size_t> keysAwaited_;
-
-  std::vector<int> sockets_;
+  // From prefix -> the sockets watching it
+  std::unordered_map<std::string, PrefixWatch> prefixWatches_;
+
+  std::unordered_set<int> sockets_;
+  // From socket -> number of wakeups collected for it but not yet sent. A
+  // socket that is closed in the meantime is only closed once they are sent,
+  // so that its file descriptor cannot be reused by a new connection that
+  // would receive them.
+  std::unordered_map<int, size_t> pendingWakeups_;
+  std::unordered_set<int> closingSockets_;
   int storeListenSocket_;
   std::vector<int> controlPipeFd_{-1, -1};
 };
@@ -67,12 +129,35 @@ class TCPStore : public Store {
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout) override;
 
+  void multiSet(
+      const std::vector<std::string>& keys,
+      const std::vector<std::vector<uint8_t>>& values) override;
+
+  std::vector<std::vector<uint8_t>> multiGet(
+      const std::vector<std::string>& keys) override;
+
+  std::vector<uint8_t> compareSet(
+      const std::string& key,
+      const std::vector<uint8_t>& expectedValue,
+      const std::vector<uint8_t>& desiredValue) override;
+
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> watchPrefix(
+      const std::string& prefix,
+      size_t minKeys) override;
+
+  std::vector<std::pair<std::string, std::vector<uint8_t>>> watchPrefix(
+      const std::string& prefix,
+      size_t minKeys,
+      const std::chrono::milliseconds& timeout) override;
+
  protected:
   int64_t addHelper_(const std::string& key, int64_t value);
   std::vector<uint8_t> getHelper_(const std::string& key);
   void waitHelper_(
       const std::vector<std::string>& keys,
       const std::chrono::milliseconds& timeout);
+  void setTimeoutHelper_(const std::chrono::milliseconds& timeout);
+  void reconnect_();
   void waitForWorkers_();
 
   bool isServer_;
@@ -26,6 +26,19 @@ struct AllreduceOptions {
   std::chrono::milliseconds timeout = kUnsetTimeout;
 };
 
+struct AllreduceCoalescedOptions {
+  ReduceOp reduceOp = ReduceOp::SUM;
+  // Sparse tensors are reduced as dense tensors if the sum of their number of
+  // non-zero entries across all processes exceeds this fraction of the
+  // number of entries along their sparse dimensions. At that point the
+  // gathered indices and values are larger than the tensor itself.
+  double sparseDensityThreshold = 1.0;
+  // Sum duplicate indices of sparse inputs before sending them. Disable to
+  // skip the local coalesce when inputs rarely contain duplicates.
+  bool sparseCoalesceInputs = true;
+  std::chrono::milliseconds timeout = kUnsetTimeout;
+};
+
 struct ReduceOptions {
   ReduceOp reduceOp = ReduceOp::SUM;
   int rootRank = 0;
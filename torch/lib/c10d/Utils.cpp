@@ -21,7 +21,9 @@ namespace tcputil {
 
 namespace {
 
-constexpr int LISTEN_QUEUE_SIZE = 64;
+// Large enough for thousands of ranks connecting to the store at once, the
+// kernel caps it at net.core.somaxconn.
+constexpr int LISTEN_QUEUE_SIZE = 2048;
 
 void setSocketNoDelay(int socket) {
   int flag = 1;
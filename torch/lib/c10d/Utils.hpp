@@ -392,6 +392,11 @@ void sendBytes(
 
   int flags = 0;
 
+#ifdef MSG_NOSIGNAL
+  // Report a closed peer as an error instead of raising SIGPIPE
+  flags |= MSG_NOSIGNAL;
+#endif
+
 #ifdef MSG_MORE
   if (moreData) { // there is more data to send
     flags |= MSG_MORE;
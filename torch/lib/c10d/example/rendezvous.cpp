@@ -0,0 +1,83 @@
+#include <sys/resource.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <c10d/TCPStore.hpp>
+
+using namespace ::c10d;
+
+// Simulates the rendezvous of SIZE ranks (default 1024) against one TCPStore
+// from within a single process. Every rank publishes its address and then
+// collects the addresses of all other ranks, either with one get per peer or
+// with a single batched call.
+
+namespace {
+
+constexpr PortType kPort = 29600;
+
+template <typename F>
+double timeRendezvous(int size, F fn) {
+  std::vector<std::unique_ptr<TCPStore>> stores;
+  for (auto rank = 0; rank < size; rank++) {
+    stores.emplace_back(new TCPStore("127.0.0.1", kPort, 1, false));
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto rank = 0; rank < size; rank++) {
+    threads.emplace_back([&, rank] { fn(*stores[rank], rank); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+std::vector<uint8_t> addressOf(int rank) {
+  auto address = "10.0.0.1:" + std::to_string(rank);
+  return std::vector<uint8_t>(address.begin(), address.end());
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  const char* sizeEnv = getenv("SIZE");
+  const int size = sizeEnv ? atoi(sizeEnv) : 1024;
+
+  // Every rank holds a client and a server side socket
+  struct rlimit limit;
+  getrlimit(RLIMIT_NOFILE, &limit);
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+
+  TCPStore server("127.0.0.1", kPort, 1, true);
+
+  const auto perKey = timeRendezvous(size, [size](Store& store, int rank) {
+    store.set("perKey/" + std::to_string(rank), addressOf(rank));
+    for (auto peer = 0; peer < size; peer++) {
+      store.get("perKey/" + std::to_string(peer));
+    }
+  });
+
+  const auto multiGet = timeRendezvous(size, [size](Store& store, int rank) {
+    store.set("multiGet/" + std::to_string(rank), addressOf(rank));
+    std::vector<std::string> keys;
+    for (auto peer = 0; peer < size; peer++) {
+      keys.push_back("multiGet/" + std::to_string(peer));
+    }
+    store.multiGet(keys);
+  });
+
+  const auto watch = timeRendezvous(size, [size](Store& store, int rank) {
+    store.set("watch/" + std::to_string(rank), addressOf(rank));
+    store.watchPrefix("watch/", size);
+  });
+
+  std::cout << "ranks: " << size << std::endl;
+  std::cout << "get per peer: " << perKey << "s" << std::endl;
+  std::cout << "multiGet:     " << multiGet << "s" << std::endl;
+  std::cout << "watchPrefix:  " << watch << "s" << std::endl;
+}
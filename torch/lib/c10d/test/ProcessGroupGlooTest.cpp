@@ -190,6 +190,48 @@ void testAllreduce(const std::string& path, const at::DeviceType b) {
   }
 }
 
+void testAllreduceChunked(const std::string& path) {
+  const auto size = 2;
+  auto tests = CollectiveTest::initialize(path, size);
+
+  // Inputs are larger than the default chunk size, on a single device
+  const auto chunkBytes = ::c10d::ProcessGroupGloo::Options().chunkBytes;
+  const auto numel = static_cast<int64_t>(chunkBytes / sizeof(float)) * 3 / 2;
+  std::vector<std::vector<at::Tensor>> inputs(size);
+  for (auto i = 0; i < size; i++) {
+    auto tensor = at::ones({numel}) * (i + 1);
+    inputs[i] = std::vector<at::Tensor>({tensor});
+  }
+
+  // Kick off work
+  std::vector<std::shared_ptr<::c10d::ProcessGroup::Work>> work(size);
+  for (auto i = 0; i < size; i++) {
+    work[i] = tests[i].getProcessGroup().allreduce(inputs[i]);
+    auto async =
+        std::dynamic_pointer_cast<::c10d::ProcessGroupGloo::AsyncWork>(work[i]);
+    if (!async || async->numSteps() < 2) {
+      throw std::runtime_error("Expected allreduce to be chunked");
+    }
+  }
+
+  // Wait for work to complete
+  for (auto i = 0; i < size; i++) {
+    work[i]->wait();
+  }
+
+  // Verify outputs
+  const auto expected = (size * (size + 1)) / 2;
+  for (auto i = 0; i < size; i++) {
+    auto& tensor = inputs[i][0];
+    auto data = tensor.data_ptr<float>();
+    for (auto j = 0; j < tensor.numel(); j++) {
+      if (data[j] != expected) {
+        throw std::runtime_error("BOOM!");
+      }
+    }
+  }
+}
+
 void testBroadcast(const std::string& path, const at::DeviceType b) {
   const auto size = 2;
   const auto stride = 2;
@@ -295,6 +337,11 @@ int main(int argc, char** argv) {
   }
 #endif
 
+  {
+    TemporaryFile file;
+    testAllreduceChunked(file.path);
+  }
+
   {
     TemporaryFile file;
     testBroadcast(file.path, at::DeviceType::CPU);
@@ -90,9 +90,111 @@ void testHelper(const std::string& prefix = "") {
     c10d::test::check(serverStore, key, val);
   }
 }
+
+void testBatchedHelper(const std::string& prefix = "") {
+  const auto numThreads = 16;
+  c10d::TCPStore serverTCPStore("127.0.0.1", 29501, 1, true);
+  c10d::PrefixStore serverStore(prefix, serverTCPStore);
+
+  // multiSet/multiGet round trip
+  std::vector<std::string> keys = {"key0", "key1", "key2"};
+  std::vector<std::vector<uint8_t>> values;
+  for (const auto& key : keys) {
+    std::string value = "value_" + key;
+    values.emplace_back(value.begin(), value.end());
+  }
+  serverStore.multiSet(keys, values);
+  if (serverStore.multiGet(keys) != values) {
+    throw std::runtime_error("multiGet returned unexpected values");
+  }
+  c10d::test::check(serverStore, "key1", "value_key1");
+
+  // compareSet only succeeds when the expected value matches
+  std::vector<uint8_t> first = {'a'};
+  std::vector<uint8_t> second = {'b'};
+  if (serverStore.compareSet("cas", {}, first) != first ||
+      serverStore.compareSet("cas", second, second) != first ||
+      serverStore.compareSet("cas", first, second) != second) {
+    throw std::runtime_error("compareSet returned unexpected values");
+  }
+
+  // Every thread publishes its rank and watches for all the others
+  std::vector<std::unique_ptr<c10d::TCPStore>> clientTCPStores;
+  std::vector<std::unique_ptr<c10d::PrefixStore>> clientStores;
+  for (auto i = 0; i < numThreads; i++) {
+    clientTCPStores.push_back(std::unique_ptr<c10d::TCPStore>(
+        new c10d::TCPStore("127.0.0.1", 29501, 1, false)));
+    clientStores.push_back(std::unique_ptr<c10d::PrefixStore>(
+        new c10d::PrefixStore(prefix, *clientTCPStores[i])));
+  }
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < numThreads; i++) {
+    threads.push_back(std::thread([&clientStores, i] {
+      c10d::test::set(
+          *clientStores[i], "rank/" + std::to_string(i), std::to_string(i));
+      auto entries = clientStores[i]->watchPrefix("rank/", numThreads);
+      if (entries.size() != static_cast<size_t>(numThreads)) {
+        throw std::runtime_error("watchPrefix returned too few keys");
+      }
+      for (const auto& entry : entries) {
+        auto value = std::string(
+            reinterpret_cast<const char*>(entry.second.data()),
+            entry.second.size());
+        if (entry.first != "rank/" + value) {
+          throw std::runtime_error("Unexpected watchPrefix entry");
+        }
+      }
+    }));
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// A request that timed out on the client must not leave a reply behind that
+// is later taken as the response to another request.
+void testTimeoutHelper() {
+  c10d::TCPStore serverStore("127.0.0.1", 29502, 1, true);
+  c10d::TCPStore clientStore("127.0.0.1", 29502, 1, false);
+  const std::chrono::milliseconds timeout(100);
+
+  bool timedOut = false;
+  try {
+    clientStore.wait({"late_key"}, timeout);
+  } catch (const std::exception&) {
+    timedOut = true;
+  }
+  if (!timedOut) {
+    throw std::runtime_error("wait should have timed out");
+  }
+  timedOut = false;
+  try {
+    clientStore.watchPrefix("late/", 1, timeout);
+  } catch (const std::exception&) {
+    timedOut = true;
+  }
+  if (!timedOut) {
+    throw std::runtime_error("watchPrefix should have timed out");
+  }
+
+  // These would wake up the abandoned requests
+  c10d::test::set(serverStore, "late_key", "value");
+  c10d::test::set(serverStore, "late/key", "value");
+  c10d::test::set(serverStore, "key", "value");
+  c10d::test::check(clientStore, "key", "value");
+  if (clientStore.add("counter", 2) != 2) {
+    throw std::runtime_error("add returned an unexpected value");
+  }
+}
+
 int main(int argc, char** argv) {
   testHelper();
   testHelper("testPrefix");
+  testBatchedHelper();
+  testBatchedHelper("testPrefix");
+  testTimeoutHelper();
   std::cout << "Test succeeded" << std::endl;
   return EXIT_SUCCESS;
 }
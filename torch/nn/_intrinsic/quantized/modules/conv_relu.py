@@ -25,25 +25,25 @@ class ConvReLU2d(nnq.Conv2d):
                                          groups=groups, bias=bias, padding_mode=padding_mode)
 
     def weight(self):
-        return torch.ops.quantized.fbgemm_conv_unpack(self._packed_weight).permute([0, 3, 1, 2])
+        return torch.ops.quantized.conv_unpack(self._packed_weight).permute([0, 3, 1, 2])
 
     def set_weight(self, w):
-        self._packed_weight = torch.ops.quantized.fbgemm_conv_prepack(w.permute([0, 2, 3, 1]),
-                                                                      self.stride,
-                                                                      self.padding,
-                                                                      self.dilation,
-                                                                      self.groups)
+        self._packed_weight = torch.ops.quantized.conv_prepack(w.permute([0, 2, 3, 1]),
+                                                               self.stride,
+                                                               self.padding,
+                                                               self.dilation,
+                                                               self.groups)
 
     def forward(self, input):
         # Temporarily using len(shape) instead of ndim due to JIT issue
         # https://github.com/pytorch/pytorch/issues/23890
         if len(input.shape) != 4:
             raise ValueError("Input shape must be `(N, C, H, W)`!")
-        output = torch.ops.quantized.fbgemm_conv2d_relu(input.permute([0, 2, 3, 1]),
-                                                        self._packed_weight, self.bias,
-                                                        self.stride, self.padding,
-                                                        self.dilation, self.groups,
-                                                        float(self.scale), int(self.zero_point))
+        output = torch.ops.quantized.conv2d_relu(input.permute([0, 2, 3, 1]),
+                                                 self._packed_weight, self.bias,
+                                                 self.stride, self.padding,
+                                                 self.dilation, self.groups,
+                                                 float(self.scale), int(self.zero_point))
         return output.permute([0, 3, 1, 2])
 
     @classmethod
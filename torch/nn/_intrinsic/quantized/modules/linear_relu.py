@@ -26,7 +26,7 @@ class LinearReLU(nnq.Linear):
         super(LinearReLU, self).__init__(in_features, out_features, bias)
 
     def forward(self, input):
-        Y_q = torch.ops.quantized.fbgemm_linear_relu(
+        Y_q = torch.ops.quantized.linear_relu(
             input, self._packed_weight,
             self.bias,
             float(self.scale),
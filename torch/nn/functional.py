@@ -1990,6 +1990,9 @@ def cross_entropy(input, target, weight=None, size_average=None, ignore_index=-1
     """
     if size_average is not None or reduce is not None:
         reduction = _Reduction.legacy_get_string(size_average, reduce)
+    if input.dim() == 2 and target.dim() == 1 and input.size(0) == target.size(0):
+        # never materializes the log probabilities on the CPU
+        return torch._C._nn.cross_entropy_loss(input, target, weight, _Reduction.get_enum(reduction), ignore_index)
     return nll_loss(log_softmax(input, 1), target, weight, None, ignore_index, None, reduction)
 
 
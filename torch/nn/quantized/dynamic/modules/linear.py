@@ -47,7 +47,7 @@ class Linear(nnq.Linear):
 
     def forward(self, x):
         # Note that we can handle self.bias == None case.
-        Y = torch.ops.quantized.fbgemm_linear_dynamic(
+        Y = torch.ops.quantized.linear_dynamic(
             x, self._packed_weight,
             self.bias)
         return Y.to(x.dtype)
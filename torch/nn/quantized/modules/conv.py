@@ -104,11 +104,11 @@ class Conv2d(torch.nn.Module):
         return s.format(**self.__dict__)
 
     def set_weight(self, w):
-        self._packed_weight = torch.ops.quantized.fbgemm_conv_prepack(
+        self._packed_weight = torch.ops.quantized.conv_prepack(
             w.permute([0, 2, 3, 1]), self.stride, self.padding, self.dilation, self.groups)
 
     def weight(self):
-        return torch.ops.quantized.fbgemm_conv_unpack(
+        return torch.ops.quantized.conv_unpack(
             self._packed_weight).permute([0, 3, 1, 2])
 
     def forward(self, input):
@@ -116,11 +116,11 @@ class Conv2d(torch.nn.Module):
         # https://github.com/pytorch/pytorch/issues/23890
         if len(input.shape) != 4:
             raise ValueError("Input shape must be `(N, C, H, W)`!")
-        output = ops.quantized.fbgemm_conv2d(input.permute([0, 2, 3, 1]),
-                                             self._packed_weight, self.bias,
-                                             self.stride, self.padding,
-                                             self.dilation, self.groups,
-                                             self.scale, self.zero_point)
+        output = ops.quantized.conv2d(input.permute([0, 2, 3, 1]),
+                                      self._packed_weight, self.bias,
+                                      self.stride, self.padding,
+                                      self.dilation, self.groups,
+                                      self.scale, self.zero_point)
         return output.permute([0, 3, 1, 2])
 
     # ===== Serialization methods =====
@@ -129,7 +129,7 @@ class Linear(torch.nn.Module):
         )
 
     def forward(self, x):
-        return torch.ops.quantized.fbgemm_linear(
+        return torch.ops.quantized.linear(
             x, self._packed_weight, self.bias, self.scale, self.zero_point)
 
     # ===== Serialization methods =====
@@ -188,10 +188,10 @@ class Linear(torch.nn.Module):
     # Function rather than property to make sure that JIT serialization doesn't
     # register this as an attribute
     def weight(self):
-        return torch.ops.quantized.fbgemm_linear_unpack(self._packed_weight)
+        return torch.ops.quantized.linear_unpack(self._packed_weight)
 
     def set_weight(self, w):
-        self._packed_weight = torch.ops.quantized.fbgemm_linear_prepack(w)
+        self._packed_weight = torch.ops.quantized.linear_prepack(w)
 
     @classmethod
     def from_float(cls, mod):